@@ -25,6 +25,17 @@ static CPUIDResult cpuid(u32 leaf, u32 subleaf)
         : "0"(leaf), "2"(subleaf));
     return result;
 }
+
+// Tells us which register state the OS saves and restores for us.
+static u64 xgetbv(u32 index)
+{
+    u32 eax;
+    u32 edx;
+    asm("xgetbv"
+        : "=a"(eax), "=d"(edx)
+        : "c"(index));
+    return (static_cast<u64>(edx) << 32) | eax;
+}
 #    endif
 
 CPUFeatures Detail::detect_cpu_features_uncached()
@@ -48,6 +59,14 @@ CPUFeatures Detail::detect_cpu_features_uncached()
     if (cpuid1.ecx >> 25 & 1)
         result |= CPUFeatures::X86_AES;
 #        endif
+#        if AK_CAN_CODEGEN_FOR_X86_AVX2
+    // The CPU supporting AVX2 isn't enough, the OS also has to save the upper halves of the YMM registers.
+    bool os_saves_avx_state = (cpuid1.ecx >> 27 & 1) && (xgetbv(0) & 0b110) == 0b110;
+    if (os_saves_avx_state && (cpuid7.ebx >> 5 & 1))
+        result |= CPUFeatures::X86_AVX2;
+#        endif
+    if (cpuid7.ebx >> 9 & 1)
+        result |= CPUFeatures::X86_ERMS;
 #    endif
 
     return result;
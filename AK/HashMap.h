@@ -9,6 +9,7 @@
 
 #include <AK/HashTable.h>
 #include <AK/Optional.h>
+#include <AK/SwissHashTable.h>
 #include <AK/Vector.h>
 #include <initializer_list>
 
@@ -17,7 +18,9 @@ namespace AK {
 // A map datastructure, mapping keys K to values V, based on a hash table with closed hashing.
 // HashMap can optionally provide ordered iteration based on the order of keys when IsOrdered = true.
 // HashMap is based on HashTable, which should be used instead if just a set datastructure is required.
-template<typename K, typename V, typename KeyTraits, typename ValueTraits, bool IsOrdered>
+// The underlying table is a HashTable unless a map opts into a SwissHashTable, which is faster for lookup-heavy maps.
+// Only maps declared as SwissHashMap (or with SwissHashTable as their HashTableTemplate) use it; HashMap itself doesn't.
+template<typename K, typename V, typename KeyTraits, typename ValueTraits, bool IsOrdered, template<typename, typename, bool> typename HashTableTemplate>
 class HashMap {
 private:
     struct Entry {
@@ -93,7 +96,7 @@ public:
         });
     }
 
-    using HashTableType = HashTable<Entry, EntryTraits, IsOrdered>;
+    using HashTableType = HashTableTemplate<Entry, EntryTraits, IsOrdered>;
     using IteratorType = typename HashTableType::Iterator;
     using ConstIteratorType = typename HashTableType::ConstIterator;
 
@@ -299,10 +302,10 @@ public:
         return hash;
     }
 
-    template<typename NewKeyTraits = KeyTraits, typename NewValueTraits = ValueTraits, bool NewIsOrdered = IsOrdered>
-    ErrorOr<HashMap<K, V, NewKeyTraits, NewValueTraits, NewIsOrdered>> clone() const
+    template<typename NewKeyTraits = KeyTraits, typename NewValueTraits = ValueTraits, bool NewIsOrdered = IsOrdered, template<typename, typename, bool> typename NewHashTableTemplate = HashTableTemplate>
+    ErrorOr<HashMap<K, V, NewKeyTraits, NewValueTraits, NewIsOrdered, NewHashTableTemplate>> clone() const
     {
-        HashMap<K, V, NewKeyTraits, NewValueTraits, NewIsOrdered> hash_map_clone;
+        HashMap<K, V, NewKeyTraits, NewValueTraits, NewIsOrdered, NewHashTableTemplate> hash_map_clone;
         TRY(hash_map_clone.try_ensure_capacity(size()));
         for (auto const& [key, value] : *this)
             hash_map_clone.set(key, value);
@@ -318,4 +321,5 @@ private:
 #if USING_AK_GLOBALLY
 using AK::HashMap;
 using AK::OrderedHashMap;
+using AK::SwissHashMap;
 #endif
@@ -0,0 +1,677 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/CharacterTypes.h>
+#include <AK/FloatingPointStringConversions.h>
+#include <AK/GenericLexer.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonDocument.h>
+#include <AK/JsonObject.h>
+#include <AK/NumericLimits.h>
+#include <AK/SIMDExtras.h>
+#include <AK/StringBuilder.h>
+
+namespace AK {
+
+namespace {
+
+// Stage 1: Find the position of every structural character.
+//
+// These are the operators `{}[]:,`, the quotes around strings, and the first character of every other scalar.
+// Everything inside of strings is skipped, which is the hard part: A quote only ends a string if it isn't escaped,
+// and whether a backslash escapes something depends on how many backslashes came before it. The input is looked
+// at in blocks of 64 bytes, so that every property of a block fits into the bits of a u64.
+class StructuralIndexer {
+public:
+    explicit StructuralIndexer(Vector<u32>& structurals)
+        : m_structurals(structurals)
+    {
+    }
+
+    ErrorOr<void> index(StringView input)
+    {
+        auto const* data = reinterpret_cast<u8 const*>(input.characters_without_null_termination());
+
+        size_t offset = 0;
+        for (; offset + block_size <= input.length(); offset += block_size)
+            TRY(index_block(data + offset, offset));
+
+        if (offset < input.length()) {
+            // Whitespace is never structural, so the last block can be padded with it.
+            u8 block[block_size];
+            __builtin_memset(block, ' ', block_size);
+            __builtin_memcpy(block, data + offset, input.length() - offset);
+            TRY(index_block(block, offset));
+        }
+
+        if (m_in_string != 0)
+            return Error::from_string_literal("JsonDocument: EOF while parsing String");
+        return {};
+    }
+
+private:
+    static constexpr size_t block_size = 64;
+
+    template<typename Predicate>
+    ALWAYS_INLINE static u64 bits_matching(SIMD::u8x16 const (&chunks)[4], Predicate predicate)
+    {
+        u64 bits = 0;
+        for (size_t i = 0; i < 4; ++i)
+            bits |= static_cast<u64>(SIMD::maskbits(predicate(chunks[i]))) << (i * 16);
+        return bits;
+    }
+
+    // Turns every bit into the xor of itself and all lower bits. Applied to the quotes, this gives us all the bits
+    // from an opening quote up to (but not including) its closing quote.
+    ALWAYS_INLINE static u64 prefix_xor(u64 bits)
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    ALWAYS_INLINE u64 escaped_characters(u64 backslashes)
+    {
+        u64 escaped = 0;
+        if (m_next_is_escaped) {
+            escaped = 1;
+            backslashes &= ~1ull;
+            m_next_is_escaped = false;
+        }
+
+        // Backslashes are rare, so it's fine to handle them one at a time. Each one escapes the next character,
+        // which can't start an escape itself then.
+        while (backslashes != 0) {
+            auto bit = static_cast<size_t>(count_trailing_zeroes(backslashes));
+            if (bit == block_size - 1) {
+                m_next_is_escaped = true;
+                break;
+            }
+            escaped |= 2ull << bit;
+            backslashes &= ~(3ull << bit);
+        }
+        return escaped;
+    }
+
+    ErrorOr<void> index_block(u8 const* block, size_t offset)
+    {
+        SIMD::u8x16 chunks[4];
+        for (size_t i = 0; i < 4; ++i)
+            chunks[i] = SIMD::load_unaligned<SIMD::u8x16>(block + i * 16);
+
+        u64 backslashes = bits_matching(chunks, [](auto chunk) { return chunk == '\\'; });
+        u64 quotes = bits_matching(chunks, [](auto chunk) { return chunk == '"'; });
+        u64 whitespace = bits_matching(chunks, [](auto chunk) { return (chunk == ' ') | (chunk == '\t') | (chunk == '\n') | (chunk == '\r'); });
+        u64 operators = bits_matching(chunks, [](auto chunk) { return (chunk == '{') | (chunk == '}') | (chunk == '[') | (chunk == ']') | (chunk == ':') | (chunk == ','); });
+        u64 controls = bits_matching(chunks, [](auto chunk) { return chunk < 0x20; });
+
+        u64 real_quotes = quotes & ~escaped_characters(backslashes);
+        u64 in_string = prefix_xor(real_quotes) ^ m_in_string;
+        m_in_string = static_cast<u64>(static_cast<i64>(in_string) >> 63);
+
+        // Spec: All code points may be placed within the quotation marks except for the code points that must be
+        //       escaped: quotation mark (U+0022), reverse solidus (U+005C), and the control characters U+0000 to U+001F.
+        if ((controls & in_string) != 0)
+            return Error::from_string_literal("JsonDocument: ASCII control sequence encountered");
+
+        // A scalar like `true` or `-12.5` starts where the previous character wasn't part of a scalar.
+        u64 scalars = ~(operators | whitespace | quotes);
+        u64 follows_scalar = (scalars << 1) | m_previous_is_scalar;
+        m_previous_is_scalar = scalars >> 63;
+        u64 scalar_starts = scalars & ~follows_scalar;
+
+        u64 structurals = ((operators | scalar_starts) & ~in_string) | real_quotes;
+
+        TRY(m_structurals.try_grow_capacity(m_structurals.size() + block_size));
+        while (structurals != 0) {
+            m_structurals.unchecked_append(offset + count_trailing_zeroes(structurals));
+            structurals &= structurals - 1;
+        }
+        return {};
+    }
+
+    Vector<u32>& m_structurals;
+    // All ones if the previous block ended inside of a string.
+    u64 m_in_string { 0 };
+    u64 m_previous_is_scalar { 0 };
+    bool m_next_is_escaped { false };
+};
+
+class StringUnescaper : private GenericLexer {
+public:
+    explicit StringUnescaper(StringView input)
+        : GenericLexer(input)
+    {
+    }
+
+    ErrorOr<ByteString> unescape()
+    {
+        StringBuilder builder { m_input.length() };
+
+        while (!is_eof()) {
+            TRY(builder.try_append(consume_until('\\')));
+            if (is_eof())
+                break;
+            ignore(); // '\'
+
+            switch (peek()) {
+            case '"':
+            case '\\':
+            case '/':
+                TRY(builder.try_append(consume()));
+                break;
+            case 'b':
+                ignore();
+                TRY(builder.try_append('\b'));
+                break;
+            case 'f':
+                ignore();
+                TRY(builder.try_append('\f'));
+                break;
+            case 'n':
+                ignore();
+                TRY(builder.try_append('\n'));
+                break;
+            case 'r':
+                ignore();
+                TRY(builder.try_append('\r'));
+                break;
+            case 't':
+                ignore();
+                TRY(builder.try_append('\t'));
+                break;
+            case 'u': {
+                ignore(); // 'u'
+                auto code_point = decode_single_or_paired_surrogate();
+                if (code_point.is_error())
+                    return Error::from_string_literal("JsonDocument: Error while parsing Unicode escape");
+                TRY(builder.try_append_code_point(code_point.value()));
+                break;
+            }
+            default:
+                return Error::from_string_literal("JsonDocument: Invalid escaped character");
+            }
+        }
+
+        return builder.to_byte_string();
+    }
+};
+
+// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+bool is_valid_number(StringView text)
+{
+    size_t i = 0;
+    auto consume_digits = [&] {
+        auto start = i;
+        while (i < text.length() && is_ascii_digit(text[i]))
+            ++i;
+        return i > start;
+    };
+
+    if (i < text.length() && text[i] == '-')
+        ++i;
+    if (i < text.length() && text[i] == '0')
+        ++i;
+    else if (!consume_digits())
+        return false;
+
+    if (i < text.length() && text[i] == '.') {
+        ++i;
+        if (!consume_digits())
+            return false;
+    }
+
+    if (i < text.length() && (text[i] == 'e' || text[i] == 'E')) {
+        ++i;
+        if (i < text.length() && (text[i] == '+' || text[i] == '-'))
+            ++i;
+        if (!consume_digits())
+            return false;
+    }
+
+    return i == text.length();
+}
+
+Variant<u64, i64, double> parse_number(StringView text)
+{
+    if (!text.find_any_of(".eE"sv).has_value()) {
+        if (text[0] != '-') {
+            if (auto value = text.to_number<u64>(); value.has_value())
+                return *value;
+        } else if (text != "-0"sv) {
+            if (auto value = text.to_number<i64>(); value.has_value())
+                return *value;
+        }
+        // Negative zero can only be represented as a double, and so can integers that are too large.
+    }
+
+    auto const* start = text.characters_without_null_termination();
+    return parse_first_floating_point(start, start + text.length()).value;
+}
+
+// Stage 2: Walk over the structural characters and check that they follow the JSON grammar, telling the handler
+// about every value on the way. There's no recursion, nesting is tracked with an explicit stack.
+template<typename Handler>
+ErrorOr<void> walk_structurals(StringView input, ReadonlySpan<u32> structurals, Handler& handler)
+{
+    enum class Scope : u8 {
+        Object,
+        Array,
+    };
+
+    enum class State : u8 {
+        Value,
+        ObjectFirstKeyOrEnd,
+        ObjectKey,
+        ArrayFirstValueOrEnd,
+        AfterValue,
+    };
+
+    Vector<Scope, 32> scopes;
+    size_t index = 0;
+
+    auto peek = [&]() -> char {
+        if (index >= structurals.size())
+            return '\0';
+        return input[structurals[index]];
+    };
+
+    // The closing quote is always the very next structural character, as nothing inside of a string is structural.
+    auto consume_string = [&](auto on_string) -> ErrorOr<void> {
+        auto start = structurals[index] + 1;
+        auto end = structurals[index + 1];
+        index += 2;
+        auto raw = input.substring_view(start, end - start);
+        if (!raw.contains('\\'))
+            return on_string(raw, Optional<ByteString> {});
+        return on_string(raw, TRY(StringUnescaper { raw }.unescape()));
+    };
+
+    auto consume_scalar = [&]() -> ErrorOr<void> {
+        auto start = structurals[index++];
+        auto end = start;
+        while (end < input.length()) {
+            auto ch = input[end];
+            if (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ':' || ch == ',' || ch == '"')
+                break;
+            ++end;
+        }
+        auto text = input.substring_view(start, end - start);
+
+        if (text == "true"sv)
+            return handler.on_bool(true);
+        if (text == "false"sv)
+            return handler.on_bool(false);
+        if (text == "null"sv)
+            return handler.on_null();
+        if (is_valid_number(text))
+            return handler.on_number(text);
+        return Error::from_string_literal("JsonDocument: Unexpected character");
+    };
+
+    auto state = State::Value;
+    for (;;) {
+        switch (state) {
+        case State::Value:
+            switch (peek()) {
+            case '{':
+                ++index;
+                TRY(handler.on_object_start());
+                TRY(scopes.try_append(Scope::Object));
+                state = State::ObjectFirstKeyOrEnd;
+                break;
+            case '[':
+                ++index;
+                TRY(handler.on_array_start());
+                TRY(scopes.try_append(Scope::Array));
+                state = State::ArrayFirstValueOrEnd;
+                break;
+            case '"':
+                TRY(consume_string([&](StringView raw, Optional<ByteString> unescaped) { return handler.on_string(raw, move(unescaped)); }));
+                state = State::AfterValue;
+                break;
+            case '\0':
+                return Error::from_string_literal("JsonDocument: Unexpected end of input");
+            case '}':
+            case ']':
+            case ':':
+            case ',':
+                return Error::from_string_literal("JsonDocument: Unexpected character");
+            default:
+                TRY(consume_scalar());
+                state = State::AfterValue;
+                break;
+            }
+            break;
+
+        case State::ObjectFirstKeyOrEnd:
+            if (peek() == '}') {
+                ++index;
+                scopes.take_last();
+                TRY(handler.on_object_end());
+                state = State::AfterValue;
+                break;
+            }
+            [[fallthrough]];
+
+        case State::ObjectKey:
+            if (peek() != '"')
+                return Error::from_string_literal("JsonDocument: Expected '\"'");
+            TRY(consume_string([&](StringView raw, Optional<ByteString> unescaped) { return handler.on_key(raw, move(unescaped)); }));
+            if (peek() != ':')
+                return Error::from_string_literal("JsonDocument: Expected ':'");
+            ++index;
+            state = State::Value;
+            break;
+
+        case State::ArrayFirstValueOrEnd:
+            if (peek() == ']') {
+                ++index;
+                scopes.take_last();
+                TRY(handler.on_array_end());
+                state = State::AfterValue;
+                break;
+            }
+            state = State::Value;
+            break;
+
+        case State::AfterValue:
+            if (scopes.is_empty()) {
+                if (index != structurals.size())
+                    return Error::from_string_literal("JsonDocument: Didn't consume all input");
+                return {};
+            }
+
+            switch (peek()) {
+            case ',':
+                ++index;
+                state = scopes.last() == Scope::Object ? State::ObjectKey : State::Value;
+                break;
+            case '}':
+                if (scopes.last() != Scope::Object)
+                    return Error::from_string_literal("JsonDocument: Unexpected '}'");
+                ++index;
+                scopes.take_last();
+                TRY(handler.on_object_end());
+                break;
+            case ']':
+                if (scopes.last() != Scope::Array)
+                    return Error::from_string_literal("JsonDocument: Unexpected ']'");
+                ++index;
+                scopes.take_last();
+                TRY(handler.on_array_end());
+                break;
+            case '\0':
+                return Error::from_string_literal("JsonDocument: Unexpected end of input");
+            default:
+                return Error::from_string_literal("JsonDocument: Expected ','");
+            }
+            break;
+        }
+    }
+}
+
+ErrorOr<Vector<u32>> index_structurals(StringView input)
+{
+    // The offsets are stored as u32 to keep the index small.
+    if (input.length() > NumericLimits<u32>::max())
+        return Error::from_string_literal("JsonDocument: Input is too large");
+
+    Vector<u32> structurals;
+    TRY(StructuralIndexer { structurals }.index(input));
+    return structurals;
+}
+
+class EventHandlerAdapter {
+public:
+    explicit EventHandlerAdapter(JsonEventHandler& handler)
+        : m_handler(handler)
+    {
+    }
+
+    ErrorOr<void> on_object_start() { return m_handler.on_object_start(); }
+    ErrorOr<void> on_object_end() { return m_handler.on_object_end(); }
+    ErrorOr<void> on_array_start() { return m_handler.on_array_start(); }
+    ErrorOr<void> on_array_end() { return m_handler.on_array_end(); }
+    ErrorOr<void> on_key(StringView raw, Optional<ByteString> unescaped) { return m_handler.on_key(unescaped.has_value() ? unescaped->view() : raw); }
+    ErrorOr<void> on_string(StringView raw, Optional<ByteString> unescaped) { return m_handler.on_string(unescaped.has_value() ? unescaped->view() : raw); }
+    ErrorOr<void> on_number(StringView text) { return m_handler.on_number(text); }
+    ErrorOr<void> on_bool(bool value) { return m_handler.on_bool(value); }
+    ErrorOr<void> on_null() { return m_handler.on_null(); }
+
+private:
+    JsonEventHandler& m_handler;
+};
+
+}
+
+ErrorOr<void> parse_json_events(StringView input, JsonEventHandler& handler)
+{
+    auto structurals = TRY(index_structurals(input));
+    EventHandlerAdapter adapter { handler };
+    return walk_structurals(input, structurals, adapter);
+}
+
+class JsonTapeBuilder {
+public:
+    explicit JsonTapeBuilder(JsonDocument& document)
+        : m_document(document)
+    {
+    }
+
+    ErrorOr<void> on_object_start() { return open(JsonDocument::Type::Object); }
+    ErrorOr<void> on_object_end() { return close(); }
+    ErrorOr<void> on_array_start() { return open(JsonDocument::Type::Array); }
+    ErrorOr<void> on_array_end() { return close(); }
+
+    ErrorOr<void> on_key(StringView raw, Optional<ByteString> unescaped)
+    {
+        // Keys are counted instead of their values, so that the values aren't counted twice.
+        ++m_document.m_tape[m_open_containers.last()].count;
+        return append_string(raw, move(unescaped));
+    }
+
+    ErrorOr<void> on_string(StringView raw, Optional<ByteString> unescaped)
+    {
+        count_array_element();
+        return append_string(raw, move(unescaped));
+    }
+
+    ErrorOr<void> on_number(StringView text)
+    {
+        count_array_element();
+        return append({ .type = JsonDocument::Type::Number, .offset = offset_of(text), .length = static_cast<u32>(text.length()) });
+    }
+
+    ErrorOr<void> on_bool(bool value)
+    {
+        count_array_element();
+        return append({ .type = JsonDocument::Type::Bool, .length = value });
+    }
+
+    ErrorOr<void> on_null()
+    {
+        count_array_element();
+        return append({ .type = JsonDocument::Type::Null });
+    }
+
+private:
+    u32 offset_of(StringView text) const
+    {
+        return text.characters_without_null_termination() - m_document.m_input.characters_without_null_termination();
+    }
+
+    void count_array_element()
+    {
+        if (m_open_containers.is_empty())
+            return;
+        auto& container = m_document.m_tape[m_open_containers.last()];
+        if (container.type == JsonDocument::Type::Array)
+            ++container.count;
+    }
+
+    ErrorOr<void> append(JsonDocument::TapeEntry entry)
+    {
+        entry.next = m_document.m_tape.size() + 1;
+        return m_document.m_tape.try_append(entry);
+    }
+
+    ErrorOr<void> append_string(StringView raw, Optional<ByteString> unescaped)
+    {
+        if (!unescaped.has_value())
+            return append({ .type = JsonDocument::Type::String, .offset = offset_of(raw), .length = static_cast<u32>(raw.length()) });
+
+        auto index = static_cast<u32>(m_document.m_unescaped_strings.size());
+        TRY(m_document.m_unescaped_strings.try_append(unescaped.release_value()));
+        return append({ .type = JsonDocument::Type::String, .is_unescaped = true, .offset = index });
+    }
+
+    ErrorOr<void> open(JsonDocument::Type type)
+    {
+        count_array_element();
+        TRY(m_open_containers.try_append(m_document.m_tape.size()));
+        return append({ .type = type });
+    }
+
+    ErrorOr<void> close()
+    {
+        auto index = m_open_containers.take_last();
+        m_document.m_tape[index].next = m_document.m_tape.size();
+        return {};
+    }
+
+    JsonDocument& m_document;
+    Vector<u32, 32> m_open_containers;
+};
+
+ErrorOr<JsonDocument> JsonDocument::parse(StringView input)
+{
+    auto structurals = TRY(index_structurals(input));
+
+    JsonDocument document;
+    document.m_input = input;
+    // There's at most one tape entry per structural character, and usually quite a bit fewer.
+    TRY(document.m_tape.try_ensure_capacity(structurals.size()));
+
+    JsonTapeBuilder builder { document };
+    TRY(walk_structurals(input, structurals, builder));
+    return document;
+}
+
+StringView JsonDocument::Value::as_string() const
+{
+    VERIFY(is_string());
+    auto const& string = entry();
+    if (string.is_unescaped)
+        return m_document->m_unescaped_strings[string.offset];
+    return m_document->m_input.substring_view(string.offset, string.length);
+}
+
+StringView JsonDocument::Value::as_number_text() const
+{
+    VERIFY(is_number());
+    return m_document->m_input.substring_view(entry().offset, entry().length);
+}
+
+Variant<u64, i64, double> JsonDocument::Value::as_number() const
+{
+    return parse_number(as_number_text());
+}
+
+JsonDocument::Value JsonDocument::Value::at(size_t index) const
+{
+    VERIFY(is_array());
+    VERIFY(index < entry().count);
+    auto tape_index = m_index + 1;
+    for (size_t i = 0; i < index; ++i)
+        tape_index = m_document->m_tape[tape_index].next;
+    return { *m_document, tape_index };
+}
+
+Optional<JsonDocument::Value> JsonDocument::Value::get(StringView key) const
+{
+    VERIFY(is_object());
+    auto tape_index = m_index + 1;
+    for (size_t i = 0; i < entry().count; ++i) {
+        if (Value { *m_document, tape_index }.as_string() == key)
+            return Value { *m_document, tape_index + 1 };
+        tape_index = m_document->m_tape[tape_index + 1].next;
+    }
+    return {};
+}
+
+Optional<bool> JsonDocument::Value::get_bool(StringView key) const
+{
+    auto value = get(key);
+    if (!value.has_value())
+        return {};
+    return value->get_bool();
+}
+
+Optional<StringView> JsonDocument::Value::get_string(StringView key) const
+{
+    auto value = get(key);
+    if (!value.has_value() || !value->is_string())
+        return {};
+    return value->as_string();
+}
+
+Optional<ByteString> JsonDocument::Value::get_byte_string(StringView key) const
+{
+    auto value = get(key);
+    if (!value.has_value() || !value->is_string())
+        return {};
+    return value->as_byte_string();
+}
+
+Optional<JsonDocument::Value> JsonDocument::Value::get_array(StringView key) const
+{
+    auto value = get(key);
+    if (!value.has_value() || !value->is_array())
+        return {};
+    return value;
+}
+
+Optional<JsonDocument::Value> JsonDocument::Value::get_object(StringView key) const
+{
+    auto value = get(key);
+    if (!value.has_value() || !value->is_object())
+        return {};
+    return value;
+}
+
+JsonValue JsonDocument::Value::to_json_value() const
+{
+    switch (type()) {
+    case Type::Null:
+        return {};
+    case Type::Bool:
+        return as_bool();
+    case Type::Number:
+        return as_number().visit([](auto value) { return JsonValue { value }; });
+    case Type::String:
+        return as_string();
+    case Type::Array: {
+        JsonArray array;
+        array.ensure_capacity(size());
+        for_each([&](auto const& element) { array.must_append(element.to_json_value()); });
+        return array;
+    }
+    case Type::Object: {
+        JsonObject object;
+        for_each_member([&](auto key, auto const& value) { object.set(key, value.to_json_value()); });
+        return object;
+    }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+}
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#ifdef KERNEL
+#    error "JsonDocument does not propagate allocation failures, so it is not safe to use in the kernel."
+#endif
+
+#include <AK/ByteString.h>
+#include <AK/Checked.h>
+#include <AK/Error.h>
+#include <AK/JsonValue.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Variant.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+// Receives the parts of a JSON text in document order, as a SAX parser would hand them out. Nothing is
+// built up in between, so this is the cheapest way to look at a document exactly once.
+// Returning an error from any of the callbacks stops parsing, and is passed on to the caller.
+class JsonEventHandler {
+public:
+    virtual ~JsonEventHandler() = default;
+
+    virtual ErrorOr<void> on_object_start() { return {}; }
+    virtual ErrorOr<void> on_object_end() { return {}; }
+    virtual ErrorOr<void> on_array_start() { return {}; }
+    virtual ErrorOr<void> on_array_end() { return {}; }
+    // The strings are unescaped, but only live until the callback returns.
+    virtual ErrorOr<void> on_key(StringView) { return {}; }
+    virtual ErrorOr<void> on_string(StringView) { return {}; }
+    // Numbers are passed on as they were written. They are valid JSON numbers, but might not fit any C++ type.
+    virtual ErrorOr<void> on_number(StringView) { return {}; }
+    virtual ErrorOr<void> on_bool(bool) { return {}; }
+    virtual ErrorOr<void> on_null() { return {}; }
+};
+
+ErrorOr<void> parse_json_events(StringView input, JsonEventHandler&);
+
+// A read-only JSON document that is parsed in two passes, like simdjson does it: The first pass finds the
+// positions of all structural characters with SIMD, 64 bytes at a time. The second one walks over those
+// positions and writes every value into a flat "tape". The values handed out are just views into that tape,
+// and strings and numbers are views into the input. Only strings with escape sequences get copied.
+//
+// The document does not copy the input, so the input has to outlive the document and all of its values.
+class JsonDocument {
+    AK_MAKE_NONCOPYABLE(JsonDocument);
+    AK_MAKE_DEFAULT_MOVABLE(JsonDocument);
+
+public:
+    enum class Type : u8 {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+
+private:
+    struct TapeEntry {
+        Type type;
+        // Set for strings that were unescaped into m_unescaped_strings, `offset` is the index into that then.
+        bool is_unescaped { false };
+        // Where the string or number starts in the input.
+        u32 offset { 0 };
+        // The length of a string or number, or whether a bool is true.
+        u32 length { 0 };
+        // The number of elements or members of an array or object.
+        u32 count { 0 };
+        // The tape index of the next value after this one and everything in it.
+        u32 next { 0 };
+    };
+
+public:
+    class Value {
+    public:
+        Type type() const { return entry().type; }
+
+        bool is_null() const { return type() == Type::Null; }
+        bool is_bool() const { return type() == Type::Bool; }
+        bool is_number() const { return type() == Type::Number; }
+        bool is_string() const { return type() == Type::String; }
+        bool is_array() const { return type() == Type::Array; }
+        bool is_object() const { return type() == Type::Object; }
+
+        bool as_bool() const
+        {
+            VERIFY(is_bool());
+            return entry().length != 0;
+        }
+
+        Optional<bool> get_bool() const
+        {
+            if (!is_bool())
+                return {};
+            return as_bool();
+        }
+
+        // This does not allocate, unless the string had escape sequences in it when the document was parsed.
+        StringView as_string() const;
+        ByteString as_byte_string() const { return ByteString { as_string() }; }
+
+        // The number exactly as it was written in the input.
+        StringView as_number_text() const;
+        Variant<u64, i64, double> as_number() const;
+
+        template<Integral T>
+        Optional<T> get_integer() const
+        {
+            if (!is_number())
+                return {};
+            return as_number().visit(
+                []<Arithmetic U>(U value) -> Optional<T> {
+                    if constexpr (Integral<U>) {
+                        if (!is_within_range<T>(value))
+                            return {};
+                        return static_cast<T>(value);
+                    } else {
+                        if (static_cast<U>(static_cast<T>(value)) != value)
+                            return {};
+                        return static_cast<T>(value);
+                    }
+                });
+        }
+
+        template<Integral T>
+        bool is_integer() const { return get_integer<T>().has_value(); }
+
+        template<Integral T>
+        T as_integer() const { return get_integer<T>().value(); }
+
+        Optional<i32> get_i32() const { return get_integer<i32>(); }
+        Optional<u32> get_u32() const { return get_integer<u32>(); }
+        Optional<i64> get_i64() const { return get_integer<i64>(); }
+        Optional<u64> get_u64() const { return get_integer<u64>(); }
+
+        Optional<double> get_double_with_precision_loss() const
+        {
+            if (!is_number())
+                return {};
+            return as_number().visit([](auto value) { return static_cast<double>(value); });
+        }
+
+        // Arrays and objects are not separate types, these exist to keep code that works with JsonValue working.
+        Value const& as_array() const
+        {
+            VERIFY(is_array());
+            return *this;
+        }
+
+        Value const& as_object() const
+        {
+            VERIFY(is_object());
+            return *this;
+        }
+
+        // The number of elements in an array, or members in an object.
+        size_t size() const
+        {
+            VERIFY(is_array() || is_object());
+            return entry().count;
+        }
+
+        bool is_empty() const { return size() == 0; }
+
+        template<typename Callback>
+        void for_each(Callback callback) const
+        {
+            VERIFY(is_array());
+            auto index = m_index + 1;
+            for (size_t i = 0; i < entry().count; ++i) {
+                Value element { *m_document, index };
+                callback(element);
+                index = m_document->m_tape[index].next;
+            }
+        }
+
+        // This has to walk over all of the elements in front of the wanted one.
+        Value at(size_t index) const;
+        Value operator[](size_t index) const { return at(index); }
+
+        template<typename Callback>
+        void for_each_member(Callback callback) const
+        {
+            VERIFY(is_object());
+            auto index = m_index + 1;
+            for (size_t i = 0; i < entry().count; ++i) {
+                auto key = Value { *m_document, index }.as_string();
+                Value value { *m_document, index + 1 };
+                callback(key, value);
+                index = m_document->m_tape[index + 1].next;
+            }
+        }
+
+        // Looks up a member by comparing the keys one after the other. That's cheaper than hashing for the small
+        // objects that JSON is usually made of, and doesn't require any setup.
+        Optional<Value> get(StringView key) const;
+        bool has(StringView key) const { return get(key).has_value(); }
+
+        template<Integral T>
+        Optional<T> get_integer(StringView key) const
+        {
+            auto value = get(key);
+            if (!value.has_value())
+                return {};
+            return value->get_integer<T>();
+        }
+
+        Optional<i32> get_i32(StringView key) const { return get_integer<i32>(key); }
+        Optional<u32> get_u32(StringView key) const { return get_integer<u32>(key); }
+        Optional<i64> get_i64(StringView key) const { return get_integer<i64>(key); }
+        Optional<u64> get_u64(StringView key) const { return get_integer<u64>(key); }
+        Optional<bool> get_bool(StringView key) const;
+        Optional<StringView> get_string(StringView key) const;
+        Optional<ByteString> get_byte_string(StringView key) const;
+        Optional<Value> get_array(StringView key) const;
+        Optional<Value> get_object(StringView key) const;
+
+        // Builds a JsonValue with a copy of this value and everything in it.
+        JsonValue to_json_value() const;
+
+    private:
+        friend class JsonDocument;
+
+        Value(JsonDocument const& document, u32 index)
+            : m_document(&document)
+            , m_index(index)
+        {
+        }
+
+        TapeEntry const& entry() const { return m_document->m_tape[m_index]; }
+
+        JsonDocument const* m_document { nullptr };
+        u32 m_index { 0 };
+    };
+
+    static ErrorOr<JsonDocument> parse(StringView input);
+
+    Value root() const { return { *this, 0 }; }
+
+private:
+    friend class JsonTapeBuilder;
+
+    JsonDocument() = default;
+
+    StringView m_input;
+    Vector<TapeEntry> m_tape;
+    Vector<ByteString> m_unescaped_strings;
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::JsonDocument;
+using AK::JsonEventHandler;
+using AK::parse_json_events;
+#endif
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/InsertionSort.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+namespace Detail {
+
+// Runs this short are sorted with (stable) insertion sort before merging.
+static constexpr size_t MERGE_SORT_INSERTION_SORT_THRESHOLD = 16;
+
+template<typename Collection, typename LessThan, typename T>
+void merge_sort_impl(Collection& col, size_t begin, size_t end, LessThan& less_than, Vector<T>& buffer)
+{
+    if (end - begin <= MERGE_SORT_INSERTION_SORT_THRESHOLD) {
+        AK::insertion_sort(col, begin, end - 1, less_than);
+        return;
+    }
+
+    size_t middle = begin + (end - begin) / 2;
+    merge_sort_impl(col, begin, middle, less_than, buffer);
+    merge_sort_impl(col, middle, end, less_than, buffer);
+
+    // The two halves are already in order, which happens a lot with partially sorted input.
+    if (!less_than(col[middle], col[middle - 1]))
+        return;
+
+    // Move the left half out of the way, then merge it and the right half from the front.
+    buffer.clear_with_capacity();
+    for (size_t i = begin; i < middle; ++i)
+        buffer.unchecked_append(move(col[i]));
+
+    size_t left = 0;
+    size_t right = middle;
+    size_t out = begin;
+    while (left < buffer.size() && right < end) {
+        // Only take from the right half if it's strictly less, so that equal elements keep their order.
+        if (less_than(col[right], buffer[left]))
+            col[out++] = move(col[right++]);
+        else
+            col[out++] = move(buffer[left++]);
+    }
+    while (left < buffer.size())
+        col[out++] = move(buffer[left++]);
+}
+
+}
+
+// This is a stable sort, so elements that compare equal keep their relative order. Unlike quick_sort(),
+// it needs to move elements around instead of just swapping them, and allocates a buffer of n/2 elements.
+template<typename Collection, typename LessThan>
+void merge_sort(Collection& collection, LessThan less_than)
+{
+    size_t size = collection.size();
+    if (size <= 1)
+        return;
+
+    Vector<RemoveCVReference<decltype(collection[0])>> buffer;
+    buffer.ensure_capacity(size / 2 + 1);
+    Detail::merge_sort_impl(collection, 0, size, less_than, buffer);
+}
+
+template<typename Collection>
+void merge_sort(Collection& collection)
+{
+    merge_sort(collection, [](auto& a, auto& b) { return a < b; });
+}
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::merge_sort;
+#endif
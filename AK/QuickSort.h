@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/InsertionSort.h>
 #include <AK/StdLibExtras.h>
 
@@ -139,6 +140,327 @@ void single_pivot_quick_sort(Iterator start, Iterator end, LessThan less_than)
     }
 }
 
+namespace Detail {
+
+// Ranges smaller than this are left to insertion sort.
+static constexpr size_t PDQ_INSERTION_SORT_THRESHOLD = 24;
+// Ranges larger than this use the pseudomedian of nine as their pivot.
+static constexpr size_t PDQ_NINTHER_THRESHOLD = 128;
+// How many element moves a partial insertion sort may do before it gives up.
+static constexpr size_t PDQ_PARTIAL_INSERTION_SORT_LIMIT = 8;
+// Number of elements that are classified at once by the branchless partition.
+static constexpr size_t PDQ_BLOCK_SIZE = 64;
+
+template<typename Collection, typename LessThan>
+void pdq_insertion_sort(Collection& col, size_t begin, size_t end, LessThan& less_than)
+{
+    for (size_t i = begin + 1; i < end; ++i) {
+        for (size_t j = i; j > begin && less_than(col[j], col[j - 1]); --j)
+            swap(col[j], col[j - 1]);
+    }
+}
+
+// Like insertion sort, but gives up and returns false if the range turns out to be far from sorted.
+template<typename Collection, typename LessThan>
+bool pdq_partial_insertion_sort(Collection& col, size_t begin, size_t end, LessThan& less_than)
+{
+    size_t moves = 0;
+    for (size_t i = begin + 1; i < end; ++i) {
+        for (size_t j = i; j > begin && less_than(col[j], col[j - 1]); --j) {
+            swap(col[j], col[j - 1]);
+            ++moves;
+        }
+        if (moves > PDQ_PARTIAL_INSERTION_SORT_LIMIT)
+            return false;
+    }
+    return true;
+}
+
+template<typename Collection, typename LessThan>
+void heap_sort_sift_down(Collection& col, size_t begin, size_t root, size_t size, LessThan& less_than)
+{
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= size)
+            return;
+        if (child + 1 < size && less_than(col[begin + child], col[begin + child + 1]))
+            ++child;
+        if (!less_than(col[begin + root], col[begin + child]))
+            return;
+        swap(col[begin + root], col[begin + child]);
+        root = child;
+    }
+}
+
+template<typename Collection, typename LessThan>
+void heap_sort(Collection& col, size_t begin, size_t end, LessThan& less_than)
+{
+    size_t size = end - begin;
+    for (size_t i = size / 2; i > 0; --i)
+        heap_sort_sift_down(col, begin, i - 1, size, less_than);
+    for (size_t i = size; i > 1; --i) {
+        swap(col[begin], col[begin + i - 1]);
+        heap_sort_sift_down(col, begin, 0, i - 1, less_than);
+    }
+}
+
+template<typename Collection, typename LessThan>
+void sort3(Collection& col, size_t a, size_t b, size_t c, LessThan& less_than)
+{
+    if (less_than(col[b], col[a]))
+        swap(col[a], col[b]);
+    if (less_than(col[c], col[b]))
+        swap(col[b], col[c]);
+    if (less_than(col[b], col[a]))
+        swap(col[a], col[b]);
+}
+
+struct PartitionResult {
+    size_t pivot_position;
+    bool was_already_partitioned;
+};
+
+// Partitions [begin, end) around the pivot at col[begin]. Elements equal to the pivot end up on the right.
+// The pivot stays in place until the very end, so this only ever needs to swap elements.
+template<bool Branchless, typename Collection, typename LessThan>
+PartitionResult pdq_partition_right(Collection& col, size_t begin, size_t end, LessThan& less_than)
+{
+    auto&& pivot = col[begin];
+
+    // [begin + 1, first) is less than the pivot, [last, end) is not.
+    size_t first = begin + 1;
+    size_t last = end;
+    while (first < last && less_than(col[first], pivot))
+        ++first;
+    while (first < last && !less_than(col[last - 1], pivot))
+        --last;
+
+    bool was_already_partitioned = first >= last;
+
+    if constexpr (Branchless) {
+        if (!was_already_partitioned) {
+            swap(col[first], col[last - 1]);
+            ++first;
+            --last;
+        }
+
+        // Classify a whole block of elements on each side without branching on the comparison, and only
+        // then swap the misplaced ones. This avoids a branch misprediction for about every other element.
+        u8 left_offsets[PDQ_BLOCK_SIZE];
+        u8 right_offsets[PDQ_BLOCK_SIZE];
+        size_t left_base = first;
+        size_t right_base = last;
+        size_t left_count = 0;
+        size_t right_count = 0;
+        size_t left_start = 0;
+        size_t right_start = 0;
+
+        while (first < last) {
+            size_t unknown = last - first;
+            size_t left_split = left_count == 0 ? (right_count == 0 ? unknown / 2 : unknown) : 0;
+            size_t right_split = right_count == 0 ? unknown - left_split : 0;
+
+            for (size_t i = 0; i < min(left_split, PDQ_BLOCK_SIZE); ++i) {
+                left_offsets[left_count] = i;
+                left_count += !less_than(col[first], pivot);
+                ++first;
+            }
+            for (size_t i = 0; i < min(right_split, PDQ_BLOCK_SIZE); ++i) {
+                --last;
+                right_offsets[right_count] = i + 1;
+                right_count += less_than(col[last], pivot);
+            }
+
+            size_t count = min(left_count, right_count);
+            for (size_t i = 0; i < count; ++i)
+                swap(col[left_base + left_offsets[left_start + i]], col[right_base - right_offsets[right_start + i]]);
+
+            left_count -= count;
+            right_count -= count;
+            left_start += count;
+            right_start += count;
+            if (left_count == 0) {
+                left_start = 0;
+                left_base = first;
+            }
+            if (right_count == 0) {
+                right_start = 0;
+                right_base = last;
+            }
+        }
+
+        // At most one side still has misplaced elements, move them over to the boundary.
+        if (left_count > 0) {
+            while (left_count > 0) {
+                --left_count;
+                swap(col[left_base + left_offsets[left_start + left_count]], col[--last]);
+            }
+            first = last;
+        }
+        if (right_count > 0) {
+            while (right_count > 0) {
+                --right_count;
+                swap(col[right_base - right_offsets[right_start + right_count]], col[first++]);
+            }
+        }
+    } else {
+        while (first < last) {
+            swap(col[first], col[last - 1]);
+            ++first;
+            --last;
+            while (first < last && less_than(col[first], pivot))
+                ++first;
+            while (first < last && !less_than(col[last - 1], pivot))
+                --last;
+        }
+    }
+
+    size_t pivot_position = first - 1;
+    swap(col[begin], col[pivot_position]);
+    return { pivot_position, was_already_partitioned };
+}
+
+// Partitions [begin, end) around the pivot at col[begin], with elements equal to the pivot ending up on the left.
+// This is used when the pivot is known to be equal to the element before the range, so everything that ends up on
+// the left is equal to it and doesn't need to be looked at again.
+template<typename Collection, typename LessThan>
+size_t pdq_partition_left(Collection& col, size_t begin, size_t end, LessThan& less_than)
+{
+    auto&& pivot = col[begin];
+
+    // [begin + 1, first) is not greater than the pivot, [last, end) is.
+    size_t first = begin + 1;
+    size_t last = end;
+    while (first < last && less_than(pivot, col[last - 1]))
+        --last;
+    while (first < last && !less_than(pivot, col[first]))
+        ++first;
+
+    while (first < last) {
+        swap(col[first], col[last - 1]);
+        ++first;
+        --last;
+        while (first < last && less_than(pivot, col[last - 1]))
+            --last;
+        while (first < last && !less_than(pivot, col[first]))
+            ++first;
+    }
+
+    size_t pivot_position = first - 1;
+    swap(col[begin], col[pivot_position]);
+    return pivot_position;
+}
+
+template<bool Branchless, typename Collection, typename LessThan>
+void pattern_defeating_quick_sort_loop(Collection& col, size_t begin, size_t end, LessThan& less_than, int bad_partitions_allowed, bool leftmost)
+{
+    for (;;) {
+        size_t size = end - begin;
+        if (size < PDQ_INSERTION_SORT_THRESHOLD) {
+            pdq_insertion_sort(col, begin, end, less_than);
+            return;
+        }
+
+        // Move the pivot to col[begin].
+        size_t half = size / 2;
+        if (size > PDQ_NINTHER_THRESHOLD) {
+            sort3(col, begin, begin + half, end - 1, less_than);
+            sort3(col, begin + 1, begin + half - 1, end - 2, less_than);
+            sort3(col, begin + 2, begin + half + 1, end - 3, less_than);
+            sort3(col, begin + half - 1, begin + half, begin + half + 1, less_than);
+            swap(col[begin], col[begin + half]);
+        } else {
+            sort3(col, begin + half, begin, end - 1, less_than);
+        }
+
+        // If the pivot is equal to the element before this range (which is the pivot of an earlier partition), then
+        // there are lots of equal elements. Put them all on the left, where they are already in their final place.
+        if (!leftmost && !less_than(col[begin - 1], col[begin])) {
+            begin = pdq_partition_left(col, begin, end, less_than) + 1;
+            continue;
+        }
+
+        auto [pivot_position, was_already_partitioned] = pdq_partition_right<Branchless>(col, begin, end, less_than);
+
+        size_t left_size = pivot_position - begin;
+        size_t right_size = end - (pivot_position + 1);
+
+        if (left_size < size / 8 || right_size < size / 8) {
+            // After too many bad partitions the input is likely adversarial, so fall back to heap sort
+            // to keep the worst case at O(n log n).
+            if (--bad_partitions_allowed == 0) {
+                heap_sort(col, begin, end, less_than);
+                return;
+            }
+
+            // Otherwise, shuffle some elements around to break up the pattern that led to the bad partition.
+            if (left_size >= PDQ_INSERTION_SORT_THRESHOLD) {
+                swap(col[begin], col[begin + left_size / 4]);
+                swap(col[pivot_position - 1], col[pivot_position - left_size / 4]);
+                if (left_size > PDQ_NINTHER_THRESHOLD) {
+                    swap(col[begin + 1], col[begin + left_size / 4 + 1]);
+                    swap(col[begin + 2], col[begin + left_size / 4 + 2]);
+                    swap(col[pivot_position - 2], col[pivot_position - (left_size / 4 + 1)]);
+                    swap(col[pivot_position - 3], col[pivot_position - (left_size / 4 + 2)]);
+                }
+            }
+            if (right_size >= PDQ_INSERTION_SORT_THRESHOLD) {
+                swap(col[pivot_position + 1], col[pivot_position + 1 + right_size / 4]);
+                swap(col[end - 1], col[end - right_size / 4]);
+                if (right_size > PDQ_NINTHER_THRESHOLD) {
+                    swap(col[pivot_position + 2], col[pivot_position + 2 + right_size / 4]);
+                    swap(col[pivot_position + 3], col[pivot_position + 3 + right_size / 4]);
+                    swap(col[end - 2], col[end - (1 + right_size / 4)]);
+                    swap(col[end - 3], col[end - (2 + right_size / 4)]);
+                }
+            }
+        } else if (was_already_partitioned
+            && pdq_partial_insertion_sort(col, begin, pivot_position, less_than)
+            && pdq_partial_insertion_sort(col, pivot_position + 1, end, less_than)) {
+            // A balanced partition that didn't have to move anything suggests that the input is (nearly) sorted.
+            return;
+        }
+
+        // Both sides are at least an eighth of the range unless we ran into a bad partition, and there can only be
+        // a logarithmic number of those, so this doesn't recurse too deeply.
+        pattern_defeating_quick_sort_loop<Branchless>(col, begin, pivot_position, less_than, bad_partitions_allowed, leftmost);
+        begin = pivot_position + 1;
+        leftmost = false;
+    }
+}
+
+}
+
+// This is a pattern-defeating quick sort (https://arxiv.org/abs/2106.05123). It is an introsort, so it falls back to
+// heap sort on inputs that make it pick bad pivots, and has a worst case of O(n log n). It also sorts inputs that are
+// already (nearly) sorted or have lots of equal elements in linear time. Like the dual pivot quick sort above, it only
+// needs to swap elements, and `end` is exclusive.
+template<typename Collection, typename LessThan>
+void pattern_defeating_quick_sort(Collection& col, size_t start, size_t end, LessThan less_than)
+{
+    if (end - start <= 1)
+        return;
+
+    // Comparing cheap values is fast enough that a mispredicted branch is the most expensive part of partitioning.
+    using ValueType = RemoveCVReference<decltype(col[start])>;
+    constexpr bool branchless = IsArithmetic<ValueType> || IsPointer<ValueType>;
+
+    int bad_partitions_allowed = sizeof(size_t) * 8 - count_leading_zeroes(end - start);
+    Detail::pattern_defeating_quick_sort_loop<branchless>(col, start, end, less_than, bad_partitions_allowed, true);
+}
+
+template<typename Collection, typename LessThan>
+void sort(Collection& collection, LessThan less_than)
+{
+    pattern_defeating_quick_sort(collection, 0, collection.size(), move(less_than));
+}
+
+template<typename Collection>
+void sort(Collection& collection)
+{
+    pattern_defeating_quick_sort(collection, 0, collection.size(), [](auto& a, auto& b) { return a < b; });
+}
+
 template<typename Iterator>
 void quick_sort(Iterator start, Iterator end)
 {
@@ -154,14 +476,13 @@ void quick_sort(Iterator start, Iterator end, LessThan less_than)
 template<typename Collection, typename LessThan>
 void quick_sort(Collection& collection, LessThan less_than)
 {
-    dual_pivot_quick_sort(collection, 0, collection.size() - 1, move(less_than));
+    AK::sort(collection, move(less_than));
 }
 
 template<typename Collection>
 void quick_sort(Collection& collection)
 {
-    dual_pivot_quick_sort(collection, 0, collection.size() - 1,
-        [](auto& a, auto& b) { return a < b; });
+    AK::sort(collection);
 }
 
 }
@@ -40,6 +40,21 @@ ALWAYS_INLINE static i32 maskbits(i32x4 mask)
 #endif
 }
 
+// Gathers the top bit of each byte, like pmovmskb does.
+ALWAYS_INLINE static u16 maskbits(i8x16 mask)
+{
+#if defined(__SSE2__)
+    return __builtin_ia32_pmovmskb128((c8x16)mask);
+#else
+    // Give the top bit of each byte in a half a different place value, then add up all the bytes of that half
+    // with a multiplication. There can't be any carries, so the sum ends up in the top byte.
+    u8x16 bits = ((u8x16)mask >> 7) << (u8x16) { 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7 };
+    auto halves = (u64x2)bits;
+    constexpr u64 add_all_bytes = 0x0101010101010101;
+    return ((halves[0] * add_all_bytes) >> 56) | (((halves[1] * add_all_bytes) >> 56) << 8);
+#endif
+}
+
 ALWAYS_INLINE static bool all(i32x4 mask)
 {
     return maskbits(mask) == 15;
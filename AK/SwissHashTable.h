@@ -0,0 +1,580 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/Concepts.h>
+#include <AK/Error.h>
+#include <AK/HashTable.h>
+#include <AK/IterationDecision.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Traits.h>
+#include <AK/Types.h>
+#include <AK/kmalloc.h>
+
+#ifndef KERNEL
+#    include <AK/SIMDExtras.h>
+#endif
+
+namespace AK {
+
+namespace Detail {
+
+// Every slot of a SwissHashTable has a control byte, which is either Empty, Deleted, or (if the slot is in use)
+// 7 bits of the hash of the value in it. Control bytes are checked a whole group at a time, which rules out most
+// of the slots whose values we'd otherwise have to compare.
+class SwissHashTableGroup {
+public:
+    static constexpr size_t size = 16;
+
+    static constexpr u8 empty = 0b1000'0000;
+    static constexpr u8 deleted = 0b1111'1110;
+    static constexpr bool is_full(u8 control) { return !(control & 0b1000'0000); }
+
+    explicit SwissHashTableGroup(u8 const* controls)
+    {
+        __builtin_memcpy(&m_controls, controls, size);
+    }
+
+    // Bit i of these masks is set if control byte i matches.
+    u32 match(u8 control) const
+    {
+#ifndef KERNEL
+        return SIMD::maskbits(m_controls == static_cast<i8>(control));
+#else
+        u32 mask = 0;
+        for (size_t i = 0; i < size; ++i)
+            mask |= static_cast<u32>(m_controls[i] == control) << i;
+        return mask;
+#endif
+    }
+
+    u32 match_empty() const { return match(empty); }
+
+    u32 match_empty_or_deleted() const
+    {
+#ifndef KERNEL
+        return SIMD::maskbits(m_controls);
+#else
+        u32 mask = 0;
+        for (size_t i = 0; i < size; ++i)
+            mask |= static_cast<u32>(!is_full(m_controls[i])) << i;
+        return mask;
+#endif
+    }
+
+private:
+    // The kernel can't use vector registers, so it has to make do with looking at one byte after the other.
+#ifndef KERNEL
+    SIMD::i8x16 m_controls;
+#else
+    u8 m_controls[size];
+#endif
+};
+
+}
+
+template<typename SwissHashTableType, typename T>
+class SwissHashTableIterator {
+    friend SwissHashTableType;
+
+public:
+    bool operator==(SwissHashTableIterator const& other) const { return m_slot == other.m_slot; }
+    bool operator!=(SwissHashTableIterator const& other) const { return m_slot != other.m_slot; }
+    T& operator*() { return *m_slot; }
+    T* operator->() { return m_slot; }
+    void operator++() { skip_to_next(); }
+
+private:
+    void skip_to_next()
+    {
+        if (!m_slot)
+            return;
+        do {
+            ++m_slot;
+            ++m_control;
+            if (m_control == m_end_control) {
+                m_slot = nullptr;
+                return;
+            }
+        } while (!Detail::SwissHashTableGroup::is_full(*m_control));
+    }
+
+    SwissHashTableIterator(T* slot, u8 const* control, u8 const* end_control)
+        : m_slot(slot)
+        , m_control(control)
+        , m_end_control(end_control)
+    {
+    }
+
+    T* m_slot { nullptr };
+    u8 const* m_control { nullptr };
+    u8 const* m_end_control { nullptr };
+};
+
+// A set datastructure based on a hash table with open addressing, in the style of Abseil's "Swiss tables".
+// Values are stored separately from their control bytes, which are probed a group of 16 at a time with SIMD
+// compares. It has the same interface as an unordered HashTable, and can be used by HashMap (see SwissHashMap).
+//
+// Lookups, especially ones that don't find anything, are faster than with HashTable. On the other hand,
+// removing values leaves tombstones behind, so tables that see a lot of churn get rehashed more often.
+template<typename T, typename TraitsForT, bool IsOrdered>
+class SwissHashTable {
+    static_assert(!IsOrdered, "SwissHashTable does not support ordered iteration, use an OrderedHashTable instead");
+
+    using Group = Detail::SwissHashTableGroup;
+
+public:
+    SwissHashTable() = default;
+    explicit SwissHashTable(size_t capacity) { ensure_capacity(capacity); }
+
+    ~SwissHashTable()
+    {
+        if (!m_controls)
+            return;
+
+        if constexpr (!IsTriviallyDestructible<T>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (Group::is_full(m_controls[i]))
+                    m_slots[i].~T();
+            }
+        }
+
+        kfree_sized(m_controls, size_in_bytes(m_capacity));
+    }
+
+    SwissHashTable(SwissHashTable const& other)
+    {
+        ensure_capacity(other.size());
+        for (auto& it : other)
+            set(it);
+    }
+
+    SwissHashTable& operator=(SwissHashTable const& other)
+    {
+        SwissHashTable temporary(other);
+        swap(*this, temporary);
+        return *this;
+    }
+
+    SwissHashTable(SwissHashTable&& other) noexcept
+        : m_controls(exchange(other.m_controls, nullptr))
+        , m_slots(exchange(other.m_slots, nullptr))
+        , m_size(exchange(other.m_size, 0))
+        , m_capacity(exchange(other.m_capacity, 0))
+        , m_growth_left(exchange(other.m_growth_left, 0))
+    {
+    }
+
+    SwissHashTable& operator=(SwissHashTable&& other) noexcept
+    {
+        SwissHashTable temporary { move(other) };
+        swap(*this, temporary);
+        return *this;
+    }
+
+    friend void swap(SwissHashTable& a, SwissHashTable& b) noexcept
+    {
+        swap(a.m_controls, b.m_controls);
+        swap(a.m_slots, b.m_slots);
+        swap(a.m_size, b.m_size);
+        swap(a.m_capacity, b.m_capacity);
+        swap(a.m_growth_left, b.m_growth_left);
+    }
+
+    [[nodiscard]] bool is_empty() const { return m_size == 0; }
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+    template<typename U, size_t N>
+    ErrorOr<void> try_set_from(U (&from_array)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+            TRY(try_set(from_array[i]));
+        return {};
+    }
+    template<typename U, size_t N>
+    void set_from(U (&from_array)[N])
+    {
+        MUST(try_set_from(from_array));
+    }
+
+    ErrorOr<void> try_ensure_capacity(size_t capacity)
+    {
+        if (capacity <= m_size + m_growth_left)
+            return {};
+        return try_rehash(capacity);
+    }
+    void ensure_capacity(size_t capacity)
+    {
+        MUST(try_ensure_capacity(capacity));
+    }
+
+    [[nodiscard]] bool contains(T const& value) const
+    {
+        return find(value) != end();
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] bool contains(K const& value) const
+    {
+        return find(value) != end();
+    }
+
+    using Iterator = SwissHashTableIterator<SwissHashTable, T>;
+    using ConstIterator = SwissHashTableIterator<SwissHashTable const, T const>;
+
+    [[nodiscard]] Iterator begin()
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (Group::is_full(m_controls[i]))
+                return iterator_for(&m_slots[i]);
+        }
+        return end();
+    }
+
+    [[nodiscard]] Iterator end()
+    {
+        return Iterator(nullptr, nullptr, nullptr);
+    }
+
+    [[nodiscard]] ConstIterator begin() const
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (Group::is_full(m_controls[i]))
+                return iterator_for(&m_slots[i]);
+        }
+        return end();
+    }
+
+    [[nodiscard]] ConstIterator end() const
+    {
+        return ConstIterator(nullptr, nullptr, nullptr);
+    }
+
+    void clear()
+    {
+        *this = SwissHashTable();
+    }
+
+    void clear_with_capacity()
+    {
+        if (m_capacity == 0)
+            return;
+        if constexpr (!IsTriviallyDestructible<T>) {
+            for (auto& value : *this)
+                value.~T();
+        }
+        __builtin_memset(m_controls, Group::empty, m_capacity);
+        m_size = 0;
+        m_growth_left = max_size_for_capacity(m_capacity);
+    }
+
+    template<typename U = T>
+    ErrorOr<HashSetResult> try_set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
+    {
+        if (m_growth_left == 0)
+            TRY(grow());
+
+        return write_value(forward<U>(value), existing_entry_behavior);
+    }
+    template<typename U = T>
+    HashSetResult set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
+    {
+        return MUST(try_set(forward<U>(value), existing_entry_behavior));
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] Iterator find(unsigned hash, TUnaryPredicate predicate)
+    {
+        if (auto* slot = lookup_with_hash(hash, move(predicate)))
+            return iterator_for(slot);
+        return end();
+    }
+
+    [[nodiscard]] Iterator find(T const& value)
+    {
+        if (is_empty())
+            return end();
+        return find(TraitsForT::hash(value), [&](auto& entry) { return TraitsForT::equals(entry, value); });
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] ConstIterator find(unsigned hash, TUnaryPredicate predicate) const
+    {
+        if (auto* slot = lookup_with_hash(hash, move(predicate)))
+            return iterator_for(slot);
+        return end();
+    }
+
+    [[nodiscard]] ConstIterator find(T const& value) const
+    {
+        if (is_empty())
+            return end();
+        return find(TraitsForT::hash(value), [&](auto& entry) { return TraitsForT::equals(entry, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value)
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), [&](auto& entry) { return Traits<T>::equals(entry, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value, TUnaryPredicate predicate)
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value) const
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), [&](auto& entry) { return Traits<T>::equals(entry, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value, TUnaryPredicate predicate) const
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    bool remove(T const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) bool remove(K const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    // This invalidates the iterator
+    void remove(Iterator& iterator)
+    {
+        VERIFY(iterator.m_slot);
+        delete_slot(iterator.m_slot - m_slots);
+        iterator.m_slot = nullptr;
+    }
+
+    template<typename TUnaryPredicate>
+    bool remove_all_matching(TUnaryPredicate const& predicate)
+    {
+        // Removing values never moves any others around, so we can simply go through all slots once.
+        bool has_removed_anything = false;
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (!Group::is_full(m_controls[i]) || !predicate(m_slots[i]))
+                continue;
+            delete_slot(i);
+            has_removed_anything = true;
+        }
+        return has_removed_anything;
+    }
+
+    [[nodiscard]] Vector<T> values() const
+    {
+        Vector<T> list;
+        list.ensure_capacity(size());
+        for (auto& value : *this)
+            list.unchecked_append(value);
+        return list;
+    }
+
+private:
+    // Keep at least 1/8 of the slots empty, so lookups that don't find anything don't have to look for long.
+    static constexpr size_t max_size_for_capacity(size_t capacity) { return capacity - capacity / 8; }
+
+    // The control bytes come first, followed by the slots.
+    static constexpr size_t slots_offset(size_t capacity) { return round_up_to_power_of_two(capacity, alignof(T)); }
+    static constexpr size_t size_in_bytes(size_t capacity) { return slots_offset(capacity) + sizeof(T) * capacity; }
+
+    // The group is picked with the low bits of the hash, so take the bits for the control byte from a mix of all of them.
+    static u8 control_for_hash(unsigned hash) { return (hash * 0x9e3779b1u) >> 25; }
+
+    Iterator iterator_for(T* slot)
+    {
+        auto* control = m_controls + (slot - m_slots);
+        return Iterator(slot, control, m_controls + m_capacity);
+    }
+    ConstIterator iterator_for(T const* slot) const
+    {
+        auto* control = m_controls + (slot - m_slots);
+        return ConstIterator(slot, control, m_controls + m_capacity);
+    }
+
+    // Calls the callback for each group along the probe sequence of the hash until it returns IterationDecision::Break.
+    // There's always at least one empty slot, and since the number of groups is a power of two, stepping ahead by
+    // triangular numbers of groups visits every single one of them eventually.
+    template<typename Callback>
+    ALWAYS_INLINE void for_each_group_in_probe_sequence(unsigned hash, Callback callback) const
+    {
+        size_t group_mask = m_capacity / Group::size - 1;
+        size_t group_index = hash & group_mask;
+        for (size_t stride = 1;; ++stride) {
+            size_t first_slot = group_index * Group::size;
+            if (callback(Group { m_controls + first_slot }, first_slot) == IterationDecision::Break)
+                return;
+            group_index = (group_index + stride) & group_mask;
+        }
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] T* lookup_with_hash(unsigned hash, TUnaryPredicate predicate) const
+    {
+        if (is_empty())
+            return nullptr;
+
+        T* result = nullptr;
+        auto control = control_for_hash(hash);
+        for_each_group_in_probe_sequence(hash, [&](Group const& group, size_t first_slot) {
+            for (u32 matches = group.match(control); matches; matches &= matches - 1) {
+                auto* slot = &m_slots[first_slot + count_trailing_zeroes(matches)];
+                if (predicate(*slot)) {
+                    result = slot;
+                    return IterationDecision::Break;
+                }
+            }
+            // Had the value been in the table, it would have been put into that empty slot.
+            if (group.match_empty())
+                return IterationDecision::Break;
+            return IterationDecision::Continue;
+        });
+        return result;
+    }
+
+    size_t find_slot_for_insertion(unsigned hash) const
+    {
+        size_t index = 0;
+        for_each_group_in_probe_sequence(hash, [&](Group const& group, size_t first_slot) {
+            auto free_slots = group.match_empty_or_deleted();
+            if (!free_slots)
+                return IterationDecision::Continue;
+            index = first_slot + count_trailing_zeroes(free_slots);
+            return IterationDecision::Break;
+        });
+        return index;
+    }
+
+    ErrorOr<void> grow()
+    {
+        // If much of the table is taken up by tombstones, getting rid of them makes enough room.
+        if (m_capacity != 0 && m_size <= max_size_for_capacity(m_capacity) / 2)
+            return try_rehash(max_size_for_capacity(m_capacity));
+        return try_rehash(max_size_for_capacity(m_capacity * 2));
+    }
+
+    ErrorOr<void> try_rehash(size_t required_size)
+    {
+        VERIFY(required_size >= m_size);
+        size_t new_capacity = Group::size;
+        while (max_size_for_capacity(new_capacity) < required_size)
+            new_capacity *= 2;
+
+        auto* new_storage = kmalloc(size_in_bytes(new_capacity));
+        if (!new_storage)
+            return Error::from_errno(ENOMEM);
+
+        auto* old_controls = m_controls;
+        auto* old_slots = m_slots;
+        auto old_capacity = m_capacity;
+
+        m_controls = static_cast<u8*>(new_storage);
+        m_slots = reinterpret_cast<T*>(m_controls + slots_offset(new_capacity));
+        m_capacity = new_capacity;
+        m_growth_left = max_size_for_capacity(new_capacity) - m_size;
+        __builtin_memset(m_controls, Group::empty, new_capacity);
+
+        if (!old_controls)
+            return {};
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (!Group::is_full(old_controls[i]))
+                continue;
+            auto hash = TraitsForT::hash(old_slots[i]);
+            auto index = find_slot_for_insertion(hash);
+            new (&m_slots[index]) T(move(old_slots[i]));
+            old_slots[i].~T();
+            m_controls[index] = control_for_hash(hash);
+        }
+
+        kfree_sized(old_controls, size_in_bytes(old_capacity));
+        return {};
+    }
+
+    template<typename U = T>
+    HashSetResult write_value(U&& value, HashSetExistingEntryBehavior existing_entry_behavior)
+    {
+        auto hash = TraitsForT::hash(value);
+        auto* existing_slot = lookup_with_hash(hash, [&](auto& entry) { return TraitsForT::equals(entry, static_cast<T const&>(value)); });
+        if (existing_slot) {
+            if (existing_entry_behavior == HashSetExistingEntryBehavior::Replace) {
+                *existing_slot = forward<U>(value);
+                return HashSetResult::ReplacedExistingEntry;
+            }
+            return HashSetResult::KeptExistingEntry;
+        }
+
+        auto index = find_slot_for_insertion(hash);
+        // Reusing a tombstone doesn't take away from the empty slots that keep probe sequences short.
+        if (m_controls[index] == Group::empty)
+            --m_growth_left;
+        new (&m_slots[index]) T(forward<U>(value));
+        m_controls[index] = control_for_hash(hash);
+        ++m_size;
+        return HashSetResult::InsertedNewEntry;
+    }
+
+    void delete_slot(size_t index)
+    {
+        VERIFY(index < m_capacity);
+        VERIFY(Group::is_full(m_controls[index]));
+
+        m_slots[index].~T();
+        --m_size;
+
+        // A group that still has an empty slot has never been full, so no probe sequence has gone past it,
+        // and this slot can become empty again. Otherwise, it has to leave a tombstone for probing to go past.
+        Group group { m_controls + index / Group::size * Group::size };
+        if (group.match_empty()) {
+            m_controls[index] = Group::empty;
+            ++m_growth_left;
+        } else {
+            m_controls[index] = Group::deleted;
+        }
+    }
+
+    u8* m_controls { nullptr };
+    T* m_slots { nullptr };
+    size_t m_size { 0 };
+    size_t m_capacity { 0 };
+    // The number of values we can add before running out of empty slots, not counting tombstones.
+    size_t m_growth_left { 0 };
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::SwissHashTable;
+#endif
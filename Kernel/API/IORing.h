@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// Shared memory layout of an I/O ring, see io_ring_setup(2).
+//
+// The mapping starts with an IORingControl, followed by the submission queue entries at
+// IORingParameters::submission_queue_offset and the completion queue entries at
+// IORingParameters::completion_queue_offset. Both queues are single-producer, single-consumer
+// rings indexed by free-running 32-bit counters; an index is turned into a slot with `& (entries - 1)`.
+// Userspace produces submissions and consumes completions, the kernel does the opposite.
+
+enum class IORingOperation : u8 {
+    Nop = 0,
+    Read,
+    Write,
+    Accept,
+    Recv,
+    Send,
+    Fsync,
+    Open,
+};
+
+// Use the file's current offset instead of IORingSubmission::offset.
+constexpr u64 IORING_CURRENT_OFFSET = ~0ull;
+
+struct IORingSubmission {
+    IORingOperation operation;
+    u8 reserved0 { 0 };
+    u16 reserved1 { 0 };
+    // The file descriptor to operate on. For Open, the directory fd that relative paths resolve against.
+    i32 fd { -1 };
+    // File offset for Read and Write, or IORING_CURRENT_OFFSET.
+    u64 offset { IORING_CURRENT_OFFSET };
+    // The data buffer for Read, Write, Recv and Send, the path for Open.
+    u64 address { 0 };
+    u32 length { 0 };
+    // MSG_* flags for Recv and Send, SOCK_* flags for Accept, O_* flags for Open.
+    u32 operation_flags { 0 };
+    // Mode for Open.
+    u32 mode { 0 };
+    u32 reserved2 { 0 };
+    // Handed back in the completion as-is.
+    u64 user_data { 0 };
+};
+static_assert(sizeof(IORingSubmission) == 48);
+
+struct IORingCompletion {
+    u64 user_data;
+    // The return value of the operation as the equivalent syscall would give it, or a negated errno.
+    i32 result;
+    u32 flags;
+};
+static_assert(sizeof(IORingCompletion) == 16);
+
+struct IORingControl {
+    // Written by the kernel.
+    u32 submission_head;
+    // Written by userspace.
+    u32 submission_tail;
+    // Written by userspace.
+    u32 completion_head;
+    // Written by the kernel.
+    u32 completion_tail;
+    u32 submission_entries;
+    u32 completion_entries;
+    u32 reserved[2];
+};
+
+struct IORingParameters {
+    u32 submission_entries;
+    u32 completion_entries;
+    u32 submission_queue_offset;
+    u32 completion_queue_offset;
+    // How much to mmap() from the ring file descriptor.
+    u32 mapping_size;
+    u32 reserved;
+};
+
+// io_ring_enter() flags.
+// Wait until at least min_complete completions are available, instead of just submitting.
+constexpr u32 IORING_ENTER_GETEVENTS = 1 << 0;
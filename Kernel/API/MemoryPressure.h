@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/EnumBits.h>
+#include <AK/Types.h>
+
+// How hard the kernel is struggling to keep memory available, see watch_memory_pressure(2).
+enum class MemoryPressureLevel : u32 {
+    // Plenty of memory is available.
+    Normal = 0,
+    // Free memory has dropped below the low watermark, and the kernel is reclaiming what it can.
+    // Caches that are cheap to rebuild should be dropped.
+    Low,
+    // The kernel is close to failing allocations. Everything that can be given back should be.
+    Critical,
+};
+
+// What is read from a memory pressure listener, once per change of the pressure level.
+struct MemoryPressureEvent {
+    MemoryPressureLevel level;
+    u32 reserved;
+    // How much physical memory is available for new allocations, in bytes.
+    u64 available_bytes;
+};
+
+enum class MemoryPressureListenerFlags : u32 {
+    None = 0,
+    Nonblock = 1 << 0,
+    CloseOnExec = 1 << 1,
+};
+
+AK_ENUM_BITWISE_OPERATORS(MemoryPressureListenerFlags);
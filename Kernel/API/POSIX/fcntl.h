@@ -42,6 +42,10 @@ extern "C" {
 #define O_DIRECT (1 << 12)
 #define O_SYNC (1 << 13)
 
+#define SPLICE_F_MOVE (1 << 0)
+#define SPLICE_F_NONBLOCK (1 << 1)
+#define SPLICE_F_MORE (1 << 2)
+
 #define F_RDLCK ((short)0)
 #define F_WRLCK ((short)1)
 #define F_UNLCK ((short)2)
@@ -23,6 +23,7 @@ struct pollfd;
 struct timeval;
 struct timespec;
 struct sockaddr;
+struct mmsghdr;
 struct siginfo;
 struct stat;
 struct statvfs;
@@ -72,6 +73,9 @@ enum class NeedsBigProcessLock {
     S(dump_backtrace, NeedsBigProcessLock::No)             \
     S(dup2, NeedsBigProcessLock::No)                       \
     S(emuctl, NeedsBigProcessLock::No)                     \
+    S(epoll_create1, NeedsBigProcessLock::No)              \
+    S(epoll_ctl, NeedsBigProcessLock::No)                  \
+    S(epoll_pwait, NeedsBigProcessLock::No)                \
     S(execve, NeedsBigProcessLock::Yes)                    \
     S(exit, NeedsBigProcessLock::Yes)                      \
     S(exit_thread, NeedsBigProcessLock::Yes)               \
@@ -115,6 +119,8 @@ enum class NeedsBigProcessLock {
     S(getuid, NeedsBigProcessLock::No)                     \
     S(inode_watcher_add_watch, NeedsBigProcessLock::No)    \
     S(inode_watcher_remove_watch, NeedsBigProcessLock::No) \
+    S(io_ring_enter, NeedsBigProcessLock::Yes)             \
+    S(io_ring_setup, NeedsBigProcessLock::No)              \
     S(ioctl, NeedsBigProcessLock::No)                      \
     S(join_thread, NeedsBigProcessLock::No)                \
     S(kill, NeedsBigProcessLock::No)                       \
@@ -149,16 +155,20 @@ enum class NeedsBigProcessLock {
     S(pread, NeedsBigProcessLock::Yes)                     \
     S(readlink, NeedsBigProcessLock::No)                   \
     S(readv, NeedsBigProcessLock::Yes)                     \
+    S(preadv, NeedsBigProcessLock::Yes)                    \
     S(realpath, NeedsBigProcessLock::No)                   \
     S(recvfd, NeedsBigProcessLock::No)                     \
     S(recvmsg, NeedsBigProcessLock::Yes)                   \
+    S(recvmmsg, NeedsBigProcessLock::Yes)                  \
     S(rename, NeedsBigProcessLock::No)                     \
     S(remount, NeedsBigProcessLock::No)                    \
     S(rmdir, NeedsBigProcessLock::No)                      \
     S(scheduler_get_parameters, NeedsBigProcessLock::No)   \
     S(scheduler_set_parameters, NeedsBigProcessLock::No)   \
     S(sendfd, NeedsBigProcessLock::No)                     \
+    S(sendfile, NeedsBigProcessLock::Yes)                  \
     S(sendmsg, NeedsBigProcessLock::Yes)                   \
+    S(sendmmsg, NeedsBigProcessLock::Yes)                  \
     S(set_mmap_name, NeedsBigProcessLock::No)              \
     S(setegid, NeedsBigProcessLock::No)                    \
     S(seteuid, NeedsBigProcessLock::No)                    \
@@ -184,6 +194,7 @@ enum class NeedsBigProcessLock {
     S(sigtimedwait, NeedsBigProcessLock::No)               \
     S(socket, NeedsBigProcessLock::No)                     \
     S(socketpair, NeedsBigProcessLock::No)                 \
+    S(splice, NeedsBigProcessLock::Yes)                    \
     S(stat, NeedsBigProcessLock::No)                       \
     S(statvfs, NeedsBigProcessLock::No)                    \
     S(symlink, NeedsBigProcessLock::No)                    \
@@ -200,6 +211,7 @@ enum class NeedsBigProcessLock {
     S(utime, NeedsBigProcessLock::No)                      \
     S(utimensat, NeedsBigProcessLock::No)                  \
     S(waitid, NeedsBigProcessLock::Yes)                    \
+    S(watch_memory_pressure, NeedsBigProcessLock::No)      \
     S(write, NeedsBigProcessLock::Yes)                     \
     S(pwritev, NeedsBigProcessLock::Yes)                   \
     S(yield, NeedsBigProcessLock::No)
@@ -267,6 +279,14 @@ struct SC_poll_params {
     u32 const* sigmask;
 };
 
+struct SC_epoll_pwait_params {
+    int epfd;
+    struct epoll_event* events;
+    int maxevents;
+    const struct timespec* timeout;
+    u32 const* sigmask;
+};
+
 struct SC_clock_nanosleep_params {
     int clock_id;
     int flags;
@@ -286,6 +306,14 @@ struct SC_accept4_params {
     int flags;
 };
 
+struct SC_recvmmsg_params {
+    int sockfd;
+    struct mmsghdr* msgvec;
+    unsigned vlen;
+    int flags;
+    const struct timespec* timeout;
+};
+
 struct SC_getsockopt_params {
     int sockfd;
     int level;
@@ -321,6 +349,15 @@ struct SC_socketpair_params {
     int* sv;
 };
 
+struct SC_splice_params {
+    int fd_in;
+    int64_t* offset_in;
+    int fd_out;
+    int64_t* offset_out;
+    size_t length;
+    unsigned flags;
+};
+
 struct SC_futex_params {
     u32* userspace_address;
     int futex_op;
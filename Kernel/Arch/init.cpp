@@ -60,6 +60,7 @@
 #include <Kernel/Tasks/FinalizerTask.h>
 #include <Kernel/Tasks/HostnameContext.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/ReclaimTask.h>
 #include <Kernel/Tasks/Scheduler.h>
 #include <Kernel/Tasks/SyncTask.h>
 #include <Kernel/Tasks/WorkQueue.h>
@@ -391,6 +392,7 @@ void init_stage2(void*)
 
     SyncTask::spawn();
     FinalizerTask::spawn();
+    ReclaimTask::spawn();
 
     auto boot_profiling = kernel_command_line().is_boot_profiling_enabled();
 
@@ -69,11 +69,25 @@ ErrorOr<NonnullRefPtr<OpenFileDescription>> Device::open(int options)
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const& completed_request)
 {
     SpinlockLocker lock(m_requests_lock);
-    VERIFY(!m_requests.is_empty());
-    VERIFY(m_requests.first().ptr() == &completed_request);
-    m_requests.remove(m_requests.begin());
-    if (!m_requests.is_empty()) {
-        auto* next_request = m_requests.first().ptr();
+    auto it = m_requests.begin();
+    while (it != m_requests.end() && it->ptr() != &completed_request)
+        ++it;
+    VERIFY(it != m_requests.end());
+    m_requests.remove(it);
+    VERIFY(m_requests_in_flight > 0);
+    --m_requests_in_flight;
+
+    // Requests may finish out of order if several of them are in flight, but they are always started in order.
+    AsyncDeviceRequest* next_request = nullptr;
+    size_t index = 0;
+    for (auto& request : m_requests) {
+        if (index++ == m_requests_in_flight) {
+            next_request = request.ptr();
+            break;
+        }
+    }
+    if (next_request) {
+        ++m_requests_in_flight;
         next_request->do_start(move(lock));
     }
 
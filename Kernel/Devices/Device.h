@@ -56,16 +56,20 @@ public:
     {
         auto request = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) AsyncRequestType(*this, forward<Args>(args)...)));
         SpinlockLocker lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
         TRY(m_requests.try_append(request));
-        if (was_empty)
+        if (m_requests_in_flight < max_requests_in_flight()) {
+            ++m_requests_in_flight;
             request->do_start(move(lock));
+        }
         return request;
     }
 
 protected:
     Device(MajorNumber major, MinorNumber minor);
 
+    // How many requests may be started before the earlier ones have finished.
+    virtual size_t max_requests_in_flight() const { return 1; }
+
     void after_inserting_add_to_device_management();
     void before_will_be_destroyed_remove_from_device_management();
 
@@ -84,7 +88,9 @@ private:
     State m_state { State::Normal };
 
     Spinlock<LockRank::None> m_requests_lock {};
+    // Requests are started in order, so the first m_requests_in_flight of them are the ones that were started.
     DoublyLinkedList<LockRefPtr<AsyncDeviceRequest>> m_requests;
+    size_t m_requests_in_flight { 0 };
 
 protected:
     // FIXME: This pointer will be eventually removed after all nodes in /sys/dev/block/ and
@@ -39,6 +39,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::initialize(bool is_queue_polled)
     // Nr of queues = one queue per core
     auto nr_of_queues = Processor::count();
     auto queue_type = is_queue_polled ? QueueType::Polled : QueueType::IRQ;
+    m_queue_type = queue_type;
 
     PCI::enable_memory_space(device_identifier());
     PCI::enable_bus_mastering(device_identifier());
@@ -181,6 +182,15 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
             return EFAULT;
         }
     }
+
+    // Every namespace submits to the same per-CPU IO queues, so they have to share the queue entries.
+    size_t namespace_count = 0;
+    while (namespace_count < array_size(active_namespace_list) && active_namespace_list[namespace_count] != 0)
+        ++namespace_count;
+    auto max_requests_in_flight = clamp<size_t>((IO_QUEUE_SIZE - 1) / max<size_t>(namespace_count, 1), 1, IO_MAX_REQUESTS_IN_FLIGHT);
+    if (m_queue_type == QueueType::IRQ)
+        enable_interrupt_coalescing(max_requests_in_flight);
+
     // Get the NAMESPACE attributes
     {
         NVMeSubmission sub {};
@@ -209,7 +219,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
 
             dbgln_if(NVME_DEBUG, "NVMe: Block count is {} and Block size is {}", block_counts, block_size);
 
-            m_namespaces.append(TRY(NVMeNameSpace::try_create(*this, m_queues, nsid, block_counts, block_size)));
+            m_namespaces.append(TRY(NVMeNameSpace::try_create(*this, m_queues, nsid, block_counts, block_size, m_max_pages_per_request, max_requests_in_flight)));
             m_device_count++;
             dbgln_if(NVME_DEBUG, "NVMe: Initialized namespace with NSID: {}", nsid);
         }
@@ -245,6 +255,12 @@ ErrorOr<void> NVMeController::identify_and_init_controller()
         }
     }
 
+    // MDTS is a power of two in units of the minimum memory page size, with 0 meaning that there is no limit.
+    if (ctrl.mdts != 0) {
+        auto max_transfer_size = (static_cast<u64>(1) << ctrl.mdts) * (4096 << CAP_MPSMIN(m_controller_regs->cap));
+        m_max_pages_per_request = clamp<size_t>(max_transfer_size / PAGE_SIZE, 1, IO_MAX_PAGES_PER_REQUEST);
+    }
+
     if (ctrl.oacs & ID_CTRL_SHADOW_DBBUF_MASK) {
         OwnPtr<Memory::Region> dbbuf_dma_region;
         OwnPtr<Memory::Region> eventidx_dma_region;
@@ -276,6 +292,24 @@ ErrorOr<void> NVMeController::identify_and_init_controller()
     return {};
 }
 
+UNMAP_AFTER_INIT void NVMeController::enable_interrupt_coalescing(size_t max_requests_in_flight)
+{
+    // With several requests in flight, let the controller gather their completions into one interrupt.
+    // It waits for at most INTERRUPT_COALESCING_TIME, so a lone request is only delayed by that much.
+    if (max_requests_in_flight <= 1)
+        return;
+
+    NVMeSubmission sub {};
+    sub.op = OP_ADMIN_SET_FEATURES;
+    sub.generic.cdw10 = AK::convert_between_host_and_little_endian(static_cast<u32>(FEATURE_INTERRUPT_COALESCING));
+    // The aggregation threshold is 0 based
+    u32 threshold = max_requests_in_flight - 1;
+    sub.generic.cdw11 = AK::convert_between_host_and_little_endian((INTERRUPT_COALESCING_TIME << 8) | (threshold & 0xff));
+    // Interrupt coalescing is optional, so carry on without it if the controller doesn't support it.
+    if (auto status = submit_admin_command(sub, true); status != 0)
+        dbgln_if(NVME_DEBUG, "NVMe: Failed to enable interrupt coalescing, status {:x}", status);
+}
+
 UNMAP_AFTER_INIT NVMeController::NSFeatures NVMeController::get_ns_features(IdentifyNamespace& identify_data_struct)
 {
     auto flbas = identify_data_struct.flbas & FLBA_SIZE_MASK;
@@ -38,9 +38,11 @@ struct IdentifyNamespace {
 // more values from id_ctrl command, use separate member variables
 // instead of using rsd array.
 struct IdentifyController {
-    u8 rsdv1[256];
+    u8 rsdv1[77];
+    u8 mdts;
+    u8 rsdv2[178];
     u16 oacs;
-    u8 rsdv2[3838];
+    u8 rsdv3[3838];
 };
 
 // DOORBELL
@@ -64,6 +66,13 @@ static constexpr u32 CAP_TO(u64 cap)
     return (cap & CAP_TO_MASK) >> CAP_TO_SHIFT;
 }
 
+static constexpr u8 CAP_MPSMIN_SHIFT = 48;
+static constexpr u64 CAP_MPSMIN_MASK = 0xfull << CAP_MPSMIN_SHIFT;
+static constexpr u32 CAP_MPSMIN(u64 cap)
+{
+    return (cap & CAP_MPSMIN_MASK) >> CAP_MPSMIN_SHIFT;
+}
+
 // CC – Controller Configuration
 static constexpr u8 CC_EN_BIT = 0x0;
 static constexpr u8 CSTS_RDY_BIT = 0x0;
@@ -100,6 +109,14 @@ static constexpr u16 CQ_STATUS_FIELD(u16 x)
 
 static constexpr u16 ADMIN_QUEUE_SIZE = 2;
 static constexpr u16 IO_QUEUE_SIZE = 64; // TODO:Need to be configurable
+// Requests larger than a page are transferred with a single command, using a PRP list.
+static constexpr u16 IO_MAX_PAGES_PER_REQUEST = 16;
+// Every request in flight needs its own DMA buffer, so this limits how many requests a namespace starts at once.
+static constexpr u16 IO_MAX_REQUESTS_IN_FLIGHT = 8;
+static_assert(IO_MAX_REQUESTS_IN_FLIGHT < IO_QUEUE_SIZE);
+
+// Interrupt coalescing, the aggregation time is in 100 microsecond units
+static constexpr u8 INTERRUPT_COALESCING_TIME = 1;
 
 // IDENTIFY
 static constexpr u16 NVMe_IDENTIFY_SIZE = 4096;
@@ -117,9 +134,15 @@ enum AdminCommandOpCode {
     OP_ADMIN_CREATE_COMPLETION_QUEUE = 0x5,
     OP_ADMIN_CREATE_SUBMISSION_QUEUE = 0x1,
     OP_ADMIN_IDENTIFY = 0x6,
+    OP_ADMIN_SET_FEATURES = 0x9,
     OP_ADMIN_DBBUF_CONFIG = 0x7C,
 };
 
+// FEATURES
+enum FeatureIdentifier {
+    FEATURE_INTERRUPT_COALESCING = 0x8,
+};
+
 // IO opcodes
 enum IOCommandOpcode {
     OP_NVME_WRITE = 0x1,
@@ -11,15 +11,15 @@
 
 namespace Kernel {
 
-ErrorOr<NonnullLockRefPtr<NVMeInterruptQueue>> NVMeInterruptQueue::try_create(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalRAMPage> rw_dma_page, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+ErrorOr<NonnullLockRefPtr<NVMeInterruptQueue>> NVMeInterruptQueue::try_create(PCI::Device& device, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
 {
-    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(device, move(rw_dma_region), rw_dma_page, qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))));
+    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(device, qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))));
     queue->initialize_interrupt_queue();
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeInterruptQueue::NVMeInterruptQueue(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalRAMPage> rw_dma_page, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
-    : NVMeQueue(move(rw_dma_region), rw_dma_page, qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))
+UNMAP_AFTER_INIT NVMeInterruptQueue::NVMeInterruptQueue(PCI::Device& device, u16 qid, u8 irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+    : NVMeQueue(qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))
     , PCI::IRQHandler(device, irq)
 {
 }
@@ -41,20 +41,39 @@ void NVMeInterruptQueue::submit_sqe(NVMeSubmission& sub)
 
 void NVMeInterruptQueue::complete_current_request(u16 cmdid, u16 status)
 {
-    auto work_item_creation_result = g_io_work->try_queue([this, cmdid, status]() {
-        NVMeQueue::complete_current_request(cmdid, status);
+    auto append_result = m_pending_completions.with([&](auto& pending_completions) -> ErrorOr<bool> {
+        TRY(pending_completions.try_append({ cmdid, status }));
+        return pending_completions.size() == 1;
     });
 
+    ErrorOr<void> work_item_creation_result {};
+    if (append_result.is_error())
+        work_item_creation_result = append_result.release_error();
+    else if (append_result.value())
+        work_item_creation_result = g_io_work->try_queue([this]() { complete_pending_requests(); });
+
     if (work_item_creation_result.is_error()) {
-        m_requests.with([cmdid, status](auto& requests) {
-            auto& request_pdu = requests.get(cmdid).release_value();
-            auto current_request = request_pdu.request;
-
-            current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            if (request_pdu.end_io_handler)
-                request_pdu.end_io_handler(status);
-            request_pdu.clear();
+        // We have to finish the command right here. We can't copy into the request buffer from interrupt
+        // context though, so read/write commands are reported as failed.
+        static constexpr u16 internal_error_status = 0x6;
+        auto has_request = m_requests.with([cmdid](auto& requests) {
+            return !requests.get(cmdid).release_value().request.is_null();
+        });
+        NVMeQueue::complete_current_request(cmdid, has_request ? internal_error_status : status);
+    }
+}
+
+void NVMeInterruptQueue::complete_pending_requests()
+{
+    for (;;) {
+        Vector<PendingCompletion> completions;
+        m_pending_completions.with([&](auto& pending_completions) {
+            swap(completions, pending_completions);
         });
+        if (completions.is_empty())
+            return;
+        for (auto& completion : completions)
+            NVMeQueue::complete_current_request(completion.cmdid, completion.status);
     }
 }
 }
@@ -23,16 +23,24 @@ class NVMeNameSpace : public StorageDevice {
     friend class DeviceManagement;
 
 public:
-    static ErrorOr<NonnullLockRefPtr<NVMeNameSpace>> try_create(NVMeController const&, Vector<NonnullLockRefPtr<NVMeQueue>> queues, u16 nsid, size_t storage_size, size_t lba_size);
+    static ErrorOr<NonnullLockRefPtr<NVMeNameSpace>> try_create(NVMeController const&, Vector<NonnullLockRefPtr<NVMeQueue>> queues, u16 nsid, size_t storage_size, size_t lba_size, size_t max_pages_per_request, size_t max_requests_in_flight);
 
     CommandSet command_set() const override { return CommandSet::NVMe; }
     void start_request(AsyncBlockDeviceRequest& request) override;
 
 private:
-    NVMeNameSpace(LUNAddress, u32 hardware_relative_controller_id, Vector<NonnullLockRefPtr<NVMeQueue>> queues, size_t storage_size, size_t lba_size, u16 nsid);
+    // ^Device
+    virtual size_t max_requests_in_flight() const override { return m_dma_buffers->size(); }
+
+    // ^StorageDevice
+    virtual size_t max_blocks_per_request() const override { return m_max_pages_per_request * PAGE_SIZE / block_size(); }
+
+    NVMeNameSpace(LUNAddress, u32 hardware_relative_controller_id, Vector<NonnullLockRefPtr<NVMeQueue>> queues, size_t storage_size, size_t lba_size, u16 nsid, size_t max_pages_per_request, NonnullOwnPtr<NVMeDMABufferPool>);
 
     u16 m_nsid;
+    size_t m_max_pages_per_request;
     Vector<NonnullLockRefPtr<NVMeQueue>> m_queues;
+    NonnullOwnPtr<NVMeDMABufferPool> m_dma_buffers;
 };
 
 }
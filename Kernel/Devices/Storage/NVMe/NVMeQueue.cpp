@@ -12,34 +12,93 @@
 #include <Kernel/Library/StdLib.h>
 
 namespace Kernel {
-ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(NVMeController& device, u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type)
+UNMAP_AFTER_INIT ErrorOr<NonnullOwnPtr<NVMeDMABuffer>> NVMeDMABuffer::try_create(NVMeDMABufferPool& pool)
 {
-    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalRAMPage> rw_dma_page;
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page));
+    // Note: Requests don't exceed IO_MAX_PAGES_PER_REQUEST pages (Storage device takes care of it), and one more page holds the PRP list.
+    Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> pages;
+    auto region = TRY(MM.allocate_dma_buffer_pages((IO_MAX_PAGES_PER_REQUEST + 1) * PAGE_SIZE, "NVMe Read/Write DMA"sv, Memory::Region::Access::ReadWrite, pages));
 
-    if (rw_dma_page.is_null())
+    if (pages.size() != IO_MAX_PAGES_PER_REQUEST + 1)
         return ENOMEM;
 
+    // PRP1 always points to the first page, so the list starts with the second one.
+    auto* prp_list = reinterpret_cast<u64*>(region->vaddr().offset(IO_MAX_PAGES_PER_REQUEST * PAGE_SIZE).as_ptr());
+    for (size_t i = 1; i < IO_MAX_PAGES_PER_REQUEST; ++i)
+        prp_list[i - 1] = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(pages[i]->paddr().as_ptr()));
+
+    return adopt_nonnull_own_or_enomem(new (nothrow) NVMeDMABuffer(pool, move(region), move(pages)));
+}
+
+UNMAP_AFTER_INIT NVMeDMABuffer::NVMeDMABuffer(NVMeDMABufferPool& pool, NonnullOwnPtr<Memory::Region> region, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> pages)
+    : m_pool(pool)
+    , m_region(move(region))
+    , m_pages(move(pages))
+{
+}
+
+DataPtr NVMeDMABuffer::data_ptr(size_t page_count) const
+{
+    VERIFY(page_count > 0 && page_count <= IO_MAX_PAGES_PER_REQUEST);
+    DataPtr data_ptr {};
+    data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_pages[0]->paddr().as_ptr()));
+    // A transfer of two pages points to the second page directly, only longer ones need the PRP list.
+    if (page_count == 2)
+        data_ptr.prp2 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_pages[1]->paddr().as_ptr()));
+    else if (page_count > 2)
+        data_ptr.prp2 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_pages.last()->paddr().as_ptr()));
+    return data_ptr;
+}
+
+void NVMeDMABuffer::release()
+{
+    m_pool.release(*this);
+}
+
+UNMAP_AFTER_INIT ErrorOr<NonnullOwnPtr<NVMeDMABufferPool>> NVMeDMABufferPool::try_create(size_t buffer_count)
+{
+    auto pool = TRY(adopt_nonnull_own_or_enomem(new (nothrow) NVMeDMABufferPool));
+    TRY(pool->m_buffers.try_ensure_capacity(buffer_count));
+    for (size_t i = 0; i < buffer_count; ++i) {
+        auto buffer = TRY(NVMeDMABuffer::try_create(*pool));
+        pool->m_free_buffers.with([&](auto& free_buffers) { free_buffers.append(*buffer); });
+        pool->m_buffers.unchecked_append(move(buffer));
+    }
+    return pool;
+}
+
+NVMeDMABuffer& NVMeDMABufferPool::take()
+{
+    return m_free_buffers.with([](auto& free_buffers) -> NVMeDMABuffer& {
+        // The device doesn't start more requests than there are buffers.
+        auto* buffer = free_buffers.take_first();
+        VERIFY(buffer);
+        return *buffer;
+    });
+}
+
+void NVMeDMABufferPool::release(NVMeDMABuffer& buffer)
+{
+    m_free_buffers.with([&](auto& free_buffers) { free_buffers.append(buffer); });
+}
+
+ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(NVMeController& device, u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type)
+{
     if (queue_type == QueueType::Polled) {
-        auto queue = NVMePollQueue::try_create(move(rw_dma_region), rw_dma_page.release_nonnull(), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+        auto queue = NVMePollQueue::try_create(qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
         return queue;
     }
 
-    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), rw_dma_page.release_nonnull(), qid, irq.release_value(), q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+    auto queue = NVMeInterruptQueue::try_create(device, qid, irq.release_value(), q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalRAMPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
-    : m_rw_dma_region(move(rw_dma_region))
-    , m_qid(qid)
+UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+    : m_qid(qid)
     , m_admin_queue(qid == 0)
     , m_qdepth(q_depth)
     , m_cq_dma_region(move(cq_dma_region))
     , m_sq_dma_region(move(sq_dma_region))
     , m_db_regs(move(db_regs))
-    , m_rw_dma_page(rw_dma_page)
-
 {
     m_requests.with([q_depth](auto& requests) {
         requests.try_ensure_capacity(q_depth).release_value_but_fixme_should_propagate_errors();
@@ -110,17 +169,22 @@ void NVMeQueue::submit_sqe(NVMeSubmission& sub)
 
 void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
 {
-    m_requests.with([this, cmdid, status](auto& requests) {
+    m_requests.with([cmdid, status](auto& requests) {
         auto& request_pdu = requests.get(cmdid).release_value();
         auto current_request = request_pdu.request;
+        auto* dma_buffer = request_pdu.dma_buffer;
         AsyncDeviceRequest::RequestResult req_result = AsyncDeviceRequest::Success;
 
-        ScopeGuard guard = [&req_result, status, &request_pdu] {
-            if (request_pdu.request)
-                request_pdu.request->complete(req_result);
-            if (request_pdu.end_io_handler)
-                request_pdu.end_io_handler(status);
+        ScopeGuard guard = [&req_result, status, &request_pdu, &current_request, dma_buffer] {
+            // The buffer has to be back in the pool before the request completes, as that may start the next one.
+            if (dma_buffer)
+                dma_buffer->release();
+            auto end_io_handler = move(request_pdu.end_io_handler);
             request_pdu.clear();
+            if (current_request)
+                current_request->complete(req_result);
+            if (end_io_handler)
+                end_io_handler(status);
         };
 
         // There can be submission without any request associated with it such as with
@@ -134,7 +198,7 @@ void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
         }
 
         if (current_request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
-            if (auto result = current_request->write_to_buffer(current_request->buffer(), m_rw_dma_region->vaddr().as_ptr(), current_request->buffer_size()); result.is_error()) {
+            if (auto result = current_request->write_to_buffer(current_request->buffer(), dma_buffer->data(), current_request->buffer_size()); result.is_error()) {
                 req_result = AsyncBlockDeviceRequest::MemoryFault;
                 return;
             }
@@ -150,7 +214,7 @@ u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
     sub.cmdid = cid;
 
     m_requests.with([this, &sub, &cmd_status](auto& requests) {
-        requests.set(sub.cmdid, { nullptr, [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } });
+        requests.set(sub.cmdid, { .request = nullptr, .dma_buffer = nullptr, .end_io_handler = [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } });
     });
     submit_sqe(sub);
 
@@ -160,46 +224,43 @@ u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
     return cmd_status;
 }
 
-void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+void NVMeQueue::read(AsyncBlockDeviceRequest& request, NVMeDMABuffer& dma_buffer, u16 nsid, u64 index, u32 count)
 {
-    NVMeSubmission sub {};
-    sub.op = OP_NVME_READ;
-    sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
-    // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
-
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
-    });
+    submit_rw(request, dma_buffer, OP_NVME_READ, nsid, index, count);
+}
 
-    full_memory_barrier();
-    submit_sqe(sub);
+void NVMeQueue::write(AsyncBlockDeviceRequest& request, NVMeDMABuffer& dma_buffer, u16 nsid, u64 index, u32 count)
+{
+    if (auto result = request.read_from_buffer(request.buffer(), dma_buffer.data(), request.buffer_size()); result.is_error()) {
+        dma_buffer.release();
+        request.complete(AsyncDeviceRequest::MemoryFault);
+        return;
+    }
+    submit_rw(request, dma_buffer, OP_NVME_WRITE, nsid, index, count);
 }
 
-void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+void NVMeQueue::submit_rw(AsyncBlockDeviceRequest& request, NVMeDMABuffer& dma_buffer, u8 op, u16 nsid, u64 index, u32 count)
 {
     NVMeSubmission sub {};
-
-    sub.op = OP_NVME_WRITE;
+    sub.op = op;
     sub.rw.nsid = nsid;
     sub.rw.slba = AK::convert_between_host_and_little_endian(index);
     // No. of lbas is 0 based
     sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
+    sub.rw.data_ptr = dma_buffer.data_ptr(ceil_div(request.buffer_size(), static_cast<size_t>(PAGE_SIZE)));
 
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
+    m_requests.with([&](auto& requests) {
+        // Several requests can be in flight on a queue, so skip over command ids that are still in use.
+        // There are never more of them than fit into the queue, so we always find a free one.
+        for (;;) {
+            sub.cmdid = get_request_cid();
+            auto request_pdu = requests.get(sub.cmdid);
+            if (!request_pdu.has_value() || !request_pdu->is_in_use())
+                break;
+        }
+        requests.set(sub.cmdid, { .request = request, .dma_buffer = &dma_buffer, .end_io_handler = nullptr });
     });
 
-    if (auto result = request.read_from_buffer(request.buffer(), m_rw_dma_region->vaddr().as_ptr(), request.buffer_size()); result.is_error()) {
-        complete_current_request(sub.cmdid, AsyncDeviceRequest::MemoryFault);
-        return;
-    }
-
     full_memory_barrier();
     submit_sqe(sub);
 }
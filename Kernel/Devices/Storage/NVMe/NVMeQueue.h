@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
 #include <AK/OwnPtr.h>
 #include <AK/Types.h>
 #include <Kernel/Bus/PCI/Device.h>
@@ -39,13 +40,61 @@ enum class QueueType {
 
 class AsyncBlockDeviceRequest;
 
+// The buffer a read/write request is transferred through. Its last page holds a PRP list that
+// points to the others, so a request needs only one command no matter how many pages it spans.
+class NVMeDMABufferPool;
+class NVMeDMABuffer {
+    AK_MAKE_NONCOPYABLE(NVMeDMABuffer);
+    AK_MAKE_NONMOVABLE(NVMeDMABuffer);
+
+public:
+    static ErrorOr<NonnullOwnPtr<NVMeDMABuffer>> try_create(NVMeDMABufferPool&);
+
+    u8* data() { return m_region->vaddr().as_ptr(); }
+    DataPtr data_ptr(size_t page_count) const;
+    void release();
+
+private:
+    NVMeDMABuffer(NVMeDMABufferPool&, NonnullOwnPtr<Memory::Region>, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>>);
+
+    NVMeDMABufferPool& m_pool;
+    NonnullOwnPtr<Memory::Region> m_region;
+    Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> m_pages;
+    IntrusiveListNode<NVMeDMABuffer> m_list_node;
+
+public:
+    using List = IntrusiveList<&NVMeDMABuffer::m_list_node>;
+};
+
+// One DMA buffer for every request that may be in flight at the same time.
+class NVMeDMABufferPool {
+    AK_MAKE_NONCOPYABLE(NVMeDMABufferPool);
+    AK_MAKE_NONMOVABLE(NVMeDMABufferPool);
+
+public:
+    static ErrorOr<NonnullOwnPtr<NVMeDMABufferPool>> try_create(size_t buffer_count);
+
+    size_t size() const { return m_buffers.size(); }
+    NVMeDMABuffer& take();
+    void release(NVMeDMABuffer&);
+
+private:
+    NVMeDMABufferPool() = default;
+
+    Vector<NonnullOwnPtr<NVMeDMABuffer>> m_buffers;
+    SpinlockProtected<NVMeDMABuffer::List, LockRank::None> m_free_buffers {};
+};
+
 struct NVMeIO {
     void clear()
     {
         request = nullptr;
+        dma_buffer = nullptr;
         end_io_handler = nullptr;
     }
+    bool is_in_use() const { return request || end_io_handler; }
     RefPtr<AsyncBlockDeviceRequest> request;
+    NVMeDMABuffer* dma_buffer { nullptr };
     Function<void(u16 status)> end_io_handler;
 };
 
@@ -55,8 +104,8 @@ public:
     static ErrorOr<NonnullLockRefPtr<NVMeQueue>> try_create(NVMeController& device, u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type);
     bool is_admin_queue() { return m_admin_queue; }
     u16 submit_sync_sqe(NVMeSubmission&);
-    void read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
-    void write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
+    void read(AsyncBlockDeviceRequest& request, NVMeDMABuffer&, u16 nsid, u64 index, u32 count);
+    void write(AsyncBlockDeviceRequest& request, NVMeDMABuffer&, u16 nsid, u64 index, u32 count);
     virtual void submit_sqe(NVMeSubmission&);
     virtual ~NVMeQueue();
 
@@ -83,7 +132,7 @@ protected:
             m_db_regs.mmio_reg->sq_tail = m_sq_tail;
     }
 
-    NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalRAMPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
+    NVMeQueue(u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
 
     [[nodiscard]] u32 get_request_cid()
     {
@@ -101,6 +150,8 @@ protected:
     virtual void complete_current_request(u16 cmdid, u16 status);
 
 private:
+    void submit_rw(AsyncBlockDeviceRequest&, NVMeDMABuffer&, u8 op, u16 nsid, u64 index, u32 count);
+
     bool cqe_available();
     void update_cqe_head();
     void update_cq_doorbell()
@@ -113,7 +164,6 @@ private:
 
 protected:
     SpinlockProtected<HashMap<u16, NVMeIO>, LockRank::None> m_requests;
-    NonnullOwnPtr<Memory::Region> m_rw_dma_region;
 
 private:
     u16 m_qid {};
@@ -130,6 +180,5 @@ private:
     Span<NVMeCompletion> m_cqe_array;
     WaitQueue m_sync_wait_queue;
     Doorbell m_db_regs;
-    NonnullRefPtr<Memory::PhysicalRAMPage const> const m_rw_dma_page;
 };
 }
@@ -88,6 +88,10 @@ protected:
     // ^DiskDevice
     virtual StringView class_name() const override;
 
+    // Note: Most controllers use a single page for their DMA buffer, so by default
+    // we don't transfer more than PAGE_SIZE with a single request.
+    virtual size_t max_blocks_per_request() const { return m_blocks_per_page; }
+
 private:
     virtual ErrorOr<void> after_inserting() override;
     virtual void will_be_destroyed() override;
@@ -4,115 +4,391 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
 
+static BlockBasedFileSystem::DiskCacheStatistics s_disk_cache_statistics;
+
+BlockBasedFileSystem::DiskCacheStatistics& BlockBasedFileSystem::disk_cache_statistics()
+{
+    return s_disk_cache_statistics;
+}
+
 struct CacheEntry {
+    enum class Queue : u8 {
+        Free,
+        Probation,
+        Protected,
+        Dirty,
+    };
+
     IntrusiveListNode<CacheEntry> list_node;
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    Queue queue { Queue::Free };
+    // NOTE: Dirty entries remember which queue they return to once written back.
+    bool is_protected { false };
+    // Entries without data that read-ahead is going to fill carry its token. Only an entry that still
+    // has no data and the same token may be filled, anything else means the block was touched meanwhile.
+    u64 read_ahead_token { 0 };
 };
 
-class DiskCache {
+// A contiguous batch of cache entries and their block storage.
+// Shards grow and shrink one chunk at a time.
+class DiskCacheChunk {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
+    static constexpr size_t EntryCount = 256;
+
+    static ErrorOr<NonnullOwnPtr<DiskCacheChunk>> try_create(size_t block_size)
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs->logical_block_size();
-            m_clean_list.append(entries()[i]);
-        }
+        auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, EntryCount * block_size));
+        auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, EntryCount * sizeof(CacheEntry)));
+        return adopt_nonnull_own_or_enomem(new (nothrow) DiskCacheChunk(block_size, move(cached_block_data), move(entries_data)));
     }
 
-    ~DiskCache() = default;
+    Span<CacheEntry> entries() { return { reinterpret_cast<CacheEntry*>(m_entries->data()), EntryCount }; }
 
-    bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
+private:
+    DiskCacheChunk(size_t block_size, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries)
+        : m_cached_block_data(move(cached_block_data))
+        , m_entries(move(entries))
+    {
+        for (size_t i = 0; i < EntryCount; ++i)
+            this->entries()[i].data = m_cached_block_data->data() + i * block_size;
+    }
+
+    NonnullOwnPtr<KBuffer> m_cached_block_data;
+    NonnullOwnPtr<KBuffer> m_entries;
+};
+
+// One shard of the disk cache, using 2Q replacement:
+// - Blocks seen for the first time enter the FIFO "probation" queue. Hits there do not promote them,
+//   so a single sequential pass over a large file only ever churns through probation.
+// - Blocks evicted from probation are remembered in a bounded "ghost" set. Missing on a ghost means
+//   the block is being reused, so it is inserted directly into the LRU "protected" queue.
+// - Ghost hits also tell us the shard is too small, so that is when we try to grow it.
+class DiskCacheShard {
+public:
+    static constexpr size_t MinimumChunkCount = 1;
+    static constexpr size_t InitialChunkCount = 5;
+    static constexpr size_t MaximumChunkCount = 32;
+    static constexpr size_t GhostCapacity = MaximumChunkCount * DiskCacheChunk::EntryCount / 2;
+
+    // Memory pressure checks happen once every this many misses.
+    static constexpr size_t MemoryPressureCheckInterval = 256;
 
-    void mark_all_clean()
+    DiskCacheShard() = default;
+
+    ~DiskCacheShard()
     {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+        auto& statistics = BlockBasedFileSystem::disk_cache_statistics();
+        statistics.cached_blocks.fetch_sub(capacity(), AK::MemoryOrder::memory_order_relaxed);
+        statistics.cached_bytes.fetch_sub(capacity() * m_block_size, AK::MemoryOrder::memory_order_relaxed);
     }
 
-    void mark_dirty(CacheEntry& entry)
+    ErrorOr<void> initialize(size_t block_size)
     {
-        m_dirty_list.prepend(entry);
+        m_block_size = block_size;
+        TRY(m_ghost_ring.try_ensure_capacity(GhostCapacity));
+        for (size_t i = 0; i < InitialChunkCount; ++i)
+            TRY(grow());
+        return {};
     }
 
-    void mark_clean(CacheEntry& entry)
+    size_t capacity() const { return m_chunks.size() * DiskCacheChunk::EntryCount; }
+
+    bool is_dirty() const { return !m_dirty_list.is_empty(); }
+    bool entry_is_dirty(CacheEntry const& entry) const { return entry.queue == CacheEntry::Queue::Dirty; }
+
+    void mark_dirty(CacheEntry& entry)
     {
-        m_clean_list.prepend(entry);
+        if (entry.queue == CacheEntry::Queue::Dirty)
+            return;
+        unlink(entry);
+        entry.queue = CacheEntry::Queue::Dirty;
+        m_dirty_list.prepend(entry);
     }
 
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
+    // Looks up an entry without touching its position in the replacement queues.
+    CacheEntry* find(BlockBasedFileSystem::BlockIndex block_index)
     {
         auto it = m_hash.find(block_index);
         if (it == m_hash.end())
             return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
-        VERIFY(entry.block_index == block_index);
-        if (!entry_is_dirty(entry) && (m_clean_list.first() != &entry)) {
-            // Cache hit! Promote the entry to the front of the list.
-            m_clean_list.prepend(entry);
+        VERIFY(it->value->block_index == block_index);
+        return it->value;
+    }
+
+    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        auto* entry = find(block_index);
+        if (!entry)
+            return nullptr;
+        BlockBasedFileSystem::disk_cache_statistics().hits.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        if (entry->queue == CacheEntry::Queue::Protected && m_protected_list.first() != entry) {
+            // Cache hit! Promote the entry to the front of the LRU list.
+            m_protected_list.prepend(*entry);
         }
-        return &entry;
+        return entry;
     }
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
+    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem& fs, BlockBasedFileSystem::BlockIndex block_index)
     {
         if (auto* entry = get(block_index))
             return entry;
 
-        if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            m_fs->flush_writes_impl();
-            return ensure(block_index);
+        auto& statistics = BlockBasedFileSystem::disk_cache_statistics();
+        statistics.misses.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+
+        bool is_reused = m_ghost_set.remove(block_index);
+        if (is_reused) {
+            statistics.ghost_hits.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            if (m_chunks.size() < MaximumChunkCount && has_plenty_of_free_memory())
+                (void)grow();
+        } else if (++m_misses_since_pressure_check >= MemoryPressureCheckInterval) {
+            m_misses_since_pressure_check = 0;
+            if (is_under_memory_pressure())
+                shrink(fs);
         }
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
-
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
+        auto& new_entry = *TRY(take_entry(fs));
+        if (auto result = m_hash.try_set(block_index, &new_entry); result.is_error()) {
+            m_free_list.append(new_entry);
+            return result.release_error();
+        }
 
         new_entry.block_index = block_index;
         new_entry.has_data = false;
+        new_entry.is_protected = is_reused;
+        new_entry.read_ahead_token = 0;
+        link_clean(new_entry);
 
         return &new_entry;
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    // Drops an entry that never got its data.
+    void forget(CacheEntry& entry)
+    {
+        VERIFY(!entry.has_data);
+        m_hash.remove(entry.block_index);
+        unlink(entry);
+        m_free_list.append(entry);
+    }
+
+    size_t flush(BlockBasedFileSystem& fs)
+    {
+        size_t count = 0;
+        while (auto* entry = m_dirty_list.first()) {
+            auto base_offset = entry->block_index.value() * m_block_size;
+            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+            [[maybe_unused]] auto rc = fs.file_description().write(base_offset, entry_data_buffer, m_block_size);
+            m_dirty_list.remove(*entry);
+            link_clean(*entry);
+            ++count;
+        }
+        BlockBasedFileSystem::disk_cache_statistics().writebacks.fetch_add(count, AK::MemoryOrder::memory_order_relaxed);
+        return count;
+    }
+
+private:
+    static bool is_under_memory_pressure()
+    {
+        auto info = MM.get_system_memory_info();
+        return info.physical_pages_uncommitted < info.physical_pages / 16;
+    }
+
+    static bool has_plenty_of_free_memory()
+    {
+        auto info = MM.get_system_memory_info();
+        return info.physical_pages_uncommitted > info.physical_pages / 4;
+    }
+
+    ErrorOr<void> grow()
+    {
+        TRY(m_chunks.try_ensure_capacity(m_chunks.size() + 1));
+        auto chunk = TRY(DiskCacheChunk::try_create(m_block_size));
+        for (auto& entry : chunk->entries())
+            m_free_list.append(entry);
+        m_chunks.unchecked_append(move(chunk));
+
+        auto& statistics = BlockBasedFileSystem::disk_cache_statistics();
+        statistics.grow_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        statistics.cached_blocks.fetch_add(DiskCacheChunk::EntryCount, AK::MemoryOrder::memory_order_relaxed);
+        statistics.cached_bytes.fetch_add(DiskCacheChunk::EntryCount * m_block_size, AK::MemoryOrder::memory_order_relaxed);
+        return {};
+    }
+
+    void shrink(BlockBasedFileSystem& fs)
+    {
+        if (m_chunks.size() <= MinimumChunkCount)
+            return;
+
+        auto& chunk = *m_chunks.last();
+        for (auto& entry : chunk.entries()) {
+            if (entry_is_dirty(entry)) {
+                flush(fs);
+                break;
+            }
+        }
+        for (auto& entry : chunk.entries()) {
+            if (entry.queue != CacheEntry::Queue::Free)
+                m_hash.remove(entry.block_index);
+            unlink(entry);
+        }
+        m_chunks.remove(m_chunks.size() - 1);
+
+        auto& statistics = BlockBasedFileSystem::disk_cache_statistics();
+        statistics.shrink_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        statistics.cached_blocks.fetch_sub(DiskCacheChunk::EntryCount, AK::MemoryOrder::memory_order_relaxed);
+        statistics.cached_bytes.fetch_sub(DiskCacheChunk::EntryCount * m_block_size, AK::MemoryOrder::memory_order_relaxed);
+    }
+
+    ErrorOr<CacheEntry*> take_entry(BlockBasedFileSystem& fs)
+    {
+        if (auto* entry = m_free_list.first()) {
+            unlink(*entry);
+            return entry;
+        }
+
+        // Keep probation at roughly a quarter of the shard, as recommended for 2Q.
+        bool evict_from_probation = m_probation_count > capacity() / 4 || m_protected_list.is_empty();
+        auto* victim = evict_from_probation ? m_probation_list.last() : m_protected_list.last();
+        if (!victim)
+            victim = evict_from_probation ? m_protected_list.last() : m_probation_list.last();
+
+        if (!victim) {
+            // Not a single clean entry! Flush writes and try again.
+            VERIFY(is_dirty());
+            flush(fs);
+            return take_entry(fs);
+        }
+
+        if (victim->queue == CacheEntry::Queue::Probation)
+            remember_ghost(victim->block_index);
+        m_hash.remove(victim->block_index);
+        unlink(*victim);
+        BlockBasedFileSystem::disk_cache_statistics().evictions.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        return victim;
+    }
+
+    void remember_ghost(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        if (m_ghost_ring.size() < GhostCapacity) {
+            m_ghost_ring.unchecked_append(block_index);
+        } else {
+            m_ghost_set.remove(m_ghost_ring[m_ghost_ring_next]);
+            m_ghost_ring[m_ghost_ring_next] = block_index;
+            m_ghost_ring_next = (m_ghost_ring_next + 1) % GhostCapacity;
+        }
+        // NOTE: Forgetting a ghost is harmless, so we don't care if this fails.
+        (void)m_ghost_set.try_set(block_index);
+    }
+
+    void link_clean(CacheEntry& entry)
+    {
+        if (entry.is_protected) {
+            entry.queue = CacheEntry::Queue::Protected;
+            m_protected_list.prepend(entry);
+        } else {
+            entry.queue = CacheEntry::Queue::Probation;
+            m_probation_list.prepend(entry);
+            ++m_probation_count;
+        }
+    }
+
+    void unlink(CacheEntry& entry)
+    {
+        switch (entry.queue) {
+        case CacheEntry::Queue::Free:
+            m_free_list.remove(entry);
+            break;
+        case CacheEntry::Queue::Probation:
+            m_probation_list.remove(entry);
+            --m_probation_count;
+            break;
+        case CacheEntry::Queue::Protected:
+            m_protected_list.remove(entry);
+            break;
+        case CacheEntry::Queue::Dirty:
+            m_dirty_list.remove(entry);
+            break;
+        }
+        entry.queue = CacheEntry::Queue::Free;
+    }
+
+    size_t m_block_size { 0 };
+
+    // NOTE: m_chunks must be declared before the lists because their entries are allocated from it.
+    // We need to ensure that the destructors of the lists are called before the chunks are destroyed.
+    Vector<NonnullOwnPtr<DiskCacheChunk>> m_chunks;
+    IntrusiveList<&CacheEntry::list_node> m_free_list;
+    IntrusiveList<&CacheEntry::list_node> m_probation_list;
+    IntrusiveList<&CacheEntry::list_node> m_protected_list;
+    IntrusiveList<&CacheEntry::list_node> m_dirty_list;
+    size_t m_probation_count { 0 };
+    size_t m_misses_since_pressure_check { 0 };
+
+    HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+
+    Vector<BlockBasedFileSystem::BlockIndex> m_ghost_ring;
+    size_t m_ghost_ring_next { 0 };
+    HashTable<BlockBasedFileSystem::BlockIndex> m_ghost_set;
+};
+
+// The disk cache is split into independently locked shards so that readers of unrelated
+// blocks don't serialize on a single lock. The outer BlockBasedFileSystem::m_cache lock is
+// only taken exclusively when the whole cache is created or torn down.
+class DiskCache {
+public:
+    static constexpr size_t ShardCount = 8;
+
+    explicit DiskCache(BlockBasedFileSystem& fs)
+        : m_fs(fs)
+    {
+    }
+
+    ~DiskCache() = default;
+
+    ErrorOr<void> initialize()
+    {
+        for (auto& shard : m_shards) {
+            TRY(shard.with_exclusive([&](auto& shard) {
+                return shard.initialize(m_fs->logical_block_size());
+            }));
+        }
+        return {};
+    }
+
+    template<typename Callback>
+    decltype(auto) with_shard_for(BlockBasedFileSystem::BlockIndex block_index, Callback callback) const
+    {
+        auto& shard = m_shards[u64_hash(block_index.value()) % ShardCount];
+        return shard.with_exclusive([&](auto& shard) {
+            return callback(shard);
+        });
+    }
 
     template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+    void for_each_shard(Callback callback) const
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        for (auto& shard : m_shards) {
+            shard.with_exclusive([&](auto& shard) {
+                callback(shard);
+            });
+        }
     }
 
 private:
     mutable NonnullRefPtr<BlockBasedFileSystem> m_fs;
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
-
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
-    NonnullOwnPtr<KBuffer> m_entries;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    mutable Array<MutexProtected<DiskCacheShard>, ShardCount> m_shards;
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
@@ -136,9 +412,8 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(logical_block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * logical_block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this)));
+    TRY(disk_cache->initialize());
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
@@ -159,7 +434,7 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
             flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * logical_block_size() + offset;
@@ -168,16 +443,18 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
             return {};
         }
 
-        auto entry = TRY(cache->ensure(index));
-        if (count < logical_block_size()) {
-            // Fill the cache first.
-            TRY(read_block(index, nullptr, logical_block_size()));
-        }
-        memcpy(entry->data + offset, buffered_data.data(), count);
+        return cache->with_shard_for(index, [&](auto& shard) -> ErrorOr<void> {
+            auto entry = TRY(shard.ensure(*this, index));
+            if (count < logical_block_size()) {
+                // Fill the cache first.
+                TRY(read_block(index, nullptr, logical_block_size()));
+            }
+            memcpy(entry->data + offset, buffered_data.data(), count);
 
-        cache->mark_dirty(*entry);
-        entry->has_data = true;
-        return {};
+            shard.mark_dirty(*entry);
+            entry->has_data = true;
+            return {};
+        });
     });
 }
 
@@ -233,7 +510,7 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= logical_block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
             const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * logical_block_size() + offset;
@@ -242,17 +519,19 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
             return {};
         }
 
-        auto* entry = TRY(cache->ensure(index));
-        if (!entry->has_data) {
-            auto base_offset = index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-            auto nread = TRY(file_description().read(entry_data_buffer, base_offset, logical_block_size()));
-            VERIFY(nread == logical_block_size());
-            entry->has_data = true;
-        }
-        if (buffer)
-            TRY(buffer->write(entry->data + offset, count));
-        return {};
+        return cache->with_shard_for(index, [&](auto& shard) -> ErrorOr<void> {
+            auto* entry = TRY(shard.ensure(const_cast<BlockBasedFileSystem&>(*this), index));
+            if (!entry->has_data) {
+                auto base_offset = index.value() * logical_block_size();
+                auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+                auto nread = TRY(file_description().read(entry_data_buffer, base_offset, logical_block_size()));
+                VERIFY(nread == logical_block_size());
+                entry->has_data = true;
+            }
+            if (buffer)
+                TRY(buffer->write(entry->data + offset, count));
+            return {};
+        });
     });
 }
 
@@ -272,37 +551,134 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
-void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
+ErrorOr<void> BlockBasedFileSystem::read_ahead_blocks(ReadonlySpan<BlockIndex> blocks) const
 {
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
+    // Issue one device read per physically contiguous run. Zero block indices are holes and are skipped.
+    size_t run_start = 0;
+    for (size_t i = 1; i <= blocks.size(); ++i) {
+        if (i < blocks.size() && blocks[i - 1].value() != 0 && blocks[i].value() == blocks[i - 1].value() + 1)
+            continue;
+        if (blocks[run_start].value() != 0)
+            TRY(read_ahead_contiguous_blocks(blocks[run_start], i - run_start));
+        run_start = i;
+    }
+    return {};
+}
+
+ErrorOr<void> BlockBasedFileSystem::read_ahead_contiguous_blocks(BlockIndex index, size_t count) const
+{
+    VERIFY(m_device_block_size);
+    dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_ahead_contiguous_blocks {}, count={}", index, count);
+
+    // NOTE: Read-ahead runs asynchronously, so the cache may have been torn down by an unmount in the meantime.
+    auto is_cached = [&](BlockIndex block_index) {
+        return m_cache.with_shared([&](auto& cache) {
+            if (!cache)
+                return true;
+            return cache->with_shard_for(block_index, [&](auto& shard) {
+                return shard.find(block_index) != nullptr;
+            });
+        });
+    };
+
+    // Don't bother reading the blocks at either end of the run that we already have.
+    while (count > 0 && is_cached(index)) {
+        index = index.value() + 1;
+        --count;
+    }
+    while (count > 0 && is_cached(BlockIndex { index.value() + count - 1 }))
+        --count;
+    if (count == 0)
+        return {};
+
+    auto data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Read-ahead"sv, count * logical_block_size()));
+
+    auto for_each_block_in_cache = [&](auto callback) {
+        m_cache.with_shared([&](auto& cache) {
+            if (!cache)
+                return;
+            for (size_t i = 0; i < count; ++i) {
+                BlockIndex block_index { index.value() + i };
+                cache->with_shard_for(block_index, [&](auto& shard) {
+                    callback(shard, block_index, i);
+                });
+            }
+        });
+    };
+
+    // Put a placeholder into the cache for every block we're going to read before we read it. Whatever happens to
+    // a block while the device read is in flight (it gets written, read, flushed or evicted) replaces or drops its
+    // placeholder, so we can tell which of the blocks we read may be stale.
+    auto token = m_next_read_ahead_token.fetch_add(1);
+    for_each_block_in_cache([&](auto& shard, BlockIndex block_index, size_t) {
+        if (shard.find(block_index))
             return;
-        auto* entry = cache->get(index);
-        if (!entry)
+        auto entry_or_error = shard.ensure(const_cast<BlockBasedFileSystem&>(*this), block_index);
+        if (!entry_or_error.is_error())
+            entry_or_error.value()->read_ahead_token = token;
+    });
+
+    size_t nread = 0;
+    ErrorOr<void> read_result {};
+    while (nread < data->size()) {
+        auto data_buffer = UserOrKernelBuffer::for_kernel_buffer(data->data() + nread);
+        auto result = file_description().read(data_buffer, index.value() * logical_block_size() + nread, data->size() - nread);
+        if (result.is_error()) {
+            read_result = result.release_error();
+            break;
+        }
+        if (result.value() == 0)
+            break;
+        nread += result.value();
+    }
+
+    for_each_block_in_cache([&](auto& shard, BlockIndex block_index, size_t i) {
+        auto* entry = shard.find(block_index);
+        if (!entry || entry->has_data || entry->read_ahead_token != token)
             return;
-        if (!cache->entry_is_dirty(*entry))
+        if ((i + 1) * logical_block_size() > nread) {
+            shard.forget(*entry);
             return;
-        size_t base_offset = entry->block_index.value() * logical_block_size();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-        (void)file_description().write(base_offset, entry_data_buffer, logical_block_size());
+        }
+        memcpy(entry->data, data->data() + i * logical_block_size(), logical_block_size());
+        entry->has_data = true;
+        entry->read_ahead_token = 0;
+        disk_cache_statistics().read_ahead_blocks.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    });
+
+    return read_result;
+}
+
+void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
+{
+    m_cache.with_shared([&](auto& cache) {
+        cache->with_shard_for(index, [&](auto& shard) {
+            if (!shard.is_dirty())
+                return;
+            auto* entry = shard.find(index);
+            if (!entry)
+                return;
+            if (!shard.entry_is_dirty(*entry))
+                return;
+            size_t base_offset = entry->block_index.value() * logical_block_size();
+            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+            (void)file_description().write(base_offset, entry_data_buffer, logical_block_size());
+        });
     });
 }
 
 void BlockBasedFileSystem::flush_writes_impl()
 {
     size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, logical_block_size());
-            ++count;
+    m_cache.with_shared([&](auto& cache) {
+        cache->for_each_shard([&](auto& shard) {
+            if (!shard.is_dirty())
+                return;
+            count += shard.flush(*this);
         });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
     });
+    if (count)
+        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
 }
 
 ErrorOr<void> BlockBasedFileSystem::flush_writes()
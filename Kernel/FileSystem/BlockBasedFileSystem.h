@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/Locking/MutexProtected.h>
 
@@ -15,6 +16,22 @@ class BlockBasedFileSystem : public FileBackedFileSystem {
 public:
     AK_TYPEDEF_DISTINCT_ORDERED_ID(u64, BlockIndex);
 
+    // Counters shared by the disk caches of all block-based filesystems, exposed in /sys/kernel/disk_cache.
+    struct DiskCacheStatistics {
+        Atomic<u64> hits { 0 };
+        Atomic<u64> misses { 0 };
+        Atomic<u64> ghost_hits { 0 };
+        Atomic<u64> evictions { 0 };
+        Atomic<u64> writebacks { 0 };
+        Atomic<u64> read_ahead_blocks { 0 };
+        Atomic<u64> grow_count { 0 };
+        Atomic<u64> shrink_count { 0 };
+        Atomic<u64> cached_blocks { 0 };
+        Atomic<u64> cached_bytes { 0 };
+    };
+
+    static DiskCacheStatistics& disk_cache_statistics();
+
     virtual ~BlockBasedFileSystem() override;
 
     u64 device_block_size() const { return m_device_block_size; }
@@ -29,6 +46,7 @@ protected:
 
     ErrorOr<void> read_block(BlockIndex, UserOrKernelBuffer*, size_t count, u64 offset = 0, bool allow_cache = true) const;
     ErrorOr<void> read_blocks(BlockIndex, unsigned count, UserOrKernelBuffer&, bool allow_cache = true) const;
+    ErrorOr<void> read_ahead_blocks(ReadonlySpan<BlockIndex>) const;
 
     ErrorOr<void> raw_read(BlockIndex, UserOrKernelBuffer&);
     ErrorOr<void> raw_write(BlockIndex, UserOrKernelBuffer const&);
@@ -45,8 +63,12 @@ protected:
 
 private:
     void flush_specific_block_if_needed(BlockIndex index);
+    ErrorOr<void> read_ahead_contiguous_blocks(BlockIndex, size_t count) const;
 
     mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
+
+    // Tells apart the cache entries that concurrent read-aheads are going to fill.
+    mutable Atomic<u64> m_next_read_ahead_token { 1 };
 };
 
 }
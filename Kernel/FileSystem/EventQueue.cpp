@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventQueue.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Thread.h>
+
+namespace Kernel {
+
+// Locking order: Registration::m_lock, then a watched file's blocker set, the watched
+// description's observer list, or the queue's own locks. Readiness notifications arrive with
+// the watched file's blocker set locked, and only ever touch the queue's ready list.
+
+ErrorOr<NonnullRefPtr<EventQueue>> EventQueue::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EventQueue);
+}
+
+EventQueue::~EventQueue()
+{
+    (void)close();
+}
+
+bool EventQueue::can_read(OpenFileDescription const&, u64) const
+{
+    return m_ready_count.load() > 0;
+}
+
+ErrorOr<void> EventQueue::close()
+{
+    auto registrations = m_registrations.with([](auto& registrations) { return move(registrations); });
+    for (auto& it : registrations)
+        it.value->detach();
+
+    m_ready_list.with([&](auto& ready_list) {
+        while (!ready_list.is_empty())
+            (void)ready_list.take_first();
+        m_ready_count = 0;
+    });
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EventQueue::pseudo_path(OpenFileDescription const&) const
+{
+    return m_registrations.with([](auto& registrations) -> ErrorOr<NonnullOwnPtr<KString>> {
+        return KString::formatted("EventQueue:({})", registrations.size());
+    });
+}
+
+ErrorOr<void> EventQueue::add(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    auto registration = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Registration(*this, fd, description, event)));
+
+    // A closed fd number may have been reused for a different description in the meantime.
+    RefPtr<Registration> stale_registration;
+    TRY(m_registrations.with([&](auto& registrations) -> ErrorOr<void> {
+        if (auto existing = registrations.get(fd); existing.has_value()) {
+            if (existing.value()->is_for(description))
+                return EEXIST;
+            stale_registration = existing.value();
+        }
+        TRY(registrations.try_set(fd, registration));
+        return {};
+    }));
+    if (stale_registration) {
+        stale_registration->detach();
+        m_ready_list.with([&](auto& ready_list) {
+            if (ready_list.contains(*stale_registration)) {
+                ready_list.remove(*stale_registration);
+                --m_ready_count;
+            }
+        });
+    }
+
+    description.add_readiness_observer(*registration);
+    description.blocker_set().add_readiness_observer(*registration);
+
+    // Let the next wait find out whether it's ready already.
+    enqueue(*registration);
+    return {};
+}
+
+ErrorOr<void> EventQueue::modify(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    auto registration = m_registrations.with([&](auto& registrations) -> RefPtr<Registration> {
+        auto existing = registrations.get(fd);
+        if (!existing.has_value() || !existing.value()->is_for(description))
+            return nullptr;
+        return existing.value();
+    });
+    if (!registration)
+        return ENOENT;
+
+    registration->set_event(event);
+    enqueue(*registration);
+    return {};
+}
+
+ErrorOr<void> EventQueue::remove(int fd, OpenFileDescription& description)
+{
+    auto registration = m_registrations.with([&](auto& registrations) -> RefPtr<Registration> {
+        auto existing = registrations.get(fd);
+        if (!existing.has_value() || !existing.value()->is_for(description))
+            return nullptr;
+        return registrations.take(fd).release_value();
+    });
+    if (!registration)
+        return ENOENT;
+
+    registration->detach();
+    forget(*registration);
+    return {};
+}
+
+ErrorOr<size_t> EventQueue::collect_ready_events(Span<epoll_event> events)
+{
+    using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+    Vector<NonnullRefPtr<Registration>, 32> candidates;
+    TRY(candidates.try_ensure_capacity(events.size()));
+    m_ready_list.with([&](auto& ready_list) {
+        while (!ready_list.is_empty() && candidates.size() < events.size()) {
+            candidates.unchecked_append(*ready_list.take_first());
+            --m_ready_count;
+        }
+    });
+
+    size_t count = 0;
+    for (auto& registration : candidates) {
+        // Looking at the description itself may take locks that are held while notifying us,
+        // so this has to happen outside of all of our own locks.
+        auto description = registration->strong_description();
+        if (!description || !registration->is_armed())
+            continue;
+
+        auto event = registration->event();
+        auto block_flags = BlockFlags::None;
+        if (event.events & EPOLLIN)
+            block_flags |= BlockFlags::Read;
+        if (event.events & EPOLLOUT)
+            block_flags |= BlockFlags::Write;
+        auto unblocked_flags = description->should_unblock(block_flags);
+
+        u32 ready_events = 0;
+        if (has_flag(unblocked_flags, BlockFlags::Read))
+            ready_events |= EPOLLIN;
+        if (has_flag(unblocked_flags, BlockFlags::Write))
+            ready_events |= EPOLLOUT;
+        if (ready_events == 0)
+            continue;
+
+        events[count++] = { ready_events, event.data };
+
+        if (event.events & EPOLLONESHOT)
+            registration->disarm();
+        else if (!(event.events & EPOLLET))
+            enqueue(*registration); // Level-triggered: look at it again next time.
+    }
+    return count;
+}
+
+void EventQueue::enqueue(Registration& registration)
+{
+    if (!registration.is_armed())
+        return;
+    bool did_enqueue = m_ready_list.with([&](auto& ready_list) {
+        if (ready_list.contains(registration))
+            return false;
+        ready_list.append(registration);
+        ++m_ready_count;
+        return true;
+    });
+    if (did_enqueue)
+        evaluate_block_conditions();
+}
+
+void EventQueue::forget(Registration& registration)
+{
+    m_registrations.with([&](auto& registrations) {
+        auto existing = registrations.get(registration.fd());
+        if (existing.has_value() && existing.value() == &registration)
+            registrations.remove(registration.fd());
+    });
+    m_ready_list.with([&](auto& ready_list) {
+        if (ready_list.contains(registration)) {
+            ready_list.remove(registration);
+            --m_ready_count;
+        }
+    });
+}
+
+void EventQueue::Registration::description_will_be_destroyed(OpenFileDescription& description)
+{
+    // The description has already unlinked us from its own list.
+    SpinlockLocker locker(m_lock);
+    if (m_description != &description)
+        return;
+    m_description->blocker_set().remove_readiness_observer(*this);
+    m_description = nullptr;
+
+    // Our queue can't go away while we're holding the lock, as closing it has to detach us first.
+    m_queue.forget(*this);
+}
+
+void EventQueue::Registration::detach()
+{
+    SpinlockLocker locker(m_lock);
+    if (!m_description)
+        return;
+    m_description->blocker_set().remove_readiness_observer(*this);
+    m_description->remove_readiness_observer(*this);
+    m_description = nullptr;
+}
+
+RefPtr<OpenFileDescription> EventQueue::Registration::strong_description()
+{
+    SpinlockLocker locker(m_lock);
+    if (!m_description || !m_description->try_ref())
+        return nullptr;
+    return adopt_ref(*m_description);
+}
+
+bool EventQueue::Registration::is_for(OpenFileDescription const& description) const
+{
+    SpinlockLocker locker(m_lock);
+    return m_description == &description;
+}
+
+epoll_event EventQueue::Registration::event() const
+{
+    SpinlockLocker locker(m_lock);
+    return m_event;
+}
+
+void EventQueue::Registration::set_event(epoll_event const& event)
+{
+    SpinlockLocker locker(m_lock);
+    m_event = event;
+    m_armed = true;
+}
+
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// A persistent set of open file descriptions to watch for readiness, in the style of epoll.
+// Files push readiness changes into the queue as they happen, so waiting on it only costs
+// time proportional to the number of descriptions that became ready, not the number registered.
+class EventQueue final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<EventQueue>> try_create();
+    virtual ~EventQueue() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EventQueue"sv; }
+    virtual bool is_event_queue() const override { return true; }
+
+    ErrorOr<void> add(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove(int fd, OpenFileDescription&);
+
+    // Fills in events for descriptions that are ready right now. Never blocks.
+    ErrorOr<size_t> collect_ready_events(Span<epoll_event>);
+
+private:
+    EventQueue() = default;
+
+    class Registration final : public FileReadinessObserver {
+    public:
+        Registration(EventQueue& queue, int fd, OpenFileDescription& description, epoll_event const& event)
+            : m_queue(queue)
+            , m_fd(fd)
+            , m_event(event)
+            , m_description(&description)
+        {
+        }
+
+        virtual void readiness_may_have_changed() override { m_queue.enqueue(*this); }
+        virtual void description_will_be_destroyed(OpenFileDescription&) override;
+
+        void detach();
+        RefPtr<OpenFileDescription> strong_description();
+        bool is_for(OpenFileDescription const&) const;
+
+        int fd() const { return m_fd; }
+        epoll_event event() const;
+        void set_event(epoll_event const&);
+        bool is_armed() const { return m_armed; }
+        void disarm() { m_armed = false; }
+
+        IntrusiveListNode<Registration, RefPtr<Registration>> m_ready_list_node;
+
+    private:
+        EventQueue& m_queue;
+        int const m_fd;
+        Atomic<bool> m_armed { true };
+
+        mutable Spinlock<LockRank::None> m_lock {};
+        epoll_event m_event {};
+        OpenFileDescription* m_description { nullptr };
+    };
+
+    using ReadyList = IntrusiveList<&Registration::m_ready_list_node>;
+
+    void enqueue(Registration&);
+    void forget(Registration&);
+
+    SpinlockProtected<HashMap<int, NonnullRefPtr<Registration>>, LockRank::None> m_registrations {};
+    SpinlockProtected<ReadyList, LockRank::None> m_ready_list {};
+    Atomic<size_t> m_ready_count { 0 };
+};
+
+}
@@ -6,6 +6,7 @@
  */
 
 #include <AK/IntegralMath.h>
+#include <AK/ScopeGuard.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
 #include <Kernel/FileSystem/Ext2FS/Inode.h>
@@ -14,6 +15,8 @@
 
 namespace Kernel {
 
+static constexpr size_t max_delayed_allocation_memory = 16 * MiB;
+
 ErrorOr<NonnullRefPtr<FileSystem>> Ext2FS::try_create(OpenFileDescription& file_description, FileSystemSpecificOptions const&)
 {
     return TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Ext2FS(file_description)));
@@ -223,9 +226,42 @@ ErrorOr<void> Ext2FS::write_ext2_inode(InodeIndex inode, ext2_inode const& e2ino
     return write_block(block_index, buffer, inode_size(), offset);
 }
 
-auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) -> ErrorOr<Vector<BlockIndex>>
+ErrorOr<void> Ext2FS::reserve_blocks(size_t count)
+{
+    MutexLocker locker(m_lock);
+    if (m_reserved_block_count + count > super_block().s_free_blocks_count)
+        return ENOSPC;
+    m_reserved_block_count += count;
+    return {};
+}
+
+void Ext2FS::unreserve_blocks(size_t count)
+{
+    MutexLocker locker(m_lock);
+    VERIFY(count <= m_reserved_block_count);
+    m_reserved_block_count -= count;
+}
+
+bool Ext2FS::try_account_delayed_allocation_memory(size_t size)
+{
+    MutexLocker locker(m_lock);
+    if (m_delayed_allocation_memory + size > max_delayed_allocation_memory)
+        return false;
+    m_delayed_allocation_memory += size;
+    return true;
+}
+
+void Ext2FS::unaccount_delayed_allocation_memory(size_t size)
 {
-    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {})", preferred_group_index, count);
+    MutexLocker locker(m_lock);
+    VERIFY(size <= m_delayed_allocation_memory);
+    m_delayed_allocation_memory -= size;
+}
+
+auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal, size_t reserved_count) -> ErrorOr<Vector<BlockIndex>>
+{
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {}, goal {})", preferred_group_index, count, goal);
+    VERIFY(reserved_count <= count);
     if (count == 0)
         return Vector<BlockIndex> {};
 
@@ -233,6 +269,33 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
     TRY(blocks.try_ensure_capacity(count));
 
     MutexLocker locker(m_lock);
+    VERIFY(reserved_count <= m_reserved_block_count);
+    if (count - reserved_count > super_block().s_free_blocks_count - m_reserved_block_count)
+        return ENOSPC;
+
+    // Give back what was claimed so far if we fail halfway, so that the caller can simply try again.
+    ArmedScopeGuard free_blocks_on_failure([&] {
+        for (auto block_index : blocks)
+            (void)set_block_allocation_state(block_index, false);
+    });
+
+    if (goal != 0 && goal.value() < super_block().s_blocks_count) {
+        auto goal_group_index = group_index_from_block_index(goal);
+        auto const& bgd = group_descriptor(goal_group_index);
+        if (bgd.bg_free_blocks_count) {
+            auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+            u32 blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
+            auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
+            BlockIndex first_block_in_group = first_block_of_group(goal_group_index);
+            for (auto bit_index = goal.value() - first_block_in_group.value(); bit_index < blocks_in_group && blocks.size() < count && !block_bitmap.get(bit_index); ++bit_index) {
+                BlockIndex block_index = first_block_in_group.value() + bit_index;
+                TRY(set_block_allocation_state(block_index, true));
+                blocks.unchecked_append(block_index);
+            }
+            dbgln_if(EXT2_DEBUG, "Ext2FS: allocated {} block(s) at goal {}", blocks.size(), goal);
+        }
+    }
+
     auto group_index = preferred_group_index;
 
     if (!group_descriptor(preferred_group_index).bg_free_blocks_count) {
@@ -276,6 +339,8 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
     }
 
     VERIFY(blocks.size() == count);
+    free_blocks_on_failure.disarm();
+    m_reserved_block_count -= reserved_count;
     return blocks;
 }
 
@@ -644,6 +709,22 @@ void Ext2FS::flush_block_group_descriptor_table()
 
 ErrorOr<void> Ext2FS::flush_writes()
 {
+    // Delayed allocations pin their data in memory until they're flushed, so write them out along with everything else.
+    // The inode lock has to be taken before ours, so collect the inodes first.
+    Vector<NonnullRefPtr<Ext2FSInode>> inodes_with_delayed_allocation;
+    {
+        MutexLocker locker(m_lock);
+        for (auto& it : m_inode_cache) {
+            if (it.value && it.value->has_delayed_allocation())
+                TRY(inodes_with_delayed_allocation.try_append(*it.value));
+        }
+    }
+    for (auto& inode : inodes_with_delayed_allocation) {
+        MutexLocker inode_locker(inode->m_inode_lock);
+        if (auto result = inode->flush_delayed_allocation(); result.is_error())
+            dbgln("Ext2FS[{}]::flush_writes(): Failed to flush delayed allocation of inode {}: {}", fsid(), inode->index(), result.error());
+    }
+
     {
         MutexLocker locker(m_lock);
         if (m_super_block_dirty) {
@@ -683,7 +764,7 @@ ErrorOr<void> Ext2FS::flush_writes()
             if (cached_inode == nullptr)
                 return true;
 
-            return cached_inode->ref_count() == 1 && !cached_inode->has_watchers();
+            return cached_inode->ref_count() == 1 && !cached_inode->has_watchers() && !cached_inode->has_delayed_allocation();
         });
     }
 
@@ -92,7 +92,14 @@ private:
     BlockIndex first_block_index() const;
     BlockIndex first_block_of_block_group_descriptors() const;
     ErrorOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
-    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+    // If a goal block is given, the allocation tries to start exactly there, so that a file's blocks stay contiguous.
+    // The reserved count says how many of the blocks to allocate have previously been set aside with reserve_blocks().
+    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal = 0, size_t reserved_count = 0);
+    ErrorOr<void> reserve_blocks(size_t count);
+    void unreserve_blocks(size_t count);
+    // Delayed allocations keep their data in kernel memory until they're flushed, so all inodes together may only hold so much.
+    bool try_account_delayed_allocation_memory(size_t);
+    void unaccount_delayed_allocation_memory(size_t);
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
     BlockIndex first_block_of_group(GroupIndex) const;
@@ -113,6 +120,10 @@ private:
 
     mutable HashMap<InodeIndex, RefPtr<Ext2FSInode>> m_inode_cache;
 
+    // Blocks promised to delayed allocations that haven't been allocated yet.
+    size_t m_reserved_block_count { 0 };
+    size_t m_delayed_allocation_memory { 0 };
+
     bool m_super_block_dirty { false };
     bool m_block_group_descriptors_dirty { false };
 
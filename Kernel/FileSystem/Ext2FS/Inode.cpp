@@ -7,6 +7,7 @@
 
 #include <AK/IntegralMath.h>
 #include <AK/MemoryStream.h>
+#include <AK/ScopeGuard.h>
 #include <Kernel/API/POSIX/errno.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
@@ -17,6 +18,7 @@
 namespace Kernel {
 
 static constexpr size_t max_inline_symlink_length = 60;
+static constexpr size_t max_delayed_allocation_size = 256 * KiB;
 
 static u8 to_ext2_file_type(mode_t mode)
 {
@@ -203,7 +205,12 @@ ErrorOr<u32> Ext2FSInode::allocate_and_zero_block()
 {
     auto const block_size = fs().logical_block_size();
 
-    auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), 1));
+    // Indirect blocks needed to map a delayed allocation were reserved along with it. While the run is being flushed,
+    // it has no blocks left, but some of that reservation.
+    auto const& delayed = m_delayed_allocation;
+    size_t reserved_count = delayed.block_count == 0 && delayed.reserved_indirect_block_count > 0 ? 1 : 0;
+    auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), 1, 0, reserved_count));
+    m_delayed_allocation.reserved_indirect_block_count -= reserved_count;
     auto block = blocks.first();
 
     auto buffer_content = TRY(ByteBuffer::create_zeroed(block_size));
@@ -351,9 +358,17 @@ Ext2FSInode::Ext2FSInode(Ext2FS& fs, InodeIndex index)
 Ext2FSInode::~Ext2FSInode()
 {
     if (m_raw_inode.i_links_count == 0) {
+        discard_delayed_blocks_from(0);
         // Alas, we have nowhere to propagate any errors that occur here.
         (void)fs().free_inode(*this);
+    } else if (has_delayed_allocation()) {
+        MutexLocker locker(m_inode_lock);
+        if (auto result = flush_delayed_allocation(); result.is_error()) {
+            dbgln("Ext2FSInode[{}]::~Ext2FSInode(): Failed to flush delayed allocation: {}", identifier(), result.error());
+            discard_delayed_blocks_from(0);
+        }
     }
+    release_delayed_buffer();
 }
 
 u64 Ext2FSInode::size() const
@@ -393,6 +408,7 @@ InodeMetadata Ext2FSInode::metadata() const
 ErrorOr<void> Ext2FSInode::flush_metadata()
 {
     MutexLocker locker(m_inode_lock);
+    TRY(flush_delayed_allocation());
     if (!is_metadata_dirty())
         return {};
 
@@ -423,6 +439,18 @@ ErrorOr<void> Ext2FSInode::compute_block_list_with_exclusive_locking()
 }
 
 ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
+{
+    bool allow_cache = !description || !description->is_direct();
+    return read_bytes_impl(offset, count, buffer, allow_cache);
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer) const
+{
+    // The page cache keeps the file's data, so there's no point in keeping it in the disk cache as well.
+    return read_bytes_impl(offset, count, buffer, false);
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_impl(off_t offset, size_t count, UserOrKernelBuffer& buffer, bool allow_cache) const
 {
     VERIFY(m_inode_lock.is_locked());
     VERIFY(offset >= 0);
@@ -448,8 +476,6 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     // shared mode.
     TRY(const_cast<Ext2FSInode&>(*this).compute_block_list_with_exclusive_locking());
 
-    bool allow_cache = !description || !description->is_direct();
-
     int const block_size = fs().logical_block_size();
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
@@ -467,7 +493,9 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
         size_t offset_into_block = (current_block_logical_index == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
         auto buffer_offset = buffer.offset(nread);
-        if (block_index.value() == 0) {
+        if (auto* delayed_data = delayed_block_data(current_block_logical_index)) {
+            TRY(buffer_offset.write(delayed_data + offset_into_block, num_bytes_to_copy));
+        } else if (block_index.value() == 0) {
             // This is a hole, act as if it's filled with zeroes.
             TRY(buffer_offset.memset(0, num_bytes_to_copy));
         } else {
@@ -484,6 +512,28 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     return nread;
 }
 
+ErrorOr<void> Ext2FSInode::read_ahead_locked(off_t offset, size_t count) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+    if (static_cast<u64>(offset) >= size() || is_symlink())
+        return {};
+
+    TRY(const_cast<Ext2FSInode&>(*this).compute_block_list_with_exclusive_locking());
+
+    auto const block_size = fs().logical_block_size();
+    auto end_offset = min(static_cast<u64>(offset) + count, size());
+    auto first_block_logical_index = offset / block_size;
+    auto last_block_logical_index = (end_offset - 1) / block_size;
+
+    Vector<BlockBasedFileSystem::BlockIndex> blocks;
+    TRY(blocks.try_ensure_capacity(last_block_logical_index - first_block_logical_index + 1));
+    for (auto i = first_block_logical_index; i <= last_block_logical_index; ++i)
+        blocks.unchecked_append(get_block(i));
+
+    return fs().read_ahead_blocks(blocks);
+}
+
 ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 {
     VERIFY(m_inode_lock.is_locked());
@@ -498,6 +548,8 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
         BlockBasedFileSystem::BlockIndex first_block_logical_index = ceil_div(new_size, block_size);
         BlockBasedFileSystem::BlockIndex last_block_logical_index = size() / block_size;
 
+        discard_delayed_blocks_from(first_block_logical_index);
+
         if (m_block_list.is_empty())
             m_block_list = TRY(compute_block_list());
         auto old_block_list = TRY(m_block_list.clone());
@@ -547,6 +599,10 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
 
     bool allow_cache = !description || !description->is_direct();
 
+    // Direct writes go straight to disk, so they need to find every block already allocated.
+    if (!allow_cache)
+        TRY(flush_delayed_allocation());
+
     auto const block_size = fs().logical_block_size();
     auto new_size = max(static_cast<u64>(offset) + count, size());
 
@@ -569,12 +625,19 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
     while (remaining_count) {
         size_t offset_into_block = (current_block_logical_index == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
-        auto block_index = TRY(get_or_allocate_block(current_block_logical_index, num_bytes_to_copy != block_size, allow_cache));
+        bool did_delay_allocation = false;
+        if (allow_cache && can_delay_block_allocation(current_block_logical_index)) {
+            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Delaying allocation of block (index {}, offset_into_block: {})", identifier(), current_block_logical_index, offset_into_block);
+            did_delay_allocation = TRY(write_delayed_block(current_block_logical_index, data.offset(nwritten), num_bytes_to_copy, offset_into_block));
+        }
+        if (!did_delay_allocation) {
+            auto block_index = TRY(get_or_allocate_block(current_block_logical_index, num_bytes_to_copy != block_size, allow_cache));
 
-        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), block_index, offset_into_block);
-        if (auto result = fs().write_block(block_index, data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
-            dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write block {} (index {})", identifier(), block_index, current_block_logical_index);
-            return result.release_error();
+            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), block_index, offset_into_block);
+            if (auto result = fs().write_block(block_index, data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
+                dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write block {} (index {})", identifier(), block_index, current_block_logical_index);
+                return result.release_error();
+            }
         }
         current_block_logical_index = current_block_logical_index.value() + 1;
         remaining_count -= num_bytes_to_copy;
@@ -717,6 +780,193 @@ BlockBasedFileSystem::BlockIndex Ext2FSInode::get_block(BlockBasedFileSystem::Bl
     return (*it).value;
 }
 
+bool Ext2FSInode::can_delay_block_allocation(BlockBasedFileSystem::BlockIndex block_index) const
+{
+    return Kernel::is_regular_file(m_raw_inode.i_mode) && !m_block_list.contains(block_index);
+}
+
+u8* Ext2FSInode::delayed_block_data(BlockBasedFileSystem::BlockIndex block_index) const
+{
+    auto const& delayed = m_delayed_allocation;
+    if (block_index < delayed.first_logical_block || block_index.value() >= delayed.first_logical_block.value() + delayed.block_count)
+        return nullptr;
+    return delayed.buffer->data() + (block_index.value() - delayed.first_logical_block.value()) * fs().logical_block_size();
+}
+
+ErrorOr<bool> Ext2FSInode::write_delayed_block(BlockBasedFileSystem::BlockIndex block_index, UserOrKernelBuffer const& data, size_t count, size_t offset_into_block)
+{
+    VERIFY(m_inode_lock.is_locked());
+    auto& delayed = m_delayed_allocation;
+    auto const block_size = fs().logical_block_size();
+
+    if (!delayed_block_data(block_index)) {
+        bool extends_run = has_delayed_allocation()
+            && block_index.value() == delayed.first_logical_block.value() + delayed.block_count
+            && (delayed.block_count + 1) * block_size <= max_delayed_allocation_size;
+        if (!extends_run) {
+            TRY(flush_delayed_allocation());
+            delayed.first_logical_block = block_index;
+        }
+        if (!TRY(try_grow_delayed_buffer(delayed.block_count + 1))) {
+            // The filesystem already holds as much delayed data as it may, so write ours out as well
+            // and let the caller allocate this block right away.
+            TRY(flush_delayed_allocation());
+            release_delayed_buffer();
+            return false;
+        }
+        auto indirect_block_count = max_indirect_blocks_for_run(delayed.first_logical_block, delayed.block_count + 1);
+        if (auto result = fs().reserve_blocks(1 + indirect_block_count - delayed.reserved_indirect_block_count); result.is_error()) {
+            if (!has_delayed_allocation())
+                release_delayed_buffer();
+            return result.release_error();
+        }
+        delayed.reserved_indirect_block_count = indirect_block_count;
+        ++delayed.block_count;
+        memset(delayed_block_data(block_index), 0, block_size);
+        set_metadata_dirty(true);
+    }
+
+    TRY(data.read(delayed_block_data(block_index) + offset_into_block, count));
+    return true;
+}
+
+ErrorOr<bool> Ext2FSInode::try_grow_delayed_buffer(size_t block_count)
+{
+    auto& delayed = m_delayed_allocation;
+    auto const block_size = fs().logical_block_size();
+    size_t needed_size = block_count * block_size;
+    size_t old_capacity = delayed.buffer ? delayed.buffer->capacity() : 0;
+    if (needed_size <= old_capacity)
+        return true;
+
+    // Grow geometrically, so that appending block by block doesn't copy the run over and over.
+    size_t new_capacity = TRY(Memory::page_round_up(min(max(old_capacity * 2, needed_size), max_delayed_allocation_size)));
+    if (!fs().try_account_delayed_allocation_memory(new_capacity - old_capacity))
+        return false;
+    auto new_buffer_or_error = KBuffer::try_create_with_size("Ext2FSInode: Delayed allocation"sv, new_capacity);
+    if (new_buffer_or_error.is_error()) {
+        fs().unaccount_delayed_allocation_memory(new_capacity - old_capacity);
+        return new_buffer_or_error.release_error();
+    }
+    auto new_buffer = new_buffer_or_error.release_value();
+    if (delayed.buffer)
+        memcpy(new_buffer->data(), delayed.buffer->data(), delayed.block_count * block_size);
+    delayed.buffer = move(new_buffer);
+    return true;
+}
+
+void Ext2FSInode::release_delayed_buffer()
+{
+    auto& delayed = m_delayed_allocation;
+    if (!delayed.buffer)
+        return;
+    fs().unaccount_delayed_allocation_memory(delayed.buffer->capacity());
+    delayed.buffer = nullptr;
+}
+
+ErrorOr<void> Ext2FSInode::flush_delayed_allocation()
+{
+    VERIFY(m_inode_lock.is_locked());
+    auto& delayed = m_delayed_allocation;
+    if (!has_delayed_allocation())
+        return {};
+
+    if (m_block_list.is_empty())
+        m_block_list = TRY(compute_block_list());
+
+    // Try to place the run right behind the block that precedes it in the file.
+    BlockBasedFileSystem::BlockIndex goal = 0;
+    if (delayed.first_logical_block > 0) {
+        if (auto previous_block = get_block(delayed.first_logical_block.value() - 1); previous_block != 0)
+            goal = previous_block.value() + 1;
+    }
+
+    // Everything that can fail without leaving a trace happens before the blocks are allocated. From then on, the run
+    // belongs to the file and is no longer delayed, even if writing it out fails.
+    auto old_block_list = TRY(m_block_list.clone());
+    TRY(m_block_list.try_ensure_capacity(m_block_list.size() + delayed.block_count));
+
+    auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), delayed.block_count, goal, delayed.block_count));
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::flush_delayed_allocation(): Allocated {} block(s) starting at {}", identifier(), blocks.size(), blocks.first());
+
+    for (size_t i = 0; i < blocks.size(); ++i)
+        m_block_list.set(delayed.first_logical_block.value() + i, blocks[i]);
+    auto buffer = move(delayed.buffer);
+    delayed.block_count = 0;
+    set_metadata_dirty(true);
+    ScopeGuard unaccount_buffer = [&] {
+        fs().unaccount_delayed_allocation_memory(buffer->capacity());
+    };
+
+    // flush_block_list() takes the indirect blocks it needs from our reservation, the rest is given back.
+    ScopeGuard unreserve_unused_indirect_blocks = [&] {
+        fs().unreserve_blocks(delayed.reserved_indirect_block_count);
+        delayed.reserved_indirect_block_count = 0;
+    };
+
+    // Write the data before pointing the file at it, but keep the block list consistent either way.
+    ErrorOr<void> write_result {};
+    auto const block_size = fs().logical_block_size();
+    for (size_t i = 0; i < blocks.size();) {
+        size_t run_length = 1;
+        while (i + run_length < blocks.size() && blocks[i + run_length].value() == blocks[i].value() + run_length)
+            ++run_length;
+        auto run_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data() + i * block_size);
+        if (auto result = fs().write_blocks(blocks[i], run_length, run_buffer); result.is_error()) {
+            dbgln("Ext2FSInode[{}]::flush_delayed_allocation(): Failed to write {} block(s) at {}", identifier(), run_length, blocks[i]);
+            write_result = result.release_error();
+            break;
+        }
+        i += run_length;
+    }
+
+    TRY(flush_block_list(old_block_list));
+    return write_result;
+}
+
+size_t Ext2FSInode::max_indirect_blocks_for_run(BlockBasedFileSystem::BlockIndex first_logical_block, size_t block_count) const
+{
+    u64 const entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
+    u64 const begin = first_logical_block.value();
+    u64 const end = begin + block_count;
+
+    // How many of the blocks that each map `span` logical blocks from `base` onwards the run touches.
+    auto blocks_touched = [&](u64 base, u64 limit, u64 span) -> size_t {
+        auto first = max(begin, base);
+        auto last = min(end, limit);
+        if (first >= last)
+            return 0;
+        return (last - 1 - base) / span - (first - base) / span + 1;
+    };
+
+    size_t count = blocks_touched(EXT2_NDIR_BLOCKS, singly_indirect_block_capacity(), entries_per_block);
+    count += blocks_touched(singly_indirect_block_capacity(), doubly_indirect_block_capacity(), entries_per_block * entries_per_block);
+    count += blocks_touched(singly_indirect_block_capacity(), doubly_indirect_block_capacity(), entries_per_block);
+    count += blocks_touched(doubly_indirect_block_capacity(), triply_indirect_block_capacity(), entries_per_block * entries_per_block * entries_per_block);
+    count += blocks_touched(doubly_indirect_block_capacity(), triply_indirect_block_capacity(), entries_per_block * entries_per_block);
+    count += blocks_touched(doubly_indirect_block_capacity(), triply_indirect_block_capacity(), entries_per_block);
+    return count;
+}
+
+void Ext2FSInode::discard_delayed_blocks_from(BlockBasedFileSystem::BlockIndex block_index)
+{
+    auto& delayed = m_delayed_allocation;
+    if (!has_delayed_allocation())
+        return;
+
+    auto first_discarded_block = max(block_index, delayed.first_logical_block);
+    auto end_of_run = delayed.first_logical_block.value() + delayed.block_count;
+    if (first_discarded_block.value() >= end_of_run)
+        return;
+
+    delayed.block_count = first_discarded_block.value() - delayed.first_logical_block.value();
+    auto indirect_block_count = max_indirect_blocks_for_run(delayed.first_logical_block, delayed.block_count);
+    fs().unreserve_blocks(end_of_run - first_discarded_block.value() + delayed.reserved_indirect_block_count - indirect_block_count);
+    delayed.reserved_indirect_block_count = indirect_block_count;
+    if (delayed.block_count == 0)
+        release_delayed_buffer();
+}
+
 ErrorOr<NonnullRefPtr<Inode>> Ext2FSInode::create_child(StringView name, mode_t mode, dev_t dev, UserID uid, GroupID gid)
 {
     if (Kernel::is_directory(mode))
@@ -979,6 +1229,7 @@ ErrorOr<void> Ext2FSInode::truncate_locked(u64 size)
 ErrorOr<int> Ext2FSInode::get_block_address(int index)
 {
     MutexLocker locker(m_inode_lock);
+    TRY(flush_delayed_allocation());
 
     if (m_block_list.is_empty())
         m_block_list = TRY(compute_block_list());
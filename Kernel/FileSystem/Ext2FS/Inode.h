@@ -7,10 +7,12 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
 #include <Kernel/FileSystem/Ext2FS/Definitions.h>
 #include <Kernel/FileSystem/Ext2FS/DirectoryEntry.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Library/KBuffer.h>
 #include <Kernel/UnixTypes.h>
 
 namespace Kernel {
@@ -28,6 +30,8 @@ public:
 private:
     // ^Inode
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const override;
+    virtual ErrorOr<size_t> read_bytes_for_page_cache_locked(off_t, size_t, UserOrKernelBuffer& buffer) const override;
+    virtual ErrorOr<void> read_ahead_locked(off_t, size_t) const override;
     virtual InodeMetadata metadata() const override;
     virtual ErrorOr<void> traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)>) const override;
     virtual ErrorOr<NonnullRefPtr<Inode>> lookup(StringView name) override;
@@ -49,6 +53,7 @@ private:
     BlockBasedFileSystem::BlockIndex get_block(BlockBasedFileSystem::BlockIndex) const;
     ErrorOr<u32> allocate_and_zero_block();
 
+    ErrorOr<size_t> read_bytes_impl(off_t, size_t, UserOrKernelBuffer& buffer, bool allow_cache) const;
     ErrorOr<void> write_directory(Vector<Ext2FSDirectoryEntry>&);
     ErrorOr<void> populate_lookup_cache();
     ErrorOr<void> resize(u64);
@@ -58,6 +63,17 @@ private:
     ErrorOr<void> write_block_pointer(BlockBasedFileSystem::BlockIndex logical_block_index, BlockBasedFileSystem::BlockIndex on_disk_index);
     ErrorOr<void> flush_block_list(Ext2FS::BlockList const& old_block_list);
 
+    bool has_delayed_allocation() const { return m_delayed_allocation.block_count != 0; }
+    bool can_delay_block_allocation(BlockBasedFileSystem::BlockIndex) const;
+    u8* delayed_block_data(BlockBasedFileSystem::BlockIndex) const;
+    // Returns false if the block couldn't be delayed and has to be allocated right away.
+    ErrorOr<bool> write_delayed_block(BlockBasedFileSystem::BlockIndex, UserOrKernelBuffer const&, size_t count, size_t offset_into_block);
+    ErrorOr<bool> try_grow_delayed_buffer(size_t block_count);
+    void release_delayed_buffer();
+    ErrorOr<void> flush_delayed_allocation();
+    void discard_delayed_blocks_from(BlockBasedFileSystem::BlockIndex);
+    size_t max_indirect_blocks_for_run(BlockBasedFileSystem::BlockIndex first_logical_block, size_t block_count) const;
+
     ErrorOr<void> compute_block_list_with_exclusive_locking();
     ErrorOr<Ext2FS::BlockList> compute_block_list() const;
     ErrorOr<Ext2FS::BlockList> compute_block_list_impl(Vector<Ext2FS::BlockIndex>* meta_blocks = nullptr) const;
@@ -86,6 +102,19 @@ private:
     Ext2FSInode(Ext2FS&, InodeIndex);
 
     Ext2FS::BlockList m_block_list;
+
+    // Newly written blocks of a regular file are buffered here with only a reservation against the
+    // free block count, and get their on-disk blocks in one contiguous allocation when flushed.
+    struct DelayedAllocation {
+        BlockBasedFileSystem::BlockIndex first_logical_block { 0 };
+        size_t block_count { 0 };
+        // Mapping the run might need new indirect blocks, so those are reserved too (assuming the worst).
+        // This is also where they're taken from while the run is flushed.
+        size_t reserved_indirect_block_count { 0 };
+        OwnPtr<KBuffer> buffer;
+    };
+    DelayedAllocation m_delayed_allocation;
+
     HashMap<NonnullOwnPtr<KString>, InodeIndex> m_lookup_cache;
     ext2_inode m_raw_inode {};
 
@@ -459,6 +459,23 @@ ErrorOr<size_t> FATInode::read_bytes_locked(off_t offset, size_t size, UserOrKer
     return size;
 }
 
+ErrorOr<void> FATInode::read_ahead_locked(off_t offset, size_t size) const
+{
+    VERIFY(offset >= 0);
+    if (offset >= m_entry.file_size)
+        return {};
+
+    auto block_list = TRY(const_cast<FATInode&>(*this).get_block_list());
+
+    u32 first_block_index = offset / fs().m_device_block_size;
+    u32 last_block_index = (min<u64>(offset + size, m_entry.file_size) - 1) / fs().m_device_block_size;
+    if (first_block_index >= block_list.size())
+        return {};
+    last_block_index = min<u32>(last_block_index, block_list.size() - 1);
+
+    return fs().read_ahead_blocks(block_list.span().slice(first_block_index, last_block_index - first_block_index + 1));
+}
+
 InodeMetadata FATInode::metadata() const
 {
     return {
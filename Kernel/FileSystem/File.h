@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -21,10 +22,44 @@ namespace Kernel {
 
 class File;
 
+// Something that wants to hear about every possible change in readiness of an open file,
+// without a thread blocking on it. This is what EventQueue registrations are built on.
+class FileReadinessObserver : public AtomicRefCounted<FileReadinessObserver> {
+public:
+    virtual ~FileReadinessObserver() = default;
+
+    // Called with the file's blocker set locked, so this must not block or look at the file itself.
+    virtual void readiness_may_have_changed() = 0;
+    virtual void description_will_be_destroyed(OpenFileDescription&) = 0;
+
+private:
+    friend class FileBlockerSet;
+    friend class OpenFileDescription;
+
+    IntrusiveListNode<FileReadinessObserver, RefPtr<FileReadinessObserver>> m_blocker_set_list_node;
+    IntrusiveListNode<FileReadinessObserver, RefPtr<FileReadinessObserver>> m_description_list_node;
+
+public:
+    using BlockerSetList = IntrusiveList<&FileReadinessObserver::m_blocker_set_list_node>;
+    using DescriptionList = IntrusiveList<&FileReadinessObserver::m_description_list_node>;
+};
+
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
     FileBlockerSet() { }
 
+    void add_readiness_observer(FileReadinessObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_readiness_observers.append(observer);
+    }
+
+    void remove_readiness_observer(FileReadinessObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_readiness_observers.remove(observer);
+    }
+
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
@@ -40,7 +75,12 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& observer : m_readiness_observers)
+            observer.readiness_may_have_changed();
     }
+
+private:
+    FileReadinessObserver::BlockerSetList m_readiness_observers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -114,6 +154,8 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_event_queue() const { return false; }
+    virtual bool is_io_ring() const { return false; }
     virtual bool is_mount_file() const { return false; }
     virtual bool is_loop_device() const { return false; }
 
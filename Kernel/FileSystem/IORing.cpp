@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+// Locking order: a watched file's blocker set, then our own blocker set, then m_queues.
+// Readiness notifications arrive with the watched file's blocker set locked, and only ever move
+// requests between our lists. Nothing that looks at a file happens with m_queues held.
+
+static constexpr u32 queue_alignment = 64;
+
+ErrorOr<NonnullRefPtr<IORing>> IORing::try_create(Process& owner, u32 submission_entries)
+{
+    if (submission_entries == 0 || submission_entries > maximum_submission_entries || !is_power_of_two(submission_entries))
+        return EINVAL;
+
+    IORingParameters parameters {};
+    parameters.submission_entries = submission_entries;
+    // Leave room for completions to pile up while userspace keeps the submission queue full.
+    parameters.completion_entries = submission_entries * 2;
+    parameters.submission_queue_offset = align_up_to(sizeof(IORingControl), queue_alignment);
+    parameters.completion_queue_offset = align_up_to(parameters.submission_queue_offset + submission_entries * sizeof(IORingSubmission), queue_alignment);
+    parameters.mapping_size = TRY(Memory::page_round_up(parameters.completion_queue_offset + parameters.completion_entries * sizeof(IORingCompletion)));
+
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(parameters.mapping_size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, parameters.mapping_size, "IORing"sv, Memory::Region::Access::ReadWrite));
+
+    auto& control = *reinterpret_cast<IORingControl*>(region->vaddr().as_ptr());
+    control.submission_entries = parameters.submission_entries;
+    control.completion_entries = parameters.completion_entries;
+
+    return adopt_nonnull_ref_or_enomem(new (nothrow) IORing(owner.pid(), move(vmobject), move(region), parameters));
+}
+
+IORing::IORing(ProcessID owner_pid, NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region, IORingParameters const& parameters)
+    : m_owner_pid(owner_pid)
+    , m_vmobject(move(vmobject))
+    , m_region(move(region))
+    , m_parameters(parameters)
+{
+}
+
+IORing::~IORing()
+{
+    (void)close();
+}
+
+bool IORing::is_owned_by(Process const& process) const
+{
+    return process.pid() == m_owner_pid;
+}
+
+bool IORing::can_read(OpenFileDescription const&, u64) const
+{
+    return m_queues.with([](auto& queues) {
+        return !queues.ready.is_empty() || !queues.finished.is_empty();
+    });
+}
+
+ErrorOr<void> IORing::close()
+{
+    Vector<NonnullRefPtr<Request>> requests;
+    bool was_closed = m_queues.with([&](auto& queues) {
+        if (m_closed.exchange(true))
+            return true;
+        auto take_all = [&](RequestList& list) {
+            while (auto request = list.take_first())
+                requests.append(request.release_nonnull());
+        };
+        take_all(queues.waiting);
+        take_all(queues.ready);
+        take_all(queues.blocking);
+        take_all(queues.finished);
+        return false;
+    });
+    if (was_closed)
+        return {};
+
+    for (auto& request : requests) {
+        if (request->m_is_watching_description)
+            request->m_description->blocker_set().remove_readiness_observer(*request);
+    }
+
+    // Let the worker notice that it's no longer needed.
+    m_worker_wait_queue.wake_all();
+    return {};
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> IORing::vmobject_for_mmap(Process&, Memory::VirtualRange const& range, u64& offset, bool shared)
+{
+    if (!shared || offset != 0 || range.size() > m_parameters.mapping_size)
+        return EINVAL;
+    return m_vmobject;
+}
+
+ErrorOr<NonnullOwnPtr<KString>> IORing::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::formatted("IORing:({})", m_parameters.submission_entries);
+}
+
+u32 IORing::unconsumed_completions() const
+{
+    return m_completion_tail - AK::atomic_load(&control().completion_head, AK::memory_order_acquire);
+}
+
+ErrorOr<u32> IORing::submit(Process& process, u32 count)
+{
+    VERIFY(is_owned_by(process));
+
+    auto tail = AK::atomic_load(&control().submission_tail, AK::memory_order_acquire);
+    auto available = tail - m_submission_head;
+    if (available > m_parameters.submission_entries)
+        return EINVAL;
+    count = min(count, available);
+
+    u32 submitted = 0;
+    while (submitted < count) {
+        // Every request ends up as a completion, don't take on more than the completion queue can ever hold.
+        if (m_requests_in_flight >= m_parameters.completion_entries) {
+            if (submitted == 0)
+                return EBUSY;
+            break;
+        }
+
+        // Take a private copy first, so userspace can't change the submission while we're looking at it.
+        IORingSubmission submission;
+        memcpy(&submission, &submission_queue()[m_submission_head & (m_parameters.submission_entries - 1)], sizeof(submission));
+        AK::atomic_signal_fence(AK::memory_order_acq_rel);
+
+        auto request_or_error = adopt_nonnull_ref_or_enomem(new (nothrow) Request(*this, submission));
+        if (request_or_error.is_error()) {
+            if (submitted == 0)
+                return request_or_error.release_error();
+            break;
+        }
+        auto request = request_or_error.release_value();
+
+        ++m_submission_head;
+        ++m_requests_in_flight;
+        ++submitted;
+
+        if (auto result = prepare_request(process, *request); result.is_error()) {
+            finish(*request, result.release_error());
+            continue;
+        }
+        enqueue(*request);
+    }
+
+    AK::atomic_store(&control().submission_head, m_submission_head, AK::memory_order_release);
+    return submitted;
+}
+
+ErrorOr<void> IORing::prepare_request(Process& process, Request& request)
+{
+    auto const& submission = request.m_submission;
+    TRY(process.require_promise(Pledge::stdio));
+
+    switch (submission.operation) {
+    case IORingOperation::Nop:
+        request.m_result = 0;
+        return {};
+    case IORingOperation::Open: {
+        auto path = TRY(Process::get_syscall_path_argument(Userspace<char const*>(submission.address), submission.length));
+        request.m_result = TRY(process.do_open(submission.fd, path->view(), submission.operation_flags, submission.mode));
+        return {};
+    }
+    case IORingOperation::Read:
+    case IORingOperation::Write:
+    case IORingOperation::Accept:
+    case IORingOperation::Recv:
+    case IORingOperation::Send:
+    case IORingOperation::Fsync:
+        break;
+    default:
+        return EINVAL;
+    }
+
+    auto description = TRY(process.open_file_description(submission.fd));
+    // Rings and event queues notify their watchers themselves, watching them could go around in circles.
+    if (description->is_io_ring() || description->is_event_queue())
+        return EINVAL;
+
+    bool is_reading = submission.operation == IORingOperation::Read || submission.operation == IORingOperation::Recv || submission.operation == IORingOperation::Accept;
+    bool is_writing = submission.operation == IORingOperation::Write || submission.operation == IORingOperation::Send;
+    if (is_reading && !description->is_readable())
+        return EBADF;
+    if (is_writing && !description->is_writable())
+        return EBADF;
+    if (submission.operation == IORingOperation::Read && description->is_directory())
+        return EISDIR;
+
+    switch (submission.operation) {
+    case IORingOperation::Accept:
+        TRY(process.require_promise(Pledge::accept));
+        [[fallthrough]];
+    case IORingOperation::Recv:
+    case IORingOperation::Send:
+        if (!description->is_socket())
+            return ENOTSOCK;
+        break;
+    default:
+        break;
+    }
+
+    if (submission.offset != IORING_CURRENT_OFFSET) {
+        if (!description->file().is_seekable())
+            return ESPIPE;
+        if (submission.offset > static_cast<u64>(NumericLimits<off_t>::max()))
+            return EINVAL;
+    }
+    if (submission.length > static_cast<u32>(NumericLimits<i32>::max()))
+        return EINVAL;
+
+    request.m_description = description;
+
+    if (submission.operation != IORingOperation::Fsync && !description->file().is_inode() && !description->file().is_block_device()) {
+        request.m_kind = Request::Kind::Pollable;
+        return {};
+    }
+
+    request.m_kind = Request::Kind::Blocking;
+    if (submission.operation == IORingOperation::Read || submission.operation == IORingOperation::Write) {
+        auto length = min<size_t>(submission.length, maximum_blocking_transfer_size);
+        if (length > 0) {
+            request.m_bounce_buffer = TRY(KBuffer::try_create_with_size("IORing: Transfer buffer"sv, length));
+            if (submission.operation == IORingOperation::Write)
+                TRY(copy_from_user(request.m_bounce_buffer->data(), reinterpret_cast<void const*>(submission.address), length));
+        }
+    }
+    TRY(ensure_worker());
+    return {};
+}
+
+void IORing::enqueue(Request& request)
+{
+    switch (request.m_kind) {
+    case Request::Kind::Immediate:
+        finish(request, static_cast<size_t>(request.m_result));
+        return;
+    case Request::Kind::Pollable:
+        // Whether the description is ready already gets checked next time we post completions.
+        request.m_is_watching_description = true;
+        request.m_description->blocker_set().add_readiness_observer(request);
+        if (!append_unless_closed(request, &Queues::ready)) {
+            stop_watching_description(request);
+            return;
+        }
+        evaluate_block_conditions();
+        return;
+    case Request::Kind::Blocking:
+        if (append_unless_closed(request, &Queues::blocking))
+            m_worker_wait_queue.wake_one();
+        return;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+bool IORing::append_unless_closed(Request& request, RequestList Queues::*list)
+{
+    return m_queues.with([&](auto& queues) {
+        if (m_closed)
+            return false;
+        (queues.*list).append(request);
+        return true;
+    });
+}
+
+void IORing::stop_watching_description(Request& request)
+{
+    if (!request.m_is_watching_description)
+        return;
+    request.m_description->blocker_set().remove_readiness_observer(request);
+    request.m_is_watching_description = false;
+}
+
+void IORing::finish(Request& request, ErrorOr<size_t> result)
+{
+    if (result.is_error())
+        request.m_result = -static_cast<i32>(result.error().code());
+    else
+        request.m_result = static_cast<i32>(result.value());
+
+    if (append_unless_closed(request, &Queues::finished))
+        evaluate_block_conditions();
+}
+
+void IORing::wait_for_readiness(Request& request)
+{
+    enum class Outcome {
+        Waiting,
+        Retry,
+        Closed,
+    };
+    auto outcome = m_queues.with([&](auto& queues) {
+        if (m_closed)
+            return Outcome::Closed;
+        if (request.m_may_be_ready) {
+            request.m_may_be_ready = false;
+            queues.ready.append(request);
+            return Outcome::Retry;
+        }
+        queues.waiting.append(request);
+        return Outcome::Waiting;
+    });
+    if (outcome == Outcome::Retry)
+        evaluate_block_conditions();
+    else if (outcome == Outcome::Closed)
+        stop_watching_description(request);
+}
+
+void IORing::request_may_be_ready(Request& request)
+{
+    bool did_become_ready = m_queues.with([&](auto& queues) {
+        if (!queues.waiting.contains(request)) {
+            // It's either queued up already, or being carried out right now.
+            request.m_may_be_ready = true;
+            return false;
+        }
+        queues.waiting.remove(request);
+        queues.ready.append(request);
+        return true;
+    });
+    if (did_become_ready)
+        evaluate_block_conditions();
+}
+
+u32 IORing::post_completions(Process& process)
+{
+    VERIFY(is_owned_by(process));
+
+    // Only go through the requests that are ready right now; anything that turns out to still
+    // be ready after being carried out is picked up again next time around.
+    RequestList ready;
+    m_queues.with([&](auto& queues) {
+        while (auto request = queues.ready.take_first()) {
+            request->m_may_be_ready = false;
+            ready.append(*request);
+        }
+    });
+    while (auto request = ready.take_first()) {
+        auto result = perform_pollable_request(process, *request);
+        if (result.is_error() && result.error().code() == EAGAIN) {
+            wait_for_readiness(*request);
+            continue;
+        }
+        stop_watching_description(*request);
+        finish(*request, move(result));
+    }
+
+    auto completion_head = AK::atomic_load(&control().completion_head, AK::memory_order_acquire);
+    u32 posted = 0;
+    while (m_completion_tail - completion_head < m_parameters.completion_entries) {
+        auto request = m_queues.with([](auto& queues) { return queues.finished.take_first(); });
+        if (!request)
+            break;
+
+        // Reads from the disk were made into a kernel buffer, as the worker can't see our memory.
+        if (request->m_submission.operation == IORingOperation::Read && request->m_bounce_buffer && request->m_result > 0) {
+            if (copy_to_user(reinterpret_cast<void*>(request->m_submission.address), request->m_bounce_buffer->data(), request->m_result).is_error())
+                request->m_result = -EFAULT;
+        }
+
+        auto& completion = completion_queue()[m_completion_tail & (m_parameters.completion_entries - 1)];
+        completion.user_data = request->m_submission.user_data;
+        completion.result = request->m_result;
+        completion.flags = 0;
+        ++m_completion_tail;
+        --m_requests_in_flight;
+        ++posted;
+    }
+    if (posted > 0)
+        AK::atomic_store(&control().completion_tail, m_completion_tail, AK::memory_order_release);
+    return posted;
+}
+
+ErrorOr<size_t> IORing::perform_pollable_request(Process& process, Request& request)
+{
+    auto const& submission = request.m_submission;
+    auto& description = *request.m_description;
+
+    bool is_reading = submission.operation != IORingOperation::Write && submission.operation != IORingOperation::Send;
+    if (is_reading ? !description.can_read() : !description.can_write())
+        return EAGAIN;
+
+    if (submission.operation == IORingOperation::Accept)
+        return perform_accept(process, request);
+
+    auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(submission.address), submission.length));
+
+    // Sockets may block in read() and write() depending on the description, so ask them not to.
+    if (description.is_socket()) {
+        auto& socket = *description.socket();
+        int flags = (submission.operation == IORingOperation::Recv || submission.operation == IORingOperation::Send) ? submission.operation_flags : 0;
+        if (is_reading) {
+            if (socket.is_shut_down_for_reading())
+                return 0;
+            UnixDateTime timestamp {};
+            return socket.recvfrom(description, buffer, submission.length, flags | MSG_DONTWAIT, {}, {}, timestamp, false);
+        }
+        return socket.sendto(description, buffer, submission.length, flags | MSG_DONTWAIT, {}, 0);
+    }
+
+    if (submission.operation == IORingOperation::Read) {
+        if (submission.offset != IORING_CURRENT_OFFSET)
+            return description.read(buffer, submission.offset, submission.length);
+        return description.read(buffer, submission.length);
+    }
+    if (submission.offset != IORING_CURRENT_OFFSET)
+        return description.write(submission.offset, buffer, submission.length);
+    return description.write(buffer, submission.length);
+}
+
+ErrorOr<size_t> IORing::perform_accept(Process& process, Request& request)
+{
+    auto& socket = *request.m_description->socket();
+    auto fd_allocation = TRY(process.allocate_fd());
+
+    auto accepted_socket = socket.accept();
+    if (!accepted_socket)
+        return EAGAIN;
+
+    auto accepted_socket_description = TRY(OpenFileDescription::try_create(*accepted_socket));
+    accepted_socket_description->set_readable(true);
+    accepted_socket_description->set_writable(true);
+    if (request.m_submission.operation_flags & SOCK_NONBLOCK)
+        accepted_socket_description->set_blocking(false);
+    int fd_flags = 0;
+    if (request.m_submission.operation_flags & SOCK_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    process.fds().with_exclusive([&](auto& fds) {
+        fds[fd_allocation.fd].set(move(accepted_socket_description), fd_flags);
+    });
+
+    // NOTE: Moving this state to Completed is what causes connect() to unblock on the client side.
+    accepted_socket->set_setup_state(Socket::SetupState::Completed);
+    return fd_allocation.fd;
+}
+
+ErrorOr<size_t> IORing::perform_blocking_request(Request& request)
+{
+    auto const& submission = request.m_submission;
+    auto& description = *request.m_description;
+
+    if (submission.operation == IORingOperation::Fsync) {
+        TRY(description.sync());
+        return 0;
+    }
+
+    if (!request.m_bounce_buffer)
+        return 0;
+    auto buffer = request.m_bounce_buffer->as_kernel_buffer();
+    auto length = request.m_bounce_buffer->size();
+
+    if (submission.operation == IORingOperation::Read) {
+        if (submission.offset != IORING_CURRENT_OFFSET)
+            return description.read(buffer, submission.offset, length);
+        return description.read(buffer, length);
+    }
+
+    if (submission.offset != IORING_CURRENT_OFFSET)
+        return description.write(submission.offset, buffer, length);
+    if (description.should_append())
+        TRY(description.seek(0, SEEK_END));
+    return description.write(buffer, length);
+}
+
+ErrorOr<void> IORing::ensure_worker()
+{
+    MutexLocker locker(m_worker_lock);
+    if (m_has_worker)
+        return {};
+    (void)TRY(Process::create_kernel_process("IORing Worker"sv, [ring = NonnullRefPtr(*this)] {
+        ring->worker_loop();
+    }));
+    m_has_worker = true;
+    return {};
+}
+
+void IORing::worker_loop()
+{
+    for (;;) {
+        auto request = m_queues.with([](auto& queues) { return queues.blocking.take_first(); });
+        if (!request) {
+            if (m_closed)
+                return;
+            m_worker_wait_queue.wait_forever("IORing"sv);
+            continue;
+        }
+
+        dbgln_if(IO_DEBUG, "IORing: Worker carrying out operation {} on fd {}", to_underlying(request->m_submission.operation), request->m_submission.fd);
+        auto result = perform_blocking_request(*request);
+        finish(*request, move(result));
+    }
+}
+
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/IntrusiveList.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Tasks/WaitQueue.h>
+
+namespace Kernel {
+
+// A pair of submission and completion queues shared with userspace, in the style of io_uring.
+//
+// Operations are carried out in one of three ways:
+// - Open and Nop complete right away while the submissions are being consumed.
+// - Operations on files that can be waited on (sockets, pipes, devices) wait for the file to become
+//   ready without occupying any thread, and are then carried out by the owning process the next
+//   time it enters the ring.
+// - Reads, writes and syncs of regular files may block on the disk, so they go to a worker thread
+//   that belongs to the ring, going through a kernel buffer since it can't see the process' memory.
+//
+// Completions are only ever posted from within io_ring_enter(), in the context of the owning process.
+// The ring's file descriptor is readable while there are completions waiting to be posted.
+class IORing final : public File {
+public:
+    static constexpr u32 maximum_submission_entries = 4096;
+    // Disk I/O goes through a kernel buffer, so a single operation moves at most this much.
+    static constexpr size_t maximum_blocking_transfer_size = 1 * MiB;
+
+    static ErrorOr<NonnullRefPtr<IORing>> try_create(Process& owner, u32 submission_entries);
+    virtual ~IORing() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "IORing"sv; }
+    virtual bool is_io_ring() const override { return true; }
+
+    IORingParameters const& parameters() const { return m_parameters; }
+
+    // Buffer addresses in submissions refer to the address space of the process that set up the ring.
+    bool is_owned_by(Process const&) const;
+
+    // Consumes up to `count` submissions. Returns how many were consumed.
+    ErrorOr<u32> submit(Process&, u32 count);
+
+    // Carries out operations whose files became ready and posts everything that has finished
+    // to the completion queue. Never blocks. Returns how many completions were posted.
+    u32 post_completions(Process&);
+
+    // How many completions userspace hasn't consumed yet.
+    u32 unconsumed_completions() const;
+
+private:
+    IORing(ProcessID owner_pid, NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>, IORingParameters const&);
+
+    class Request final : public FileReadinessObserver {
+    public:
+        enum class Kind {
+            Immediate,
+            Pollable,
+            Blocking,
+        };
+
+        Request(IORing& ring, IORingSubmission const& submission)
+            : m_ring(ring)
+            , m_submission(submission)
+        {
+        }
+
+        virtual void readiness_may_have_changed() override { m_ring.request_may_be_ready(*this); }
+        virtual void description_will_be_destroyed(OpenFileDescription&) override { }
+
+        IORing& m_ring;
+        IORingSubmission const m_submission;
+        Kind m_kind { Kind::Immediate };
+        RefPtr<OpenFileDescription> m_description;
+        OwnPtr<KBuffer> m_bounce_buffer;
+        bool m_is_watching_description { false };
+        // Set when a readiness change arrives while the request is being carried out. Guarded by m_queues.
+        bool m_may_be_ready { false };
+        i32 m_result { 0 };
+
+        IntrusiveListNode<Request, RefPtr<Request>> m_list_node;
+    };
+
+    using RequestList = IntrusiveList<&Request::m_list_node>;
+
+    struct Queues {
+        // Waiting for their description to become ready.
+        RequestList waiting;
+        // Their description may be ready, look at them next time we post completions.
+        RequestList ready;
+        // Waiting for the worker thread.
+        RequestList blocking;
+        // Done, waiting to be posted.
+        RequestList finished;
+    };
+
+    IORingControl& control() { return *reinterpret_cast<IORingControl*>(m_region->vaddr().as_ptr()); }
+    IORingControl const& control() const { return *reinterpret_cast<IORingControl const*>(m_region->vaddr().as_ptr()); }
+    IORingSubmission const* submission_queue() const { return reinterpret_cast<IORingSubmission const*>(m_region->vaddr().offset(m_parameters.submission_queue_offset).as_ptr()); }
+    IORingCompletion* completion_queue() { return reinterpret_cast<IORingCompletion*>(m_region->vaddr().offset(m_parameters.completion_queue_offset).as_ptr()); }
+
+    ErrorOr<void> prepare_request(Process&, Request&);
+    void enqueue(Request&);
+    void finish(Request&, ErrorOr<size_t>);
+    // Returns false if the ring has been closed, in which case the request is dropped instead.
+    bool append_unless_closed(Request&, RequestList Queues::*);
+    void wait_for_readiness(Request&);
+    void stop_watching_description(Request&);
+    void request_may_be_ready(Request&);
+
+    ErrorOr<size_t> perform_pollable_request(Process&, Request&);
+    ErrorOr<size_t> perform_blocking_request(Request&);
+    ErrorOr<size_t> perform_accept(Process&, Request&);
+
+    ErrorOr<void> ensure_worker();
+    void worker_loop();
+
+    ProcessID const m_owner_pid;
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Memory::Region> m_region;
+    IORingParameters const m_parameters;
+
+    // Our own copies of the indices we produce, since userspace can scribble over the shared ones.
+    // Only touched by the owning process from within io_ring_enter(), with its big lock held.
+    u32 m_submission_head { 0 };
+    u32 m_completion_tail { 0 };
+    u32 m_requests_in_flight { 0 };
+
+    SpinlockProtected<Queues, LockRank::None> m_queues {};
+    Atomic<bool> m_closed { false };
+
+    Mutex m_worker_lock { "IORing worker"sv };
+    bool m_has_worker { false };
+    WaitQueue m_worker_wait_queue;
+};
+
+}
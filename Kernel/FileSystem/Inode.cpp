@@ -15,7 +15,9 @@
 #include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/FileSystem/VFSRootContext.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Library/KBuffer.h>
 #include <Kernel/Library/KBufferBuilder.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Tasks/Process.h>
@@ -92,13 +94,19 @@ void Inode::will_be_destroyed()
 ErrorOr<void> Inode::truncate(u64 size)
 {
     MutexLocker locker(m_inode_lock);
-    return truncate_locked(size);
+    TRY(truncate_locked(size));
+    update_page_cache_after_truncate_locked(size);
+    return {};
 }
 
 ErrorOr<size_t> Inode::write_bytes(off_t offset, size_t length, UserOrKernelBuffer const& target_buffer, OpenFileDescription* open_description)
 {
     MutexLocker locker(m_inode_lock);
-    return prepare_and_write_bytes_locked(offset, length, target_buffer, open_description);
+    auto nwritten = TRY(prepare_and_write_bytes_locked(offset, length, target_buffer, open_description));
+    // NOTE: Direct writes have to keep the page cache up to date as well, as other descriptions may be reading through it.
+    if (nwritten > 0 && uses_page_cache(metadata(), nullptr))
+        update_page_cache_after_write_locked(offset, nwritten, target_buffer);
+    return nwritten;
 }
 
 ErrorOr<size_t> Inode::prepare_and_write_bytes_locked(off_t offset, size_t length, UserOrKernelBuffer const& target_buffer, OpenFileDescription* open_description)
@@ -110,10 +118,139 @@ ErrorOr<size_t> Inode::prepare_and_write_bytes_locked(off_t offset, size_t lengt
 
 ErrorOr<size_t> Inode::read_bytes(off_t offset, size_t length, UserOrKernelBuffer& buffer, OpenFileDescription* open_description) const
 {
+    // NOTE: Some filesystems lock the inode exclusively to put the metadata together, so we look at it before locking.
+    if (auto inode_metadata = metadata(); uses_page_cache(inode_metadata, open_description)) {
+        MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+        return read_bytes_through_page_cache_locked(offset, length, buffer, inode_metadata.size);
+    }
     MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
     return read_bytes_locked(offset, length, buffer, open_description);
 }
 
+ErrorOr<void> Inode::read_ahead(off_t offset, size_t length) const
+{
+    auto inode_metadata = metadata();
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    if (!uses_page_cache(inode_metadata, nullptr))
+        return read_ahead_locked(offset, length);
+
+    auto end_offset = min(static_cast<u64>(offset) + length, static_cast<u64>(inode_metadata.size));
+    if (static_cast<u64>(offset) >= end_offset)
+        return {};
+    auto scratch_buffer = TRY(KBuffer::try_create_with_size("Inode: Page cache read-ahead"sv, PAGE_SIZE));
+    for (size_t page_index = offset / PAGE_SIZE; page_index <= (end_offset - 1) / PAGE_SIZE; ++page_index)
+        TRY(ensure_page_cached_locked(page_index, scratch_buffer->bytes()));
+    return {};
+}
+
+bool Inode::uses_page_cache(InodeMetadata const& inode_metadata, OpenFileDescription const* open_description) const
+{
+    // Only data that lives on a disk is worth caching, everything else is either in memory already
+    // or can change behind our back.
+    if (!fs().is_file_backed() || !inode_metadata.is_regular_file())
+        return false;
+    return !open_description || !open_description->is_direct();
+}
+
+ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> Inode::ensure_page_cached_locked(size_t page_index, Bytes scratch_buffer) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(scratch_buffer.size() == PAGE_SIZE);
+
+    if (auto page = m_page_cache.find(page_index))
+        return page.release_nonnull();
+
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(scratch_buffer.data());
+    auto nread = TRY(read_bytes_for_page_cache_locked(page_index * PAGE_SIZE, PAGE_SIZE, buffer));
+    // Whatever is past the end of the file has to read as zeroes, both to read() and to mmap().
+    if (nread < PAGE_SIZE)
+        memset(scratch_buffer.data() + nread, 0, PAGE_SIZE - nread);
+
+    auto page = TRY(MM.allocate_physical_page(Memory::MemoryManager::ShouldZeroFill::No));
+    MM.copy_to_physical_page(*page, 0, scratch_buffer);
+    return m_page_cache.add(page_index, move(page));
+}
+
+ErrorOr<size_t> Inode::read_bytes_through_page_cache_locked(off_t offset, size_t length, UserOrKernelBuffer& buffer, u64 file_size) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+
+    if (static_cast<u64>(offset) >= file_size)
+        return 0;
+    auto remaining_length = min(static_cast<u64>(length), file_size - offset);
+
+    // NOTE: A page is too much to put on the kernel stack.
+    auto page_buffer = TRY(KBuffer::try_create_with_size("Inode: Page cache read"sv, PAGE_SIZE));
+    size_t nread = 0;
+    while (remaining_length > 0) {
+        auto position = offset + nread;
+        auto offset_in_page = position % PAGE_SIZE;
+        auto chunk_length = min(PAGE_SIZE - offset_in_page, remaining_length);
+
+        auto page = TRY(ensure_page_cached_locked(position / PAGE_SIZE, page_buffer->bytes()));
+        // NOTE: We can't copy straight out of the quickmapped page, as writing to the buffer may fault.
+        MM.copy_from_physical_page(*page, offset_in_page, page_buffer->bytes().trim(chunk_length));
+        TRY(buffer.write(page_buffer->data(), nread, chunk_length));
+
+        nread += chunk_length;
+        remaining_length -= chunk_length;
+    }
+    return nread;
+}
+
+void Inode::update_page_cache_after_write_locked(off_t offset, size_t length, UserOrKernelBuffer const& data)
+{
+    VERIFY(m_inode_lock.is_locked());
+
+    OwnPtr<KBuffer> chunk_buffer;
+    size_t nupdated = 0;
+    while (nupdated < length) {
+        auto position = offset + nupdated;
+        auto page_index = position / PAGE_SIZE;
+        auto offset_in_page = position % PAGE_SIZE;
+        auto chunk_length = min(PAGE_SIZE - offset_in_page, length - nupdated);
+
+        if (auto page = m_page_cache.find(page_index)) {
+            if (!chunk_buffer) {
+                if (auto buffer_or_error = KBuffer::try_create_with_size("Inode: Page cache update"sv, PAGE_SIZE); !buffer_or_error.is_error())
+                    chunk_buffer = buffer_or_error.release_value();
+            }
+            if (!chunk_buffer || data.read(chunk_buffer->data(), nupdated, chunk_length).is_error()) {
+                // The data made it to the filesystem, but we can't get at it from here. Let the page be read in again.
+                m_page_cache.remove(page_index);
+            } else {
+                MM.copy_to_physical_page(*page, offset_in_page, chunk_buffer->bytes().trim(chunk_length));
+            }
+        }
+        nupdated += chunk_length;
+    }
+}
+
+void Inode::update_page_cache_after_truncate_locked(u64 size)
+{
+    VERIFY(m_inode_lock.is_locked());
+
+    m_page_cache.remove_pages_from(ceil_div(size, static_cast<u64>(PAGE_SIZE)));
+
+    // The part of the last page past the new end of the file has to read as zeroes if the file grows again.
+    auto offset_in_last_page = size % PAGE_SIZE;
+    if (offset_in_last_page == 0)
+        return;
+    if (auto page = m_page_cache.find(size / PAGE_SIZE))
+        MM.zero_fill_physical_page(*page, offset_in_last_page, PAGE_SIZE - offset_in_last_page);
+}
+
+ErrorOr<RefPtr<Memory::PhysicalRAMPage>> Inode::page_cache_page(size_t page_index) const
+{
+    auto inode_metadata = metadata();
+    if (!uses_page_cache(inode_metadata, nullptr) || static_cast<u64>(page_index) * PAGE_SIZE >= static_cast<u64>(inode_metadata.size))
+        return nullptr;
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    auto scratch_buffer = TRY(KBuffer::try_create_with_size("Inode: Page cache fill"sv, PAGE_SIZE));
+    return TRY(ensure_page_cached_locked(page_index, scratch_buffer->bytes()));
+}
+
 ErrorOr<size_t> Inode::read_until_filled_or_end(off_t offset, size_t length, UserOrKernelBuffer buffer, OpenFileDescription* open_description) const
 {
     auto remaining_length = length;
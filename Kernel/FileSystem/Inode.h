@@ -16,6 +16,7 @@
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/InodeIdentifier.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/InodePageCache.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/ListedRefCounted.h>
 #include <Kernel/Library/LockWeakPtr.h>
@@ -56,6 +57,7 @@ public:
     ErrorOr<size_t> write_bytes(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*);
     ErrorOr<size_t> read_bytes(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const;
     ErrorOr<size_t> read_until_filled_or_end(off_t, size_t, UserOrKernelBuffer buffer, OpenFileDescription*) const;
+    ErrorOr<void> read_ahead(off_t, size_t) const;
     ErrorOr<void> truncate(u64);
 
     virtual ErrorOr<void> attach(OpenFileDescription&) { return {}; }
@@ -93,6 +95,10 @@ public:
     ErrorOr<void> set_shared_vmobject(Memory::SharedInodeVMObject&);
     LockRefPtr<Memory::SharedInodeVMObject> shared_vmobject() const;
 
+    // Returns the page cache's copy of the given page of the file, reading it in if needed,
+    // or null if this inode's data doesn't go through the page cache or the page is past the end of the file.
+    ErrorOr<RefPtr<Memory::PhysicalRAMPage>> page_cache_page(size_t page_index) const;
+
     static void sync_all();
     void sync();
 
@@ -125,14 +131,26 @@ protected:
 
     virtual ErrorOr<size_t> write_bytes_locked(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*) = 0;
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const = 0;
+    // Reads data that is about to be put in the page cache. Filesystems that keep a cache of their own
+    // should bypass it here, so that file data doesn't end up in memory twice.
+    virtual ErrorOr<size_t> read_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer) const { return read_bytes_locked(offset, count, buffer, nullptr); }
+    // Pulls the given range into the filesystem's caches without copying it anywhere. This is only a hint.
+    virtual ErrorOr<void> read_ahead_locked(off_t, size_t) const { return {}; }
     virtual ErrorOr<void> truncate_locked(u64) { return {}; }
 
 private:
+    bool uses_page_cache(InodeMetadata const&, OpenFileDescription const*) const;
+    ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> ensure_page_cached_locked(size_t page_index, Bytes scratch_buffer) const;
+    ErrorOr<size_t> read_bytes_through_page_cache_locked(off_t, size_t, UserOrKernelBuffer& buffer, u64 file_size) const;
+    void update_page_cache_after_write_locked(off_t, size_t, UserOrKernelBuffer const& data);
+    void update_page_cache_after_truncate_locked(u64 size);
+
     ErrorOr<bool> try_apply_flock(Process const&, OpenFileDescription const&, flock const&);
 
     FileSystem& m_file_system;
     InodeIndex m_index { 0 };
     LockWeakPtr<Memory::SharedInodeVMObject> m_shared_vmobject;
+    mutable InodePageCache m_page_cache;
     LockWeakPtr<LocalSocket> m_bound_socket;
     SpinlockProtected<HashTable<InodeWatcher*>, LockRank::None> m_watchers {};
     bool m_metadata_dirty { false };
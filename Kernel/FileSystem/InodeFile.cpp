@@ -15,6 +15,7 @@
 #include <Kernel/Memory/PrivateInodeVMObject.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel {
 
@@ -34,6 +35,14 @@ ErrorOr<size_t> InodeFile::read(OpenFileDescription& description, u64 offset, Us
     if (nread > 0) {
         Thread::current()->did_file_read(nread);
         evaluate_block_conditions();
+        if (!description.is_direct()) {
+            if (auto window = description.update_read_ahead_window(offset, nread); window.has_value()) {
+                // NOTE: Read-ahead is only a hint, so we don't care if we fail to queue it.
+                (void)g_read_ahead_work->try_queue([inode = m_inode, window = window.release_value()] {
+                    (void)inode->read_ahead(window.offset, window.size);
+                });
+            }
+        }
     }
     return nread;
 }
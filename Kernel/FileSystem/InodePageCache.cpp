@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Singleton.h>
+#include <Kernel/FileSystem/InodePageCache.h>
+
+namespace Kernel {
+
+static Singleton<SpinlockProtected<InodePageCache::List, LockRank::None>> s_all_page_caches;
+
+Atomic<size_t> InodePageCache::s_cached_page_count { 0 };
+
+InodePageCache::InodePageCache()
+{
+    s_all_page_caches->with([&](auto& list) { list.append(*this); });
+}
+
+InodePageCache::~InodePageCache()
+{
+    s_all_page_caches->with([&](auto& list) { list.remove(*this); });
+
+    ReleaseList released;
+    m_entries.with([&](auto& entries) {
+        for (auto& entry : entries)
+            released.append(entry);
+        entries.clear();
+    });
+    destroy_entries(released);
+}
+
+RefPtr<Memory::PhysicalRAMPage> InodePageCache::find(u64 page_index)
+{
+    return m_entries.with([&](auto& entries) -> RefPtr<Memory::PhysicalRAMPage> {
+        auto* entry = entries.find(page_index);
+        if (!entry)
+            return nullptr;
+        entry->recently_used = true;
+        return entry->page;
+    });
+}
+
+ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> InodePageCache::add(u64 page_index, NonnullRefPtr<Memory::PhysicalRAMPage> page)
+{
+    auto* new_entry = new (nothrow) Entry(move(page));
+    if (!new_entry)
+        return ENOMEM;
+
+    Entry* existing_entry = nullptr;
+    auto cached_page = m_entries.with([&](auto& entries) -> NonnullRefPtr<Memory::PhysicalRAMPage> {
+        existing_entry = entries.find(page_index);
+        if (existing_entry) {
+            existing_entry->recently_used = true;
+            return *existing_entry->page;
+        }
+        entries.insert(page_index, *new_entry);
+        return *new_entry->page;
+    });
+
+    if (existing_entry)
+        delete new_entry;
+    else
+        s_cached_page_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    return cached_page;
+}
+
+void InodePageCache::remove(u64 page_index)
+{
+    auto* entry = m_entries.with([&](auto& entries) -> Entry* {
+        auto* entry = entries.find(page_index);
+        if (entry)
+            entries.remove(page_index);
+        return entry;
+    });
+    if (!entry)
+        return;
+    s_cached_page_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+    delete entry;
+}
+
+void InodePageCache::remove_pages_from(u64 first_page_index)
+{
+    ReleaseList released;
+    m_entries.with([&](auto& entries) {
+        auto* first_entry = entries.find_smallest_not_below(first_page_index);
+        if (!first_entry)
+            return;
+        for (auto it = entries.begin_from(*first_entry); it != entries.end(); ++it)
+            released.append(*it);
+        for (auto& entry : released)
+            entries.remove(entry.m_tree_node.key());
+    });
+    destroy_entries(released);
+}
+
+size_t InodePageCache::take_unused_pages(size_t count, TakeRecentlyUsed take_recently_used, ReleaseList& released)
+{
+    ReleaseList taken;
+    size_t taken_count = 0;
+    m_entries.with([&](auto& entries) {
+        for (auto& entry : entries) {
+            if (taken_count == count)
+                break;
+            // Someone is still using this page, most likely a shared mapping of the file.
+            if (entry.page->ref_count() > 1)
+                continue;
+            if (entry.recently_used && take_recently_used == TakeRecentlyUsed::No) {
+                entry.recently_used = false;
+                continue;
+            }
+            taken.append(entry);
+            ++taken_count;
+        }
+        for (auto& entry : taken)
+            entries.remove(entry.m_tree_node.key());
+    });
+    while (auto* entry = taken.take_first())
+        released.append(*entry);
+    return taken_count;
+}
+
+size_t InodePageCache::release_unused_pages(size_t count, TakeRecentlyUsed may_take_recently_used)
+{
+    ReleasedEntries released;
+    return release_unused_pages(count, released, may_take_recently_used);
+}
+
+size_t InodePageCache::release_unused_pages(size_t count, ReleasedEntries& released_entries, TakeRecentlyUsed may_take_recently_used)
+{
+    ReleaseList released;
+    size_t released_count = 0;
+
+    s_all_page_caches->with([&](auto& list) {
+        // Go easy on pages that were used recently first, and only take those if we have to.
+        for (auto take_recently_used : Array { TakeRecentlyUsed::No, TakeRecentlyUsed::Yes }) {
+            if (take_recently_used == TakeRecentlyUsed::Yes && may_take_recently_used == TakeRecentlyUsed::No)
+                return;
+            for (auto& page_cache : list) {
+                if (released_count == count)
+                    return;
+                released_count += page_cache.take_unused_pages(count - released_count, take_recently_used, released);
+            }
+        }
+    });
+
+    // Nobody else holds a reference to these pages, so this hands them straight back to the MemoryManager.
+    while (auto* entry = released.take_first()) {
+        entry->page = nullptr;
+        released_entries.m_entries.append(*entry);
+    }
+    return released_count;
+}
+
+void InodePageCache::destroy_entries(ReleaseList& released)
+{
+    while (auto* entry = released.take_first()) {
+        s_cached_page_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+        delete entry;
+    }
+}
+
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/IntrusiveList.h>
+#include <AK/IntrusiveRedBlackTree.h>
+#include <AK/Noncopyable.h>
+#include <AK/RefPtr.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Memory/PhysicalRAMPage.h>
+
+namespace Kernel {
+
+// The pages of a file's contents, indexed by their page index within the file.
+//
+// This is the one copy of a file's data that read(), write() and shared mappings of the file
+// all work with: SharedInodeVMObject maps these very pages, so a write() is immediately visible
+// through mmap() and vice versa. Writes go through to the filesystem right away, so the only
+// pages that can differ from what is on disk are the ones dirtied through a shared mapping,
+// and those are kept alive by the VMObject until it has synced them.
+//
+// Pages nobody else references are given back to the MemoryManager when it runs low on memory.
+class InodePageCache {
+    AK_MAKE_NONCOPYABLE(InodePageCache);
+    AK_MAKE_NONMOVABLE(InodePageCache);
+
+public:
+    InodePageCache();
+    ~InodePageCache();
+
+    RefPtr<Memory::PhysicalRAMPage> find(u64 page_index);
+
+    // Caches the page unless someone else got there first. Returns the page that ends up cached.
+    ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> add(u64 page_index, NonnullRefPtr<Memory::PhysicalRAMPage>);
+
+    void remove(u64 page_index);
+    void remove_pages_from(u64 first_page_index);
+
+    enum class TakeRecentlyUsed {
+        No,
+        Yes,
+    };
+
+    class ReleasedEntries;
+
+    // Gives up to `count` unreferenced pages of all inodes back to the MemoryManager.
+    // Pages that were used recently are only taken if there's nothing else, and only if allowed to.
+    // Returns how many pages were released.
+    static size_t release_unused_pages(size_t count, TakeRecentlyUsed = TakeRecentlyUsed::Yes);
+
+    // Same as above, but only the pages are freed right away. The cache's own bookkeeping is freed when
+    // `released` goes out of scope, so this can be called with the MemoryManager's lock held: kmalloc takes
+    // that lock while holding its own when it expands the heap, so nothing may be kfree()'d under it.
+    static size_t release_unused_pages(size_t count, ReleasedEntries& released, TakeRecentlyUsed = TakeRecentlyUsed::Yes);
+
+    static size_t cached_page_count() { return s_cached_page_count.load(AK::MemoryOrder::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        explicit Entry(NonnullRefPtr<Memory::PhysicalRAMPage> page)
+            : page(move(page))
+        {
+        }
+
+        // Only null once the entry was released, and is waiting to be freed.
+        RefPtr<Memory::PhysicalRAMPage> page;
+        // Set on every lookup, cleared by reclaim. Pages that were used since the last
+        // time reclaim looked at them are only taken if nothing else can be found.
+        bool recently_used { true };
+
+        IntrusiveRedBlackTreeNode<u64, Entry, RawPtr<Entry>> m_tree_node;
+        IntrusiveListNode<Entry> m_release_list_node;
+    };
+
+    using EntryTree = IntrusiveRedBlackTree<&Entry::m_tree_node>;
+    using ReleaseList = IntrusiveList<&Entry::m_release_list_node>;
+
+    // Moves up to `count` pages out of the cache and onto `released`. Must not free anything, as this
+    // runs with spinlocks held that the MemoryManager may need.
+    size_t take_unused_pages(size_t count, TakeRecentlyUsed, ReleaseList& released);
+
+    static void destroy_entries(ReleaseList&);
+
+    // NOTE: Entries are allocated and freed (and thereby pages freed) only with this lock released,
+    //       since the MemoryManager takes it while reclaiming pages.
+    SpinlockProtected<EntryTree, LockRank::None> m_entries {};
+
+    IntrusiveListNode<InodePageCache> m_list_node;
+
+    static Atomic<size_t> s_cached_page_count;
+
+public:
+    using List = IntrusiveList<&InodePageCache::m_list_node>;
+
+    class ReleasedEntries {
+        AK_MAKE_NONCOPYABLE(ReleasedEntries);
+        AK_MAKE_NONMOVABLE(ReleasedEntries);
+
+    public:
+        ReleasedEntries() = default;
+        ~ReleasedEntries() { destroy_entries(m_entries); }
+
+    private:
+        friend class InodePageCache;
+
+        ReleaseList m_entries;
+    };
+};
+
+}
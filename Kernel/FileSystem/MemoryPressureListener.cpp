@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/FileSystem/MemoryPressureListener.h>
+#include <Kernel/Library/KString.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Tasks/ReclaimTask.h>
+
+namespace Kernel {
+
+static Singleton<SpinlockProtected<MemoryPressureListener::List, LockRank::None>> s_all_listeners;
+
+ErrorOr<NonnullRefPtr<MemoryPressureListener>> MemoryPressureListener::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) MemoryPressureListener);
+}
+
+MemoryPressureListener::MemoryPressureListener()
+{
+    s_all_listeners->with([&](auto& list) { list.append(*this); });
+}
+
+MemoryPressureListener::~MemoryPressureListener()
+{
+    s_all_listeners->with([&](auto& list) { list.remove(*this); });
+}
+
+void MemoryPressureListener::notify_pressure_level_changed()
+{
+    // NOTE: A listener that is being destroyed can't get past removing itself from the list while we hold it.
+    s_all_listeners->with([&](auto& list) {
+        for (auto& listener : list)
+            listener.evaluate_block_conditions();
+    });
+}
+
+bool MemoryPressureListener::can_read(OpenFileDescription const&, u64) const
+{
+    return m_reported_level.load(AK::MemoryOrder::memory_order_relaxed) != ReclaimTask::pressure_level();
+}
+
+ErrorOr<size_t> MemoryPressureListener::read(OpenFileDescription&, u64, UserOrKernelBuffer& buffer, size_t size)
+{
+    if (size < sizeof(MemoryPressureEvent))
+        return EINVAL;
+
+    auto level = ReclaimTask::pressure_level();
+    // can_read will catch the blocking case.
+    if (m_reported_level.load(AK::MemoryOrder::memory_order_relaxed) == level)
+        return EAGAIN;
+
+    MemoryPressureEvent event {
+        .level = level,
+        .reserved = 0,
+        .available_bytes = static_cast<u64>(MM.get_system_memory_info().physical_pages_uncommitted) * PAGE_SIZE,
+    };
+    TRY(buffer.write(&event, sizeof(event)));
+    m_reported_level.store(level, AK::MemoryOrder::memory_order_relaxed);
+    return sizeof(event);
+}
+
+ErrorOr<NonnullOwnPtr<KString>> MemoryPressureListener::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::try_create("MemoryPressureListener"sv);
+}
+
+}
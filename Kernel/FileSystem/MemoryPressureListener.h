@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/IntrusiveList.h>
+#include <Kernel/API/MemoryPressure.h>
+#include <Kernel/FileSystem/File.h>
+
+namespace Kernel {
+
+// Becomes readable whenever the memory pressure level differs from what was last read from it.
+// Reading gives a single MemoryPressureEvent describing the current state, so changes that happen
+// in quick succession are coalesced.
+class MemoryPressureListener final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<MemoryPressureListener>> try_create();
+    virtual ~MemoryPressureListener() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
+    // Can't write to a memory pressure listener.
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return true; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EIO; }
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "MemoryPressureListener"sv; }
+
+    // Called by the ReclaimTask.
+    static void notify_pressure_level_changed();
+
+private:
+    MemoryPressureListener();
+
+    // Starts out as Normal, so a listener created while under pressure is readable right away.
+    Atomic<MemoryPressureLevel> m_reported_level { MemoryPressureLevel::Normal };
+
+    IntrusiveListNode<MemoryPressureListener> m_list_node;
+
+public:
+    using List = IntrusiveList<&MemoryPressureListener::m_list_node>;
+};
+
+}
@@ -11,8 +11,10 @@
 #include <Kernel/Devices/TTY/MasterPTY.h>
 #include <Kernel/Devices/TTY/TTY.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/EventQueue.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/InodeFile.h>
+#include <Kernel/FileSystem/IORing.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
 #include <Kernel/FileSystem/MountFile.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
@@ -53,6 +55,13 @@ OpenFileDescription::OpenFileDescription(File& file)
 
 OpenFileDescription::~OpenFileDescription()
 {
+    for (;;) {
+        auto observer = m_readiness_observers.with([](auto& observers) { return observers.take_first(); });
+        if (!observer)
+            break;
+        observer->description_will_be_destroyed(*this);
+    }
+
     m_file->detach(*this);
     // FIXME: Should this error path be observed somehow?
     (void)m_file->close();
@@ -313,6 +322,30 @@ InodeWatcher* OpenFileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool OpenFileDescription::is_event_queue() const
+{
+    return m_file->is_event_queue();
+}
+
+EventQueue* OpenFileDescription::event_queue()
+{
+    if (!is_event_queue())
+        return nullptr;
+    return static_cast<EventQueue*>(m_file.ptr());
+}
+
+bool OpenFileDescription::is_io_ring() const
+{
+    return m_file->is_io_ring();
+}
+
+IORing* OpenFileDescription::io_ring()
+{
+    if (!is_io_ring())
+        return nullptr;
+    return static_cast<IORing*>(m_file.ptr());
+}
+
 bool OpenFileDescription::is_mount_file() const
 {
     return m_file->is_mount_file();
@@ -450,6 +483,16 @@ FileBlockerSet& OpenFileDescription::blocker_set()
     return m_file->blocker_set();
 }
 
+void OpenFileDescription::add_readiness_observer(FileReadinessObserver& observer)
+{
+    m_readiness_observers.with([&](auto& observers) { observers.append(observer); });
+}
+
+void OpenFileDescription::remove_readiness_observer(FileReadinessObserver& observer)
+{
+    m_readiness_observers.with([&](auto& observers) { observers.remove(observer); });
+}
+
 ErrorOr<void> OpenFileDescription::apply_flock(Process const& process, Userspace<flock const*> lock, ShouldBlock should_block)
 {
     if (!m_inode)
@@ -498,6 +541,38 @@ bool OpenFileDescription::is_direct() const
     return m_state.with([](auto& state) { return state.direct; });
 }
 
+static constexpr size_t minimum_read_ahead_window_size = 16 * KiB;
+static constexpr size_t maximum_read_ahead_window_size = 256 * KiB;
+
+Optional<OpenFileDescription::ReadAheadWindow> OpenFileDescription::update_read_ahead_window(u64 offset, size_t count)
+{
+    // This loosely follows the Linux read-ahead heuristics: the first sequential read opens a window a few
+    // times larger than the request, and every time the reader gets halfway into the current window, the
+    // next one is issued at twice the size.
+    return m_state.with([&](auto& state) -> Optional<ReadAheadWindow> {
+        bool is_sequential = offset == state.next_sequential_read_offset;
+        state.next_sequential_read_offset = offset + count;
+
+        if (!is_sequential) {
+            state.read_ahead_window_size = 0;
+            return {};
+        }
+
+        if (state.read_ahead_window_size == 0) {
+            state.read_ahead_window_offset = offset + count;
+            state.read_ahead_window_size = clamp(count * 4, minimum_read_ahead_window_size, maximum_read_ahead_window_size);
+            return ReadAheadWindow { state.read_ahead_window_offset, state.read_ahead_window_size };
+        }
+
+        if (offset + count < state.read_ahead_window_offset + state.read_ahead_window_size / 2)
+            return {};
+
+        state.read_ahead_window_offset += state.read_ahead_window_size;
+        state.read_ahead_window_size = min(state.read_ahead_window_size * 2, maximum_read_ahead_window_size);
+        return ReadAheadWindow { state.read_ahead_window_offset, state.read_ahead_window_size };
+    });
+}
+
 bool OpenFileDescription::is_directory() const
 {
     return m_state.with([](auto& state) { return state.is_directory; });
@@ -63,6 +63,14 @@ public:
 
     bool is_direct() const;
 
+    struct ReadAheadWindow {
+        u64 offset { 0 };
+        size_t size { 0 };
+    };
+
+    // Records a completed read and returns the range that should be read ahead, if any.
+    Optional<ReadAheadWindow> update_read_ahead_window(u64 offset, size_t count);
+
     bool is_directory() const;
 
     File& file() { return *m_file; }
@@ -80,6 +88,12 @@ public:
     InodeWatcher const* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_event_queue() const;
+    EventQueue* event_queue();
+
+    bool is_io_ring() const;
+    IORing* io_ring();
+
     bool is_mount_file() const;
     MountFile const* mount_file() const;
     MountFile* mount_file();
@@ -129,6 +143,9 @@ public:
 
     FileBlockerSet& blocker_set();
 
+    void add_readiness_observer(FileReadinessObserver&);
+    void remove_readiness_observer(FileReadinessObserver&);
+
     ErrorOr<void> apply_flock(Process const&, Userspace<flock const*>, ShouldBlock);
     ErrorOr<void> get_flock(Userspace<flock*>) const;
 
@@ -157,8 +174,14 @@ private:
         bool should_append : 1 { false };
         bool direct : 1 { false };
         FIFO::Direction fifo_direction : 2 { FIFO::Direction::Neither };
+
+        // Sequential access detection for read-ahead.
+        u64 next_sequential_read_offset { 0 };
+        u64 read_ahead_window_offset { 0 };
+        size_t read_ahead_window_size { 0 };
     };
 
     SpinlockProtected<State, LockRank::None> m_state {};
+    SpinlockProtected<FileReadinessObserver::DescriptionList, LockRank::None> m_readiness_observers {};
 };
 }
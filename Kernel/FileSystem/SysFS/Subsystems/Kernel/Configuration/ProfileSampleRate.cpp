@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/ProfileSampleRate.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSProfileSampleRate::SysFSProfileSampleRate(SysFSDirectory const& parent_directory)
+    : SysFSSystemStringVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSProfileSampleRate> SysFSProfileSampleRate::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSProfileSampleRate(parent_directory)).release_nonnull();
+}
+
+ErrorOr<NonnullOwnPtr<KString>> SysFSProfileSampleRate::value() const
+{
+    return KString::formatted("{}", TimeManagement::the().profile_sample_rate());
+}
+
+void SysFSProfileSampleRate::set_value(NonnullOwnPtr<KString> new_value)
+{
+    // NOTE: Values that aren't a sample rate we can use are ignored, just like writes of anything else to these variables.
+    auto sample_rate = new_value->view().to_number<u32>();
+    if (!sample_rate.has_value())
+        return;
+    (void)TimeManagement::the().set_profile_sample_rate(sample_rate.value());
+}
+
+mode_t SysFSProfileSampleRate::permissions() const
+{
+    // NOTE: Sampling faster slows down the whole system, so only root gets to change this.
+    return S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+}
+
+}
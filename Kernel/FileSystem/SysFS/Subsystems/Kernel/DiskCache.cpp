@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DiskCache.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSDiskCache::SysFSDiskCache(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSDiskCache> SysFSDiskCache::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSDiskCache(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSDiskCache::try_generate(KBufferBuilder& builder)
+{
+    auto& statistics = BlockBasedFileSystem::disk_cache_statistics();
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("hits"sv, statistics.hits.load()));
+    TRY(json.add("misses"sv, statistics.misses.load()));
+    TRY(json.add("ghost_hits"sv, statistics.ghost_hits.load()));
+    TRY(json.add("evictions"sv, statistics.evictions.load()));
+    TRY(json.add("writebacks"sv, statistics.writebacks.load()));
+    TRY(json.add("read_ahead_blocks"sv, statistics.read_ahead_blocks.load()));
+    TRY(json.add("grow_count"sv, statistics.grow_count.load()));
+    TRY(json.add("shrink_count"sv, statistics.shrink_count.load()));
+    TRY(json.add("cached_blocks"sv, statistics.cached_blocks.load()));
+    TRY(json.add("cached_bytes"sv, statistics.cached_bytes.load()));
+    TRY(json.finish());
+    return {};
+}
+
+}
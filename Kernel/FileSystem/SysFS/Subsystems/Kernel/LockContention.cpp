@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/LockContention.h>
+#include <Kernel/Locking/LockContention.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSLockContention::SysFSLockContention(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSLockContention> SysFSLockContention::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSLockContention(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSLockContention::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    TRY(LockContention::for_each_lock([&](auto const& statistics) -> ErrorOr<void> {
+        auto obj = TRY(array.add_object());
+        TRY(obj.add("name"sv, statistics.name()));
+        TRY(obj.add("spun"sv, statistics.spun));
+        TRY(obj.add("blocked"sv, statistics.blocked));
+        TRY(obj.add("total_blocked_time_us"sv, statistics.total_blocked_time_us));
+        TRY(obj.add("maximum_blocked_time_us"sv, statistics.maximum_blocked_time_us));
+        TRY(obj.finish());
+        return {};
+    }));
+    TRY(array.finish());
+    return {};
+}
+
+}
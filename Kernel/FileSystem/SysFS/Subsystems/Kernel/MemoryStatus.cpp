@@ -8,6 +8,7 @@
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/MemoryStatus.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Sections.h>
+#include <Kernel/Tasks/ReclaimTask.h>
 
 namespace Kernel {
 
@@ -35,8 +36,24 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_available"sv, system_memory.physical_pages - system_memory.physical_pages_used));
     TRY(json.add("physical_committed"sv, system_memory.physical_pages_committed));
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
+    TRY(json.add("physical_reclaimed"sv, ReclaimTask::reclaimed_page_count()));
+    TRY(json.add("memory_pressure_level"sv, to_underlying(ReclaimTask::pressure_level())));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    {
+        auto caches = TRY(json.add_array("kmalloc_caches"sv));
+        for (auto const& cache : stats.caches) {
+            auto cache_object = TRY(caches.add_object());
+            TRY(cache_object.add("object_size"sv, cache.object_size));
+            TRY(cache_object.add("allocations"sv, cache.allocations));
+            TRY(cache_object.add("frees"sv, cache.frees));
+            TRY(cache_object.add("refills"sv, cache.refills));
+            TRY(cache_object.add("drains"sv, cache.drains));
+            TRY(cache_object.add("cached_objects"sv, cache.cached_objects));
+            TRY(cache_object.finish());
+        }
+        TRY(caches.finish());
+    }
     TRY(json.finish());
     return {};
 }
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/PerformanceEventStream.h>
+#include <Kernel/Library/KBufferBuilder.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PerformanceEventBuffer.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSPerformanceEventStream::SysFSPerformanceEventStream(SysFSDirectory const& parent_directory)
+    : SysFSComponent(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSPerformanceEventStream> SysFSPerformanceEventStream::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSPerformanceEventStream(parent_directory)).release_nonnull();
+}
+
+ErrorOr<size_t> SysFSPerformanceEventStream::read_bytes(off_t, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription*) const
+{
+    if (!g_global_perf_events)
+        return ENOENT;
+
+    auto builder = TRY(KBufferBuilder::try_create());
+    // NOTE: Staying within the builder's initial capacity saves it from having to grow.
+    TRY(g_global_perf_events->consume_as_json_lines(builder, min(count, static_cast<size_t>(4 * MiB))));
+    auto bytes = builder.bytes().trim(builder.length());
+    TRY(buffer.write(bytes));
+    return bytes.size();
+}
+
+mode_t SysFSPerformanceEventStream::permissions() const
+{
+    return S_IRUSR;
+}
+
+}
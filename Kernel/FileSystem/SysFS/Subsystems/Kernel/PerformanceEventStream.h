@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Component.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+// Hands out the events of `profile -a` as they come in, one JSON object per line.
+// Every read consumes what it returns, and returns nothing if no new events are available.
+class SysFSPerformanceEventStream final : public SysFSComponent {
+public:
+    virtual StringView name() const override { return "perf_stream"sv; }
+
+    static NonnullRefPtr<SysFSPerformanceEventStream> must_create(SysFSDirectory const& parent_directory);
+
+    virtual ErrorOr<size_t> read_bytes(off_t, size_t, UserOrKernelBuffer&, OpenFileDescription*) const override;
+
+private:
+    virtual mode_t permissions() const override;
+
+    explicit SysFSPerformanceEventStream(SysFSDirectory const& parent_directory);
+};
+
+}
@@ -23,6 +23,7 @@ class Device;
 class DeviceControlDevice;
 class DiskCache;
 class DoubleBuffer;
+class EventQueue;
 class File;
 class FATInode;
 class OpenFileDescription;
@@ -30,6 +31,7 @@ class DisplayConnector;
 class FileSystem;
 class FutexQueue;
 class HostnameContext;
+class IORing;
 class IPv4Socket;
 class Inode;
 class InodeIdentifier;
@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -412,7 +413,7 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[KMALLOC_CACHE_COUNT] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
@@ -425,6 +426,94 @@ static size_t g_kfree_call_count;
 static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
+// Every processor keeps a magazine of free objects for each slab size, so that most small
+// allocations and frees don't need to take s_lock. Magazines are refilled from and drained
+// to the slabheaps in batches of half their capacity.
+struct KmallocMagazine {
+    static constexpr size_t capacity = 32;
+    static constexpr size_t batch_size = capacity / 2;
+
+    size_t count { 0 };
+    void* objects[capacity];
+
+    size_t allocations { 0 };
+    size_t frees { 0 };
+    size_t refills { 0 };
+    size_t drains { 0 };
+};
+
+static KmallocMagazine s_magazines[MAX_CPU_COUNT][KMALLOC_CACHE_COUNT];
+
+static Optional<size_t> magazine_index_for(size_t size)
+{
+    for (size_t i = 0; i < KMALLOC_CACHE_COUNT; ++i) {
+        if (size <= g_kmalloc_global->slabheaps[i].slab_size())
+            return i;
+    }
+    return {};
+}
+
+static void* allocate_from_magazine(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+#ifdef HAS_ADDRESS_SANITIZER
+    // The slabheaps keep the shadow memory up to date, so let them see every allocation.
+    return nullptr;
+#endif
+    auto index = magazine_index_for(size);
+    if (!index.has_value())
+        return nullptr;
+    auto& slabheap = g_kmalloc_global->slabheaps[*index];
+    if (alignment > slabheap.slab_size())
+        return nullptr;
+
+    InterruptDisabler disabler;
+    auto& magazine = s_magazines[Processor::current_id()][*index];
+    if (magazine.count == 0) {
+        SpinlockLocker lock(s_lock);
+        while (magazine.count < KmallocMagazine::batch_size) {
+            auto* ptr = slabheap.allocate(slabheap.slab_size(), CallerWillInitializeMemory::Yes);
+            if (!ptr)
+                break;
+            magazine.objects[magazine.count++] = ptr;
+        }
+        if (magazine.count == 0)
+            return nullptr;
+        ++magazine.refills;
+    }
+
+    auto* ptr = magazine.objects[--magazine.count];
+    ++magazine.allocations;
+    if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, KMALLOC_SCRUB_BYTE, slabheap.slab_size());
+    return ptr;
+}
+
+static bool deallocate_to_magazine(void* ptr, size_t size)
+{
+#ifdef HAS_ADDRESS_SANITIZER
+    return false;
+#endif
+    auto index = magazine_index_for(size);
+    if (!index.has_value())
+        return false;
+    auto& slabheap = g_kmalloc_global->slabheaps[*index];
+    VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+    memset(ptr, KFREE_SCRUB_BYTE, slabheap.slab_size());
+
+    InterruptDisabler disabler;
+    auto& magazine = s_magazines[Processor::current_id()][*index];
+    if (magazine.count == KmallocMagazine::capacity) {
+        SpinlockLocker lock(s_lock);
+        for (size_t i = 0; i < KmallocMagazine::batch_size; ++i)
+            slabheap.deallocate(magazine.objects[--magazine.count]);
+        ++magazine.drains;
+    }
+
+    magazine.objects[magazine.count++] = ptr;
+    ++magazine.frees;
+    return true;
+}
+
 void kmalloc_enable_expand()
 {
     g_kmalloc_global->enable_expansion();
@@ -439,6 +528,14 @@ UNMAP_AFTER_INIT void kmalloc_init()
     s_lock.initialize();
 }
 
+static Thread* current_thread_for_accounting()
+{
+    Thread* current_thread = Thread::current();
+    if (!current_thread)
+        current_thread = Processor::idle_thread();
+    return current_thread;
+}
+
 static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
 {
     // Catch bad callers allocating under spinlock.
@@ -449,20 +546,20 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
+    void* ptr = g_dump_kmalloc_stacks ? nullptr : allocate_from_magazine(size, alignment, caller_will_initialize_memory);
+    if (!ptr) {
+        SpinlockLocker lock(s_lock);
+        ++g_kmalloc_call_count;
 
-    if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available.was_set()) {
-        dbgln("kmalloc({})", size);
-        Kernel::dump_backtrace();
-    }
+        if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available.was_set()) {
+            dbgln("kmalloc({})", size);
+            Kernel::dump_backtrace();
+        }
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    }
 
-    Thread* current_thread = Thread::current();
-    if (!current_thread)
-        current_thread = Processor::idle_thread();
-    if (current_thread) {
+    if (auto* current_thread = current_thread_for_accounting()) {
         // FIXME: By the time we check this, we have already allocated above.
         //        This means that in the case of an infinite recursion, we can't catch it this way.
         VERIFY(current_thread->is_allocation_enabled());
@@ -500,18 +597,24 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
+    // Frees of profiled threads take the locked path below, which guards against
+    // recursing into kfree_sized() while recording the perf event.
+    auto* current_thread = current_thread_for_accounting();
+    bool is_profiled = current_thread && !current_thread->is_profiling_suppressed() && (g_profiling_all_threads || current_thread->process().is_profiling());
+    if (!is_profiled) {
+        if (current_thread)
+            VERIFY(current_thread->is_allocation_enabled());
+        if (deallocate_to_magazine(ptr, size))
+            return;
+    }
+
     SpinlockLocker lock(s_lock);
     ++g_kfree_call_count;
     ++g_nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
-        Thread* current_thread = Thread::current();
-        if (!current_thread)
-            current_thread = Processor::idle_thread();
-        if (current_thread) {
-            VERIFY(current_thread->is_allocation_enabled());
-            PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
-        }
+    if (g_nested_kfree_calls == 1 && current_thread) {
+        VERIFY(current_thread->is_allocation_enabled());
+        PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
     }
 
     g_kmalloc_global->deallocate(ptr, size);
@@ -604,4 +707,25 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_free = g_kmalloc_global->free_bytes();
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+
+    // The magazines belong to their processors, so these are only a snapshot.
+    for (size_t i = 0; i < KMALLOC_CACHE_COUNT; ++i) {
+        auto& cache = stats.caches[i];
+        cache = {};
+        cache.object_size = g_kmalloc_global->slabheaps[i].slab_size();
+        for (auto const& magazines : s_magazines) {
+            auto const& magazine = magazines[i];
+            cache.allocations += AK::atomic_load(&magazine.allocations, AK::MemoryOrder::memory_order_relaxed);
+            cache.frees += AK::atomic_load(&magazine.frees, AK::MemoryOrder::memory_order_relaxed);
+            cache.refills += AK::atomic_load(&magazine.refills, AK::MemoryOrder::memory_order_relaxed);
+            cache.drains += AK::atomic_load(&magazine.drains, AK::MemoryOrder::memory_order_relaxed);
+            cache.cached_objects += AK::atomic_load(&magazine.count, AK::MemoryOrder::memory_order_relaxed);
+        }
+        // Objects cached in magazines are free as far as the callers are concerned.
+        auto cached_bytes = cache.cached_objects * cache.object_size;
+        stats.bytes_allocated -= min(cached_bytes, stats.bytes_allocated);
+        stats.bytes_free += cached_bytes;
+        stats.kmalloc_call_count += cache.allocations;
+        stats.kfree_call_count += cache.frees;
+    }
 }
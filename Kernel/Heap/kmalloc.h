@@ -47,11 +47,24 @@ void kmalloc_init();
 
 void kfree_sized(void*, size_t);
 
+// One cache per slab size, each with a small magazine of free objects per processor.
+static constexpr size_t KMALLOC_CACHE_COUNT = 6;
+
+struct kmalloc_cache_stats {
+    size_t object_size;
+    size_t allocations;    // Allocations served straight from a magazine.
+    size_t frees;          // Frees that went straight into a magazine.
+    size_t refills;        // Batches taken from the global heap.
+    size_t drains;         // Batches given back to the global heap.
+    size_t cached_objects; // Free objects currently sitting in magazines.
+};
+
 struct kmalloc_stats {
     size_t bytes_allocated;
     size_t bytes_free;
     size_t kmalloc_call_count;
     size_t kfree_call_count;
+    kmalloc_cache_stats caches[KMALLOC_CACHE_COUNT];
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
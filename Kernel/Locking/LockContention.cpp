@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <Kernel/Locking/LockContention.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// Locks are told apart by name only, so this comfortably fits every named Mutex in the kernel.
+// Anything beyond that is accounted to the last slot.
+static constexpr size_t lock_contention_table_size = 256;
+static constexpr StringView overflow_name = "(other)"sv;
+static constexpr StringView unnamed_name = "(unnamed)"sv;
+
+static SpinlockProtected<Array<LockContention::Statistics, lock_contention_table_size>, LockRank::None> s_statistics {};
+
+static void set_name(LockContention::Statistics& statistics, StringView name)
+{
+    name = name.substring_view(0, min(name.length(), LockContention::maximum_name_length));
+    __builtin_memcpy(statistics.name_characters, name.characters_without_null_termination(), name.length());
+    statistics.name_length = static_cast<u8>(name.length());
+}
+
+static LockContention::Statistics& find_or_add(Array<LockContention::Statistics, lock_contention_table_size>& table, StringView name)
+{
+    if (name.is_empty())
+        name = unnamed_name;
+    name = name.substring_view(0, min(name.length(), LockContention::maximum_name_length));
+
+    // Open addressing over all but the last slot, which is reserved for overflow.
+    constexpr size_t probe_slots = lock_contention_table_size - 1;
+    auto start = name.hash() % probe_slots;
+    for (size_t i = 0; i < probe_slots; ++i) {
+        auto& statistics = table[(start + i) % probe_slots];
+        if (statistics.name_length == 0) {
+            set_name(statistics, name);
+            return statistics;
+        }
+        if (statistics.name() == name)
+            return statistics;
+    }
+
+    auto& overflow = table[probe_slots];
+    if (overflow.name_length == 0)
+        set_name(overflow, overflow_name);
+    return overflow;
+}
+
+void LockContention::record(StringView lock_name, Resolution resolution, u64 blocked_time_us)
+{
+    s_statistics.with([&](auto& table) {
+        auto& statistics = find_or_add(table, lock_name);
+        switch (resolution) {
+        case Resolution::Spun:
+            ++statistics.spun;
+            break;
+        case Resolution::Blocked:
+            ++statistics.blocked;
+            statistics.total_blocked_time_us += blocked_time_us;
+            statistics.maximum_blocked_time_us = max(statistics.maximum_blocked_time_us, blocked_time_us);
+            break;
+        }
+    });
+}
+
+ErrorOr<void> LockContention::for_each_lock(Function<ErrorOr<void>(Statistics const&)> callback)
+{
+    // Copy one entry at a time, so that the callback runs without the lock held.
+    for (size_t i = 0; i < lock_contention_table_size; ++i) {
+        auto statistics = s_statistics.with([&](auto& table) { return table[i]; });
+        if (statistics.name_length != 0)
+            TRY(callback(statistics));
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// How often Mutexes had to wait for another thread, aggregated by the name of the Mutex.
+// Only the contended path records anything, so uncontended locking stays as cheap as before.
+class LockContention {
+public:
+    static constexpr size_t maximum_name_length = 47;
+
+    enum class Resolution {
+        // The holder let go while we were spinning on it.
+        Spun,
+        // We had to go to sleep until the lock was handed to us.
+        Blocked,
+    };
+
+    struct Statistics {
+        StringView name() const { return { name_characters, name_length }; }
+
+        char name_characters[maximum_name_length];
+        u8 name_length { 0 };
+        u64 spun { 0 };
+        u64 blocked { 0 };
+        u64 total_blocked_time_us { 0 };
+        u64 maximum_blocked_time_us { 0 };
+    };
+
+    static void record(StringView lock_name, Resolution, u64 blocked_time_us = 0);
+
+    static ErrorOr<void> for_each_lock(Function<ErrorOr<void>(Statistics const&)>);
+};
+
+}
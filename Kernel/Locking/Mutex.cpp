@@ -8,10 +8,12 @@
 #include <AK/SetOnce.h>
 #include <Kernel/Debug.h>
 #include <Kernel/KSyms.h>
+#include <Kernel/Locking/LockContention.h>
 #include <Kernel/Locking/LockLocation.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Tasks/Thread.h>
+#include <Kernel/Time/TimeManagement.h>
 
 extern SetOnce g_not_in_early_boot;
 
@@ -31,6 +33,11 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
     auto* current_thread = Thread::current();
 
     SpinlockLocker lock(m_lock);
+    if (m_mode == Mode::Exclusive && m_holder != bit_cast<uintptr_t>(current_thread)) {
+        if (spin_while_holder_is_running(lock))
+            LockContention::record(m_name, LockContention::Resolution::Spun);
+    }
+
     bool did_block = false;
     Mode current_mode = m_mode;
     switch (current_mode) {
@@ -227,10 +234,20 @@ void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock<Loc
             append_to_list(lists.list_for_mode(mode));
     });
 
+    // There is no clock to ask this early on, but there is no contention either.
+    Optional<MonotonicTime> block_start;
+    if (TimeManagement::is_initialized())
+        block_start = TimeManagement::the().monotonic_time();
+
     dbgln_if(LOCK_TRACE_DEBUG, "Mutex::lock @ {} ({}) waiting...", this, m_name);
     current_thread.block(*this, lock, requested_locks);
     dbgln_if(LOCK_TRACE_DEBUG, "Mutex::lock @ {} ({}) waited", this, m_name);
 
+    u64 blocked_time_us = 0;
+    if (block_start.has_value())
+        blocked_time_us = max<i64>(0, (TimeManagement::the().monotonic_time() - block_start.value()).to_microseconds());
+    LockContention::record(m_name, LockContention::Resolution::Blocked, blocked_time_us);
+
     m_blocked_thread_lists.with([&](auto& lists) {
         auto remove_from_list = [&]<typename L>(L& list) {
             VERIFY(list.contains(current_thread));
@@ -244,6 +261,32 @@ void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock<Loc
     });
 }
 
+bool Mutex::spin_while_holder_is_running(SpinlockLocker<Spinlock<LockRank::None>>& lock)
+{
+    // With a single processor, the holder can't make progress while we spin.
+    if (Processor::count() == 1)
+        return false;
+
+    for (size_t round = 0; round < adaptive_spin_rounds; ++round) {
+        // We only know who holds the Mutex when it's locked exclusively. The holder can't
+        // unlock it (and therefore can't go away) as long as we hold m_lock.
+        if (m_mode != Mode::Exclusive)
+            return false;
+        auto const* holder = bit_cast<Thread const*>(m_holder);
+        if (holder->state() != Thread::State::Running)
+            return false;
+
+        lock.unlock();
+        for (size_t i = 0; i < pauses_per_adaptive_spin_round; ++i)
+            Processor::pause();
+        lock.lock();
+
+        if (m_mode == Mode::Unlocked)
+            return true;
+    }
+    return false;
+}
+
 void Mutex::unblock_waiters(Mode previous_mode)
 {
     VERIFY(m_times_locked == 0);
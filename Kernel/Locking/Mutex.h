@@ -84,6 +84,12 @@ private:
 
     // FIXME: Allow any lock rank.
     void block(Thread&, Mode, SpinlockLocker<Spinlock<LockRank::None>>&, u32);
+
+    // Waiting for a holder that is running on another processor to let go is usually much cheaper than
+    // a round-trip through the scheduler. Returns true if the Mutex was unlocked while we were spinning.
+    bool spin_while_holder_is_running(SpinlockLocker<Spinlock<LockRank::None>>&);
+    static constexpr size_t adaptive_spin_rounds = 100;
+    static constexpr size_t pauses_per_adaptive_spin_round = 32;
     void unblock_waiters(Mode);
 
     StringView m_name;
@@ -267,6 +267,54 @@ NonnullRefPtr<PhysicalRAMPage> AnonymousVMObject::allocate_committed_page(Badge<
     return m_unused_committed_pages->take_one();
 }
 
+bool AnonymousVMObject::can_install_huge_page(Badge<Region>, size_t first_page_index)
+{
+    return is_untouched_huge_page_range(first_page_index);
+}
+
+bool AnonymousVMObject::is_untouched_huge_page_range(size_t first_page_index)
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(first_page_index % pages_per_huge_page == 0);
+    if (m_purgeable || m_shared_committed_cow_pages || first_page_index + pages_per_huge_page > page_count())
+        return false;
+
+    // Only take over the range if nothing in it has been faulted in yet, and every page in it
+    // is backed the same way (either committed up front or the shared zero page).
+    auto pages = physical_pages().slice(first_page_index, pages_per_huge_page);
+    if (!pages[0])
+        return false;
+    bool is_committed = pages[0]->is_lazy_committed_page();
+    for (size_t i = 0; i < pages_per_huge_page; ++i) {
+        auto& page = pages[i];
+        if (!page || (is_committed ? !page->is_lazy_committed_page() : !page->is_shared_zero_page()))
+            return false;
+        if (!m_cow_map.is_null() && m_cow_map.get(first_page_index + i))
+            return false;
+    }
+    if (is_committed && (!m_unused_committed_pages.has_value() || m_unused_committed_pages->page_count() < pages_per_huge_page))
+        return false;
+    return true;
+}
+
+bool AnonymousVMObject::try_install_huge_page(Badge<Region>, size_t first_page_index, Vector<NonnullRefPtr<PhysicalRAMPage>>& huge_page)
+{
+    VERIFY(huge_page.size() == pages_per_huge_page);
+    // The huge page was allocated without holding our lock, so someone may have faulted in part of the range since.
+    if (!is_untouched_huge_page_range(first_page_index))
+        return false;
+
+    auto pages = physical_pages().slice(first_page_index, pages_per_huge_page);
+    // The huge page came from the uncommitted pool, so the commitment for this range isn't needed anymore.
+    if (pages[0]->is_lazy_committed_page())
+        m_unused_committed_pages->uncommit(pages_per_huge_page);
+
+    for (size_t i = 0; i < pages_per_huge_page; ++i)
+        pages[i] = move(huge_page[i]);
+    huge_page.clear();
+    return true;
+}
+
 void AnonymousVMObject::reset_cow_map()
 {
     for (size_t i = 0; i < page_count(); ++i) {
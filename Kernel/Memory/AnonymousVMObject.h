@@ -26,6 +26,10 @@ public:
     virtual ErrorOr<NonnullLockRefPtr<VMObject>> try_clone() override;
 
     [[nodiscard]] NonnullRefPtr<PhysicalRAMPage> allocate_committed_page(Badge<Region>);
+    // Whether the naturally aligned run of pages starting at first_page_index is still untouched.
+    bool can_install_huge_page(Badge<Region>, size_t first_page_index);
+    // Replaces such a run with the given physically contiguous huge page, unless it was touched in the meantime.
+    bool try_install_huge_page(Badge<Region>, size_t first_page_index, Vector<NonnullRefPtr<PhysicalRAMPage>>& huge_page);
     PageFaultResponse handle_cow_fault(size_t, VirtualAddress);
     size_t cow_pages() const;
     bool should_cow(size_t page_index, bool) const;
@@ -56,6 +60,8 @@ private:
 
     virtual bool is_anonymous() const override { return true; }
 
+    bool is_untouched_huge_page_range(size_t first_page_index);
+
     ErrorOr<void> ensure_cow_map();
     ErrorOr<void> ensure_or_reset_cow_map();
     void reset_cow_map();
@@ -81,6 +81,31 @@ int InodeVMObject::try_release_clean_pages(int page_amount)
     return count;
 }
 
+int InodeVMObject::try_release_clean_pages_not_recently_accessed(int page_amount)
+{
+    SpinlockLocker locker(m_lock);
+
+    int count = 0;
+    for (size_t i = 0; i < page_count() && count < page_amount; ++i) {
+        if (m_dirty_pages.get(i) || !m_physical_pages[i])
+            continue;
+        // Ask every region, so they all start over with a clean slate for next time.
+        bool was_accessed = false;
+        for_each_region([&](auto& region) {
+            auto page_index_in_region = i;
+            if (region.translate_vmobject_page(page_index_in_region) && region.test_and_clear_page_accessed(page_index_in_region))
+                was_accessed = true;
+        });
+        if (was_accessed)
+            continue;
+        m_physical_pages[i] = nullptr;
+        ++count;
+    }
+    if (count)
+        remap_regions();
+    return count;
+}
+
 u32 InodeVMObject::writable_mappings() const
 {
     u32 count = 0;
@@ -27,6 +27,8 @@ public:
 
     int release_all_clean_pages();
     int try_release_clean_pages(int page_amount);
+    // Like try_release_clean_pages(), but spares pages that were accessed through any of our regions since the last call.
+    int try_release_clean_pages_not_recently_accessed(int page_amount);
 
     u32 writable_mappings() const;
 
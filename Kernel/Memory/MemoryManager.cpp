@@ -30,6 +30,7 @@
 #include <Kernel/Sections.h>
 #include <Kernel/Security/AddressSanitizer.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/ReclaimTask.h>
 #include <Userland/Libraries/LibDeviceTree/FlattenedDeviceTree.h>
 
 extern u8 start_of_kernel_image[];
@@ -856,6 +857,9 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     PageDirectoryEntry const& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
+#if ARCH(X86_64)
+    VERIFY(!pde.is_huge());
+#endif
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
@@ -870,7 +874,12 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     auto& pde = pd[page_directory_index];
-    if (pde.is_present())
+#if ARCH(X86_64)
+    bool is_huge = pde.is_present() && pde.is_huge();
+#else
+    bool is_huge = false;
+#endif
+    if (pde.is_present() && !is_huge)
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
 
     bool did_purge = false;
@@ -887,8 +896,28 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
         pd = quickmap_pd(page_directory, page_directory_table_index);
         VERIFY(&pde == &pd[page_directory_index]); // Sanity check
 
-        VERIFY(!pde.is_present()); // Should have not changed
+        VERIFY(pde.is_present() == is_huge); // Should have not changed
+    }
+
+#if ARCH(X86_64)
+    if (is_huge) {
+        // Split the huge page into a page table with the same mappings, so that the caller
+        // can change a single page. The physical pages belong to the VMObject, one by one.
+        auto* entries = quickmap_pt(page_table->paddr());
+        for (size_t i = 0; i < pages_per_huge_page; ++i) {
+            auto& entry = entries[i];
+            entry.set_physical_page_base(pde.page_table_base() + i * PAGE_SIZE);
+            entry.set_present(true);
+            entry.set_writable(pde.is_writable());
+            entry.set_user_allowed(pde.is_user_allowed());
+            entry.set_cache_disabled(pde.is_cache_disabled());
+            entry.set_execute_disabled(pde.is_execute_disabled());
+            entry.set_global(pde.is_global());
+        }
+        pde.clear();
     }
+#endif
+
     pde.set_page_table_base(page_table->paddr().get());
     pde.set_user_allowed(true);
     pde.set_present(true);
@@ -911,6 +940,14 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
+#if ARCH(X86_64)
+    if (pde.is_present() && pde.is_huge()) {
+        // Huge pages only ever cover ranges that lie entirely within one region,
+        // and regions are always unmapped as a whole.
+        pde.clear();
+        return;
+    }
+#endif
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
@@ -934,6 +971,78 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+void MemoryManager::write_protect_mapped_pages(PageDirectory& page_directory, VirtualRange const& range, Function<bool(VirtualAddress)> const& should_write_protect)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+
+    // Every page table covers as much as a huge page.
+    constexpr FlatPtr page_table_coverage = huge_page_size;
+
+    auto vaddr = range.base().page_base();
+    auto end = range.end();
+    while (vaddr < end) {
+        u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+        u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+        auto next_page_table_vaddr = VirtualAddress { (vaddr.get() & ~(page_table_coverage - 1)) + page_table_coverage };
+        auto page_table_end = min(end, next_page_table_vaddr);
+
+        auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+        auto& pde = pd[page_directory_index];
+        if (!pde.is_present()) {
+            vaddr = page_table_end;
+            continue;
+        }
+#if ARCH(X86_64)
+        if (pde.is_huge()) {
+            // Huge pages lie entirely within one region, so the pages in it are all in the same state.
+            if (should_write_protect(vaddr))
+                pde.set_writable(false);
+            vaddr = page_table_end;
+            continue;
+        }
+#endif
+
+        auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
+        for (; vaddr < page_table_end; vaddr = vaddr.offset(PAGE_SIZE)) {
+            auto& pte = page_table[(vaddr.get() >> 12) & 0x1ff];
+            if (!pte.is_present() || !pte.is_writable())
+                continue;
+            if (should_write_protect(vaddr))
+                pte.set_writable(false);
+        }
+    }
+}
+
+#if ARCH(X86_64)
+void MemoryManager::map_huge_page(PageDirectory& page_directory, VirtualAddress vaddr, PhysicalAddress paddr, bool writable, bool user_allowed, bool executable)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % huge_page_size == 0);
+    VERIFY(paddr.get() % huge_page_size == 0);
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (pde.is_present() && !pde.is_huge()) {
+        // The range is currently mapped page by page (to the shared zero page or the lazy committed page),
+        // so the page table isn't needed anymore.
+        get_physical_page_entry(PhysicalAddress { pde.page_table_base() }).allocated.physical_page.unref();
+    }
+
+    pde.clear();
+    pde.set_page_table_base(paddr.get());
+    pde.set_huge(true);
+    pde.set_present(true);
+    pde.set_writable(writable);
+    pde.set_user_allowed(user_allowed);
+    if (Processor::current().has_nx())
+        pde.set_execute_disabled(!executable);
+}
+#endif
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     dmesgln("Initialize MMU");
@@ -1160,7 +1269,14 @@ ErrorOr<NonnullOwnPtr<Region>> MemoryManager::allocate_kernel_region_with_vmobje
 ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t page_count)
 {
     VERIFY(page_count > 0);
+    size_t pages_left = 0;
+    // NOTE: This has to outlive our lock, see InodePageCache::release_unused_pages().
+    InodePageCache::ReleasedEntries released_page_cache_entries;
     auto result = m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
+        if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
+            // Pages released from the page cache go back to the uncommitted pool.
+            InodePageCache::release_unused_pages(page_count - global_data.system_memory_info.physical_pages_uncommitted, released_page_cache_entries);
+        }
         if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
             dbgln("MM: Unable to commit {} pages, have only {}", page_count, global_data.system_memory_info.physical_pages_uncommitted);
             return ENOMEM;
@@ -1168,8 +1284,10 @@ ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t pa
 
         global_data.system_memory_info.physical_pages_uncommitted -= page_count;
         global_data.system_memory_info.physical_pages_committed += page_count;
+        pages_left = global_data.system_memory_info.physical_pages_uncommitted;
         return CommittedPhysicalPageSet { {}, page_count };
     });
+    ReclaimTask::did_allocate_pages(pages_left);
     if (result.is_error()) {
         Process::for_each_ignoring_process_lists([&](Process const& process) {
             size_t amount_resident = 0;
@@ -1271,7 +1389,10 @@ NonnullRefPtr<PhysicalRAMPage> MemoryManager::allocate_committed_physical_page(B
 
 ErrorOr<NonnullRefPtr<PhysicalRAMPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
-    return m_global_data.with([&](auto&) -> ErrorOr<NonnullRefPtr<PhysicalRAMPage>> {
+    size_t pages_left = 0;
+    // NOTE: This has to outlive our lock, see InodePageCache::release_unused_pages().
+    InodePageCache::ReleasedEntries released_page_cache_entries;
+    auto page_or_error = m_global_data.with([&](auto& global_data) -> ErrorOr<NonnullRefPtr<PhysicalRAMPage>> {
         auto page = find_free_physical_page(false);
         bool purged_pages = false;
 
@@ -1295,20 +1416,33 @@ ErrorOr<NonnullRefPtr<PhysicalRAMPage>> MemoryManager::allocate_physical_page(Sh
             });
         }
         if (!page) {
-            // Second, we look for a file-backed VMObject with clean pages.
+            // Second, we look for file contents in the page cache that nobody is using right now.
+            if (auto released_page_count = InodePageCache::release_unused_pages(1, released_page_cache_entries)) {
+                dbgln("MM: Page cache release saved the day! Released {} pages from the page cache", released_page_count);
+                page = find_free_physical_page(false);
+                VERIFY(page);
+            }
+        }
+        if (!page) {
+            // Third, we look for a file-backed VMObject with clean pages.
             for_each_vmobject([&](auto& vmobject) {
                 if (!vmobject.is_inode())
                     return IterationDecision::Continue;
                 auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
                 if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
-                    dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
+                    // Pages of shared mappings belong to the page cache, so they only become free once we take them out of there too.
                     page = find_free_physical_page(false);
-                    VERIFY(page);
+                    if (!page && InodePageCache::release_unused_pages(1, released_page_cache_entries))
+                        page = find_free_physical_page(false);
+                    if (!page)
+                        return IterationDecision::Continue;
+                    dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
                     return IterationDecision::Break;
                 }
                 return IterationDecision::Continue;
             });
         }
+        pages_left = global_data.system_memory_info.physical_pages_uncommitted;
         if (!page) {
             dmesgln("MM: no physical pages available");
             return ENOMEM;
@@ -1324,6 +1458,8 @@ ErrorOr<NonnullRefPtr<PhysicalRAMPage>> MemoryManager::allocate_physical_page(Sh
             *did_purge = purged_pages;
         return page.release_nonnull();
     });
+    ReclaimTask::did_allocate_pages(pages_left);
+    return page_or_error;
 }
 
 ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_contiguous_physical_pages(size_t size)
@@ -1355,6 +1491,36 @@ ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_contiguo
     return physical_pages;
 }
 
+ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_huge_physical_pages()
+{
+    Vector<NonnullRefPtr<PhysicalRAMPage>> physical_pages;
+    m_global_data.with([&](auto& global_data) {
+        // We need to make sure we don't touch pages that we have committed to
+        if (global_data.system_memory_info.physical_pages_uncommitted < pages_per_huge_page)
+            return;
+
+        for (auto& region : global_data.physical_regions) {
+            physical_pages = region->take_naturally_aligned_free_pages(pages_per_huge_page);
+            if (!physical_pages.is_empty()) {
+                global_data.system_memory_info.physical_pages_uncommitted -= pages_per_huge_page;
+                global_data.system_memory_info.physical_pages_used += pages_per_huge_page;
+                return;
+            }
+        }
+    });
+    if (physical_pages.is_empty())
+        return ENOMEM;
+
+    // NOTE: Callers must not hold any spinlock here, zeroing 2 MiB takes a while.
+    for (auto& page : physical_pages) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(page);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+    return physical_pages;
+}
+
 void MemoryManager::enter_process_address_space(Process& process)
 {
     process.address_space().with([](auto& space) {
@@ -1513,9 +1679,14 @@ NonnullRefPtr<PhysicalRAMPage> CommittedPhysicalPageSet::take_one()
 
 void CommittedPhysicalPageSet::uncommit_one()
 {
-    VERIFY(m_page_count > 0);
-    --m_page_count;
-    MM.uncommit_physical_pages({}, 1);
+    uncommit(1);
+}
+
+void CommittedPhysicalPageSet::uncommit(size_t page_count)
+{
+    VERIFY(m_page_count >= page_count);
+    m_page_count -= page_count;
+    MM.uncommit_physical_pages({}, page_count);
 }
 
 void MemoryManager::copy_physical_page(PhysicalRAMPage& physical_page, u8 page_buffer[PAGE_SIZE])
@@ -1525,6 +1696,33 @@ void MemoryManager::copy_physical_page(PhysicalRAMPage& physical_page, u8 page_b
     unquickmap_page();
 }
 
+void MemoryManager::copy_from_physical_page(PhysicalRAMPage& physical_page, size_t offset_in_page, Bytes bytes)
+{
+    VERIFY(offset_in_page + bytes.size() <= PAGE_SIZE);
+    InterruptDisabler disabler;
+    auto* quickmapped_page = quickmap_page(physical_page);
+    memcpy(bytes.data(), quickmapped_page + offset_in_page, bytes.size());
+    unquickmap_page();
+}
+
+void MemoryManager::copy_to_physical_page(PhysicalRAMPage& physical_page, size_t offset_in_page, ReadonlyBytes bytes)
+{
+    VERIFY(offset_in_page + bytes.size() <= PAGE_SIZE);
+    InterruptDisabler disabler;
+    auto* quickmapped_page = quickmap_page(physical_page);
+    memcpy(quickmapped_page + offset_in_page, bytes.data(), bytes.size());
+    unquickmap_page();
+}
+
+void MemoryManager::zero_fill_physical_page(PhysicalRAMPage& physical_page, size_t offset_in_page, size_t length)
+{
+    VERIFY(offset_in_page + length <= PAGE_SIZE);
+    InterruptDisabler disabler;
+    auto* quickmapped_page = quickmap_page(physical_page);
+    memset(quickmapped_page + offset_in_page, 0, length);
+    unquickmap_page();
+}
+
 ErrorOr<NonnullOwnPtr<Memory::Region>> MemoryManager::create_identity_mapped_region(PhysicalAddress address, size_t size)
 {
     auto vmobject = TRY(Memory::AnonymousVMObject::try_create_for_physical_range(address, size));
@@ -34,6 +34,11 @@ constexpr FlatPtr page_round_down(FlatPtr x)
     return ((FlatPtr)(x)) & ~(PAGE_SIZE - 1);
 }
 
+// Where the architecture allows it, aligned 2 MiB stretches of private anonymous memory
+// are backed by physically contiguous pages and mapped with a single page directory entry.
+constexpr size_t huge_page_size = 2 * MiB;
+constexpr size_t pages_per_huge_page = huge_page_size / PAGE_SIZE;
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - physical_to_virtual_offset;
@@ -115,6 +120,7 @@ public:
 
     [[nodiscard]] NonnullRefPtr<PhysicalRAMPage> take_one();
     void uncommit_one();
+    void uncommit(size_t page_count);
 
     void operator=(CommittedPhysicalPageSet&&) = delete;
 
@@ -166,6 +172,13 @@ public:
     NonnullRefPtr<PhysicalRAMPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
     ErrorOr<NonnullRefPtr<PhysicalRAMPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> allocate_contiguous_physical_pages(size_t size);
+    // Returns a naturally aligned, physically contiguous and zeroed huge page, drawn from the uncommitted pool.
+    ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> allocate_huge_physical_pages();
+
+#if ARCH(X86_64)
+    // Maps a naturally aligned huge page with a single page directory entry, dropping any page table there.
+    void map_huge_page(PageDirectory&, VirtualAddress, PhysicalAddress, bool writable, bool user_allowed, bool executable);
+#endif
     void deallocate_physical_page(PhysicalAddress);
 
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, Region::Cacheable = Region::Cacheable::Yes);
@@ -234,6 +247,10 @@ public:
     PhysicalAddress get_physical_address(PhysicalRAMPage const&);
 
     void copy_physical_page(PhysicalRAMPage&, u8 page_buffer[PAGE_SIZE]);
+    // Unlike copy_physical_page(), these take care of disabling interrupts themselves.
+    void copy_from_physical_page(PhysicalRAMPage&, size_t offset_in_page, Bytes);
+    void copy_to_physical_page(PhysicalRAMPage&, size_t offset_in_page, ReadonlyBytes);
+    void zero_fill_physical_page(PhysicalRAMPage&, size_t offset_in_page, size_t length);
 
     IterationDecision for_each_physical_memory_range(Function<IterationDecision(PhysicalMemoryRange const&)>);
 
@@ -292,6 +309,10 @@ private:
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
+    // Takes away write access from every page in the range that is mapped and for which `should_write_protect`
+    // returns true. Unlike going through ensure_pte(), parts of the range without page tables are skipped wholesale.
+    void write_protect_mapped_pages(PageDirectory&, VirtualRange const&, Function<bool(VirtualAddress)> const& should_write_protect);
+
     // NOTE: These are outside of GlobalData as they are only assigned on startup,
     //       and then never change. Atomic ref-counting covers that case without
     //       the need for additional synchronization.
@@ -102,6 +102,43 @@ Vector<NonnullRefPtr<PhysicalRAMPage>> PhysicalRegion::take_contiguous_free_page
     return physical_pages;
 }
 
+Vector<NonnullRefPtr<PhysicalRAMPage>> PhysicalRegion::take_naturally_aligned_free_pages(size_t count)
+{
+    VERIFY(is_power_of_two(count));
+    auto order = count_trailing_zeroes(count);
+    auto const alignment = count * PAGE_SIZE;
+
+    for (auto& zone : m_usable_zones) {
+        // Buddy blocks are only aligned relative to the start of their zone. If the zone itself
+        // isn't aligned, a block twice the size always contains an aligned range we can keep.
+        auto block_order = zone.base().get() % alignment == 0 ? order : order + 1;
+        auto block_base = zone.allocate_block(block_order);
+        if (!block_base.has_value())
+            continue;
+
+        auto aligned_base = PhysicalAddress { align_up_to(block_base->get(), alignment) };
+        auto aligned_end = aligned_base.offset(alignment);
+        auto block_end = block_base->offset(PAGE_SIZE << block_order);
+        for (auto paddr = block_base.value(); paddr < aligned_base; paddr = paddr.offset(PAGE_SIZE))
+            zone.deallocate_block(paddr, 0);
+        for (auto paddr = aligned_end; paddr < block_end; paddr = paddr.offset(PAGE_SIZE))
+            zone.deallocate_block(paddr, 0);
+
+        if (zone.is_empty()) {
+            // We've exhausted this zone, move it to the full zones list.
+            m_full_zones.append(zone);
+        }
+
+        Vector<NonnullRefPtr<PhysicalRAMPage>> physical_pages;
+        physical_pages.ensure_capacity(count);
+        for (size_t i = 0; i < count; ++i)
+            physical_pages.append(PhysicalRAMPage::create(aligned_base.offset(i * PAGE_SIZE)));
+        return physical_pages;
+    }
+
+    return {};
+}
+
 RefPtr<PhysicalRAMPage> PhysicalRegion::take_free_page()
 {
     if (m_usable_zones.is_empty())
@@ -36,6 +36,7 @@ public:
 
     RefPtr<PhysicalRAMPage> take_free_page();
     Vector<NonnullRefPtr<PhysicalRAMPage>> take_contiguous_free_pages(size_t count);
+    Vector<NonnullRefPtr<PhysicalRAMPage>> take_naturally_aligned_free_pages(size_t count);
     void return_page(PhysicalAddress);
 
 private:
@@ -126,7 +126,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
 
     // Set up a COW region. The parent (this) region becomes COW as well!
     if (is_writable())
-        remap();
+        write_protect_for_cow();
 
     OwnPtr<KString> clone_region_name;
     if (m_name)
@@ -353,6 +353,55 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, PhysicalAddress paddr,
     return ENOMEM;
 }
 
+ErrorOr<void> Region::map_on_demand(PageDirectory& page_directory)
+{
+    // Only anonymous and inode-backed memory know how to fault their pages back in.
+    if (!vmobject().is_anonymous() && !vmobject().is_inode())
+        return map(page_directory, ShouldFlushTLB::No);
+
+    SpinlockLocker page_lock(page_directory.get_lock());
+    set_page_directory(page_directory);
+    return {};
+}
+
+bool Region::test_and_clear_page_accessed(size_t page_index)
+{
+    VERIFY(page_index < page_count());
+    if (!m_page_directory)
+        return false;
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    auto* pte = MM.pte(*m_page_directory, vaddr_from_page_index(page_index));
+    if (!pte || !pte->is_present())
+        return false;
+#if ARCH(X86_64)
+    // NOTE: We don't flush the TLB here, so a page that stays cached there may look unused for a while.
+    //       That only costs us a page fault if it gets evicted.
+    bool was_accessed = pte->is_accessed();
+    pte->set_accessed(false);
+    return was_accessed;
+#else
+    return true;
+#endif
+}
+
+void Region::write_protect_for_cow()
+{
+    VERIFY(m_page_directory);
+
+    // Only anonymous memory keeps track of which pages are copy-on-write, everything else is simply mapped again.
+    if (!vmobject().is_anonymous()) {
+        remap();
+        return;
+    }
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    MM.write_protect_mapped_pages(*m_page_directory, range(), [&](VirtualAddress page_vaddr) {
+        return should_cow(page_index_from_address(page_vaddr));
+    });
+    MemoryManager::flush_tlb(m_page_directory, vaddr(), page_count());
+}
+
 void Region::remap()
 {
     VERIFY(m_page_directory);
@@ -418,13 +467,12 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
                 return PageFaultResponse::OutOfMemory;
             return PageFaultResponse::Continue;
         }
-        dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
-        dbgln("     - Physical page slot pointer: {:p}", page_slot.ptr());
         if (page_slot) {
-            dbgln("     - Physical page: {}", page_slot->paddr());
-            dbgln("     - Lazy committed: {}", page_slot->is_lazy_committed_page());
-            dbgln("     - Shared zero: {}", page_slot->is_shared_zero_page());
+            vmobject_locker.unlock();
+            return handle_fault_on_unmapped_page(page_index_in_region, fault);
         }
+        dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
+        dbgln("     - Physical page slot pointer: {:p}", page_slot.ptr());
         return PageFaultResponse::ShouldCrash;
     }
     VERIFY(fault.type() == PageFault::Type::ProtectionViolation);
@@ -499,12 +547,64 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
             return PageFaultResponse::OutOfMemory;
         return PageFaultResponse::Continue;
     }
+    if (page_slot) {
+        vmobject_locker.unlock();
+        return handle_fault_on_unmapped_page(page_index_in_region, fault);
+    }
 
     dbgln("Unexpected page fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
     return PageFaultResponse::ShouldCrash;
 #endif
 }
 
+bool Region::try_map_huge_page(size_t page_index_in_region)
+{
+#if ARCH(X86_64)
+    if (m_shared || !is_user() || !is_readable() || !is_writable() || !m_cacheable || m_write_combine)
+        return false;
+
+    auto huge_page_vaddr = vaddr_from_page_index(page_index_in_region).page_base();
+    huge_page_vaddr = VirtualAddress { huge_page_vaddr.get() & ~(huge_page_size - 1) };
+    if (huge_page_vaddr < vaddr() || huge_page_vaddr.offset(huge_page_size) > vaddr().offset(size()))
+        return false;
+
+    // The virtual and physical address have to be aligned the same way, so the VMObject offset has to line up too.
+    auto first_page_index_in_region = (huge_page_vaddr.get() - vaddr().get()) / PAGE_SIZE;
+    auto first_page_index_in_vmobject = translate_to_vmobject_page(first_page_index_in_region);
+    if (first_page_index_in_vmobject % pages_per_huge_page != 0)
+        return false;
+
+    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject());
+    {
+        SpinlockLocker locker(anonymous_vmobject.m_lock);
+        if (!anonymous_vmobject.can_install_huge_page({}, first_page_index_in_vmobject))
+            return false;
+    }
+
+    // Allocate and zero the huge page without holding the VMObject lock, like handle_zero_fault() does for single pages.
+    auto huge_page_or_error = MM.allocate_huge_physical_pages();
+    if (huge_page_or_error.is_error())
+        return false;
+    auto huge_page = huge_page_or_error.release_value();
+
+    SpinlockLocker locker(anonymous_vmobject.m_lock);
+    if (!anonymous_vmobject.try_install_huge_page({}, first_page_index_in_vmobject, huge_page)) {
+        // Someone faulted in part of the range in the meantime, the huge page goes back to the free pool.
+        return false;
+    }
+
+    auto paddr = physical_page(first_page_index_in_region)->paddr();
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    MM.map_huge_page(*m_page_directory, huge_page_vaddr, paddr, true, true, is_executable());
+    MemoryManager::flush_tlb(m_page_directory, huge_page_vaddr, pages_per_huge_page);
+    dbgln_if(PAGE_FAULT_DEBUG, "      >> MAPPED HUGE PAGE {} at {}", paddr, huge_page_vaddr);
+    return true;
+#else
+    (void)page_index_in_region;
+    return false;
+#endif
+}
+
 PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, PhysicalRAMPage& page_in_slot_at_time_of_fault)
 {
     VERIFY(vmobject().is_anonymous());
@@ -516,6 +616,9 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (try_map_huge_page(page_index_in_region))
+        return PageFaultResponse::Continue;
+
     RefPtr<PhysicalRAMPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -558,6 +661,28 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     return PageFaultResponse::Continue;
 }
 
+// The page is there, it just hasn't been mapped into this address space yet, see map_on_demand().
+PageFaultResponse Region::handle_fault_on_unmapped_page(size_t page_index_in_region, PageFault const& fault)
+{
+    RefPtr<PhysicalRAMPage> page;
+    {
+        SpinlockLocker vmobject_locker(vmobject().m_lock);
+        page = physical_page(page_index_in_region);
+    }
+    VERIFY(page);
+
+    // Don't bother mapping a page that's about to be replaced.
+    if (fault.is_write() && should_cow(page_index_in_region)) {
+        if (page->is_shared_zero_page() || page->is_lazy_committed_page())
+            return handle_zero_fault(page_index_in_region, *page);
+        return handle_cow_fault(page_index_in_region);
+    }
+
+    if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region), page.release_nonnull()))
+        return PageFaultResponse::OutOfMemory;
+    return PageFaultResponse::Continue;
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     auto current_thread = Thread::current();
@@ -605,9 +730,48 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
     if (current_thread)
         current_thread->did_inode_fault();
 
-    u8 page_buffer[PAGE_SIZE];
     auto& inode = inode_vmobject.inode();
 
+    // Shared mappings use the page cache's own copy of the page, so they see write()s to the file right away and vice versa.
+    RefPtr<PhysicalRAMPage> new_physical_page;
+    if (inode_vmobject.is_shared_inode()) {
+        auto page_or_error = inode.page_cache_page(page_index_in_vmobject);
+        if (page_or_error.is_error()) {
+            dmesgln("handle_inode_fault: Error ({}) while reading from inode", page_or_error.error());
+            return PageFaultResponse::ShouldCrash;
+        }
+        new_physical_page = page_or_error.release_value();
+    }
+
+    if (!new_physical_page) {
+        auto response = read_inode_page_into_new_physical_page(inode, page_index_in_vmobject, new_physical_page);
+        if (response != PageFaultResponse::Continue)
+            return response;
+    }
+
+    {
+        SpinlockLocker locker(inode_vmobject.m_lock);
+
+        // Someone else can assign a new page before we get here, so check if physical_page_slot is still null.
+        if (physical_page_slot.is_null()) {
+            physical_page_slot = new_physical_page;
+            // Something went wrong if a newly loaded page is already marked dirty
+            VERIFY(!inode_vmobject.is_page_dirty(page_index_in_vmobject));
+        } else {
+            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
+        }
+
+        if (mark_page_dirty)
+            inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
+        if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot))
+            return PageFaultResponse::OutOfMemory;
+        return PageFaultResponse::Continue;
+    }
+}
+
+PageFaultResponse Region::read_inode_page_into_new_physical_page(Inode& inode, size_t page_index_in_vmobject, RefPtr<PhysicalRAMPage>& new_physical_page)
+{
+    u8 page_buffer[PAGE_SIZE];
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
     auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
 
@@ -632,32 +796,14 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
         dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
         return PageFaultResponse::OutOfMemory;
     }
-    auto new_physical_page = new_physical_page_or_error.release_value();
+    new_physical_page = new_physical_page_or_error.release_value();
     {
         InterruptDisabler disabler;
         u8* dest_ptr = MM.quickmap_page(*new_physical_page);
         memcpy(dest_ptr, page_buffer, PAGE_SIZE);
         MM.unquickmap_page();
     }
-
-    {
-        SpinlockLocker locker(inode_vmobject.m_lock);
-
-        // Someone else can assign a new page before we get here, so check if physical_page_slot is still null.
-        if (physical_page_slot.is_null()) {
-            physical_page_slot = new_physical_page;
-            // Something went wrong if a newly loaded page is already marked dirty
-            VERIFY(!inode_vmobject.is_page_dirty(page_index_in_vmobject));
-        } else {
-            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
-        }
-
-        if (mark_page_dirty)
-            inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
-        if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot))
-            return PageFaultResponse::OutOfMemory;
-        return PageFaultResponse::Continue;
-    }
+    return PageFaultResponse::Continue;
 }
 
 PageFaultResponse Region::handle_dirty_on_write_fault(size_t page_index_in_region)
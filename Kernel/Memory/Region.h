@@ -212,7 +212,14 @@ public:
     void set_page_directory(PageDirectory&);
     ErrorOr<void> map(PageDirectory&, ShouldFlushTLB = ShouldFlushTLB::Yes);
     ErrorOr<void> map(PageDirectory&, PhysicalAddress, ShouldFlushTLB = ShouldFlushTLB::Yes);
+    // Like map(), but leaves it to the page fault handler to map pages as they are accessed.
+    // Much cheaper for large regions of which only a few pages end up being touched.
+    ErrorOr<void> map_on_demand(PageDirectory&);
     void unmap(ShouldFlushTLB = ShouldFlushTLB::Yes);
+
+    // Whether the page was accessed through this region since the last time we asked.
+    // Only x86_64 keeps track of this, elsewhere every mapped page counts as accessed.
+    [[nodiscard]] bool test_and_clear_page_accessed(size_t page_index);
     void unmap_with_locks_held(ShouldFlushTLB, SpinlockLocker<RecursiveSpinlock<LockRank::None>>& pd_locker);
 
     void remap();
@@ -236,6 +243,7 @@ private:
     Region(VirtualRange const&, NonnullLockRefPtr<VMObject>, size_t offset_in_vmobject, OwnPtr<KString>, Region::Access access, Cacheable, bool shared);
 
     [[nodiscard]] bool remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalRAMPage>);
+    void write_protect_for_cow();
 
     void set_access_bit(Access access, bool b)
     {
@@ -247,8 +255,11 @@ private:
 
     [[nodiscard]] PageFaultResponse handle_cow_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index, bool mark_page_dirty = false);
+    [[nodiscard]] PageFaultResponse read_inode_page_into_new_physical_page(Inode&, size_t page_index_in_vmobject, RefPtr<PhysicalRAMPage>&);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index, PhysicalRAMPage& page_in_slot_at_time_of_fault);
+    bool try_map_huge_page(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_dirty_on_write_fault(size_t page_index);
+    [[nodiscard]] PageFaultResponse handle_fault_on_unmapped_page(size_t page_index, PageFault const&);
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalRAMPage>);
@@ -5,6 +5,7 @@
  */
 
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Library/KBuffer.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 
@@ -61,6 +62,10 @@ ErrorOr<void> SharedInodeVMObject::sync_before_destroying()
 
 ErrorOr<void> SharedInodeVMObject::sync_impl(off_t offset_in_pages, size_t pages, bool should_remap)
 {
+    // NOTE: This is allocated before any page is marked clean, so failing here doesn't lose anything.
+    //       A page is also too much to keep on the stack while the write goes on to update the page cache.
+    auto page_buffer = TRY(KBuffer::try_create_with_size("SharedInodeVMObject: Write-back"sv, PAGE_SIZE));
+
     SpinlockLocker locker(m_lock);
 
     size_t highest_page_to_flush = min(page_count(), offset_in_pages + pages);
@@ -88,10 +93,9 @@ ErrorOr<void> SharedInodeVMObject::sync_impl(off_t offset_in_pages, size_t pages
     for (auto it = pages_to_flush.begin(); it != pages_to_flush.end(); ++it) {
         size_t page_index = *it;
         auto& physical_page = m_physical_pages[page_index];
-        u8 page_buffer[PAGE_SIZE];
 
-        MM.copy_physical_page(*physical_page, page_buffer);
-        TRY(m_inode->write_bytes(page_index * PAGE_SIZE, PAGE_SIZE, UserOrKernelBuffer::for_kernel_buffer(page_buffer), nullptr));
+        MM.copy_physical_page(*physical_page, page_buffer->data());
+        TRY(m_inode->write_bytes(page_index * PAGE_SIZE, PAGE_SIZE, UserOrKernelBuffer::for_kernel_buffer(page_buffer->data()), nullptr));
     }
 
     return {};
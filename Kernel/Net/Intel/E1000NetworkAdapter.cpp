@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Net/Intel/E1000NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/TCP.h>
 #include <Kernel/Sections.h>
 
 namespace Kernel {
@@ -80,6 +81,21 @@ namespace Kernel {
 #define CMD_RPS (1 << 4)  // Report Packet Sent
 #define CMD_VLE (1 << 6)  // VLAN Packet Enable
 #define CMD_IDE (1 << 7)  // Interrupt Delay Enable
+#define CMD_TSE (1 << 2)  // TCP Segmentation Enable (extended descriptors only)
+#define CMD_DEXT (1 << 5) // Descriptor Extension
+
+// Extended Transmit Descriptors
+
+#define TX_DTYP_CONTEXT (0 << 20)
+#define TX_DTYP_DATA (1 << 20)
+#define TX_COMMAND_SHIFT 24
+
+#define TUCMD_TCP (1 << 0) // Packet Type is TCP
+#define TUCMD_IP (1 << 1)  // Packet Type is IPv4
+#define TUCMD_TSE (1 << 2) // TCP Segmentation Enable
+
+#define POPTS_IXSM (1 << 0) // Insert IP Checksum
+#define POPTS_TXSM (1 << 1) // Insert TCP/UDP Checksum
 
 // TCTL Register
 
@@ -354,6 +370,9 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_tx_descriptors()
         descriptor.cmd = 0;
     }
 
+    // The TX buffers are physically contiguous, so a large frame can be spread over consecutive ones.
+    set_tcp_segmentation_offload_size(NumericLimits<u16>::max());
+
     out32(REG_TXDESCLO, m_tx_descriptors_region->physical_page(0)->paddr().get());
     out32(REG_TXDESCHI, 0);
     out32(REG_TXDESCLEN, number_of_tx_descriptors * sizeof(e1000_tx_desc));
@@ -400,6 +419,23 @@ u32 E1000NetworkAdapter::in32(u16 address)
     return m_registers_io_window->read32(address);
 }
 
+PhysicalAddress E1000NetworkAdapter::tx_buffer_physical_address(size_t index) const
+{
+    return m_tx_buffer_region->physical_page(0)->paddr().offset(tx_buffer_size * index);
+}
+
+void E1000NetworkAdapter::wait_for_tx_descriptor(size_t index)
+{
+    auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
+    for (;;) {
+        if (tx_descriptors[index].status) {
+            Processor::enable_interrupts();
+            break;
+        }
+        m_wait_queue.wait_forever("E1000NetworkAdapter"sv);
+    }
+}
+
 void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
 {
     disable_irq();
@@ -407,27 +443,86 @@ void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
     dbgln_if(E1000_DEBUG, "E1000: Sending packet ({} bytes)", payload.size());
     auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
     auto& descriptor = tx_descriptors[tx_current];
-    VERIFY(payload.size() <= 8192);
+    VERIFY(payload.size() <= tx_buffer_size);
     auto* vptr = (void*)m_tx_buffers[tx_current];
     memcpy(vptr, payload.data(), payload.size());
+    // The descriptor may have been used for offloading last time around, so set it up from scratch.
+    descriptor.addr = tx_buffer_physical_address(tx_current).get();
     descriptor.length = payload.size();
+    descriptor.cso = 0;
     descriptor.status = 0;
+    descriptor.css = 0;
     descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
     dbgln_if(E1000_DEBUG, "E1000: Using tx descriptor {} (head is at {})", tx_current, in32(REG_TXDESCHEAD));
+    auto sent_descriptor = tx_current;
     tx_current = (tx_current + 1) % number_of_tx_descriptors;
     Processor::disable_interrupts();
     enable_irq();
     out32(REG_TXDESCTAIL, tx_current);
-    for (;;) {
-        if (descriptor.status) {
-            Processor::enable_interrupts();
-            break;
-        }
-        m_wait_queue.wait_forever("E1000NetworkAdapter"sv);
-    }
+    wait_for_tx_descriptor(sent_descriptor);
     dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)descriptor.status);
 }
 
+void E1000NetworkAdapter::send_raw_tcp_segmented(ReadonlyBytes frame, size_t maximum_segment_size)
+{
+    auto& ipv4 = *reinterpret_cast<IPv4Packet const*>(frame.offset(layer3_payload_offset()));
+    auto& tcp = *static_cast<TCPPacket const*>(ipv4.payload());
+    size_t ipv4_offset = layer3_payload_offset();
+    size_t tcp_offset = ipv4_offset + sizeof(IPv4Packet);
+    size_t headers_size = tcp_offset + tcp.header_size();
+    size_t payload_size = frame.size() - headers_size;
+    size_t data_descriptor_count = ceil_div(frame.size(), tx_buffer_size);
+    VERIFY(data_descriptor_count < number_of_tx_descriptors);
+    dbgln_if(E1000_DEBUG, "E1000: Sending segmented TCP packet ({} bytes, mss={})", frame.size(), maximum_segment_size);
+
+    disable_irq();
+    size_t tx_current = in32(REG_TXDESCTAIL) % number_of_tx_descriptors;
+    auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
+
+    auto& context = *reinterpret_cast<e1000_tx_context_desc*>(&tx_descriptors[tx_current]);
+    context.ipcss = ipv4_offset;
+    context.ipcso = ipv4_offset + 10; // Offset of the header checksum.
+    context.ipcse = tcp_offset - 1;
+    context.tucss = tcp_offset;
+    context.tucso = tcp_offset + TCPPacket::checksum_offset;
+    context.tucse = 0;
+    context.paylen_dtyp_tucmd = payload_size | TX_DTYP_CONTEXT | ((TUCMD_IP | TUCMD_TCP | TUCMD_TSE | CMD_DEXT) << TX_COMMAND_SHIFT);
+    context.status = 0;
+    context.hdrlen = headers_size;
+    context.mss = maximum_segment_size;
+    tx_current = (tx_current + 1) % number_of_tx_descriptors;
+
+    size_t first_data_descriptor = tx_current;
+    size_t last_data_descriptor = tx_current;
+    for (size_t offset = 0; offset < frame.size(); offset += tx_buffer_size) {
+        auto chunk = frame.slice(offset, min(tx_buffer_size, frame.size() - offset));
+        memcpy(m_tx_buffers[tx_current], chunk.data(), chunk.size());
+
+        u32 command = CMD_DEXT | CMD_TSE | CMD_IFCS;
+        if (offset + chunk.size() == frame.size())
+            command |= CMD_EOP | CMD_RS;
+        auto& descriptor = *reinterpret_cast<e1000_tx_data_desc*>(&tx_descriptors[tx_current]);
+        descriptor.addr = tx_buffer_physical_address(tx_current).get();
+        descriptor.length_dtyp_dcmd = chunk.size() | TX_DTYP_DATA | (command << TX_COMMAND_SHIFT);
+        descriptor.status = 0;
+        descriptor.popts = POPTS_IXSM | POPTS_TXSM;
+        descriptor.special = 0;
+        last_data_descriptor = tx_current;
+        tx_current = (tx_current + 1) % number_of_tx_descriptors;
+    }
+
+    // The device fills in lengths and checksums for every segment it cuts. It wants the TCP checksum
+    // seeded with the pseudo-header sum without the length, and the IP header checksum cleared.
+    auto* headers = (u8*)m_tx_buffers[first_data_descriptor];
+    reinterpret_cast<IPv4Packet*>(headers + ipv4_offset)->set_checksum(0);
+    reinterpret_cast<TCPPacket*>(headers + tcp_offset)->set_checksum(tcp_pseudo_header_checksum(ipv4, 0));
+
+    Processor::disable_interrupts();
+    enable_irq();
+    out32(REG_TXDESCTAIL, tx_current);
+    wait_for_tx_descriptor(last_data_descriptor);
+}
+
 void E1000NetworkAdapter::receive()
 {
     auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
@@ -28,6 +28,7 @@ public:
     virtual ~E1000NetworkAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_tcp_segmented(ReadonlyBytes, size_t maximum_segment_size) override;
     virtual bool link_up() override { return m_link_up; }
     virtual i32 link_speed() override;
     virtual bool link_full_duplex() override;
@@ -70,6 +71,31 @@ protected:
         uint16_t volatile special { 0 };
     };
 
+    // Sets up checksum and segmentation offload for the data descriptors that follow it.
+    struct [[gnu::packed]] e1000_tx_context_desc {
+        uint8_t volatile ipcss { 0 };
+        uint8_t volatile ipcso { 0 };
+        uint16_t volatile ipcse { 0 };
+        uint8_t volatile tucss { 0 };
+        uint8_t volatile tucso { 0 };
+        uint16_t volatile tucse { 0 };
+        uint32_t volatile paylen_dtyp_tucmd { 0 };
+        uint8_t volatile status { 0 };
+        uint8_t volatile hdrlen { 0 };
+        uint16_t volatile mss { 0 };
+    };
+
+    struct [[gnu::packed]] e1000_tx_data_desc {
+        uint64_t volatile addr { 0 };
+        uint32_t volatile length_dtyp_dcmd { 0 };
+        uint8_t volatile status { 0 };
+        uint8_t volatile popts { 0 };
+        uint16_t volatile special { 0 };
+    };
+
+    static_assert(sizeof(e1000_tx_context_desc) == sizeof(e1000_tx_desc));
+    static_assert(sizeof(e1000_tx_data_desc) == sizeof(e1000_tx_desc));
+
     virtual void detect_eeprom();
     virtual u32 read_eeprom(u8 address);
     void read_mac_address();
@@ -85,6 +111,8 @@ protected:
     u32 in32(u16 address);
 
     void receive();
+    PhysicalAddress tx_buffer_physical_address(size_t index) const;
+    void wait_for_tx_descriptor(size_t index);
 
     static constexpr size_t number_of_rx_descriptors = 256;
     static constexpr size_t number_of_tx_descriptors = 256;
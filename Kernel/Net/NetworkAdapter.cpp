@@ -10,6 +10,9 @@
 #include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/Routing.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
@@ -25,9 +28,89 @@ void NetworkAdapter::send_packet(ReadonlyBytes packet)
 {
     m_packets_out++;
     m_bytes_out += packet.size();
+
+    if (packet.size() > layer3_payload_offset() + mtu()) {
+        auto& ipv4 = *reinterpret_cast<IPv4Packet const*>(packet.offset(layer3_payload_offset()));
+        VERIFY(ipv4.protocol() == (u8)IPv4Protocol::TCP);
+        auto& tcp = *static_cast<TCPPacket const*>(ipv4.payload());
+        auto maximum_segment_size = mtu() - sizeof(IPv4Packet) - tcp.header_size();
+        // A packet that was built for another adapter (or before offload was turned off) can
+        // come back here when it's retransmitted, so we can't count on the device splitting it.
+        if (packet.size() <= layer3_payload_offset() + m_tcp_segmentation_offload_size)
+            send_raw_tcp_segmented(packet, maximum_segment_size);
+        else
+            send_tcp_segmented_in_software(packet, maximum_segment_size);
+        return;
+    }
     send_raw(packet);
 }
 
+void NetworkAdapter::send_tcp_segmented_in_software(ReadonlyBytes frame, size_t maximum_segment_size)
+{
+    auto& ipv4 = *reinterpret_cast<IPv4Packet const*>(frame.offset(layer3_payload_offset()));
+    auto& tcp = *static_cast<TCPPacket const*>(ipv4.payload());
+    size_t headers_size = layer3_payload_offset() + sizeof(IPv4Packet) + tcp.header_size();
+    auto payload = frame.slice(headers_size);
+
+    auto segment = acquire_packet_buffer(headers_size + maximum_segment_size);
+    if (!segment) {
+        // Nothing was sent, so the retransmission timer will give this another go.
+        dbgln("Discarding oversized TCP packet because we're out of memory");
+        return;
+    }
+
+    for (size_t offset = 0; offset < payload.size(); offset += maximum_segment_size) {
+        auto segment_payload = payload.slice(offset, min(maximum_segment_size, payload.size() - offset));
+        bool is_last_segment = offset + segment_payload.size() == payload.size();
+
+        auto* data = segment->buffer->data();
+        memcpy(data, frame.data(), headers_size);
+        memcpy(data + headers_size, segment_payload.data(), segment_payload.size());
+
+        auto& segment_ipv4 = *reinterpret_cast<IPv4Packet*>(data + layer3_payload_offset());
+        segment_ipv4.set_length(sizeof(IPv4Packet) + tcp.header_size() + segment_payload.size());
+        segment_ipv4.set_checksum(0);
+        segment_ipv4.set_checksum(segment_ipv4.compute_checksum());
+
+        auto& segment_tcp = *static_cast<TCPPacket*>(segment_ipv4.payload());
+        segment_tcp.set_sequence_number(tcp.sequence_number() + offset);
+        if (!is_last_segment)
+            segment_tcp.set_flags(tcp.flags() & ~(TCPFlags::FIN | TCPFlags::PSH));
+        segment_tcp.set_checksum(0);
+        segment_tcp.set_checksum(TCPSocket::compute_tcp_checksum(ipv4.source(), ipv4.destination(), segment_tcp, segment_payload.size()));
+
+        send_raw({ data, headers_size + segment_payload.size() });
+    }
+
+    release_packet_buffer(*segment);
+}
+
+size_t NetworkAdapter::maximum_ipv4_packet_size(IPv4Protocol protocol) const
+{
+    if (protocol == IPv4Protocol::TCP)
+        return max<size_t>(mtu(), m_tcp_segmentation_offload_size);
+    return mtu();
+}
+
+u16 NetworkAdapter::tcp_pseudo_header_checksum(IPv4Packet const& packet, u16 tcp_length)
+{
+    u32 checksum = 0;
+    auto add = [&](u16 value) {
+        checksum += value;
+        if (checksum > 0xffff)
+            checksum = (checksum >> 16) + (checksum & 0xffff);
+    };
+    auto source = packet.source().to_u32();
+    auto destination = packet.destination().to_u32();
+    add(AK::convert_between_host_and_network_endian(static_cast<u16>(source)));
+    add(AK::convert_between_host_and_network_endian(static_cast<u16>(source >> 16)));
+    add(AK::convert_between_host_and_network_endian(static_cast<u16>(destination)));
+    add(AK::convert_between_host_and_network_endian(static_cast<u16>(destination >> 16)));
+    add((u8)IPv4Protocol::TCP);
+    add(tcp_length);
+    return checksum;
+}
+
 void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet)
 {
     size_t size_in_bytes = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -47,7 +130,7 @@ void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet
 void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Address const& source_ipv4, MACAddress const& destination_mac, IPv4Address const& destination_ipv4, IPv4Protocol protocol, size_t payload_size, u8 type_of_service, u8 ttl)
 {
     size_t ipv4_packet_size = sizeof(IPv4Packet) + payload_size;
-    VERIFY(ipv4_packet_size <= mtu());
+    VERIFY(ipv4_packet_size <= maximum_ipv4_packet_size(protocol));
 
     size_t ethernet_frame_size = ipv4_payload_offset() + payload_size;
     VERIFY(packet.buffer->size() == ethernet_frame_size);
@@ -95,20 +178,17 @@ void NetworkAdapter::did_receive(ReadonlyBytes payload)
         on_receive();
 }
 
-size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp)
+size_t NetworkAdapter::dequeue_packets(PacketBatch& batch)
 {
     InterruptDisabler disabler;
-    if (m_packet_queue.is_empty())
-        return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
-    m_packet_queue_size--;
-    packet_timestamp = packet_with_timestamp->timestamp;
-    auto& packet_buffer = packet_with_timestamp->buffer;
-    size_t packet_size = packet_buffer->size();
-    VERIFY(packet_size <= buffer_size);
-    memcpy(buffer, packet_buffer->data(), packet_size);
-    release_packet_buffer(*packet_with_timestamp);
-    return packet_size;
+    size_t count = 0;
+    // Stay within the inline capacity, so we never allocate with interrupts disabled.
+    while (!m_packet_queue.is_empty() && batch.size() < max_packet_batch_size) {
+        batch.unchecked_append(*m_packet_queue.take_first());
+        m_packet_queue_size--;
+        count++;
+    }
+    return count;
 }
 
 RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
@@ -42,6 +42,10 @@ struct PacketWithTimestamp final : public AtomicRefCounted<PacketWithTimestamp>
     IntrusiveListNode<PacketWithTimestamp, RefPtr<PacketWithTimestamp>> packet_node;
 };
 
+// Packets are handed to the network task in batches of up to this many per adapter.
+static constexpr size_t max_packet_batch_size = 64;
+using PacketBatch = Vector<NonnullRefPtr<PacketWithTimestamp>, max_packet_batch_size>;
+
 class NetworkingManagement;
 class NetworkAdapter
     : public AtomicRefCounted<NetworkAdapter>
@@ -79,13 +83,19 @@ public:
     void send(MACAddress const&, ARPPacket const&);
     void fill_in_ipv4_header(PacketWithTimestamp&, IPv4Address const&, MACAddress const&, IPv4Address const&, IPv4Protocol, size_t, u8 type_of_service, u8 ttl);
 
-    size_t dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp);
+    // Moves as many queued packets as fit into the batch. They have to be given back with release_packet_buffer().
+    size_t dequeue_packets(PacketBatch&);
 
     bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
 
     u32 mtu() const { return m_mtu; }
     void set_mtu(u32 mtu) { m_mtu = mtu; }
 
+    // The largest IPv4 packet carrying TCP that the device can split into MTU-sized segments by itself,
+    // or 0 if it can't do TCP segmentation offload.
+    size_t tcp_segmentation_offload_size() const { return m_tcp_segmentation_offload_size; }
+    size_t maximum_ipv4_packet_size(IPv4Protocol) const;
+
     u32 packets_in() const { return m_packets_in; }
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
@@ -108,7 +118,16 @@ protected:
     void did_receive(ReadonlyBytes);
     virtual void send_raw(ReadonlyBytes) = 0;
 
+    void set_tcp_segmentation_offload_size(size_t size) { m_tcp_segmentation_offload_size = size; }
+    // Only called for frames larger than the MTU, which always hold a single IPv4 TCP packet.
+    virtual void send_raw_tcp_segmented(ReadonlyBytes, size_t) { VERIFY_NOT_REACHED(); }
+    // The one's complement sum of the TCP pseudo-header, which devices start from when filling in checksums for us.
+    static u16 tcp_pseudo_header_checksum(IPv4Packet const&, u16 tcp_length);
+
 private:
+    // Splits an oversized TCP frame into MTU-sized ones for when the device can't do it for us.
+    void send_tcp_segmented_in_software(ReadonlyBytes, size_t maximum_segment_size);
+
     MACAddress m_mac_address;
     IPv4Address m_ipv4_address;
     IPv4Address m_ipv4_netmask;
@@ -127,6 +146,7 @@ private:
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
     u32 m_mtu { 1500 };
+    size_t m_tcp_segmentation_offload_size { 0 };
     u32 m_packets_dropped { 0 };
 };
 
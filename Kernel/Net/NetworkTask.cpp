@@ -25,6 +25,8 @@
 
 namespace Kernel {
 
+static void handle_packet_batch(NetworkAdapter&, PacketBatch&, Bytes coalescing_buffer);
+static void handle_frame(ReadonlyBytes frame, UnixDateTime const& packet_timestamp);
 static void handle_arp(EthernetFrameHeader const&, size_t frame_size);
 static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, UnixDateTime const& packet_timestamp);
 static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, UnixDateTime const& packet_timestamp);
@@ -71,63 +73,173 @@ void NetworkTask_main(void*)
         };
     });
 
-    auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp) -> size_t {
-        if (pending_packets == 0)
-            return 0;
-        size_t packet_size = 0;
-        NetworkingManagement::the().for_each([&](auto& adapter) {
-            if (packet_size || !adapter.has_queued_packets())
-                return;
-            packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
-            pending_packets--;
-            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
-        });
-        return packet_size;
-    };
-
     size_t buffer_size = 64 * KiB;
     auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer"sv, Memory::Region::Access::ReadWrite);
     if (region_or_error.is_error())
         TODO();
     auto buffer_region = region_or_error.release_value();
-    auto buffer = (u8*)buffer_region->vaddr().get();
-    UnixDateTime packet_timestamp;
+    Bytes coalescing_buffer { buffer_region->vaddr().as_ptr(), buffer_size };
+
+    Vector<NonnullRefPtr<NetworkAdapter>, 8> adapters_with_packets;
+    PacketBatch batch;
 
     while (!Process::current().is_dying()) {
         flush_delayed_tcp_acks();
         retransmit_tcp_packets();
-        size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
-        if (!packet_size) {
+
+        adapters_with_packets.clear_with_capacity();
+        if (pending_packets > 0) {
+            NetworkingManagement::the().for_each([&](auto& adapter) {
+                if (adapter.has_queued_packets())
+                    (void)adapters_with_packets.try_append(adapter);
+            });
+        }
+        if (adapters_with_packets.is_empty()) {
             auto timeout_time = Duration::from_milliseconds(500);
             auto timeout = Thread::BlockTimeout { false, &timeout_time };
             [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
             continue;
         }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
-            continue;
-        }
-        auto& eth = *(EthernetFrameHeader const*)buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
-
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size);
-            break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, packet_timestamp);
-            break;
-        case EtherType::IPv6:
-            // ignore
-            break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+
+        // Take everything each adapter has queued up at once, so we can coalesce consecutive TCP segments
+        // and don't have to look at the queues again for every single packet.
+        for (auto& adapter : adapters_with_packets) {
+            batch.clear_with_capacity();
+            auto count = adapter->dequeue_packets(batch);
+            pending_packets -= min<int>(count, pending_packets);
+            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued {} packets from {}", count, adapter->name());
+            handle_packet_batch(*adapter, batch, coalescing_buffer);
+            for (auto& packet : batch)
+                adapter->release_packet_buffer(*packet);
         }
     }
     Process::current().sys$exit(0);
     VERIFY_NOT_REACHED();
 }
 
+struct CoalescableTCPSegment {
+    IPv4Packet const* ipv4_packet { nullptr };
+    TCPPacket const* tcp_packet { nullptr };
+    size_t header_size { 0 };
+    size_t payload_size { 0 };
+
+    ReadonlyBytes headers() const { return { reinterpret_cast<u8 const*>(ipv4_packet) - sizeof(EthernetFrameHeader), header_size }; }
+    ReadonlyBytes payload() const { return { static_cast<u8 const*>(tcp_packet->payload()), payload_size }; }
+};
+
+// Plain in-order data segments are the only ones worth merging; everything else changes connection state.
+static Optional<CoalescableTCPSegment> coalescable_tcp_segment(ReadonlyBytes frame)
+{
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + sizeof(TCPPacket))
+        return {};
+    auto& eth = *reinterpret_cast<EthernetFrameHeader const*>(frame.data());
+    if (eth.ether_type() != EtherType::IPv4)
+        return {};
+    auto& ipv4_packet = *static_cast<IPv4Packet const*>(eth.payload());
+    if (ipv4_packet.internet_header_length() != 5 || ipv4_packet.protocol() != (u8)IPv4Protocol::TCP)
+        return {};
+    if (ipv4_packet.is_a_fragment() || ipv4_packet.length() > frame.size() - sizeof(EthernetFrameHeader))
+        return {};
+    auto& tcp_packet = *static_cast<TCPPacket const*>(ipv4_packet.payload());
+    if (tcp_packet.header_size() < sizeof(TCPPacket) || ipv4_packet.payload_size() <= tcp_packet.header_size())
+        return {};
+    if ((tcp_packet.flags() & ~TCPFlags::PSH) != TCPFlags::ACK)
+        return {};
+    auto header_size = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + tcp_packet.header_size();
+    return CoalescableTCPSegment { &ipv4_packet, &tcp_packet, header_size, ipv4_packet.payload_size() - tcp_packet.header_size() };
+}
+
+static bool can_append_tcp_segment(CoalescableTCPSegment const& last, CoalescableTCPSegment const& next)
+{
+    // A pushed segment ends what the sender wanted delivered together.
+    if (last.tcp_packet->flags() & TCPFlags::PSH)
+        return false;
+    if (last.ipv4_packet->source() != next.ipv4_packet->source() || last.ipv4_packet->destination() != next.ipv4_packet->destination())
+        return false;
+    if (last.tcp_packet->source_port() != next.tcp_packet->source_port() || last.tcp_packet->destination_port() != next.tcp_packet->destination_port())
+        return false;
+    if (last.tcp_packet->sequence_number() + last.payload_size != next.tcp_packet->sequence_number())
+        return false;
+    if (last.tcp_packet->ack_number() != next.tcp_packet->ack_number())
+        return false;
+    // Options (such as timestamps) have to match, as only the first segment's will survive.
+    if (last.header_size != next.header_size)
+        return false;
+    auto options_offset = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + sizeof(TCPPacket);
+    return last.headers().slice(options_offset) == next.headers().slice(options_offset);
+}
+
+// Generic receive offload: merges runs of consecutive segments of the same TCP connection into one large segment,
+// so sockets take their locks, copy into their receive buffer, and decide whether to ACK once per run.
+void handle_packet_batch(NetworkAdapter&, PacketBatch& batch, Bytes coalescing_buffer)
+{
+    for (size_t i = 0; i < batch.size();) {
+        auto& first_packet = batch[i];
+        auto first_segment = coalescable_tcp_segment(first_packet->bytes());
+
+        size_t run_length = 1;
+        size_t run_size = first_segment.has_value() ? first_segment->header_size + first_segment->payload_size : 0;
+        auto last_segment = first_segment;
+        while (first_segment.has_value() && i + run_length < batch.size()) {
+            auto next_segment = coalescable_tcp_segment(batch[i + run_length]->bytes());
+            if (!next_segment.has_value() || !can_append_tcp_segment(*last_segment, *next_segment))
+                break;
+            if (run_size + next_segment->payload_size > min(coalescing_buffer.size(), sizeof(EthernetFrameHeader) + NumericLimits<u16>::max()))
+                break;
+            run_size += next_segment->payload_size;
+            last_segment = next_segment;
+            ++run_length;
+        }
+
+        if (run_length == 1) {
+            handle_frame(first_packet->bytes(), first_packet->timestamp);
+            ++i;
+            continue;
+        }
+
+        dbgln_if(TCP_DEBUG, "handle_packet_batch: Coalescing {} TCP segments ({} bytes)", run_length, run_size);
+        size_t offset = first_segment->headers().copy_to(coalescing_buffer);
+        for (size_t j = 0; j < run_length; ++j) {
+            auto segment = coalescable_tcp_segment(batch[i + j]->bytes());
+            offset += segment->payload().copy_to(coalescing_buffer.slice(offset));
+        }
+        VERIFY(offset == run_size);
+
+        auto& merged_ipv4_packet = *reinterpret_cast<IPv4Packet*>(coalescing_buffer.offset(sizeof(EthernetFrameHeader)));
+        merged_ipv4_packet.set_length(run_size - sizeof(EthernetFrameHeader));
+        auto& merged_tcp_packet = *static_cast<TCPPacket*>(merged_ipv4_packet.payload());
+        merged_tcp_packet.set_flags(last_segment->tcp_packet->flags());
+        merged_tcp_packet.set_window_size(last_segment->tcp_packet->window_size());
+
+        handle_frame(coalescing_buffer.trim(run_size), first_packet->timestamp);
+        i += run_length;
+    }
+}
+
+void handle_frame(ReadonlyBytes frame, UnixDateTime const& packet_timestamp)
+{
+    if (frame.size() < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", frame.size());
+        return;
+    }
+    auto& eth = *(EthernetFrameHeader const*)frame.data();
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), frame.size());
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, frame.size());
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(eth, frame.size(), packet_timestamp);
+        break;
+    case EtherType::IPv6:
+        // ignore
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+    }
+}
+
 void handle_arp(EthernetFrameHeader const& eth, size_t frame_size)
 {
     constexpr size_t minimum_arp_frame_size = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -431,8 +543,13 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
 
     socket->receive_tcp_packet(tcp_packet, ipv4_packet.payload_size());
     Optional<u8> send_window_scale;
+    bool sack_permitted = false;
     if (tcp_packet.has_syn()) {
-        tcp_packet.for_each_option([&send_window_scale](auto const& option) {
+        tcp_packet.for_each_option([&send_window_scale, &sack_permitted](auto const& option) {
+            if (option.kind() == TCPOptionKind::SACKPermitted && option.length() == sizeof(TCPOptionSACKPermitted)) {
+                sack_permitted = true;
+                return;
+            }
             if (option.kind() != TCPOptionKind::WindowScale)
                 return;
             if (option.length() != sizeof(TCPOptionWindowScale))
@@ -479,6 +596,8 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             client->set_state(TCPSocket::State::SynReceived);
             if (send_window_scale.has_value())
                 client->set_send_window_scale(*send_window_scale);
+            if (sack_permitted)
+                client->set_sack_permitted();
             return;
         }
         default:
@@ -494,6 +613,8 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             socket->set_state(TCPSocket::State::SynReceived);
             if (send_window_scale.has_value())
                 socket->set_send_window_scale(*send_window_scale);
+            if (sack_permitted)
+                socket->set_sack_permitted();
             return;
         case TCPFlags::ACK | TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
@@ -503,6 +624,8 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             socket->set_connected(true);
             if (send_window_scale.has_value())
                 socket->set_send_window_scale(*send_window_scale);
+            if (sack_permitted)
+                socket->set_sack_permitted();
             return;
         case TCPFlags::ACK | TCPFlags::FIN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
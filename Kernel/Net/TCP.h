@@ -74,7 +74,29 @@ private:
     NetworkOrdered<u8> m_value;
 };
 
+class [[gnu::packed]] TCPOptionSACKPermitted : public TCPOption {
+public:
+    TCPOptionSACKPermitted()
+        : TCPOption(TCPOptionKind::SACKPermitted, sizeof(TCPOptionSACKPermitted))
+    {
+    }
+};
+
+// RFC 2018: Blocks of data the receiver holds beyond the cumulative ACK.
+class [[gnu::packed]] TCPOptionSACK : public TCPOption {
+public:
+    struct [[gnu::packed]] Block {
+        NetworkOrdered<u32> left_edge;
+        NetworkOrdered<u32> right_edge;
+    };
+
+    size_t block_count() const { return (length() - sizeof(TCPOption)) / sizeof(Block); }
+    Block const& block(size_t index) const { return reinterpret_cast<Block const*>(this + 1)[index]; }
+};
+
 static_assert(AssertSize<TCPOptionMSS, 4>());
+static_assert(AssertSize<TCPOptionSACKPermitted, 2>());
+static_assert(AssertSize<TCPOptionSACK::Block, 8>());
 
 class [[gnu::packed]] TCPPacket {
 public:
@@ -111,6 +133,8 @@ public:
 
     u16 checksum() const { return m_checksum; }
     void set_checksum(u16 checksum) { m_checksum = checksum; }
+    // Where the checksum lives, for network devices that fill it in for us.
+    static constexpr size_t checksum_offset = 16;
 
     u16 urgent() const { return m_urgent; }
     void set_urgent(u16 urgent) { m_urgent = urgent; }
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullOwnPtr<TCPCongestionControl>> TCPCongestionControl::try_create(StringView algorithm_name)
+{
+    if (algorithm_name == TCPCubicCongestionControl::algorithm_name)
+        return adopt_nonnull_own_or_enomem<TCPCongestionControl>(new (nothrow) TCPCubicCongestionControl);
+    if (algorithm_name == TCPNewRenoCongestionControl::algorithm_name || algorithm_name == "reno"sv)
+        return adopt_nonnull_own_or_enomem<TCPCongestionControl>(new (nothrow) TCPNewRenoCongestionControl);
+    return ENOENT;
+}
+
+void TCPCongestionControl::set_maximum_segment_size(size_t maximum_segment_size)
+{
+    VERIFY(maximum_segment_size > 0);
+    if (m_maximum_segment_size == 0) {
+        // RFC 6928: IW = min(10*MSS, max(2*MSS, 14600))
+        m_congestion_window = min(10 * maximum_segment_size, max<size_t>(2 * maximum_segment_size, 14600));
+    }
+    m_maximum_segment_size = maximum_segment_size;
+    m_congestion_window = max(m_congestion_window, maximum_segment_size);
+}
+
+void TCPCongestionControl::on_ack(size_t acked_bytes, MonotonicTime now, Duration smoothed_round_trip_time)
+{
+    if (m_maximum_segment_size == 0 || acked_bytes == 0)
+        return;
+
+    if (is_in_slow_start()) {
+        // RFC 5681, 3.1: Grow by the amount of data acknowledged, but don't overshoot ssthresh;
+        // whatever is left over counts towards congestion avoidance.
+        auto increase = min(acked_bytes, m_slow_start_threshold - m_congestion_window);
+        m_congestion_window += increase;
+        acked_bytes -= increase;
+        if (acked_bytes == 0)
+            return;
+    }
+
+    grow_in_congestion_avoidance(acked_bytes, now, smoothed_round_trip_time);
+}
+
+void TCPCongestionControl::on_enter_fast_recovery(size_t flight_size, MonotonicTime now)
+{
+    m_slow_start_threshold = slow_start_threshold_after_loss(flight_size, now);
+    m_congestion_window = m_slow_start_threshold + 3 * m_maximum_segment_size;
+}
+
+void TCPCongestionControl::on_duplicate_ack_in_fast_recovery()
+{
+    m_congestion_window += m_maximum_segment_size;
+}
+
+void TCPCongestionControl::on_partial_ack(size_t acked_bytes)
+{
+    m_congestion_window = max(m_congestion_window - min(acked_bytes, m_congestion_window), m_maximum_segment_size);
+    if (acked_bytes >= m_maximum_segment_size)
+        m_congestion_window += m_maximum_segment_size;
+}
+
+void TCPCongestionControl::on_exit_fast_recovery(size_t flight_size)
+{
+    // RFC 6582, 3.2 step 3, option 1: Deflate the window, avoiding a burst if little data is outstanding.
+    m_congestion_window = min(m_slow_start_threshold, max(flight_size, m_maximum_segment_size) + m_maximum_segment_size);
+}
+
+void TCPCongestionControl::on_retransmit_timeout(size_t flight_size, MonotonicTime now)
+{
+    m_slow_start_threshold = slow_start_threshold_after_loss(flight_size, now);
+    m_congestion_window = m_maximum_segment_size;
+}
+
+void TCPNewRenoCongestionControl::grow_in_congestion_avoidance(size_t acked_bytes, MonotonicTime, Duration)
+{
+    // RFC 5681, 3.1: Appropriate Byte Counting (RFC 3465) - add one segment once a full window was acknowledged.
+    m_bytes_acked += acked_bytes;
+    if (m_bytes_acked >= m_congestion_window) {
+        m_bytes_acked -= m_congestion_window;
+        m_congestion_window += maximum_segment_size();
+    }
+}
+
+size_t TCPNewRenoCongestionControl::slow_start_threshold_after_loss(size_t flight_size, MonotonicTime)
+{
+    m_bytes_acked = 0;
+    // RFC 5681, equation (4): ssthresh = max (FlightSize / 2, 2*SMSS)
+    return max(flight_size / 2, 2 * maximum_segment_size());
+}
+
+// RFC 9438, 4.2: C = 0.4 and beta_cubic = 0.7, kept as fractions since there is no FPU to use.
+static constexpr u64 cubic_c_numerator = 4;
+static constexpr u64 cubic_c_denominator = 10;
+static constexpr u64 cubic_beta_numerator = 7;
+static constexpr u64 cubic_beta_denominator = 10;
+
+// RFC 9438, 4.3: alpha_cubic = 3 * (1 - beta_cubic) / (1 + beta_cubic), in thousandths.
+static constexpr u64 cubic_alpha_per_mille = 3 * (cubic_beta_denominator - cubic_beta_numerator) * 1000 / (cubic_beta_denominator + cubic_beta_numerator);
+
+// Anything further away from the origin than this is far off the chart anyway, and it keeps the cube below overflowing.
+static constexpr i64 cubic_maximum_milliseconds_from_origin = 100'000;
+
+static u64 integer_cube_root(u64 value)
+{
+    // Binary search for the largest root with root^3 <= value; cube roots of 64-bit values fit in 21 bits.
+    u64 low = 0;
+    u64 high = 1u << 21;
+    while (low + 1 < high) {
+        auto middle = (low + high) / 2;
+        if (middle * middle * middle <= value)
+            low = middle;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+size_t TCPCubicCongestionControl::cubic_window_at(i64 milliseconds_since_epoch_start) const
+{
+    // RFC 9438, equation (1): W_cubic(t) = C * (t - K)^3 + W_max, with t and K in seconds and W in segments.
+    auto distance = clamp(milliseconds_since_epoch_start - m_milliseconds_to_origin, -cubic_maximum_milliseconds_from_origin, cubic_maximum_milliseconds_from_origin);
+    bool is_negative = distance < 0;
+    u64 magnitude = is_negative ? -distance : distance;
+    u64 distance_cubed = magnitude * magnitude * magnitude;
+
+    // distance^3 is in ms^3, i.e. 10^9 times the cube in seconds. Scale down in two steps to stay below 2^64.
+    u64 offset = distance_cubed * cubic_c_numerator / cubic_c_denominator / 1'000'000 * maximum_segment_size() / 1000;
+    if (is_negative)
+        return offset >= m_origin_window ? maximum_segment_size() : max<size_t>(m_origin_window - offset, maximum_segment_size());
+    return m_origin_window + offset;
+}
+
+void TCPCubicCongestionControl::grow_in_congestion_avoidance(size_t acked_bytes, MonotonicTime now, Duration smoothed_round_trip_time)
+{
+    auto mss = maximum_segment_size();
+
+    if (!m_epoch_start.has_value()) {
+        m_epoch_start = now;
+        m_reno_friendly_window = m_congestion_window;
+        if (m_congestion_window < m_window_before_reduction) {
+            // RFC 9438, equation (2): K = cubic_root((W_max - cwnd_epoch) / C), with W in segments and K in seconds.
+            // In milliseconds, that is cubic_root((W_max - cwnd_epoch) / C * 10^9).
+            u64 missing_bytes = m_window_before_reduction - m_congestion_window;
+            u64 scaled = missing_bytes * 1'000'000 / mss * 1000 * cubic_c_denominator / cubic_c_numerator;
+            m_milliseconds_to_origin = static_cast<i64>(integer_cube_root(scaled));
+            m_origin_window = m_window_before_reduction;
+        } else {
+            m_milliseconds_to_origin = 0;
+            m_origin_window = m_congestion_window;
+        }
+    }
+
+    // RFC 9438, 4.3: Estimate what Reno would do, and don't do worse than that.
+    m_reno_friendly_window += cubic_alpha_per_mille * acked_bytes * mss / 1000 / m_congestion_window;
+
+    // RFC 9438, 4.2: Aim for where the curve will be one round trip from now.
+    auto elapsed = (now - *m_epoch_start) + smoothed_round_trip_time;
+    auto target = cubic_window_at(elapsed.to_milliseconds());
+
+    if (target < m_reno_friendly_window) {
+        m_congestion_window = max(m_congestion_window, m_reno_friendly_window);
+        return;
+    }
+
+    // RFC 9438, 4.2: The target is capped at 1.5 * cwnd, and the window moves toward it by (target - cwnd) / cwnd per segment acknowledged.
+    target = min(target, m_congestion_window + m_congestion_window / 2);
+    if (target > m_congestion_window)
+        m_congestion_window += static_cast<u64>(target - m_congestion_window) * acked_bytes / m_congestion_window;
+}
+
+size_t TCPCubicCongestionControl::slow_start_threshold_after_loss(size_t flight_size, MonotonicTime)
+{
+    m_epoch_start.clear();
+
+    // RFC 9438, 4.7: Fast convergence - when losses come before reaching the previous maximum,
+    // someone else is competing for the bandwidth, so release some of it.
+    if (m_congestion_window < m_window_before_reduction)
+        m_window_before_reduction = m_congestion_window * (cubic_beta_denominator + cubic_beta_numerator) / (2 * cubic_beta_denominator);
+    else
+        m_window_before_reduction = m_congestion_window;
+
+    // RFC 9438, 4.6: ssthresh = flight_size * beta_cubic
+    return max<size_t>(flight_size * cubic_beta_numerator / cubic_beta_denominator, 2 * maximum_segment_size());
+}
+
+}
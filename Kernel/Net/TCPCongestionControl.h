@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+
+namespace Kernel {
+
+// Keeps track of the congestion window (cwnd) and slow start threshold (ssthresh) of a TCP connection.
+// Slow start and the loss responses are shared; subclasses decide how the window grows during
+// congestion avoidance and how far it is cut back after a loss.
+// All sizes are in bytes.
+class TCPCongestionControl {
+    AK_MAKE_NONCOPYABLE(TCPCongestionControl);
+    AK_MAKE_NONMOVABLE(TCPCongestionControl);
+
+public:
+    static constexpr StringView default_algorithm_name = "cubic"sv;
+    static constexpr size_t maximum_algorithm_name_length = 16;
+
+    static ErrorOr<NonnullOwnPtr<TCPCongestionControl>> try_create(StringView algorithm_name);
+    virtual ~TCPCongestionControl() = default;
+
+    virtual StringView name() const = 0;
+
+    size_t congestion_window() const { return m_congestion_window; }
+    size_t slow_start_threshold() const { return m_slow_start_threshold; }
+    bool is_in_slow_start() const { return m_congestion_window < m_slow_start_threshold; }
+
+    // The first call also sets up the initial window (RFC 6928).
+    void set_maximum_segment_size(size_t);
+
+    // New data was acknowledged outside of loss recovery.
+    void on_ack(size_t acked_bytes, MonotonicTime now, Duration smoothed_round_trip_time);
+
+    // RFC 5681, 3.2: Three duplicate ACKs were received, the first unacknowledged segment is being retransmitted.
+    void on_enter_fast_recovery(size_t flight_size, MonotonicTime now);
+    // RFC 5681, 3.2 step 4: Every further duplicate ACK means another segment has left the network.
+    void on_duplicate_ack_in_fast_recovery();
+    // RFC 6582, 3.2 step 3: Deflate the window by the amount of data that was acknowledged.
+    void on_partial_ack(size_t acked_bytes);
+    void on_exit_fast_recovery(size_t flight_size);
+
+    // RFC 5681, 3.1: The retransmission timer expired, start over with a loss window of one segment.
+    void on_retransmit_timeout(size_t flight_size, MonotonicTime now);
+
+protected:
+    TCPCongestionControl() = default;
+
+    size_t maximum_segment_size() const { return m_maximum_segment_size; }
+
+    virtual void grow_in_congestion_avoidance(size_t acked_bytes, MonotonicTime now, Duration smoothed_round_trip_time) = 0;
+    virtual size_t slow_start_threshold_after_loss(size_t flight_size, MonotonicTime now) = 0;
+
+    size_t m_congestion_window { 0 };
+    size_t m_slow_start_threshold { NumericLimits<size_t>::max() };
+
+private:
+    size_t m_maximum_segment_size { 0 };
+};
+
+// RFC 5681 and RFC 6582: Grow by one segment per round trip, halve the window on loss.
+class TCPNewRenoCongestionControl final : public TCPCongestionControl {
+public:
+    static constexpr StringView algorithm_name = "newreno"sv;
+
+    virtual StringView name() const override { return algorithm_name; }
+
+private:
+    virtual void grow_in_congestion_avoidance(size_t acked_bytes, MonotonicTime, Duration) override;
+    virtual size_t slow_start_threshold_after_loss(size_t flight_size, MonotonicTime) override;
+
+    size_t m_bytes_acked { 0 };
+};
+
+// RFC 9438: Grow along a cubic function of the time since the last loss, centered on the
+// window size at which that loss happened. Since the kernel can't use floating point, the
+// curve is evaluated in milliseconds and fixed-point segment counts.
+class TCPCubicCongestionControl final : public TCPCongestionControl {
+public:
+    static constexpr StringView algorithm_name = "cubic"sv;
+
+    virtual StringView name() const override { return algorithm_name; }
+
+private:
+    virtual void grow_in_congestion_avoidance(size_t acked_bytes, MonotonicTime, Duration smoothed_round_trip_time) override;
+    virtual size_t slow_start_threshold_after_loss(size_t flight_size, MonotonicTime) override;
+
+    size_t cubic_window_at(i64 milliseconds_since_epoch_start) const;
+
+    // The epoch starts with the first ACK after a window reduction.
+    Optional<MonotonicTime> m_epoch_start;
+    size_t m_window_before_reduction { 0 };
+    size_t m_origin_window { 0 };
+    i64 m_milliseconds_to_origin { 0 };
+    size_t m_reno_friendly_window { 0 };
+};
+
+}
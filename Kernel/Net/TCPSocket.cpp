@@ -150,7 +150,7 @@ ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create_client(IPv4Address const
             return EEXIST;
 
         auto receive_buffer = TRY(try_create_receive_buffer());
-        auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer)));
+        auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer), m_congestion_control->name()));
 
         client->set_setup_state(SetupState::InProgress);
         client->set_local_address(new_local_address);
@@ -184,10 +184,11 @@ void TCPSocket::release_for_accept(NonnullRefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer)
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer, NonnullOwnPtr<TCPCongestionControl> congestion_control)
     : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
+    , m_congestion_control(move(congestion_control))
     , m_last_ack_sent_time(TimeManagement::the().monotonic_time())
-    , m_last_retransmit_time(TimeManagement::the().monotonic_time())
+    , m_retransmit_timer_start(TimeManagement::the().monotonic_time())
     , m_timer(timer)
 {
 }
@@ -199,12 +200,13 @@ TCPSocket::~TCPSocket()
     dbgln_if(TCP_SOCKET_DEBUG, "~TCPSocket in state {}", to_string(state()));
 }
 
-ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
+ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, StringView congestion_control_algorithm)
 {
     // Note: Scratch buffer is only used for SOCK_STREAM sockets.
     auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
     auto timer = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Timer));
-    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), timer));
+    auto congestion_control = TRY(TCPCongestionControl::try_create(congestion_control_algorithm));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), timer, move(congestion_control)));
 }
 
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -232,6 +234,12 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
     size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    m_congestion_control->set_maximum_segment_size(mss);
+
+    // Don't put more data on the wire than the congestion window allows; can_write() holds writers back until ACKs open it up again.
+    auto congestion_space = congestion_window_space();
+    if (congestion_space == 0)
+        return set_so_error(EAGAIN);
 
     if (!m_no_delay) {
         // RFC 896 (Nagle’s algorithm): https://www.ietf.org/rfc/rfc0896
@@ -245,7 +253,15 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
             return set_so_error(EAGAIN);
     }
 
-    data_length = min(data_length, mss);
+    // If the adapter can cut segments up by itself, hand it as much as the peer's and the congestion window allow in one go.
+    size_t maximum_send_size = mss;
+    if (auto offload_size = routing_decision.adapter->tcp_segmentation_offload_size(); offload_size > mss) {
+        auto unacked_size = m_unacked_packets.with_shared([&](auto const& packets) { return packets.size; });
+        auto window_space = m_send_window_size > unacked_size ? m_send_window_size - unacked_size : 0;
+        maximum_send_size = clamp<size_t>(min(window_space, congestion_space), mss, offload_size - sizeof(IPv4Packet) - sizeof(TCPPacket));
+    }
+
+    data_length = min(data_length, maximum_send_size);
     TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
     return data_length;
 }
@@ -268,7 +284,10 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     bool const has_mss_option = flags & TCPFlags::SYN;
     bool const has_window_scale_option = flags & TCPFlags::SYN;
-    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0) + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0);
+    bool const has_sack_permitted_option = flags & TCPFlags::SYN;
+    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0)
+        + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0)
+        + (has_sack_permitted_option ? sizeof(TCPOptionSACKPermitted) : 0);
     size_t const tcp_header_size = sizeof(TCPPacket) + align_up_to(options_size, 4);
     size_t const buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
@@ -303,6 +322,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         tcp_packet.set_ack_number(m_ack_number);
     }
 
+    auto sequence_number = m_sequence_number;
     if (flags & TCPFlags::SYN) {
         ++m_sequence_number;
     } else {
@@ -321,6 +341,11 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         memcpy(next_option, &window_scale_option, sizeof(window_scale_option));
         next_option += sizeof(window_scale_option);
     }
+    if (has_sack_permitted_option) {
+        TCPOptionSACKPermitted sack_permitted_option;
+        memcpy(next_option, &sack_permitted_option, sizeof(sack_permitted_option));
+        next_option += sizeof(sack_permitted_option);
+    }
     if ((options_size % 4) != 0)
         *next_option = to_underlying(TCPOptionKind::End);
 
@@ -329,8 +354,22 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     bool expect_ack { tcp_packet.has_syn() || payload_size > 0 };
     if (expect_ack) {
         bool append_failed { false };
+        auto now = TimeManagement::the().monotonic_time(TimePrecision::Precise);
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
+            // RFC 6298, 5.1: Start the retransmission timer if it isn't already running.
+            if (unacked_packets.packets.is_empty())
+                m_retransmit_timer_start = now;
+
+            OutgoingPacket outgoing_packet {
+                .ack_number = m_sequence_number,
+                .buffer = packet,
+                .ipv4_payload_offset = ipv4_payload_offset,
+                .adapter = *routing_decision.adapter,
+                .sequence_number = sequence_number,
+                .payload_size = payload_size,
+                .sent_time = now,
+            };
+            auto result = unacked_packets.packets.try_append(move(outgoing_packet));
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
                 append_failed = true;
@@ -352,31 +391,70 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     return {};
 }
 
+// Sequence numbers wrap around, so compare them by their distance (RFC 9293, 3.4).
+static bool sequence_number_less_than(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) < 0;
+}
+
+static bool sequence_number_less_than_or_equal(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) <= 0;
+}
+
 void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
     if (packet.has_ack()) {
         u32 ack_number = packet.ack_number();
+        auto now = TimeManagement::the().monotonic_time(TimePrecision::Precise);
 
         dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
+        // The window field of a SYN is never scaled (RFC 7323, 2.2).
+        u32 send_window_size = packet.window_size();
+        if (!packet.has_syn())
+            send_window_size <<= m_send_window_scale;
+        bool const window_changed = send_window_size != m_send_window_size;
+        size_t const payload_size = size - packet.header_size();
+
         int removed = 0;
+        size_t acked_bytes = 0;
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+            bool is_old_ack = false;
+            bool is_duplicate_ack = false;
+            if (!unacked_packets.packets.is_empty()) {
+                auto first_unacked_sequence_number = unacked_packets.packets.first().sequence_number;
+                is_old_ack = sequence_number_less_than(ack_number, first_unacked_sequence_number);
+                // RFC 5681, 2: A duplicate ACK acknowledges nothing new, carries no data and no SYN or FIN,
+                // doesn't change the window, and arrives while data is outstanding.
+                is_duplicate_ack = ack_number == first_unacked_sequence_number
+                    && payload_size == 0 && !packet.has_syn() && !packet.has_fin() && !window_changed;
+            }
+
+            // Don't let a reordered, older segment shrink the window again.
+            if (!is_old_ack)
+                m_send_window_size = send_window_size;
+
+            if (m_sack_permitted)
+                process_sack_option(unacked_packets, packet);
+
+            Optional<Duration> round_trip_time_sample;
             while (!unacked_packets.packets.is_empty()) {
                 auto& packet = unacked_packets.packets.first();
 
                 dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
 
-                if (packet.ack_number <= ack_number) {
+                if (sequence_number_less_than_or_equal(packet.ack_number, ack_number)) {
                     auto old_adapter = packet.adapter.strong_ref();
                     if (old_adapter)
                         old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    if (m_send_window_size != tcp_packet.window_size()) {
-                        m_send_window_size = tcp_packet.window_size() << m_send_window_scale;
-                    }
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
+                    // RFC 6298, 3: Karn's algorithm - an ACK for a retransmitted segment is ambiguous, so don't sample it.
+                    if (packet.tx_counter == 0)
+                        round_trip_time_sample = now - packet.sent_time;
+                    unacked_packets.size -= packet.payload_size;
+                    if (packet.sacked)
+                        unacked_packets.sacked_size -= packet.payload_size;
+                    acked_bytes += packet.payload_size;
                     unacked_packets.packets.take_first();
                     removed++;
                 } else {
@@ -384,19 +462,155 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
                 }
             }
 
+            if (round_trip_time_sample.has_value())
+                update_round_trip_time(*round_trip_time_sample);
+
+            if (removed > 0) {
+                // RFC 6298, 5.3: Restart the timer whenever new data is acknowledged.
+                m_retransmit_attempts = 0;
+                m_retransmit_timer_start = now;
+                m_duplicate_acks_received = 0;
+            } else if (is_duplicate_ack) {
+                ++m_duplicate_acks_received;
+            }
+
+            auto smoothed_round_trip_time = m_smoothed_round_trip_time.value_or({});
+            bool should_retransmit = false;
+            bool retransmit_first_unconditionally = false;
+            switch (m_loss_recovery) {
+            case LossRecovery::None:
+                if (removed > 0) {
+                    m_congestion_control->on_ack(acked_bytes, now, smoothed_round_trip_time);
+                } else if (is_duplicate_ack && m_duplicate_acks_received == duplicate_ack_threshold) {
+                    // RFC 5681, 3.2 and RFC 6582, 3.2: Fast retransmit, then stay in fast recovery until
+                    // everything that was outstanding at this point has been acknowledged.
+                    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) entering fast recovery at {}", this, ack_number);
+                    for (auto& packet : unacked_packets.packets)
+                        packet.retransmitted_in_recovery = false;
+                    m_loss_recovery = LossRecovery::FastRecovery;
+                    m_recovery_point = m_sequence_number;
+                    m_congestion_control->on_enter_fast_recovery(bytes_in_flight(unacked_packets), now);
+                    should_retransmit = true;
+                    retransmit_first_unconditionally = true;
+                }
+                break;
+            case LossRecovery::FastRecovery:
+            case LossRecovery::RetransmitTimeout:
+                if (removed > 0 && sequence_number_less_than_or_equal(m_recovery_point, ack_number)) {
+                    if (m_loss_recovery == LossRecovery::FastRecovery)
+                        m_congestion_control->on_exit_fast_recovery(bytes_in_flight(unacked_packets));
+                    else
+                        m_congestion_control->on_ack(acked_bytes, now, smoothed_round_trip_time);
+                    m_loss_recovery = LossRecovery::None;
+                } else if (removed > 0) {
+                    // RFC 6582, 3.2 step 5: A partial ACK means the next segment was lost as well.
+                    // After a timeout, the window is in slow start again and everything is resent as it opens.
+                    if (m_loss_recovery == LossRecovery::FastRecovery) {
+                        m_congestion_control->on_partial_ack(acked_bytes);
+                        retransmit_first_unconditionally = true;
+                    } else {
+                        m_congestion_control->on_ack(acked_bytes, now, smoothed_round_trip_time);
+                    }
+                    should_retransmit = true;
+                } else if (is_duplicate_ack && m_loss_recovery == LossRecovery::FastRecovery) {
+                    m_congestion_control->on_duplicate_ack_in_fast_recovery();
+                    // With SACK, the new information may have revealed more holes to fill (RFC 6675, 5).
+                    should_retransmit = m_sack_permitted;
+                }
+                break;
+            }
+
+            if (should_retransmit) {
+                auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
+                auto routing_decision = route_to(peer_address(), local_address(), adapter);
+                if (!routing_decision.is_zero())
+                    retransmit_lost_packets(unacked_packets, routing_decision, retransmit_first_unconditionally);
+            }
+
             if (unacked_packets.packets.is_empty()) {
                 m_retransmit_attempts = 0;
+                m_loss_recovery = LossRecovery::None;
                 dequeue_for_retransmit();
             }
 
-            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets, cwnd={}", removed, m_congestion_control->congestion_window());
         });
+
+        if (removed > 0 || window_changed)
+            evaluate_block_conditions();
     }
 
     m_packets_in++;
     m_bytes_in += packet.header_size() + size;
 }
 
+void TCPSocket::process_sack_option(UnackedPackets& unacked_packets, TCPPacket const& packet)
+{
+    if (unacked_packets.packets.is_empty())
+        return;
+    if (unacked_packets.sacked_size == 0)
+        m_highest_sacked_sequence_number = unacked_packets.packets.first().sequence_number;
+
+    auto const* options_end = static_cast<u8 const*>(packet.payload());
+    packet.for_each_option([&](auto const& option) {
+        if (option.kind() != TCPOptionKind::SACK)
+            return;
+        if (reinterpret_cast<u8 const*>(&option) + option.length() > options_end)
+            return;
+        auto const& sack_option = static_cast<TCPOptionSACK const&>(option);
+        for (size_t i = 0; i < sack_option.block_count(); ++i) {
+            u32 left_edge = sack_option.block(i).left_edge;
+            u32 right_edge = sack_option.block(i).right_edge;
+            if (!sequence_number_less_than(left_edge, right_edge))
+                continue;
+            for (auto& unacked_packet : unacked_packets.packets) {
+                if (unacked_packet.sacked || unacked_packet.payload_size == 0)
+                    continue;
+                if (sequence_number_less_than_or_equal(left_edge, unacked_packet.sequence_number) && sequence_number_less_than_or_equal(unacked_packet.ack_number, right_edge)) {
+                    unacked_packet.sacked = true;
+                    unacked_packets.sacked_size += unacked_packet.payload_size;
+                }
+            }
+            if (sequence_number_less_than(m_highest_sacked_sequence_number, right_edge))
+                m_highest_sacked_sequence_number = right_edge;
+        }
+    });
+}
+
+size_t TCPSocket::bytes_in_flight(UnackedPackets const& unacked_packets) const
+{
+    return unacked_packets.size - unacked_packets.sacked_size;
+}
+
+size_t TCPSocket::congestion_window_space() const
+{
+    auto congestion_window = m_congestion_control->congestion_window();
+    // The window is only set up once we know the MSS, which is when the first data is sent.
+    if (congestion_window == 0)
+        return NumericLimits<size_t>::max();
+    auto flight_size = m_unacked_packets.with_shared([&](auto const& unacked_packets) { return bytes_in_flight(unacked_packets); });
+    return congestion_window > flight_size ? congestion_window - flight_size : 0;
+}
+
+void TCPSocket::update_round_trip_time(Duration sample)
+{
+    // RFC 6298, 2: alpha = 1/8, beta = 1/4, K = 4.
+    if (!m_smoothed_round_trip_time.has_value()) {
+        m_smoothed_round_trip_time = sample;
+        m_round_trip_time_variation = Duration::from_nanoseconds(sample.to_nanoseconds() / 2);
+    } else {
+        auto smoothed = m_smoothed_round_trip_time->to_nanoseconds();
+        auto variation = m_round_trip_time_variation.to_nanoseconds();
+        auto deviation = smoothed > sample.to_nanoseconds() ? smoothed - sample.to_nanoseconds() : sample.to_nanoseconds() - smoothed;
+        m_round_trip_time_variation = Duration::from_nanoseconds((3 * variation + deviation) / 4);
+        m_smoothed_round_trip_time = Duration::from_nanoseconds((7 * smoothed + sample.to_nanoseconds()) / 8);
+    }
+
+    // The clock granularity term is dwarfed by the one second minimum, so leave it out.
+    auto timeout = *m_smoothed_round_trip_time + Duration::from_nanoseconds(4 * m_round_trip_time_variation.to_nanoseconds());
+    m_retransmission_timeout = clamp(timeout, minimum_retransmission_timeout, maximum_retransmission_timeout);
+}
+
 bool TCPSocket::should_delay_next_ack() const
 {
     // FIXME: We don't know the MSS here so make a reasonable guess.
@@ -479,6 +693,17 @@ ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*
             return EINVAL;
         m_no_delay = value;
         return {};
+    case TCP_CONGESTION: {
+        auto length = min<size_t>(user_value_size, TCPCongestionControl::maximum_algorithm_name_length);
+        auto algorithm_name = TRY(Process::get_syscall_name_string_fixed_buffer<TCPCongestionControl::maximum_algorithm_name_length>(static_ptr_cast<char const*>(user_value), length));
+        if (algorithm_name.representable_view() == m_congestion_control->name())
+            return {};
+        // Only allowed before any data was sent, since the new algorithm starts from scratch.
+        if (m_congestion_control->congestion_window() != 0)
+            return EISCONN;
+        m_congestion_control = TRY(TCPCongestionControl::try_create(algorithm_name.representable_view()));
+        return {};
+    }
     default:
         dbgln("setsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -504,6 +729,17 @@ ErrorOr<void> TCPSocket::getsockopt(OpenFileDescription& description, int level,
         size = sizeof(nodelay);
         return copy_to_user(value_size, &size);
     }
+    case TCP_CONGESTION: {
+        auto name = m_congestion_control->name();
+        if (size < name.length() + 1)
+            return EINVAL;
+        char buffer[TCPCongestionControl::maximum_algorithm_name_length + 1] {};
+        auto fits = name.copy_characters_to_buffer(buffer, sizeof(buffer));
+        VERIFY(fits);
+        TRY(copy_to_user(static_ptr_cast<char*>(value), buffer, name.length() + 1));
+        size = name.length() + 1;
+        return copy_to_user(value_size, &size);
+    }
     default:
         dbgln("getsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -702,18 +938,18 @@ void TCPSocket::retransmit_packets()
 {
     auto now = TimeManagement::the().monotonic_time();
 
-    // RFC6298 says we should have at least one second between retransmits. According to
-    // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
-    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+    // RFC 6298, 5.5: Double the timeout every time it expires. According to RFC1122 we must
+    // do exponential backoff - even for SYN packets.
+    auto retransmission_timeout = m_retransmission_timeout;
+    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts && retransmission_timeout < maximum_retransmission_timeout; i++)
+        retransmission_timeout += retransmission_timeout;
 
-    if (m_last_retransmit_time > now - Duration::from_seconds(retransmit_interval))
+    if (m_retransmit_timer_start > now - retransmission_timeout)
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
 
-    m_last_retransmit_time = now;
+    m_retransmit_timer_start = now;
     ++m_retransmit_attempts;
 
     if (m_retransmit_attempts > maximum_retransmits) {
@@ -729,43 +965,109 @@ void TCPSocket::retransmit_packets()
         return;
 
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-        for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
+        if (unacked_packets.packets.is_empty())
+            return;
 
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+        // RFC 5681, 3.1: ssthresh must not be lowered again when the same segment times out more than once.
+        if (m_retransmit_attempts == 1)
+            m_congestion_control->on_retransmit_timeout(bytes_in_flight(unacked_packets), now);
 
-            auto packet_buffer = packet.buffer->bytes();
-
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
+        // RFC 2018, 8: The receiver is allowed to throw away data it has SACKed, so start over with a clean scoreboard.
+        for (auto& packet : unacked_packets.packets) {
+            packet.sacked = false;
+            packet.retransmitted_in_recovery = false;
         }
+        unacked_packets.sacked_size = 0;
+
+        m_loss_recovery = LossRecovery::RetransmitTimeout;
+        m_recovery_point = m_sequence_number;
+        m_duplicate_acks_received = 0;
+
+        // RFC 6298, 5.4: Retransmit the earliest segment that hasn't been acknowledged. Everything
+        // after it follows in slow start as the ACKs come back, see receive_tcp_packet().
+        retransmit_lost_packets(unacked_packets, routing_decision, true);
     });
 }
 
+bool TCPSocket::is_presumed_lost(UnackedPackets const& unacked_packets, OutgoingPacket const& packet) const
+{
+    switch (m_loss_recovery) {
+    case LossRecovery::None:
+        return false;
+    case LossRecovery::FastRecovery:
+        // RFC 6675, 4: With SACK, a hole below data the peer has received is taken as lost.
+        // Without it, all we know is that the first unacknowledged segment went missing.
+        if (&packet == &unacked_packets.packets.first())
+            return true;
+        return m_sack_permitted && sequence_number_less_than(packet.sequence_number, m_highest_sacked_sequence_number);
+    case LossRecovery::RetransmitTimeout:
+        return true;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void TCPSocket::retransmit_lost_packets(UnackedPackets& unacked_packets, RoutingDecision const& routing_decision, bool retransmit_first_unconditionally)
+{
+    // RFC 6675, 4: The "pipe" is our estimate of how much data is still in the network - everything
+    // that was neither SACKed nor presumed lost, plus what we've retransmitted since.
+    size_t pipe = 0;
+    for (auto const& packet : unacked_packets.packets) {
+        if (packet.sacked)
+            continue;
+        if (!is_presumed_lost(unacked_packets, packet) || packet.retransmitted_in_recovery)
+            pipe += packet.payload_size;
+    }
+
+    auto congestion_window = m_congestion_control->congestion_window();
+    for (auto& packet : unacked_packets.packets) {
+        if (packet.sacked || packet.retransmitted_in_recovery || !is_presumed_lost(unacked_packets, packet))
+            continue;
+        if (!retransmit_first_unconditionally && pipe >= congestion_window)
+            break;
+        retransmit_first_unconditionally = false;
+
+        retransmit_packet(packet, routing_decision);
+        packet.retransmitted_in_recovery = true;
+        pipe += packet.payload_size;
+    }
+}
+
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision const& routing_decision)
+{
+    packet.tx_counter++;
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
+
+    auto packet_buffer = packet.buffer->bytes();
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
+}
+
 bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
 {
     if (!IPv4Socket::can_write(file_description, size))
@@ -774,6 +1076,10 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
     if (m_state == State::SynSent || m_state == State::SynReceived)
         return false;
 
+    // protocol_send() refuses data while the congestion window is full, so don't let writers spin on it.
+    if (congestion_window_space() == 0)
+        return false;
+
     if (!file_description.is_blocking())
         return true;
 
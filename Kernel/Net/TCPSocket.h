@@ -15,6 +15,7 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4/Socket.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 #include <Kernel/Time/TimerQueue.h>
 
 namespace Kernel {
@@ -23,7 +24,7 @@ class TCPSocket final : public IPv4Socket {
 public:
     static void for_each(Function<void(TCPSocket const&)>);
     static ErrorOr<void> try_for_each(Function<ErrorOr<void>(TCPSocket const&)>);
-    static ErrorOr<NonnullRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
+    static ErrorOr<NonnullRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, StringView congestion_control_algorithm = TCPCongestionControl::default_algorithm_name);
     virtual ~TCPSocket() override;
 
     virtual bool unref() const override;
@@ -143,6 +144,9 @@ public:
         m_send_window_scale = scale;
     }
 
+    // RFC 2018: The peer offered SACK in its SYN, so its ACKs may carry SACK blocks.
+    void set_sack_permitted() { m_sack_permitted = true; }
+
     // FIXME: Make this configurable?
     static constexpr u32 maximum_duplicate_acks = 5;
     void set_duplicate_acks(u32 acks) { m_duplicate_acks = acks; }
@@ -180,7 +184,7 @@ protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer, NonnullOwnPtr<TCPCongestionControl>);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
@@ -198,6 +202,8 @@ private:
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    void update_round_trip_time(Duration sample);
+
     static constexpr size_t receive_window_scale()
     {
         auto buffer_size_bit_length = AK::log2(receive_buffer_size) + 1;
@@ -225,17 +231,55 @@ private:
         size_t ipv4_payload_offset;
         LockWeakPtr<NetworkAdapter> adapter;
         int tx_counter { 0 };
+        u32 sequence_number { 0 };
+        size_t payload_size { 0 };
+        MonotonicTime sent_time;
+        bool sacked { false };
+        bool retransmitted_in_recovery { false };
     };
 
     struct UnackedPackets {
         SinglyLinkedList<OutgoingPacket> packets;
         size_t size { 0 };
+        size_t sacked_size { 0 };
+    };
+
+    enum class LossRecovery {
+        None,
+        FastRecovery,
+        RetransmitTimeout,
     };
 
+    void retransmit_packet(OutgoingPacket&, RoutingDecision const&);
+    void retransmit_lost_packets(UnackedPackets&, RoutingDecision const&, bool retransmit_first_unconditionally);
+    bool is_presumed_lost(UnackedPackets const&, OutgoingPacket const&) const;
+    void process_sack_option(UnackedPackets&, TCPPacket const&);
+    size_t bytes_in_flight(UnackedPackets const&) const;
+    size_t congestion_window_space() const;
+
     MutexProtected<UnackedPackets> m_unacked_packets;
 
     u32 m_duplicate_acks { 0 };
 
+    // RFC 5681, 3.2: Three duplicate ACKs in a row are taken as a sign that a segment was lost.
+    static constexpr u32 duplicate_ack_threshold = 3;
+    u32 m_duplicate_acks_received { 0 };
+
+    NonnullOwnPtr<TCPCongestionControl> m_congestion_control;
+    LossRecovery m_loss_recovery { LossRecovery::None };
+    // Everything sent before this sequence number has to be acknowledged before loss recovery ends (RFC 6582).
+    u32 m_recovery_point { 0 };
+
+    bool m_sack_permitted { false };
+    u32 m_highest_sacked_sequence_number { 0 };
+
+    // RFC 6298: Smoothed round-trip time, its variation, and the retransmission timeout derived from them.
+    static constexpr Duration minimum_retransmission_timeout = Duration::from_seconds(1);
+    static constexpr Duration maximum_retransmission_timeout = Duration::from_seconds(60);
+    Optional<Duration> m_smoothed_round_trip_time;
+    Duration m_round_trip_time_variation;
+    Duration m_retransmission_timeout { minimum_retransmission_timeout };
+
     u32 m_last_ack_number_sent { 0 };
     MonotonicTime m_last_ack_sent_time;
 
@@ -243,7 +287,7 @@ private:
 
     // FIXME: Make this configurable (sysctl)
     static constexpr u32 maximum_retransmits = 5;
-    MonotonicTime m_last_retransmit_time;
+    MonotonicTime m_retransmit_timer_start;
     u32 m_retransmit_attempts { 0 };
 
     // Default to maximum window size. receive_tcp_packet() will update from the
@@ -7,6 +7,7 @@
 #include <Kernel/Bus/PCI/IDs.h>
 #include <Kernel/Bus/VirtIO/Transport/PCIe/TransportLink.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/TCP.h>
 #include <Kernel/Net/VirtIO/VirtIONetworkAdapter.h>
 
 namespace Kernel {
@@ -137,9 +138,15 @@ UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_virtio_resources
             negotiated |= VIRTIO_NET_F_SPEED_DUPLEX;
         if (is_feature_set(supported_features, VIRTIO_NET_F_MTU))
             negotiated |= VIRTIO_NET_F_MTU;
+        // Segmentation offload requires the device to fill in checksums for us as well.
+        if (is_feature_set(supported_features, VIRTIO_NET_F_CSUM) && is_feature_set(supported_features, VIRTIO_NET_F_HOST_TSO4))
+            negotiated |= VIRTIO_NET_F_CSUM | VIRTIO_NET_F_HOST_TSO4;
         return negotiated;
     }));
 
+    if (is_feature_accepted(VIRTIO_NET_F_HOST_TSO4))
+        set_tcp_segmentation_offload_size(NumericLimits<u16>::max());
+
     TRY(handle_device_config_change());
     TRY(setup_queues(2)); // receive & transmit
 
@@ -252,27 +259,60 @@ static bool copy_data_to_chain(VirtIO::QueueChain& chain, Memory::RingBuffer& ri
     return true;
 }
 
-void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
+void VirtIONetworkAdapter::send_frame(ReadonlyBytes header, ReadonlyBytes frame_headers, ReadonlyBytes frame_payload)
 {
-    dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: send_raw length={}", payload.size());
-
     auto& queue = get_queue(TRANSMITQ);
     SpinlockLocker queue_lock(queue.lock());
     VirtIO::QueueChain chain(queue);
 
     SpinlockLocker ringbuffer_lock(m_tx_buffers->lock());
-    if (m_tx_buffers->available_bytes() < sizeof(VirtIONetHdr) + payload.size()) {
+    if (m_tx_buffers->available_bytes() < header.size() + frame_headers.size() + frame_payload.size()) {
         // We can drop packets that don't fit to apply back pressure on eager senders.
         dmesgln("VirtIONetworkAdapter: not enough space in the buffer. Dropping packet");
         return;
     }
 
     // FIXME: Handle errors from pushing to the chain and rewind the RingBuffer.
-    VirtIONetHdr hdr {};
-    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, reinterpret_cast<u8*>(&hdr), sizeof(hdr)));
-    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, payload.data(), payload.size()));
+    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, header.data(), header.size()));
+    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, frame_headers.data(), frame_headers.size()));
+    if (!frame_payload.is_empty())
+        VERIFY(copy_data_to_chain(chain, *m_tx_buffers, frame_payload.data(), frame_payload.size()));
 
     supply_chain_and_notify(TRANSMITQ, chain);
 }
 
+void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
+{
+    dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: send_raw length={}", payload.size());
+
+    VirtIONetHdr hdr {};
+    send_frame({ &hdr, sizeof(hdr) }, payload, {});
+}
+
+void VirtIONetworkAdapter::send_raw_tcp_segmented(ReadonlyBytes frame, size_t maximum_segment_size)
+{
+    dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: send_raw_tcp_segmented length={}, mss={}", frame.size(), maximum_segment_size);
+
+    auto& ipv4 = *reinterpret_cast<IPv4Packet const*>(frame.offset(layer3_payload_offset()));
+    auto& tcp = *static_cast<TCPPacket const*>(ipv4.payload());
+    size_t tcp_offset = layer3_payload_offset() + sizeof(IPv4Packet);
+    size_t headers_size = tcp_offset + tcp.header_size();
+
+    // The device expects the TCP checksum field to hold the pseudo-header sum, like for any partially checksummed packet.
+    u8 headers[sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + 15 * sizeof(u32)];
+    VERIFY(headers_size <= sizeof(headers));
+    frame.trim(headers_size).copy_to({ headers, sizeof(headers) });
+    auto& tcp_copy = *reinterpret_cast<TCPPacket*>(headers + tcp_offset);
+    tcp_copy.set_checksum(tcp_pseudo_header_checksum(ipv4, ipv4.payload_size()));
+
+    VirtIONetHdr hdr {};
+    hdr.flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+    hdr.gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+    hdr.hdr_len = headers_size;
+    hdr.gso_size = maximum_segment_size;
+    hdr.csum_start = tcp_offset;
+    hdr.csum_offset = TCPPacket::checksum_offset;
+    send_frame({ &hdr, sizeof(hdr) }, { headers, headers_size }, frame.slice(headers_size));
+}
+
 }
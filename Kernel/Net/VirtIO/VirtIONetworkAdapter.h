@@ -42,6 +42,9 @@ private:
 
     // NetworkAdapter
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_tcp_segmented(ReadonlyBytes, size_t maximum_segment_size) override;
+
+    void send_frame(ReadonlyBytes header, ReadonlyBytes frame_headers, ReadonlyBytes frame_payload);
 
 private:
     VirtIO::Configuration const* m_device_config { nullptr };
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/EventQueue.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+// Upper bound on how many events a single epoll_pwait() call can return.
+static constexpr int max_events_per_wait = 1024;
+
+ErrorOr<FlatPtr> Process::sys$epoll_create1(int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~EPOLL_CLOEXEC)
+        return EINVAL;
+
+    auto queue = TRY(EventQueue::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(queue)));
+    description->set_readable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description));
+
+        if (flags & EPOLL_CLOEXEC)
+            fds[fd_allocation.fd].set_flags(fds[fd_allocation.fd].flags() | FD_CLOEXEC);
+
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_ctl(int epfd, int op, int fd, Userspace<epoll_event const*> user_event)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto queue_description = TRY(open_file_description(epfd));
+    if (!queue_description->is_event_queue())
+        return EINVAL;
+    auto* queue = queue_description->event_queue();
+
+    auto description = TRY(open_file_description(fd));
+    // Nested queues would let readiness notifications recurse through each other.
+    if (description->is_event_queue())
+        return EINVAL;
+
+    switch (op) {
+    case EPOLL_CTL_ADD: {
+        auto event = TRY(copy_typed_from_user(user_event));
+        TRY(queue->add(fd, *description, event));
+        return 0;
+    }
+    case EPOLL_CTL_MOD: {
+        auto event = TRY(copy_typed_from_user(user_event));
+        TRY(queue->modify(fd, *description, event));
+        return 0;
+    }
+    case EPOLL_CTL_DEL:
+        TRY(queue->remove(fd, *description));
+        return 0;
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_pwait(Userspace<Syscall::SC_epoll_pwait_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+    if (params.maxevents <= 0)
+        return EINVAL;
+
+    auto queue_description = TRY(open_file_description(params.epfd));
+    if (!queue_description->is_event_queue())
+        return EINVAL;
+    auto* queue = queue_description->event_queue();
+
+    Thread::BlockTimeout timeout;
+    bool should_block = true;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        should_block = timeout_time != Duration::zero();
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+    }
+
+    sigset_t sigmask = {};
+    if (params.sigmask)
+        TRY(copy_from_user(&sigmask, params.sigmask));
+
+    Vector<epoll_event> events;
+    TRY(events.try_resize(min(params.maxevents, max_events_per_wait)));
+
+    auto* current_thread = Thread::current();
+
+    u32 previous_signal_mask = 0;
+    if (params.sigmask)
+        previous_signal_mask = current_thread->update_signal_mask(sigmask);
+    ScopeGuard rollback_signal_mask([&]() {
+        if (params.sigmask)
+            current_thread->update_signal_mask(previous_signal_mask);
+    });
+
+    for (;;) {
+        auto count = TRY(queue->collect_ready_events(events.span()));
+        if (count > 0) {
+            TRY(copy_n_to_user(params.events, events.data(), count));
+            return count;
+        }
+        if (!should_block)
+            return 0;
+
+        dbgln_if(POLL_SELECT_DEBUG, "epoll_pwait: blocking on event queue {}", params.epfd);
+        auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+        auto result = current_thread->block<Thread::ReadBlocker>(timeout, *queue_description, unblock_flags);
+        if (result.was_interrupted())
+            return EINTR;
+        // Pick up anything that became ready right as we timed out before giving up.
+        if (result == Thread::BlockResult::InterruptedByTimeout)
+            should_block = false;
+    }
+}
+
+}
@@ -133,7 +133,8 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
             for (auto& region : parent_space->region_tree().regions()) {
                 dbgln_if(FORK_DEBUG, "fork: cloning Region '{}' @ {}", region.name(), region.vaddr());
                 auto region_clone = TRY(region.try_clone());
-                TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
+                // Most of what the parent has mapped is never touched by the child, especially when it's about to exec().
+                TRY(region_clone->map_on_demand(child_space->page_directory()));
                 TRY(child_space->region_tree().place_specifically(*region_clone, region.range()));
                 (void)region_clone.leak_ptr();
             }
@@ -97,7 +97,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     u32 cmd = params.futex_op & FUTEX_CMD_MASK;
 
     bool use_realtime_clock = (params.futex_op & FUTEX_CLOCK_REALTIME) != 0;
-    if (use_realtime_clock && cmd != FUTEX_WAIT && cmd != FUTEX_WAIT_BITSET) {
+    if (use_realtime_clock && cmd != FUTEX_WAIT && cmd != FUTEX_WAIT_BITSET && cmd != FUTEX_LOCK_PI) {
         return ENOSYS;
     }
 
@@ -107,7 +107,8 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
     case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_CMP_REQUEUE:
+    case FUTEX_LOCK_PI: {
         if (params.timeout) {
             auto timeout_time = TRY(copy_time_from_user(params.timeout));
             bool is_absolute = cmd != FUTEX_WAIT;
@@ -169,7 +170,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     auto user_address = FlatPtr(params.userspace_address);
     auto user_address2 = FlatPtr(params.userspace_address2);
 
-    auto do_wait = [&](u32 bitset) -> ErrorOr<FlatPtr> {
+    auto wait_while_value_is = [&](u32 expected_value, u32 bitset, Thread* pi_owner = nullptr) -> ErrorOr<Thread::BlockResult> {
         bool did_create;
         LockRefPtr<FutexQueue> futex_queue;
         auto futex_key = TRY(get_futex_key(user_address, shared));
@@ -177,8 +178,8 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
             auto user_value = user_atomic_load_relaxed(params.userspace_address);
             if (!user_value.has_value())
                 return EFAULT;
-            if (user_value.value() != params.val) {
-                dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, params.val);
+            if (user_value.value() != expected_value) {
+                dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, expected_value);
                 return EAGAIN;
             }
             atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
@@ -193,18 +194,138 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         // We must not hold the lock before blocking. But we have a reference
         // to the FutexQueue so that we can keep it alive.
 
+        if (pi_owner)
+            pi_owner->inherit_priority(futex_queue->priority_boost(), Thread::current()->effective_priority());
+
         Thread::BlockResult block_result = futex_queue->wait_on(timeout, bitset);
 
         if (futex_queue->is_empty_and_no_imminent_waits()) {
             // If there are no more waiters, we want to get rid of the futex!
             remove_futex_queue(futex_key);
         }
+        return block_result;
+    };
+
+    auto do_wait = [&](u32 bitset) -> ErrorOr<FlatPtr> {
+        auto block_result = TRY(wait_while_value_is(params.val, bitset));
         if (block_result == Thread::BlockResult::InterruptedByTimeout) {
             return ETIMEDOUT;
         }
         return 0;
     };
 
+    auto find_pi_futex_owner = [&](GlobalFutexKey const& futex_key, u32 owner_tid) -> ErrorOr<NonnullRefPtr<Thread>> {
+        // Userspace can write any TID into the futex, so make sure that the thread could actually own it:
+        // a private futex can only be owned by threads of this process, and a shared one only by threads
+        // of processes that map it.
+        auto owner = Thread::from_tid_ignoring_process_lists(owner_tid);
+        if (!owner)
+            return ESRCH;
+        if (futex_key.raw.offset & futex_key_private_flag) {
+            if (&owner->process() != this)
+                return ESRCH;
+            return owner.release_nonnull();
+        }
+        bool maps_futex = owner->process().address_space().with([&](auto& space) {
+            if (!space)
+                return false;
+            for (auto& region : space->region_tree().regions()) {
+                if (&region.vmobject() == futex_key.shared.vmobject)
+                    return true;
+            }
+            return false;
+        });
+        if (!maps_futex)
+            return ESRCH;
+        return owner.release_nonnull();
+    };
+
+    auto do_lock_pi = [&](bool try_only) -> ErrorOr<FlatPtr> {
+        auto* current_thread = Thread::current();
+        u32 const current_tid = current_thread->tid().value();
+        auto futex_key = TRY(get_futex_key(user_address, shared));
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            u32 const owner_tid = value & FUTEX_TID_MASK;
+
+            if (owner_tid == 0) {
+                // Keep FUTEX_WAITERS if it's set, so that the next unlock hands the futex on to whoever is still waiting.
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, value, current_tid | (value & FUTEX_WAITERS));
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (!did_exchange.value())
+                    continue;
+                atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                // Whoever is still waiting for the futex now boosts the calling thread.
+                if (auto futex_queue = TRY(find_futex_queue(futex_key, false)))
+                    current_thread->inherit_priority(futex_queue->priority_boost());
+                return 0;
+            }
+            if (owner_tid == current_tid)
+                return EDEADLK;
+            if (try_only)
+                return EAGAIN;
+
+            if (!(value & FUTEX_WAITERS)) {
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, value, value | FUTEX_WAITERS);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (!did_exchange.value())
+                    continue;
+                value |= FUTEX_WAITERS;
+            }
+
+            auto owner = TRY(find_pi_futex_owner(futex_key, owner_tid));
+            auto block_result_or_error = wait_while_value_is(value, 0, owner.ptr());
+            if (block_result_or_error.is_error()) {
+                // The futex changed hands before we got to sleep, have another look.
+                if (block_result_or_error.error().code() == EAGAIN)
+                    continue;
+                return block_result_or_error.release_error();
+            }
+            auto block_result = block_result_or_error.release_value();
+            if (block_result == Thread::BlockResult::InterruptedByTimeout)
+                return ETIMEDOUT;
+            if (block_result.was_interrupted())
+                return EINTR;
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> ErrorOr<FlatPtr> {
+        auto* current_thread = Thread::current();
+        u32 const current_tid = current_thread->tid().value();
+        auto futex_key = TRY(get_futex_key(user_address, shared));
+        LockRefPtr<FutexQueue> futex_queue;
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            if ((value & FUTEX_TID_MASK) != current_tid)
+                return EPERM;
+
+            // If anyone is left waiting, keep FUTEX_WAITERS set so that it can't be taken from userspace
+            // without the kernel knowing, and the waiter we wake up below will take it over.
+            futex_queue = TRY(find_futex_queue(futex_key, false));
+            bool has_waiters = futex_queue && !futex_queue->is_empty_and_no_imminent_waits();
+            atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+            auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, value, has_waiters ? FUTEX_WAITERS : 0);
+            if (!did_exchange.has_value())
+                return EFAULT;
+            if (did_exchange.value())
+                break;
+        }
+
+        // Only give up what was inherited through this futex, the thread may still hold others.
+        if (futex_queue)
+            current_thread->drop_inherited_priority(futex_queue->priority_boost());
+        TRY(do_wake(user_address, 1, {}));
+        return 0;
+    };
+
     auto do_requeue = [&](Optional<u32> val3) -> ErrorOr<FlatPtr> {
         auto user_value = user_atomic_load_relaxed(params.userspace_address);
         if (!user_value.has_value())
@@ -324,6 +445,15 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         if (params.val3 == 0)
             return EINVAL;
         return TRY(do_wake(user_address, params.val, params.val3));
+
+    case FUTEX_LOCK_PI:
+        return do_lock_pi(false);
+
+    case FUTEX_TRYLOCK_PI:
+        return do_lock_pi(true);
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
     }
     return ENOSYS;
 }
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$io_ring_setup(u32 entries, Userspace<IORingParameters*> user_parameters)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto ring = TRY(IORing::try_create(*this, entries));
+    auto parameters = ring->parameters();
+    auto description = TRY(OpenFileDescription::try_create(move(ring)));
+    description->set_readable(true);
+    // The queues are mapped shared and writable.
+    description->set_writable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        TRY(copy_to_user(user_parameters, &parameters));
+        fds[fd_allocation.fd].set(move(description), FD_CLOEXEC);
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$io_ring_enter(int fd, u32 to_submit, u32 min_complete, u32 flags)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~IORING_ENTER_GETEVENTS)
+        return EINVAL;
+
+    auto description = TRY(open_file_description(fd));
+    if (!description->is_io_ring())
+        return EINVAL;
+    auto& ring = *description->io_ring();
+    if (!ring.is_owned_by(*this))
+        return EPERM;
+    if (min_complete > ring.parameters().completion_entries)
+        return EINVAL;
+
+    u32 submitted = 0;
+    if (to_submit > 0)
+        submitted = TRY(ring.submit(*this, to_submit));
+
+    dbgln_if(IO_DEBUG, "sys$io_ring_enter({}, {}, {}, {}): submitted {}", fd, to_submit, min_complete, flags, submitted);
+
+    for (;;) {
+        ring.post_completions(*this);
+        if (!(flags & IORING_ENTER_GETEVENTS))
+            break;
+        auto available = ring.unconsumed_completions();
+        // Nothing more can be posted until userspace makes room.
+        if (available >= min_complete || available >= ring.parameters().completion_entries)
+            break;
+
+        auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+        if (Thread::current()->block<Thread::ReadBlocker>({}, *description, unblock_flags).was_interrupted()) {
+            if (submitted > 0)
+                break;
+            return EINTR;
+        }
+    }
+    return submitted;
+}
+
+}
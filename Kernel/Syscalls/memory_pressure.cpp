@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/API/MemoryPressure.h>
+#include <Kernel/FileSystem/MemoryPressureListener.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$watch_memory_pressure(u32 flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto listener = TRY(MemoryPressureListener::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(listener)));
+
+    description->set_readable(true);
+    if (flags & static_cast<unsigned>(MemoryPressureListenerFlags::Nonblock))
+        description->set_blocking(false);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description));
+
+        if (flags & static_cast<unsigned>(MemoryPressureListenerFlags::CloseOnExec))
+            fds[fd_allocation.fd].set_flags(fds[fd_allocation.fd].flags() | FD_CLOEXEC);
+
+        return fd_allocation.fd;
+    });
+}
+
+}
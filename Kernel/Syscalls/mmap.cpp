@@ -155,6 +155,10 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
         } else {
             vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(rounded_size, strategy));
         }
+
+        // Give large private mappings a chance to be backed by huge pages on first touch.
+        if (!params.alignment && map_private && !map_stack && !(flags & MAP_PURGEABLE) && rounded_size >= Memory::huge_page_size)
+            alignment = Memory::huge_page_size;
     } else {
         if (offset < 0)
             return EINVAL;
@@ -19,24 +19,24 @@ ErrorOr<FlatPtr> Process::open_impl(Userspace<Syscall::SC_open_params const*> us
     VERIFY_NO_PROCESS_BIG_LOCK(this);
     auto params = TRY(copy_typed_from_user(user_params));
 
-    int dirfd = params.dirfd;
-    int options = params.options;
-    u16 mode = params.mode;
+    auto path = TRY(get_syscall_path_argument(params.path));
+    return do_open(params.dirfd, path->view(), params.options, params.mode);
+}
 
+ErrorOr<FlatPtr> Process::do_open(int dirfd, StringView path, int options, u16 mode)
+{
     if (options & O_NOFOLLOW_NOERROR)
         return EINVAL;
 
     if (options & O_UNLINK_INTERNAL)
         return EINVAL;
 
-    auto path = TRY(get_syscall_path_argument(params.path));
-
     // Disable checking open pledges when building userspace with coverage
     // so that all processes can write out coverage data even with pledges
     bool skip_pledge_verification = false;
 
 #ifdef SKIP_PATH_VALIDATION_FOR_COVERAGE_INSTRUMENTATION
-    if (KLexicalPath::basename(path->view()).ends_with(".profraw"sv))
+    if (KLexicalPath::basename(path).ends_with(".profraw"sv))
         skip_pledge_verification = true;
 #endif
     if (!skip_pledge_verification) {
@@ -52,11 +52,11 @@ ErrorOr<FlatPtr> Process::open_impl(Userspace<Syscall::SC_open_params const*> us
     // Ignore everything except permission bits.
     mode &= 0777;
 
-    dbgln_if(IO_DEBUG, "sys$open(dirfd={}, path='{}', options={}, mode={})", dirfd, path->view(), options, mode);
+    dbgln_if(IO_DEBUG, "sys$open(dirfd={}, path='{}', options={}, mode={})", dirfd, path, options, mode);
 
     auto fd_allocation = TRY(allocate_fd());
-    CustodyBase base(dirfd, path->view());
-    auto description = TRY(VirtualFileSystem::open(vfs_root_context(), credentials(), path->view(), options, mode & ~umask(), base));
+    CustodyBase base(dirfd, path);
+    auto description = TRY(VirtualFileSystem::open(vfs_root_context(), credentials(), path, options, mode & ~umask(), base));
 
     if (description->inode() && description->inode()->bound_socket())
         return ENXIO;
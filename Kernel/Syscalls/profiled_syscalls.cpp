@@ -139,7 +139,7 @@ ErrorOr<FlatPtr> Process::sys$readv(int fd, Userspace<const struct iovec*> iov,
         start_timestamp = TimeManagement::the().monotonic_time(TimePrecision::Precise);
     }
 
-    auto result = readv_impl(fd, iov, iov_count);
+    auto result = readv_impl(fd, iov, iov_count, {});
 
     if (!profiling_enabled_at_entry || Thread::current()->is_profiling_suppressed())
         return result;
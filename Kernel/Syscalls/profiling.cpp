@@ -33,11 +33,13 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
         auto credentials = this->credentials();
         if (!credentials->is_superuser())
             return EPERM;
-        ScopedCritical critical;
         g_profiling_event_mask = PERF_EVENT_PROCESS_CREATE | PERF_EVENT_THREAD_CREATE | PERF_EVENT_MMAP;
-        if (g_global_perf_events) {
+        // NOTE: This takes the buffer's reader lock, so it can't happen in the critical section below.
+        if (g_global_perf_events)
             g_global_perf_events->clear();
-        } else {
+
+        ScopedCritical critical;
+        if (!g_global_perf_events) {
             g_global_perf_events = PerformanceEventBuffer::try_create_with_size(32 * MiB).leak_ptr();
             if (!g_global_perf_events) {
                 g_profiling_event_mask = 0;
@@ -38,7 +38,7 @@ static ErrorOr<void> check_blocked_read(OpenFileDescription* description)
     return {};
 }
 
-ErrorOr<FlatPtr> Process::readv_impl(int fd, Userspace<const struct iovec*> iov, int iov_count)
+ErrorOr<FlatPtr> Process::readv_impl(int fd, Userspace<const struct iovec*> iov, int iov_count, Optional<off_t> base_offset)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
     TRY(require_promise(Pledge::stdio));
@@ -48,6 +48,9 @@ ErrorOr<FlatPtr> Process::readv_impl(int fd, Userspace<const struct iovec*> iov,
     if (iov_count > IOV_MAX)
         return EFAULT;
 
+    if (base_offset.has_value() && base_offset.value() < 0)
+        return EINVAL;
+
     u64 total_length = 0;
     Vector<iovec, 32> vecs;
     TRY(vecs.try_resize(iov_count));
@@ -59,18 +62,39 @@ ErrorOr<FlatPtr> Process::readv_impl(int fd, Userspace<const struct iovec*> iov,
     }
 
     auto description = TRY(open_readable_file_description(fds(), fd));
+    if (base_offset.has_value() && !description->file().is_seekable())
+        return EINVAL;
 
     int nread = 0;
     for (auto& vec : vecs) {
-        TRY(check_blocked_read(description));
+        if (vec.iov_len == 0)
+            continue;
+        // Only the first read may block, once we have something we hand it over.
+        if (nread == 0)
+            TRY(check_blocked_read(description));
         auto buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len));
-        auto nread_here = TRY(description->read(buffer, vec.iov_len));
-        nread += nread_here;
+        auto result = base_offset.has_value()
+            ? description->read(buffer, base_offset.value() + nread, vec.iov_len)
+            : description->read(buffer, vec.iov_len);
+        if (result.is_error()) {
+            if (nread == 0)
+                return result.release_error();
+            return nread;
+        }
+        nread += result.value();
+        // A short read means there's nothing more to be had right now, so don't go looking for more.
+        if (result.value() < vec.iov_len)
+            break;
     }
 
     return nread;
 }
 
+ErrorOr<FlatPtr> Process::sys$preadv(int fd, Userspace<const struct iovec*> iov, int iov_count, off_t offset)
+{
+    return readv_impl(fd, iov, iov_count, offset);
+}
+
 ErrorOr<FlatPtr> Process::read_impl(int fd, Userspace<u8*> buffer, size_t size)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/API/POSIX/fcntl.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+// Data is copied through one kernel bounce buffer per call. This isn't zero-copy, but it
+// saves the round trip through userspace that a read()/write() loop would make.
+static constexpr size_t splice_buffer_size = 64 * KiB;
+
+static ErrorOr<void> validate_splice_descriptions(OpenFileDescription const& in, OpenFileDescription const& out)
+{
+    if (!in.is_readable() || !out.is_writable())
+        return EBADF;
+    if (in.is_directory() || out.is_directory())
+        return EISDIR;
+    // If we can't rewind the input, every byte we read has to make it out, so the output has to be blocking.
+    if (!in.file().is_seekable() && !out.is_blocking())
+        return EINVAL;
+    return {};
+}
+
+ErrorOr<FlatPtr> Process::do_splice(OpenFileDescription& in, Optional<off_t> in_offset, OpenFileDescription& out, Optional<off_t> out_offset, size_t count)
+{
+    if (count == 0)
+        return 0;
+    if (count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+    if (in_offset.has_value() && !in.file().is_seekable())
+        return ESPIPE;
+    if (out_offset.has_value() && !out.file().is_seekable())
+        return ESPIPE;
+
+    // Read seekable inputs at an explicit offset even when the caller didn't give one,
+    // so we only consume what we actually managed to write out.
+    bool should_advance_input = false;
+    if (!in_offset.has_value() && in.file().is_seekable()) {
+        in_offset = in.offset();
+        should_advance_input = true;
+    }
+
+    auto buffer = TRY(KBuffer::try_create_with_size("splice"sv, min(count, splice_buffer_size)));
+    size_t total_nwritten = 0;
+
+    while (total_nwritten < count) {
+        if (!in_offset.has_value() && !out.can_write()) {
+            // Wait for room in the output before consuming anything from an input we can't rewind.
+            auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+            if (Thread::current()->block<Thread::WriteBlocker>({}, out, unblock_flags).was_interrupted()) {
+                if (total_nwritten > 0)
+                    break;
+                return EINTR;
+            }
+            continue;
+        }
+        if (!in_offset.has_value() && !in.can_read()) {
+            if (total_nwritten > 0)
+                break;
+            if (!in.is_blocking())
+                return EAGAIN;
+            auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+            if (Thread::current()->block<Thread::ReadBlocker>({}, in, unblock_flags).was_interrupted())
+                return EINTR;
+            if (!has_flag(unblock_flags, Thread::FileBlocker::BlockFlags::Read))
+                return EAGAIN;
+        }
+
+        auto chunk_size = min(count - total_nwritten, buffer->size());
+        auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+        auto nread_or_error = in_offset.has_value()
+            ? in.read(kernel_buffer, in_offset.value() + total_nwritten, chunk_size)
+            : in.read(kernel_buffer, chunk_size);
+        if (nread_or_error.is_error()) {
+            if (total_nwritten > 0)
+                break;
+            return nread_or_error.release_error();
+        }
+        auto nread = nread_or_error.release_value();
+        if (nread == 0)
+            break;
+
+        if (in_offset.has_value()) {
+            // Whatever doesn't get written stays in the input, since we only advance past what we wrote.
+            auto nwritten_or_error = do_write(out, kernel_buffer, nread, out_offset.has_value() ? out_offset.value() + total_nwritten : Optional<off_t> {});
+            if (nwritten_or_error.is_error()) {
+                if (total_nwritten > 0)
+                    break;
+                return nwritten_or_error.release_error();
+            }
+            total_nwritten += nwritten_or_error.value();
+            if (nwritten_or_error.value() < nread)
+                break;
+            continue;
+        }
+
+        // The input has already given these bytes up, so keep going until the whole chunk is out.
+        // Only an error that makes no progress at all can stop us, and then the rest is lost.
+        size_t chunk_nwritten = 0;
+        Optional<Error> write_error;
+        while (chunk_nwritten < nread) {
+            auto nwritten_or_error = do_write(out, kernel_buffer.offset(chunk_nwritten), nread - chunk_nwritten, out_offset.has_value() ? out_offset.value() + total_nwritten + chunk_nwritten : Optional<off_t> {});
+            if (nwritten_or_error.is_error()) {
+                write_error = nwritten_or_error.release_error();
+                break;
+            }
+            chunk_nwritten += nwritten_or_error.value();
+        }
+        total_nwritten += chunk_nwritten;
+        if (write_error.has_value()) {
+            dbgln_if(IO_DEBUG, "do_splice: Dropping {} bytes that couldn't be written: {}", nread - chunk_nwritten, write_error.value());
+            if (total_nwritten > 0)
+                break;
+            return write_error.release_value();
+        }
+    }
+
+    if (should_advance_input)
+        TRY(in.seek(in_offset.value() + total_nwritten, SEEK_SET));
+    return total_nwritten;
+}
+
+ErrorOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> user_offset, size_t count)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", out_fd, in_fd, user_offset.ptr(), count);
+
+    auto in_description = TRY(open_file_description(in_fd));
+    auto out_description = TRY(open_file_description(out_fd));
+    TRY(validate_splice_descriptions(*in_description, *out_description));
+    // As elsewhere, sendfile() only reads from files. splice() handles pipes and sockets.
+    if (!in_description->file().is_seekable())
+        return EINVAL;
+
+    Optional<off_t> offset;
+    if (user_offset) {
+        offset = TRY(copy_typed_from_user(user_offset));
+        if (offset.value() < 0)
+            return EINVAL;
+    }
+
+    auto nwritten = TRY(do_splice(*in_description, offset, *out_description, {}, count));
+    if (user_offset) {
+        off_t new_offset = offset.value() + nwritten;
+        TRY(copy_to_user(user_offset, &new_offset));
+    }
+    return nwritten;
+}
+
+ErrorOr<FlatPtr> Process::sys$splice(Userspace<Syscall::SC_splice_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.flags & ~(SPLICE_F_MOVE | SPLICE_F_NONBLOCK | SPLICE_F_MORE))
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(params.fd_in));
+    auto out_description = TRY(open_file_description(params.fd_out));
+    TRY(validate_splice_descriptions(*in_description, *out_description));
+
+    Userspace<off_t*> user_offset_in { (FlatPtr)params.offset_in };
+    Userspace<off_t*> user_offset_out { (FlatPtr)params.offset_out };
+    Optional<off_t> offset_in;
+    Optional<off_t> offset_out;
+    if (user_offset_in) {
+        offset_in = TRY(copy_typed_from_user(user_offset_in));
+        if (offset_in.value() < 0)
+            return EINVAL;
+    }
+    if (user_offset_out) {
+        offset_out = TRY(copy_typed_from_user(user_offset_out));
+        if (offset_out.value() < 0)
+            return EINVAL;
+    }
+
+    if ((params.flags & SPLICE_F_NONBLOCK) && (!in_description->can_read() || !out_description->can_write()))
+        return EAGAIN;
+
+    auto nwritten = TRY(do_splice(*in_description, offset_in, *out_description, offset_out, params.length));
+    if (user_offset_in) {
+        off_t new_offset = offset_in.value() + nwritten;
+        TRY(copy_to_user(user_offset_in, &new_offset));
+    }
+    if (user_offset_out) {
+        off_t new_offset = offset_out.value() + nwritten;
+        TRY(copy_to_user(user_offset_out, &new_offset));
+    }
+    return nwritten;
+}
+
+}
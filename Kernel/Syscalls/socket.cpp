@@ -8,6 +8,7 @@
 #include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Time/TimeManagement.h>
 #include <Kernel/UnixTypes.h>
 
 namespace Kernel {
@@ -183,6 +184,45 @@ ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
     TRY(require_promise(Pledge::stdio));
+    auto description = TRY(open_file_description(sockfd));
+    if (!description->is_socket())
+        return ENOTSOCK;
+    return TRY(sendmsg_impl(*description, user_msg, flags));
+}
+
+ErrorOr<FlatPtr> Process::sys$sendmmsg(int sockfd, Userspace<struct mmsghdr*> user_msgvec, unsigned vlen, int flags)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto description = TRY(open_file_description(sockfd));
+    if (!description->is_socket())
+        return ENOTSOCK;
+
+    vlen = min(vlen, static_cast<unsigned>(IOV_MAX));
+    unsigned sent = 0;
+    while (sent < vlen) {
+        auto* user_mmsg = user_msgvec.unsafe_userspace_ptr() + sent;
+        auto result = sendmsg_impl(*description, Userspace<const struct msghdr*>((FlatPtr)&user_mmsg->msg_hdr), flags);
+        if (result.is_error()) {
+            // The caller finds out about the error on its next attempt, once it has dealt with what did get sent.
+            if (sent == 0)
+                return result.release_error();
+            break;
+        }
+        unsigned msg_len = result.value();
+        // Like on Linux, a message whose length we can't hand back isn't counted, but the ones before it still are.
+        if (auto copy_result = copy_to_user(&user_mmsg->msg_len, &msg_len); copy_result.is_error()) {
+            if (sent == 0)
+                return copy_result.release_error();
+            break;
+        }
+        ++sent;
+    }
+    return sent;
+}
+
+ErrorOr<size_t> Process::sendmsg_impl(OpenFileDescription& description, Userspace<const struct msghdr*> user_msg, int flags)
+{
     auto msg = TRY(copy_typed_from_user(user_msg));
 
     if (msg.msg_iovlen != 1)
@@ -196,11 +236,7 @@ ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*
     Userspace<sockaddr const*> user_addr((FlatPtr)msg.msg_name);
     socklen_t addr_length = msg.msg_namelen;
 
-    auto description = TRY(open_file_description(sockfd));
-    if (!description->is_socket())
-        return ENOTSOCK;
-
-    auto& socket = *description->socket();
+    auto& socket = *description.socket();
     if (socket.is_shut_down_for_writing()) {
         if ((flags & MSG_NOSIGNAL) == 0)
             Thread::current()->send_signal(SIGPIPE, &Process::current());
@@ -218,7 +254,7 @@ ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*
                 int* fds = (int*)CMSG_DATA(cmsg);
                 size_t nfds = (cmsg->cmsg_len - CMSG_ALIGN(sizeof(struct cmsghdr))) / sizeof(int);
                 for (size_t i = 0; i < nfds; ++i) {
-                    TRY(local_socket.sendfd(*description, TRY(open_file_description(fds[i]))));
+                    TRY(local_socket.sendfd(description, TRY(open_file_description(fds[i]))));
                 }
             }
         }
@@ -227,19 +263,19 @@ ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*
     auto data_buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len));
 
     while (true) {
-        while (!description->can_write()) {
-            if (!description->is_blocking()) {
+        while (!description.can_write()) {
+            if (!description.is_blocking()) {
                 return EAGAIN;
             }
 
             auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
-            if (Thread::current()->block<Thread::WriteBlocker>({}, *description, unblock_flags).was_interrupted()) {
+            if (Thread::current()->block<Thread::WriteBlocker>({}, description, unblock_flags).was_interrupted()) {
                 return EINTR;
             }
             // TODO: handle exceptions in unblock_flags
         }
 
-        auto bytes_sent_or_error = socket.sendto(*description, data_buffer, iovs[0].iov_len, flags, user_addr, addr_length);
+        auto bytes_sent_or_error = socket.sendto(description, data_buffer, iovs[0].iov_len, flags, user_addr, addr_length);
         if (bytes_sent_or_error.is_error()) {
             if ((flags & MSG_NOSIGNAL) == 0 && bytes_sent_or_error.error().code() == EPIPE)
                 Thread::current()->send_signal(SIGPIPE, &Process::current());
@@ -256,7 +292,70 @@ ErrorOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> user
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
     TRY(require_promise(Pledge::stdio));
+    auto description = TRY(open_file_description(sockfd));
+    if (!description->is_socket())
+        return ENOTSOCK;
+    return TRY(recvmsg_impl(*description, user_msg, flags));
+}
+
+ErrorOr<FlatPtr> Process::sys$recvmmsg(Userspace<Syscall::SC_recvmmsg_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    // NOTE: Like on other systems, the timeout is only looked at after each message, so this can still block indefinitely.
+    Optional<MonotonicTime> deadline;
+    if (params.timeout) {
+        auto timeout = TRY(copy_time_from_user(params.timeout));
+        deadline = TimeManagement::the().monotonic_time() + timeout;
+    }
 
+    auto description = TRY(open_file_description(params.sockfd));
+    if (!description->is_socket())
+        return ENOTSOCK;
+    auto& socket = *description->socket();
+
+    bool may_block_for_more = !(params.flags & (MSG_DONTWAIT | MSG_WAITFORONE)) && description->is_blocking();
+    auto flags = params.flags & ~MSG_WAITFORONE;
+    auto vlen = min(params.vlen, static_cast<unsigned>(IOV_MAX));
+    unsigned received = 0;
+    while (received < vlen) {
+        auto message_flags = flags;
+        if (received > 0 && !may_block_for_more) {
+            // Asking the socket for a message that isn't there would leave EAGAIN behind as its pending error.
+            if (!description->can_read())
+                break;
+            message_flags |= MSG_DONTWAIT;
+        }
+
+        auto* user_mmsg = params.msgvec + received;
+        auto result = recvmsg_impl(*description, Userspace<struct msghdr*>((FlatPtr)&user_mmsg->msg_hdr), message_flags);
+        if (result.is_error()) {
+            // The caller finds out about the error on its next attempt, once it has dealt with what did arrive.
+            if (received == 0)
+                return result.release_error();
+            break;
+        }
+        unsigned msg_len = result.value();
+        if (auto copy_result = copy_to_user(&user_mmsg->msg_len, &msg_len); copy_result.is_error()) {
+            if (received == 0)
+                return copy_result.release_error();
+            break;
+        }
+        ++received;
+
+        // There's nothing more to come once a stream has ended.
+        if (msg_len == 0 && socket.type() == SOCK_STREAM)
+            break;
+        if (deadline.has_value() && TimeManagement::the().monotonic_time() >= deadline.value())
+            break;
+    }
+    return received;
+}
+
+ErrorOr<size_t> Process::recvmsg_impl(OpenFileDescription& description, Userspace<struct msghdr*> user_msg, int flags)
+{
     struct msghdr msg;
     TRY(copy_from_user(&msg, user_msg));
 
@@ -269,18 +368,15 @@ ErrorOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> user
     Userspace<sockaddr*> user_addr((FlatPtr)msg.msg_name);
     Userspace<socklen_t*> user_addr_length(msg.msg_name ? (FlatPtr)&user_msg.unsafe_userspace_ptr()->msg_namelen : 0);
 
-    auto description = TRY(open_file_description(sockfd));
-    if (!description->is_socket())
-        return ENOTSOCK;
-    auto& socket = *description->socket();
+    auto& socket = *description.socket();
 
     if (socket.is_shut_down_for_reading())
         return 0;
 
     auto data_buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len));
     UnixDateTime timestamp {};
-    bool blocking = (flags & MSG_DONTWAIT) ? false : description->is_blocking();
-    auto result = socket.recvfrom(*description, data_buffer, iovs[0].iov_len, flags, user_addr, user_addr_length, timestamp, blocking);
+    bool blocking = (flags & MSG_DONTWAIT) ? false : description.is_blocking();
+    auto result = socket.recvfrom(description, data_buffer, iovs[0].iov_len, flags, user_addr, user_addr_length, timestamp, blocking);
 
     if (result.is_error())
         return result.release_error();
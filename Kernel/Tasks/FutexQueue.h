@@ -39,12 +39,16 @@ public:
     }
     bool is_empty_and_no_imminent_waits_locked();
 
+    // Only used by priority-inheriting futexes.
+    Thread::PriorityBoost& priority_boost() { return m_priority_boost; }
+
 protected:
     virtual bool should_add_blocker(Thread::Blocker& b, void*) override;
 
 private:
     size_t m_imminent_waits { 1 }; // We only create this object if we're going to be waiting, so start out with 1
     bool m_was_removed { false };
+    Thread::PriorityBoost m_priority_boost;
 };
 
 }
@@ -9,8 +9,10 @@
 #include <AK/JsonObjectSerializer.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StackUnwinder.h>
+#include <AK/StringBuilder.h>
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Arch/SafeMem.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/Library/KBufferBuilder.h>
 #include <Kernel/Tasks/PerformanceEventBuffer.h>
@@ -19,8 +21,10 @@
 
 namespace Kernel {
 
-PerformanceEventBuffer::PerformanceEventBuffer(NonnullOwnPtr<KBuffer> buffer)
+PerformanceEventBuffer::PerformanceEventBuffer(NonnullOwnPtr<KBuffer> buffer, FixedArray<Ring> rings, size_t events_per_ring)
     : m_buffer(move(buffer))
+    , m_rings(move(rings))
+    , m_events_per_ring(events_per_ring)
 {
 }
 
@@ -84,9 +88,6 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
 ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, ThreadID tid,
     FlatPtr ip, FlatPtr bp, int type, u32 lost_samples, FlatPtr arg1, FlatPtr arg2, StringView arg3, FilesystemEvent filesystem_event)
 {
-    if (count() >= capacity())
-        return ENOBUFS;
-
     if ((g_profiling_event_mask & type) == 0)
         return EINVAL;
 
@@ -182,15 +183,70 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
     event.pid = pid.value();
     event.tid = tid.value();
     event.timestamp = TimeManagement::the().uptime_ms();
-    at(m_count++) = event;
+
+    // NOTE: With interrupts disabled, nothing else can append to this processor's ring until we're done.
+    InterruptDisabler disabler;
+    auto processor_id = Processor::current_id();
+    if (processor_id >= m_rings.size()) {
+        // This processor came up after the buffer was created.
+        m_rings[0].lost_events.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        return ENOBUFS;
+    }
+    auto& ring = m_rings[processor_id];
+    auto tail = ring.tail.load(AK::MemoryOrder::memory_order_relaxed);
+    if (tail - ring.head.load(AK::MemoryOrder::memory_order_acquire) >= m_events_per_ring) {
+        ring.lost_events.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        return ENOBUFS;
+    }
+    ring.events[tail % m_events_per_ring] = event;
+    ring.tail.store(tail + 1, AK::MemoryOrder::memory_order_release);
     return {};
 }
 
-PerformanceEvent& PerformanceEventBuffer::at(size_t index)
+void PerformanceEventBuffer::clear()
+{
+    // Readers walk the rings from their heads, so don't move those out from under them.
+    MutexLocker locker(m_reader_lock);
+    for (auto& ring : m_rings)
+        ring.head.store(ring.tail.load(AK::MemoryOrder::memory_order_acquire), AK::MemoryOrder::memory_order_release);
+}
+
+u64 PerformanceEventBuffer::lost_event_count() const
 {
-    VERIFY(index < capacity());
-    auto* events = reinterpret_cast<PerformanceEvent*>(m_buffer->data());
-    return events[index];
+    u64 lost_event_count = 0;
+    for (auto& ring : m_rings)
+        lost_event_count += ring.lost_events.load(AK::MemoryOrder::memory_order_relaxed);
+    return lost_event_count;
+}
+
+template<typename Callback>
+ErrorOr<void> PerformanceEventBuffer::for_each_buffered_event(Vector<u64>& positions, Callback callback) const
+{
+    VERIFY(m_reader_lock.is_locked());
+
+    Vector<u64> tails;
+    TRY(positions.try_resize(m_rings.size()));
+    TRY(tails.try_resize(m_rings.size()));
+    for (size_t i = 0; i < m_rings.size(); ++i) {
+        positions[i] = m_rings[i].head.load(AK::MemoryOrder::memory_order_acquire);
+        tails[i] = m_rings[i].tail.load(AK::MemoryOrder::memory_order_acquire);
+    }
+
+    // Each ring is ordered already, so we just have to keep picking the oldest event at the front of any of them.
+    while (true) {
+        Optional<size_t> oldest_ring_index;
+        for (size_t i = 0; i < m_rings.size(); ++i) {
+            if (positions[i] == tails[i])
+                continue;
+            if (!oldest_ring_index.has_value() || event_at(i, positions[i]).timestamp < event_at(*oldest_ring_index, positions[*oldest_ring_index]).timestamp)
+                oldest_ring_index = i;
+        }
+        if (!oldest_ring_index.has_value())
+            return {};
+        if (TRY(callback(event_at(*oldest_ring_index, positions[*oldest_ring_index]))) == IterationDecision::Break)
+            return {};
+        ++positions[*oldest_ring_index];
+    }
 }
 
 template<typename Serializer>
@@ -219,152 +275,162 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
 
     auto current_process_credentials = Process::current().credentials();
     bool show_kernel_addresses = current_process_credentials->is_superuser();
-    auto array = TRY(object.add_array("events"sv));
-    bool seen_first_sample = false;
-    for (size_t i = 0; i < m_count; ++i) {
-        auto const& event = at(i);
+    {
+        auto array = TRY(object.add_array("events"sv));
+        bool seen_first_sample = false;
+        MutexLocker locker(m_reader_lock);
+        Vector<u64> positions;
+        TRY(for_each_buffered_event(positions, [&](PerformanceEvent const& event) -> ErrorOr<IterationDecision> {
+            if (!show_kernel_addresses) {
+                if (event.type == PERF_EVENT_KMALLOC || event.type == PERF_EVENT_KFREE)
+                    return IterationDecision::Continue;
+            }
 
-        if (!show_kernel_addresses) {
-            if (event.type == PERF_EVENT_KMALLOC || event.type == PERF_EVENT_KFREE)
-                continue;
-        }
+            auto event_object = TRY(array.add_object());
+            TRY(serialize_event(event_object, event, show_kernel_addresses, seen_first_sample ? event.lost_samples : 0));
+            if (event.type == PERF_EVENT_SAMPLE)
+                seen_first_sample = true;
+            return IterationDecision::Continue;
+        }));
+        TRY(array.finish());
+    }
+    TRY(object.add("lost_events"sv, lost_event_count()));
+    TRY(object.finish());
+    return {};
+}
 
-        auto event_object = TRY(array.add_object());
-        switch (event.type) {
-        case PERF_EVENT_SAMPLE:
-            TRY(event_object.add("type"sv, "sample"));
-            break;
-        case PERF_EVENT_MALLOC:
-            TRY(event_object.add("type"sv, "malloc"));
-            TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.malloc.ptr)));
-            TRY(event_object.add("size"sv, static_cast<u64>(event.data.malloc.size)));
-            break;
-        case PERF_EVENT_FREE:
-            TRY(event_object.add("type"sv, "free"));
-            TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.free.ptr)));
-            break;
-        case PERF_EVENT_MMAP:
-            TRY(event_object.add("type"sv, "mmap"));
-            TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.mmap.ptr)));
-            TRY(event_object.add("size"sv, static_cast<u64>(event.data.mmap.size)));
-            TRY(event_object.add("name"sv, event.data.mmap.name));
-            break;
-        case PERF_EVENT_MUNMAP:
-            TRY(event_object.add("type"sv, "munmap"));
-            TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.munmap.ptr)));
-            TRY(event_object.add("size"sv, static_cast<u64>(event.data.munmap.size)));
-            break;
-        case PERF_EVENT_PROCESS_CREATE:
-            TRY(event_object.add("type"sv, "process_create"));
-            TRY(event_object.add("parent_pid"sv, static_cast<u64>(event.data.process_create.parent_pid)));
-            TRY(event_object.add("executable"sv, event.data.process_create.executable));
-            break;
-        case PERF_EVENT_PROCESS_EXEC:
-            TRY(event_object.add("type"sv, "process_exec"));
-            TRY(event_object.add("executable"sv, event.data.process_exec.executable));
-            break;
-        case PERF_EVENT_PROCESS_EXIT:
-            TRY(event_object.add("type"sv, "process_exit"));
-            break;
-        case PERF_EVENT_THREAD_CREATE:
-            TRY(event_object.add("type"sv, "thread_create"));
-            TRY(event_object.add("parent_tid"sv, static_cast<u64>(event.data.thread_create.parent_tid)));
-            break;
-        case PERF_EVENT_THREAD_EXIT:
-            TRY(event_object.add("type"sv, "thread_exit"));
-            break;
-        case PERF_EVENT_CONTEXT_SWITCH:
-            TRY(event_object.add("type"sv, "context_switch"));
-            TRY(event_object.add("next_pid"sv, static_cast<u64>(event.data.context_switch.next_pid)));
-            TRY(event_object.add("next_tid"sv, static_cast<u64>(event.data.context_switch.next_tid)));
-            break;
-        case PERF_EVENT_KMALLOC:
-            TRY(event_object.add("type"sv, "kmalloc"));
-            TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.kmalloc.ptr)));
-            TRY(event_object.add("size"sv, static_cast<u64>(event.data.kmalloc.size)));
-            break;
-        case PERF_EVENT_KFREE:
-            TRY(event_object.add("type"sv, "kfree"));
-            TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.kfree.ptr)));
-            TRY(event_object.add("size"sv, static_cast<u64>(event.data.kfree.size)));
+template<typename Serializer>
+ErrorOr<void> PerformanceEventBuffer::serialize_event(Serializer& event_object, PerformanceEvent const& event, bool show_kernel_addresses, u32 lost_samples)
+{
+    switch (event.type) {
+    case PERF_EVENT_SAMPLE:
+        TRY(event_object.add("type"sv, "sample"));
+        break;
+    case PERF_EVENT_MALLOC:
+        TRY(event_object.add("type"sv, "malloc"));
+        TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.malloc.ptr)));
+        TRY(event_object.add("size"sv, static_cast<u64>(event.data.malloc.size)));
+        break;
+    case PERF_EVENT_FREE:
+        TRY(event_object.add("type"sv, "free"));
+        TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.free.ptr)));
+        break;
+    case PERF_EVENT_MMAP:
+        TRY(event_object.add("type"sv, "mmap"));
+        TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.mmap.ptr)));
+        TRY(event_object.add("size"sv, static_cast<u64>(event.data.mmap.size)));
+        TRY(event_object.add("name"sv, event.data.mmap.name));
+        break;
+    case PERF_EVENT_MUNMAP:
+        TRY(event_object.add("type"sv, "munmap"));
+        TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.munmap.ptr)));
+        TRY(event_object.add("size"sv, static_cast<u64>(event.data.munmap.size)));
+        break;
+    case PERF_EVENT_PROCESS_CREATE:
+        TRY(event_object.add("type"sv, "process_create"));
+        TRY(event_object.add("parent_pid"sv, static_cast<u64>(event.data.process_create.parent_pid)));
+        TRY(event_object.add("executable"sv, event.data.process_create.executable));
+        break;
+    case PERF_EVENT_PROCESS_EXEC:
+        TRY(event_object.add("type"sv, "process_exec"));
+        TRY(event_object.add("executable"sv, event.data.process_exec.executable));
+        break;
+    case PERF_EVENT_PROCESS_EXIT:
+        TRY(event_object.add("type"sv, "process_exit"));
+        break;
+    case PERF_EVENT_THREAD_CREATE:
+        TRY(event_object.add("type"sv, "thread_create"));
+        TRY(event_object.add("parent_tid"sv, static_cast<u64>(event.data.thread_create.parent_tid)));
+        break;
+    case PERF_EVENT_THREAD_EXIT:
+        TRY(event_object.add("type"sv, "thread_exit"));
+        break;
+    case PERF_EVENT_CONTEXT_SWITCH:
+        TRY(event_object.add("type"sv, "context_switch"));
+        TRY(event_object.add("next_pid"sv, static_cast<u64>(event.data.context_switch.next_pid)));
+        TRY(event_object.add("next_tid"sv, static_cast<u64>(event.data.context_switch.next_tid)));
+        break;
+    case PERF_EVENT_KMALLOC:
+        TRY(event_object.add("type"sv, "kmalloc"));
+        TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.kmalloc.ptr)));
+        TRY(event_object.add("size"sv, static_cast<u64>(event.data.kmalloc.size)));
+        break;
+    case PERF_EVENT_KFREE:
+        TRY(event_object.add("type"sv, "kfree"));
+        TRY(event_object.add("ptr"sv, static_cast<u64>(event.data.kfree.ptr)));
+        TRY(event_object.add("size"sv, static_cast<u64>(event.data.kfree.size)));
+        break;
+    case PERF_EVENT_PAGE_FAULT:
+        TRY(event_object.add("type"sv, "page_fault"));
+        break;
+    case PERF_EVENT_SYSCALL:
+        TRY(event_object.add("type"sv, "syscall"));
+        break;
+    case PERF_EVENT_SIGNPOST:
+        TRY(event_object.add("type"sv, "signpost"sv));
+        TRY(event_object.add("arg1"sv, event.data.signpost.arg1));
+        TRY(event_object.add("arg2"sv, event.data.signpost.arg2));
+        break;
+    case PERF_EVENT_FILESYSTEM:
+        TRY(event_object.add("type"sv, "filesystem"sv));
+        TRY(event_object.add("durationNs"sv, event.data.filesystem.durationNs));
+        switch (event.data.filesystem.type) {
+        case FilesystemEventType::Open: {
+            auto const& open = event.data.filesystem.data.open;
+            TRY(event_object.add("fs_event_type"sv, "open"sv));
+            TRY(event_object.add("dirfd"sv, open.dirfd));
+            TRY(event_object.add("filename_index"sv, open.filename_index));
+            TRY(event_object.add("options"sv, open.options));
+            TRY(event_object.add("mode"sv, open.mode));
             break;
-        case PERF_EVENT_PAGE_FAULT:
-            TRY(event_object.add("type"sv, "page_fault"));
+        }
+        case FilesystemEventType::Close: {
+            auto const& close = event.data.filesystem.data.close;
+            TRY(event_object.add("fs_event_type"sv, "close"sv));
+            TRY(event_object.add("fd"sv, close.fd));
+            TRY(event_object.add("filename_index"sv, close.filename_index));
             break;
-        case PERF_EVENT_SYSCALL:
-            TRY(event_object.add("type"sv, "syscall"));
+        }
+        case FilesystemEventType::Readv: {
+            auto const& readv = event.data.filesystem.data.readv;
+            TRY(event_object.add("fs_event_type"sv, "readv"sv));
+            TRY(event_object.add("fd"sv, readv.fd));
+            TRY(event_object.add("filename_index"sv, readv.filename_index));
             break;
-        case PERF_EVENT_SIGNPOST:
-            TRY(event_object.add("type"sv, "signpost"sv));
-            TRY(event_object.add("arg1"sv, event.data.signpost.arg1));
-            TRY(event_object.add("arg2"sv, event.data.signpost.arg2));
+        }
+        case FilesystemEventType::Read: {
+            auto const& read = event.data.filesystem.data.read;
+            TRY(event_object.add("fs_event_type"sv, "read"sv));
+            TRY(event_object.add("fd"sv, read.fd));
+            TRY(event_object.add("filename_index"sv, read.filename_index));
             break;
-        case PERF_EVENT_FILESYSTEM:
-            TRY(event_object.add("type"sv, "filesystem"sv));
-            TRY(event_object.add("durationNs"sv, event.data.filesystem.durationNs));
-            switch (event.data.filesystem.type) {
-            case FilesystemEventType::Open: {
-                auto const& open = event.data.filesystem.data.open;
-                TRY(event_object.add("fs_event_type"sv, "open"sv));
-                TRY(event_object.add("dirfd"sv, open.dirfd));
-                TRY(event_object.add("filename_index"sv, open.filename_index));
-                TRY(event_object.add("options"sv, open.options));
-                TRY(event_object.add("mode"sv, open.mode));
-                break;
-            }
-            case FilesystemEventType::Close: {
-                auto const& close = event.data.filesystem.data.close;
-                TRY(event_object.add("fs_event_type"sv, "close"sv));
-                TRY(event_object.add("fd"sv, close.fd));
-                TRY(event_object.add("filename_index"sv, close.filename_index));
-                break;
-            }
-            case FilesystemEventType::Readv: {
-                auto const& readv = event.data.filesystem.data.readv;
-                TRY(event_object.add("fs_event_type"sv, "readv"sv));
-                TRY(event_object.add("fd"sv, readv.fd));
-                TRY(event_object.add("filename_index"sv, readv.filename_index));
-                break;
-            }
-            case FilesystemEventType::Read: {
-                auto const& read = event.data.filesystem.data.read;
-                TRY(event_object.add("fs_event_type"sv, "read"sv));
-                TRY(event_object.add("fd"sv, read.fd));
-                TRY(event_object.add("filename_index"sv, read.filename_index));
-                break;
-            }
-            case FilesystemEventType::Pread: {
-                auto const& pread = event.data.filesystem.data.pread;
-                TRY(event_object.add("fs_event_type"sv, "pread"sv));
-                TRY(event_object.add("fd"sv, pread.fd));
-                TRY(event_object.add("filename_index"sv, pread.filename_index));
-                TRY(event_object.add("buffer_ptr"sv, pread.buffer_ptr));
-                TRY(event_object.add("size"sv, pread.size));
-                TRY(event_object.add("offset"sv, pread.offset));
-                break;
-            }
-            }
+        }
+        case FilesystemEventType::Pread: {
+            auto const& pread = event.data.filesystem.data.pread;
+            TRY(event_object.add("fs_event_type"sv, "pread"sv));
+            TRY(event_object.add("fd"sv, pread.fd));
+            TRY(event_object.add("filename_index"sv, pread.filename_index));
+            TRY(event_object.add("buffer_ptr"sv, pread.buffer_ptr));
+            TRY(event_object.add("size"sv, pread.size));
+            TRY(event_object.add("offset"sv, pread.offset));
             break;
         }
-        TRY(event_object.add("pid"sv, event.pid));
-        TRY(event_object.add("tid"sv, event.tid));
-        TRY(event_object.add("timestamp"sv, event.timestamp));
-        TRY(event_object.add("lost_samples"sv, seen_first_sample ? event.lost_samples : 0));
-        if (event.type == PERF_EVENT_SAMPLE)
-            seen_first_sample = true;
-        auto stack_array = TRY(event_object.add_array("stack"sv));
-        for (size_t j = 0; j < event.stack_size; ++j) {
-            auto address = event.stack[j];
-            if (!show_kernel_addresses && !Memory::is_user_address(VirtualAddress { address }))
-                address = 0xdeadc0de;
-            TRY(stack_array.add(address));
         }
-        TRY(stack_array.finish());
-        TRY(event_object.finish());
+        break;
     }
-    TRY(array.finish());
-    TRY(object.finish());
-    return {};
+    TRY(event_object.add("pid"sv, event.pid));
+    TRY(event_object.add("tid"sv, event.tid));
+    TRY(event_object.add("timestamp"sv, event.timestamp));
+    TRY(event_object.add("lost_samples"sv, lost_samples));
+    auto stack_array = TRY(event_object.add_array("stack"sv));
+    for (size_t j = 0; j < min<size_t>(event.stack_size, PerformanceEvent::max_stack_frame_count); ++j) {
+        auto address = event.stack[j];
+        if (!show_kernel_addresses && !Memory::is_user_address(VirtualAddress { address }))
+            address = 0xdeadc0de;
+        TRY(stack_array.add(address));
+    }
+    TRY(stack_array.finish());
+    return event_object.finish();
 }
 
 ErrorOr<void> PerformanceEventBuffer::to_json(KBufferBuilder& builder) const
@@ -373,12 +439,101 @@ ErrorOr<void> PerformanceEventBuffer::to_json(KBufferBuilder& builder) const
     return to_json_impl(object);
 }
 
+ErrorOr<void> PerformanceEventBuffer::consume_as_json_lines(KBufferBuilder& builder, size_t max_size)
+{
+    auto current_process_credentials = Process::current().credentials();
+    bool show_kernel_addresses = current_process_credentials->is_superuser();
+
+    MutexLocker locker(m_reader_lock);
+
+    auto append_line = [&](auto generate) -> ErrorOr<bool> {
+        StringBuilder line_builder;
+        auto object = TRY(JsonObjectSerializer<StringBuilder>::try_create(line_builder));
+        TRY(generate(object));
+        TRY(line_builder.try_append('\n'));
+        if (builder.length() + line_builder.length() > max_size) {
+            // A reader that can't even take a single event won't make any progress.
+            if (builder.length() == 0)
+                return EINVAL;
+            return false;
+        }
+        TRY(builder.append(line_builder.string_view()));
+        return true;
+    };
+
+    // Strings are referenced by index, so they go out before any event that might use them.
+    Vector<KString const*> new_strings;
+    TRY(m_strings.with([&](auto& strings) -> ErrorOr<void> {
+        TRY(new_strings.try_resize(strings.size() - min(strings.size(), m_consumed_string_count)));
+        for (auto& entry : strings) {
+            if (entry.value >= m_consumed_string_count)
+                new_strings[entry.value - m_consumed_string_count] = entry.key.ptr();
+        }
+        return {};
+    }));
+    for (auto const* string : new_strings) {
+        bool did_fit = TRY(append_line([&](auto& object) -> ErrorOr<void> {
+            TRY(object.add("type"sv, "string"sv));
+            TRY(object.add("index"sv, m_consumed_string_count));
+            TRY(object.add("value"sv, string->view()));
+            return object.finish();
+        }));
+        if (!did_fit)
+            return {};
+        ++m_consumed_string_count;
+    }
+
+    auto lost_events = lost_event_count();
+    if (lost_events != m_reported_lost_event_count) {
+        bool did_fit = TRY(append_line([&](auto& object) -> ErrorOr<void> {
+            TRY(object.add("type"sv, "lost"sv));
+            TRY(object.add("count"sv, lost_events - m_reported_lost_event_count));
+            return object.finish();
+        }));
+        if (!did_fit)
+            return {};
+        m_reported_lost_event_count = lost_events;
+    }
+
+    Vector<u64> positions;
+    auto result = for_each_buffered_event(positions, [&](PerformanceEvent const& event) -> ErrorOr<IterationDecision> {
+        if (!show_kernel_addresses) {
+            if (event.type == PERF_EVENT_KMALLOC || event.type == PERF_EVENT_KFREE)
+                return IterationDecision::Continue;
+        }
+        bool did_fit = TRY(append_line([&](auto& object) {
+            return serialize_event(object, event, show_kernel_addresses, event.lost_samples);
+        }));
+        return did_fit ? IterationDecision::Continue : IterationDecision::Break;
+    });
+
+    // Hand everything we got through back to the producers.
+    for (size_t i = 0; i < positions.size(); ++i)
+        m_rings[i].head.store(positions[i], AK::MemoryOrder::memory_order_release);
+    return result;
+}
+
 OwnPtr<PerformanceEventBuffer> PerformanceEventBuffer::try_create_with_size(size_t buffer_size)
 {
-    auto buffer_or_error = KBuffer::try_create_with_size("Performance events"sv, buffer_size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
+    auto ring_count = Processor::count();
+    auto events_per_ring = buffer_size / sizeof(PerformanceEvent) / ring_count;
+    if (events_per_ring == 0)
+        return {};
+
+    auto buffer_or_error = KBuffer::try_create_with_size("Performance events"sv, events_per_ring * ring_count * sizeof(PerformanceEvent), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
     if (buffer_or_error.is_error())
         return {};
-    return adopt_own_if_nonnull(new (nothrow) PerformanceEventBuffer(buffer_or_error.release_value()));
+    auto buffer = buffer_or_error.release_value();
+
+    auto rings_or_error = FixedArray<Ring>::create(ring_count);
+    if (rings_or_error.is_error())
+        return {};
+    auto rings = rings_or_error.release_value();
+    auto* events = reinterpret_cast<PerformanceEvent*>(buffer->data());
+    for (size_t i = 0; i < ring_count; ++i)
+        rings[i].events = events + i * events_per_ring;
+
+    return adopt_own_if_nonnull(new (nothrow) PerformanceEventBuffer(move(buffer), move(rings), events_per_ring));
 }
 
 ErrorOr<void> PerformanceEventBuffer::add_process(Process const& process, ProcessEventType event_type)
@@ -7,8 +7,11 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Error.h>
+#include <AK/FixedArray.h>
 #include <Kernel/Library/KBuffer.h>
+#include <Kernel/Locking/Mutex.h>
 
 namespace Kernel {
 
@@ -167,6 +170,10 @@ enum class ProcessEventType {
     Exec
 };
 
+// Events are recorded into one ring per processor, so threads on different processors never contend
+// with each other. Each ring only ever has a single producer, its processor (with interrupts disabled
+// while an event is being stored), and readers take turns, so no locks are needed to append.
+// Events that don't fit are dropped and counted, rather than overwriting anything that wasn't read yet.
 class PerformanceEventBuffer {
 public:
     static OwnPtr<PerformanceEventBuffer> try_create_with_size(size_t buffer_size);
@@ -177,34 +184,60 @@ public:
     ErrorOr<void> append_with_ip_and_bp(ProcessID pid, ThreadID tid, RegisterState const& regs,
         int type, u32 lost_samples, FlatPtr arg1, FlatPtr arg2, StringView arg3, FilesystemEvent filesystem_event = {});
 
-    void clear()
-    {
-        m_count = 0;
-    }
+    // Forgets about all buffered events. Doesn't block, so it can be used from critical sections.
+    void clear();
 
-    size_t capacity() const { return m_buffer->size() / sizeof(PerformanceEvent); }
-    size_t count() const { return m_count; }
-    PerformanceEvent const& at(size_t index) const
-    {
-        return const_cast<PerformanceEventBuffer&>(*this).at(index);
-    }
+    size_t capacity() const { return m_events_per_ring * m_rings.size(); }
+    u64 lost_event_count() const;
 
+    // Serializes all buffered events, ordered by their timestamp, without consuming them.
     ErrorOr<void> to_json(KBufferBuilder&) const;
 
+    // Consumes buffered events and serializes them as one JSON object per line, up to `max_size` bytes.
+    // Strings registered since the last call and the number of events that were lost in the meantime
+    // are reported as objects of type "string" and "lost", respectively.
+    ErrorOr<void> consume_as_json_lines(KBufferBuilder&, size_t max_size);
+
     ErrorOr<void> add_process(Process const&, ProcessEventType event_type);
 
     ErrorOr<FlatPtr> register_string(NonnullOwnPtr<KString>);
 
 private:
-    explicit PerformanceEventBuffer(NonnullOwnPtr<KBuffer>);
+    struct Ring {
+        // Free-running counters. The tail is only advanced by the processor that owns the ring,
+        // the head only by readers and clear(), under m_reader_lock.
+        Atomic<u64> head { 0 };
+        Atomic<u64> tail { 0 };
+        Atomic<u64> lost_events { 0 };
+        PerformanceEvent* events { nullptr };
+    };
+
+    PerformanceEventBuffer(NonnullOwnPtr<KBuffer>, FixedArray<Ring>, size_t events_per_ring);
 
     template<typename Serializer>
     ErrorOr<void> to_json_impl(Serializer&) const;
 
-    PerformanceEvent& at(size_t index);
+    template<typename Serializer>
+    static ErrorOr<void> serialize_event(Serializer&, PerformanceEvent const&, bool show_kernel_addresses, u32 lost_samples);
+
+    // Calls the callback with the ring index and position of each buffered event, oldest first,
+    // until it returns IterationDecision::Break.
+    template<typename Callback>
+    ErrorOr<void> for_each_buffered_event(Vector<u64>& positions, Callback) const;
+
+    PerformanceEvent const& event_at(size_t ring_index, u64 position) const
+    {
+        return m_rings[ring_index].events[position % m_events_per_ring];
+    }
 
-    size_t m_count { 0 };
     NonnullOwnPtr<KBuffer> m_buffer;
+    FixedArray<Ring> m_rings;
+    size_t const m_events_per_ring { 0 };
+
+    // Serializes readers and clear(), which all advance the heads of the rings.
+    mutable Mutex m_reader_lock { "PerformanceEventBuffer"sv };
+    size_t m_consumed_string_count { 0 };
+    u64 m_reported_lost_event_count { 0 };
 
     SpinlockProtected<HashMap<NonnullOwnPtr<KString>, size_t>, LockRank::None> m_strings;
 };
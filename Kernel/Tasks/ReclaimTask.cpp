@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/InodePageCache.h>
+#include <Kernel/FileSystem/MemoryPressureListener.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/InodeVMObject.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/ReclaimTask.h>
+#include <Kernel/Tasks/WaitQueue.h>
+
+namespace Kernel {
+
+static constexpr StringView reclaim_task_name = "Reclaim Task"sv;
+
+// All in pages.
+struct Watermarks {
+    // Below this, we're about to start failing allocations.
+    size_t critical { 0 };
+    // Below this, we start reclaiming.
+    size_t low { 0 };
+    // Once reclaiming, we keep at it until we get back up to this.
+    size_t high { 0 };
+};
+
+READONLY_AFTER_INIT static Watermarks s_watermarks;
+READONLY_AFTER_INIT static WaitQueue* s_wait_queue;
+static Atomic<bool> s_has_work { false };
+static Atomic<MemoryPressureLevel> s_pressure_level { MemoryPressureLevel::Normal };
+static Atomic<u64> s_reclaimed_page_count { 0 };
+
+static size_t available_pages()
+{
+    return MM.get_system_memory_info().physical_pages_uncommitted;
+}
+
+static MemoryPressureLevel pressure_level_for(size_t available_pages, MemoryPressureLevel current_level)
+{
+    if (available_pages < s_watermarks.critical)
+        return MemoryPressureLevel::Critical;
+    if (available_pages < s_watermarks.low)
+        return MemoryPressureLevel::Low;
+    // Don't let go until we're comfortably above the low watermark again, or we'd just keep flip-flopping.
+    if (current_level != MemoryPressureLevel::Normal && available_pages < s_watermarks.high)
+        return MemoryPressureLevel::Low;
+    return MemoryPressureLevel::Normal;
+}
+
+// NOTE: The VMObjects are collected first and dealt with afterwards, since releasing pages
+//       requires the MemoryManager's lock, which may be held by someone waiting for the list.
+template<typename VMObjectType, typename Filter>
+static Vector<NonnullLockRefPtr<VMObjectType>> collect_vmobjects(Filter filter)
+{
+    Vector<NonnullLockRefPtr<VMObjectType>> vmobjects;
+    Memory::MemoryManager::for_each_vmobject([&](auto& vmobject) {
+        if (!filter(vmobject))
+            return IterationDecision::Continue;
+        // If we can't remember any more of them, make do with what we have.
+        if (vmobjects.try_append(static_cast<VMObjectType&>(vmobject)).is_error())
+            return IterationDecision::Break;
+        return IterationDecision::Continue;
+    });
+    return vmobjects;
+}
+
+static void purge_volatile_memory(size_t target_pages)
+{
+    auto vmobjects = collect_vmobjects<Memory::AnonymousVMObject>([](auto& vmobject) {
+        if (!vmobject.is_anonymous())
+            return false;
+        auto& anonymous_vmobject = static_cast<Memory::AnonymousVMObject&>(vmobject);
+        return anonymous_vmobject.is_purgeable() && anonymous_vmobject.is_volatile();
+    });
+    for (auto& vmobject : vmobjects) {
+        if (available_pages() >= target_pages)
+            return;
+        vmobject->purge();
+    }
+}
+
+static void release_clean_file_pages(size_t target_pages, MemoryPressureLevel level)
+{
+    auto vmobjects = collect_vmobjects<Memory::InodeVMObject>([](auto& vmobject) { return vmobject.is_inode(); });
+    for (auto& vmobject : vmobjects) {
+        auto available = available_pages();
+        if (available >= target_pages)
+            return;
+        // When things get critical, pages that are in use are fair game too. They'll just have to be read in again.
+        if (level == MemoryPressureLevel::Critical)
+            vmobject->try_release_clean_pages(target_pages - available);
+        else
+            vmobject->try_release_clean_pages_not_recently_accessed(target_pages - available);
+    }
+}
+
+static void release_page_cache_pages(size_t target_pages, MemoryPressureLevel level)
+{
+    auto available = available_pages();
+    if (available >= target_pages)
+        return;
+    auto take_recently_used = level == MemoryPressureLevel::Critical ? InodePageCache::TakeRecentlyUsed::Yes : InodePageCache::TakeRecentlyUsed::No;
+    InodePageCache::release_unused_pages(target_pages - available, take_recently_used);
+}
+
+// Gives back memory until we're at the high watermark, going for whatever hurts the least first.
+static void reclaim(MemoryPressureLevel level)
+{
+    auto target_pages = s_watermarks.high;
+
+    // Volatile memory has been offered up by its owner, so that goes first.
+    purge_volatile_memory(target_pages);
+
+    // Then file contents nobody has looked at in a while.
+    release_page_cache_pages(target_pages, level);
+
+    // Pages of shared file mappings are owned by the page cache, so dropping them from their VMObject
+    // only makes them eligible for release from there.
+    release_clean_file_pages(target_pages, level);
+    release_page_cache_pages(target_pages, level);
+}
+
+static void set_pressure_level(MemoryPressureLevel level)
+{
+    auto previous_level = s_pressure_level.exchange(level, AK::MemoryOrder::memory_order_relaxed);
+    if (previous_level == level)
+        return;
+    dbgln("ReclaimTask: Memory pressure level changed from {} to {}, {} pages available",
+        to_underlying(previous_level), to_underlying(level), available_pages());
+    MemoryPressureListener::notify_pressure_level_changed();
+}
+
+static void reclaim_task(void*)
+{
+    while (!Process::current().is_dying()) {
+        auto level = s_pressure_level.load(AK::MemoryOrder::memory_order_relaxed);
+        auto available_before = available_pages();
+        level = pressure_level_for(available_before, level);
+
+        bool made_progress = false;
+        if (level != MemoryPressureLevel::Normal) {
+            reclaim(level);
+            auto available_after = available_pages();
+            if (available_after > available_before) {
+                s_reclaimed_page_count.fetch_add(available_after - available_before, AK::MemoryOrder::memory_order_relaxed);
+                made_progress = true;
+            }
+            level = pressure_level_for(available_after, level);
+        }
+        set_pressure_level(level);
+
+        // If there was nothing to be found this time around, give it a moment before trying again.
+        if (s_has_work.exchange(false, AK::MemoryOrder::memory_order_acq_rel) && made_progress)
+            continue;
+        // Things can change fast while we're under pressure, so keep a closer eye on them then.
+        auto timeout_time = level == MemoryPressureLevel::Normal ? Duration::from_seconds(1) : Duration::from_milliseconds(100);
+        auto timeout = Thread::BlockTimeout { false, &timeout_time };
+        [[maybe_unused]] auto result = s_wait_queue->wait_on(timeout, reclaim_task_name);
+    }
+    Process::current().sys$exit(0);
+    VERIFY_NOT_REACHED();
+}
+
+UNMAP_AFTER_INIT void ReclaimTask::spawn()
+{
+    auto physical_pages = MM.get_system_memory_info().physical_pages;
+    s_watermarks.low = max(physical_pages / 32, static_cast<size_t>(256));
+    s_watermarks.high = s_watermarks.low * 2;
+    s_watermarks.critical = s_watermarks.low / 4;
+    dmesgln("ReclaimTask: Watermarks are {} (critical), {} (low) and {} (high) pages", s_watermarks.critical, s_watermarks.low, s_watermarks.high);
+
+    s_wait_queue = new WaitQueue;
+    MUST(Process::create_kernel_process(reclaim_task_name, reclaim_task, nullptr));
+}
+
+void ReclaimTask::did_allocate_pages(size_t pages_left)
+{
+    // We're not up and running yet.
+    if (!s_wait_queue)
+        return;
+    if (pages_left >= s_watermarks.low)
+        return;
+    if (s_has_work.exchange(true, AK::MemoryOrder::memory_order_acq_rel))
+        return;
+    s_wait_queue->wake_one();
+}
+
+MemoryPressureLevel ReclaimTask::pressure_level()
+{
+    return s_pressure_level.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+u64 ReclaimTask::reclaimed_page_count()
+{
+    return s_reclaimed_page_count.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+}
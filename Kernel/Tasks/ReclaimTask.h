@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <Kernel/API/MemoryPressure.h>
+
+namespace Kernel {
+
+// Keeps a reserve of free physical pages around, so allocations rarely have to go looking for memory
+// to give back themselves (or fail) when they need some.
+//
+// Once the number of available pages drops below the low watermark, the task evicts purgeable memory,
+// file pages that haven't been accessed in a while and unused page cache pages, until it gets back
+// above the high watermark. Changes in memory pressure are passed on to MemoryPressureListeners.
+class ReclaimTask {
+public:
+    static void spawn();
+
+    // Called by the MemoryManager after it handed out pages. Wakes the task if we're running low.
+    static void did_allocate_pages(size_t pages_left);
+
+    static MemoryPressureLevel pressure_level();
+    static u64 reclaimed_page_count();
+};
+
+}
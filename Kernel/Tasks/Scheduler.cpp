@@ -46,7 +46,15 @@ struct ThreadReadyQueues {
     Array<ThreadReadyQueue, count> queues;
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+// Every processor has its own set of ready queues, so that picking the next thread
+// doesn't contend with the other processors. Idle processors steal from the others.
+// NOTE: A processor only ever holds one of these locks at a time: stealing drops the
+//       lock of its own ready queues before it takes the one of a victim, so there's
+//       no lock order between them that could deadlock. They may be taken while holding
+//       g_scheduler_lock, but never the other way around.
+static Singleton<Array<SpinlockProtected<ThreadReadyQueues, LockRank::None>, MAX_CPU_COUNT>> g_ready_queues;
+static_assert(MAX_CPU_COUNT <= 64);
+static Atomic<u64> s_processors_with_ready_threads { 0 };
 
 static SpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
@@ -64,73 +72,116 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static u32 ready_queue_processor_for(Thread const& thread)
 {
-    auto affinity_mask = 1u << Processor::current_id();
+    // Prefer the processor the thread last ran on, as its caches are likely still warm.
+    auto affinity = thread.affinity();
+    auto last_processor = thread.cpu();
+    if (last_processor < 32 && (affinity & (1u << last_processor)))
+        return last_processor;
+    auto current_processor = Processor::current_id();
+    if (current_processor < 32 && (affinity & (1u << current_processor)))
+        return current_processor;
+    VERIFY(affinity != 0);
+    return bit_scan_forward(affinity) - 1;
+}
+
+static void remove_from_ready_queue(ThreadReadyQueues& ready_queues, Thread& thread, u32 priority, u32 processor)
+{
+    auto& ready_queue = ready_queues.queues[priority];
+    ready_queue.thread_list.remove(thread);
+    if (ready_queue.thread_list.is_empty()) {
+        ready_queues.mask &= ~(1u << priority);
+        if (ready_queues.mask == 0)
+            s_processors_with_ready_threads.fetch_and(~(1ull << processor), AK::MemoryOrder::memory_order_relaxed);
+    }
+}
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
+static Thread* find_runnable_thread(ThreadReadyQueues& ready_queues, u32 affinity_mask)
+{
+    auto priority_mask = ready_queues.mask;
+    while (priority_mask != 0) {
+        auto priority = bit_scan_forward(priority_mask);
+        VERIFY(priority > 0);
+        auto& ready_queue = ready_queues.queues[--priority];
+        for (auto& thread : ready_queue.thread_list) {
+            if (thread.is_active())
+                continue;
+            if (!(thread.affinity() & affinity_mask))
+                continue;
+            return &thread;
         }
+        priority_mask &= ~(1u << priority);
+    }
+    return nullptr;
+}
+
+// Calls the callback with the ready queues of the current processor first, then with
+// the ones of every other processor that has threads waiting, until it returns a thread.
+// Processors without ready threads are skipped without touching their locks.
+template<typename Callback>
+static Thread* for_each_ready_queues_until_found(Callback callback)
+{
+    auto current_processor = Processor::current_id();
+    auto processors_with_ready_threads = s_processors_with_ready_threads.load(AK::MemoryOrder::memory_order_relaxed);
+    if (processors_with_ready_threads & (1ull << current_processor)) {
+        if (auto* thread = (*g_ready_queues)[current_processor].with([&](auto& ready_queues) { return callback(ready_queues); }))
+            return thread;
+    }
+
+    auto other_processors = processors_with_ready_threads & ~(1ull << current_processor);
+    // Start looking right after the current processor, so that idle processors don't all go after the same victim.
+    auto rotated = (other_processors >> current_processor) | (current_processor ? other_processors << (64 - current_processor) : 0);
+    while (rotated != 0) {
+        auto processor = (bit_scan_forward(rotated) - 1 + current_processor) % 64;
+        rotated &= rotated - 1;
+        if (auto* thread = (*g_ready_queues)[processor].with([&](auto& ready_queues) { return callback(ready_queues); }))
+            return thread;
+    }
+    return nullptr;
+}
 
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto affinity_mask = 1u << Processor::current_id();
+
+    auto* thread = for_each_ready_queues_until_found([&](auto& ready_queues) -> Thread* {
+        auto* thread = find_runnable_thread(ready_queues, affinity_mask);
+        if (!thread)
+            return nullptr;
+        VERIFY(thread->m_runnable_priority >= 0);
+        remove_from_ready_queue(ready_queues, *thread, thread->m_runnable_priority, thread->m_runnable_processor);
+        thread->m_runnable_priority = -1;
+        // Mark it as active because we are using this thread. This is similar
+        // to comparing it with Processor::current_thread, but when there are
+        // multiple processors there's no easy way to check whether the thread
+        // is actually still needed. This prevents accidental finalization when
+        // a thread is no longer in Running state, but running on another core.
+
+        // We need to mark it active here so that this thread won't be
+        // scheduled on another core if it were to be queued before actually
+        // switching to it.
+        // FIXME: Figure out a better way maybe?
+        thread->set_active(true);
+        return thread;
     });
+    if (thread)
+        return *thread;
+
+    auto* idle_thread = Processor::idle_thread();
+    idle_thread->set_active(true);
+    return *idle_thread;
 }
 
 Thread* Scheduler::peek_next_runnable_thread()
 {
     auto affinity_mask = 1u << Processor::current_id();
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
-            }
-            priority_mask &= ~(1u << priority);
-        }
-
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
-        return nullptr;
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled.
+    return for_each_ready_queues_until_found([&](auto& ready_queues) {
+        return find_runnable_thread(ready_queues, affinity_mask);
     });
 }
 
@@ -139,7 +190,12 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
+    if (thread.m_runnable_priority < 0) {
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        return false;
+    }
+
+    return (*g_ready_queues)[thread.m_runnable_processor].with([&](auto& ready_queues) {
         auto priority = thread.m_runnable_priority;
         if (priority < 0) {
             VERIFY(!thread.m_ready_queue_node.is_in_list());
@@ -150,11 +206,8 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
             return false;
 
         VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
+        remove_from_ready_queue(ready_queues, thread, priority, thread.m_runnable_processor);
         thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
         return true;
     });
 }
@@ -164,17 +217,22 @@ void Scheduler::enqueue_runnable_thread(Thread& thread)
     VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
-    auto priority = thread_priority_to_priority_index(thread.priority());
+    auto priority = thread_priority_to_priority_index(thread.effective_priority());
+    auto processor = ready_queue_processor_for(thread);
 
-    g_ready_queues->with([&](auto& ready_queues) {
+    (*g_ready_queues)[processor].with([&](auto& ready_queues) {
         VERIFY(thread.m_runnable_priority < 0);
         thread.m_runnable_priority = (int)priority;
+        thread.m_runnable_processor = processor;
         VERIFY(!thread.m_ready_queue_node.is_in_list());
         auto& ready_queue = ready_queues.queues[priority];
         bool was_empty = ready_queue.thread_list.is_empty();
         ready_queue.thread_list.append(thread);
-        if (was_empty)
+        if (was_empty) {
+            if (ready_queues.mask == 0)
+                s_processors_with_ready_threads.fetch_or(1ull << processor, AK::MemoryOrder::memory_order_relaxed);
             ready_queues.mask |= (1u << priority);
+        }
     });
 }
 
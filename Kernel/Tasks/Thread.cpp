@@ -104,6 +104,10 @@ Thread::~Thread()
 
     // We shouldn't be queued
     VERIFY(m_runnable_priority < 0);
+
+    SpinlockLocker lock(g_scheduler_lock);
+    while (auto* boost = m_priority_boosts.take_first())
+        boost->m_owner = nullptr;
 }
 
 Thread::BlockResult Thread::block_impl(BlockTimeout const& timeout, Blocker& blocker)
@@ -634,6 +638,53 @@ bool Thread::tick()
     return m_ticks_left != 0;
 }
 
+Thread::PriorityBoost::~PriorityBoost()
+{
+    SpinlockLocker lock(g_scheduler_lock);
+    if (m_owner)
+        m_owner->drop_inherited_priority(*this);
+}
+
+void Thread::inherit_priority(PriorityBoost& boost, u32 priority)
+{
+    SpinlockLocker lock(g_scheduler_lock);
+    if (boost.m_owner != this) {
+        if (auto* previous_owner = exchange(boost.m_owner, nullptr)) {
+            previous_owner->m_priority_boosts.remove(boost);
+            previous_owner->update_inherited_priority();
+        }
+        boost.m_owner = this;
+        m_priority_boosts.append(boost);
+    }
+    boost.m_priority = max(boost.m_priority, priority);
+    update_inherited_priority();
+}
+
+void Thread::drop_inherited_priority(PriorityBoost& boost)
+{
+    SpinlockLocker lock(g_scheduler_lock);
+    if (boost.m_owner != this)
+        return;
+    // The boost keeps its priority, as the threads still waiting for the futex will boost whoever takes it next.
+    boost.m_owner = nullptr;
+    m_priority_boosts.remove(boost);
+    update_inherited_priority();
+}
+
+void Thread::update_inherited_priority()
+{
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    u32 inherited_priority = 0;
+    for (auto& boost : m_priority_boosts)
+        inherited_priority = max(inherited_priority, boost.m_priority);
+    if (inherited_priority == m_inherited_priority)
+        return;
+    m_inherited_priority = inherited_priority;
+    // If it's waiting to be scheduled, move it over to the ready queue for its new priority right away.
+    if (Scheduler::dequeue_runnable_thread(*this))
+        Scheduler::enqueue_runnable_thread(*this);
+}
+
 void Thread::check_dispatch_pending_signal()
 {
     auto result = DispatchSignalResult::Continue;
@@ -84,6 +84,31 @@ public:
     void set_priority(u32 p) { m_priority = p; }
     u32 priority() const { return m_priority; }
 
+    // The priority inherited through one priority-inheritance futex, from the threads that waited for it.
+    // It is handed on together with the futex, and its owner runs at the highest of the boosts it holds.
+    // Guarded by g_scheduler_lock.
+    class PriorityBoost {
+        AK_MAKE_NONCOPYABLE(PriorityBoost);
+        AK_MAKE_NONMOVABLE(PriorityBoost);
+
+    public:
+        PriorityBoost() = default;
+        ~PriorityBoost();
+
+    private:
+        friend class Thread;
+
+        Thread* m_owner { nullptr };
+        u32 m_priority { 0 };
+        IntrusiveListNode<PriorityBoost> m_list_node;
+    };
+
+    // The priority the scheduler goes by. A thread that holds a priority-inheritance futex
+    // runs at least at the priority of the threads waiting for it.
+    u32 effective_priority() const { return max(m_priority, m_inherited_priority); }
+    void inherit_priority(PriorityBoost&, u32 priority = 0);
+    void drop_inherited_priority(PriorityBoost&);
+
     void detach()
     {
         SpinlockLocker lock(m_lock);
@@ -1094,6 +1119,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_runnable_processor { 0 };
 
     friend class WaitQueue;
 
@@ -1156,6 +1182,7 @@ private:
     LockMode unlock_process_if_locked(u32&);
     void relock_process(LockMode, u32);
     void reset_fpu_state();
+    void update_inherited_priority();
 
     mutable RecursiveSpinlock<LockRank::Thread> m_lock {};
     mutable RecursiveSpinlock<LockRank::None> m_block_lock {};
@@ -1226,6 +1253,9 @@ private:
     State m_state { Thread::State::Invalid };
     SpinlockProtected<Name, LockRank::None> m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    // Guarded by g_scheduler_lock.
+    u32 m_inherited_priority { 0 };
+    IntrusiveList<&PriorityBoost::m_list_node> m_priority_boosts;
 
     State m_stop_state { Thread::State::Invalid };
 
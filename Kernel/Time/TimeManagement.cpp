@@ -561,10 +561,21 @@ bool TimeManagement::enable_profile_timer()
     if (!m_profile_timer)
         return false;
     if (m_profile_enable_count.fetch_add(1) == 0)
-        return m_profile_timer->try_to_set_frequency(m_profile_timer->calculate_nearest_possible_frequency(OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE));
+        return m_profile_timer->try_to_set_frequency(m_profile_timer->calculate_nearest_possible_frequency(profile_sample_rate()));
     return true;
 }
 
+bool TimeManagement::set_profile_sample_rate(u32 sample_rate)
+{
+    // More than this and we would spend most of our time in the profiler.
+    if (sample_rate == 0 || sample_rate > 10'000)
+        return false;
+    m_profile_sample_rate.store(sample_rate, AK::MemoryOrder::memory_order_relaxed);
+    if (!m_profile_timer || m_profile_enable_count.load() == 0)
+        return true;
+    return m_profile_timer->try_to_set_frequency(m_profile_timer->calculate_nearest_possible_frequency(sample_rate));
+}
+
 bool TimeManagement::disable_profile_timer()
 {
     if (!m_profile_timer)
@@ -64,6 +64,9 @@ public:
 
     bool enable_profile_timer();
     bool disable_profile_timer();
+    // How many samples per second the profiler takes. Takes effect right away if it's running.
+    u32 profile_sample_rate() const { return m_profile_sample_rate.load(AK::MemoryOrder::memory_order_relaxed); }
+    bool set_profile_sample_rate(u32);
 
     u64 uptime_ms() const;
     static UnixDateTime now();
@@ -116,6 +119,7 @@ private:
     LockRefPtr<HardwareTimerBase> m_time_keeper_timer;
 
     Atomic<u32> m_profile_enable_count { 0 };
+    Atomic<u32> m_profile_sample_rate { OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE };
     LockRefPtr<HardwareTimerBase> m_profile_timer;
 
     NonnullOwnPtr<Memory::Region> m_time_page_region;
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteString.h>
+#include <AK/JsonDocument.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonParser.h>
+#include <AK/JsonValue.h>
+#include <AK/StringBuilder.h>
+#include <AK/Vector.h>
+
+TEST_CASE(load_form)
+{
+    auto raw_form_json = R"(
+    {
+        "name": "Form1",
+        "widgets": [
+            {
+                "enabled": true,
+                "forecolor": "#000000ff",
+                "x": 155,
+                "tooltip": null,
+                "height": 121,
+                "class": "GTextEditor",
+                "text": "Hi"
+            },
+            {
+                "enabled": false,
+                "class": "GButton",
+                "text": "Click \"here\""
+            }
+        ]
+    })"sv;
+
+    auto document = TRY_OR_FAIL(JsonDocument::parse(raw_form_json));
+    auto root = document.root();
+    EXPECT(root.is_object());
+    EXPECT_EQ(root.size(), 2u);
+    EXPECT_EQ(root.get_string("name"sv), "Form1"sv);
+    EXPECT(!root.has("missing"sv));
+
+    auto widgets = root.get_array("widgets"sv);
+    EXPECT(widgets.has_value());
+    EXPECT_EQ(widgets->size(), 2u);
+
+    auto first = widgets->at(0);
+    EXPECT_EQ(first.get_bool("enabled"sv), true);
+    EXPECT_EQ(first.get_i32("x"sv), 155);
+    EXPECT_EQ(first.get_u32("height"sv), 121u);
+    EXPECT(first.get("tooltip"sv)->is_null());
+    EXPECT_EQ(first.get_byte_string("class"sv), "GTextEditor");
+
+    // Skipping over the first widget has to skip over everything inside of it too.
+    auto second = (*widgets)[1];
+    EXPECT_EQ(second.get_bool("enabled"sv), false);
+    EXPECT_EQ(second.get_string("text"sv), "Click \"here\""sv);
+
+    Vector<ByteString> classes;
+    widgets->for_each([&](auto const& widget) {
+        classes.append(widget.get_byte_string("class"sv).value());
+    });
+    EXPECT_EQ(classes, (Vector<ByteString> { "GTextEditor", "GButton" }));
+
+    Vector<ByteString> keys;
+    first.for_each_member([&](StringView key, auto const&) {
+        keys.append(key);
+    });
+    EXPECT_EQ(keys, (Vector<ByteString> { "enabled", "forecolor", "x", "tooltip", "height", "class", "text" }));
+}
+
+TEST_CASE(strings_are_views_into_the_input)
+{
+    auto input = R"(["plain", "escaped\ttab"])"sv;
+    auto document = TRY_OR_FAIL(JsonDocument::parse(input));
+
+    auto plain = document.root().at(0).as_string();
+    EXPECT_EQ(plain, "plain"sv);
+    EXPECT_EQ(plain.characters_without_null_termination(), input.characters_without_null_termination() + 2);
+
+    EXPECT_EQ(document.root().at(1).as_string(), "escaped\ttab"sv);
+}
+
+TEST_CASE(escapes)
+{
+    auto document = TRY_OR_FAIL(JsonDocument::parse(R"(["\"\\\/\b\f\n\r\t", "é😀", "\\", "\\\""])"sv));
+    auto root = document.root();
+    EXPECT_EQ(root.at(0).as_string(), "\"\\/\b\f\n\r\t"sv);
+    EXPECT_EQ(root.at(1).as_string(), "\xc3\xa9\xf0\x9f\x98\x80"sv);
+    EXPECT_EQ(root.at(2).as_string(), "\\"sv);
+    EXPECT_EQ(root.at(3).as_string(), "\\\""sv);
+}
+
+TEST_CASE(numbers)
+{
+    auto document = TRY_OR_FAIL(JsonDocument::parse("[0, -0, 42, -42, 18446744073709551615, -9223372036854775808, 1.5, -2.5e3, 1e400]"sv));
+    auto root = document.root();
+
+    EXPECT_EQ(root.at(0).get_u64(), 0u);
+    EXPECT_EQ(root.at(1).get_double_with_precision_loss(), -0.0);
+    EXPECT_EQ(root.at(2).get_i32(), 42);
+    EXPECT_EQ(root.at(3).get_i32(), -42);
+    EXPECT(!root.at(3).get_u32().has_value());
+    EXPECT_EQ(root.at(4).get_u64(), NumericLimits<u64>::max());
+    EXPECT(!root.at(4).get_i64().has_value());
+    EXPECT_EQ(root.at(5).get_i64(), NumericLimits<i64>::min());
+    EXPECT_EQ(root.at(6).get_double_with_precision_loss(), 1.5);
+    EXPECT(!root.at(6).get_i32().has_value());
+    EXPECT_EQ(root.at(7).get_i32(), -2500);
+    EXPECT_EQ(root.at(8).as_number_text(), "1e400"sv);
+}
+
+TEST_CASE(strings_across_block_boundaries)
+{
+    // The structural index is built 64 bytes at a time, so quotes and runs of backslashes have to carry over.
+    for (size_t padding = 0; padding < 140; ++padding) {
+        for (size_t backslashes = 0; backslashes < 6; ++backslashes) {
+            StringBuilder builder;
+            builder.append("[\""sv);
+            builder.append_repeated('x', padding);
+            builder.append_repeated('\\', backslashes);
+            builder.append("\"y\", 1]"sv);
+
+            auto input = builder.string_view();
+            auto document = JsonDocument::parse(input);
+            auto expected = JsonValue::from_string(input);
+            EXPECT_EQ(document.is_error(), expected.is_error());
+            if (!document.is_error() && !expected.is_error())
+                EXPECT_EQ(document.value().root().to_json_value().serialized<StringBuilder>(), expected.value().serialized<StringBuilder>());
+        }
+    }
+}
+
+TEST_CASE(matches_json_parser)
+{
+    auto inputs = {
+        "{}"sv,
+        "[]"sv,
+        " 1 "sv,
+        "\"string\""sv,
+        "null"sv,
+        R"({"a": [1, 2, {"b": null}], "c": {"d": [[], {}]}, "e": "f"})"sv,
+        R"([true, false, null, "", 0.25, -1e-2])"sv,
+        R"({"duplicate": 1, "duplicate": 2})"sv,
+    };
+    for (auto input : inputs) {
+        auto document = TRY_OR_FAIL(JsonDocument::parse(input));
+        auto expected = TRY_OR_FAIL(JsonValue::from_string(input));
+        EXPECT_EQ(document.root().to_json_value().serialized<StringBuilder>(), expected.serialized<StringBuilder>());
+    }
+}
+
+TEST_CASE(invalid_input)
+{
+    auto inputs = {
+        ""sv,
+        "   "sv,
+        "nul"sv,
+        "nullx"sv,
+        "tru"sv,
+        "[1,]"sv,
+        R"({"a": 1,})"sv,
+        "[1 2]"sv,
+        R"({"a" 1})"sv,
+        "{1: 2}"sv,
+        "\"unterminated"sv,
+        "\"control\ncharacter\""sv,
+        R"(["\x"])"sv,
+        R"(["\u12"])"sv,
+        "01"sv,
+        "-"sv,
+        "1."sv,
+        ".5"sv,
+        "1e+"sv,
+        "[}"sv,
+        "{]"sv,
+        "[1]]"sv,
+        "1 2"sv,
+        R"("a" "b")"sv,
+        "[1,,2]"sv,
+    };
+    for (auto input : inputs)
+        EXPECT(JsonDocument::parse(input).is_error());
+}
+
+TEST_CASE(events)
+{
+    struct Recorder : public JsonEventHandler {
+        virtual ErrorOr<void> on_object_start() override { return record("{"sv); }
+        virtual ErrorOr<void> on_object_end() override { return record("}"sv); }
+        virtual ErrorOr<void> on_array_start() override { return record("["sv); }
+        virtual ErrorOr<void> on_array_end() override { return record("]"sv); }
+        virtual ErrorOr<void> on_key(StringView key) override { return record(ByteString::formatted("key:{}", key)); }
+        virtual ErrorOr<void> on_string(StringView string) override { return record(ByteString::formatted("string:{}", string)); }
+        virtual ErrorOr<void> on_number(StringView number) override { return record(ByteString::formatted("number:{}", number)); }
+        virtual ErrorOr<void> on_bool(bool value) override { return record(value ? "true"sv : "false"sv); }
+        virtual ErrorOr<void> on_null() override { return record("null"sv); }
+
+        ErrorOr<void> record(StringView event)
+        {
+            events.append(event);
+            return {};
+        }
+
+        Vector<ByteString> events;
+    };
+
+    Recorder recorder;
+    TRY_OR_FAIL(parse_json_events(R"({"a\n": [1.5, true, null], "b": "c"})"sv, recorder));
+    EXPECT_EQ(recorder.events, (Vector<ByteString> { "{", "key:a\n", "[", "number:1.5", "true", "null", "]", "key:b", "string:c", "}" }));
+
+    struct Stopper : public JsonEventHandler {
+        virtual ErrorOr<void> on_number(StringView) override { return Error::from_string_literal("Stop"); }
+    };
+    Stopper stopper;
+    EXPECT(parse_json_events("[1, 2]"sv, stopper).is_error());
+}
+
+TEST_CASE(to_json_value)
+{
+    auto document = TRY_OR_FAIL(JsonDocument::parse(R"({"name": "serenity", "numbers": [1, -2, 3.5], "nested": {"ok": true}})"sv));
+    auto value = document.root().to_json_value();
+    EXPECT(value.is_object());
+    EXPECT_EQ(value.as_object().get_byte_string("name"sv), "serenity");
+    EXPECT_EQ(value.as_object().get_array("numbers"sv)->size(), 3u);
+    EXPECT_EQ(value.as_object().get_object("nested"sv)->get_bool("ok"sv), true);
+}
+
+// Benchmarks comparing JsonDocument with JsonParser on a /sys/kernel/processes-like document.
+
+static ByteString make_benchmark_document()
+{
+    StringBuilder builder;
+    builder.append("{\"processes\":["sv);
+    for (size_t i = 0; i < 500; ++i) {
+        if (i != 0)
+            builder.append(',');
+        builder.appendff("{{\"pid\":{},\"name\":\"process-{}\",\"executable\":\"/bin/process\\/{}\",\"kernel\":false,\"threads\":[", i, i, i);
+        for (size_t j = 0; j < 4; ++j) {
+            if (j != 0)
+                builder.append(',');
+            builder.appendff("{{\"tid\":{},\"name\":\"thread-{}\",\"state\":\"Running\",\"time_user\":{},\"time_kernel\":{},\"cpu\":{}}}", i * 4 + j, j, i * 1000 + j, j * 12345, j % 4);
+        }
+        builder.append("]}"sv);
+    }
+    builder.append("]}"sv);
+    return builder.to_byte_string();
+}
+
+static constexpr size_t benchmark_rounds = 50;
+
+BENCHMARK_CASE(json_parser)
+{
+    auto input = make_benchmark_document();
+    u64 total = 0;
+    for (size_t round = 0; round < benchmark_rounds; ++round) {
+        auto json = MUST(JsonValue::from_string(input));
+        json.as_object().get_array("processes"sv)->for_each([&](auto const& process) {
+            total += process.as_object().get_u32("pid"sv).value_or(0);
+        });
+    }
+    EXPECT_EQ(total, benchmark_rounds * 499 * 500 / 2);
+}
+
+BENCHMARK_CASE(json_document)
+{
+    auto input = make_benchmark_document();
+    u64 total = 0;
+    for (size_t round = 0; round < benchmark_rounds; ++round) {
+        auto document = MUST(JsonDocument::parse(input));
+        document.root().get_array("processes"sv)->for_each([&](auto const& process) {
+            total += process.get_u32("pid"sv).value_or(0);
+        });
+    }
+    EXPECT_EQ(total, benchmark_rounds * 499 * 500 / 2);
+}
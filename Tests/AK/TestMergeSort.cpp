@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/MergeSort.h>
+#include <AK/Noncopyable.h>
+#include <AK/Random.h>
+#include <AK/Vector.h>
+
+TEST_CASE(sorts_ascending)
+{
+    for (size_t size : { 0, 1, 2, 15, 16, 17, 1000 }) {
+        Vector<int> values;
+        for (size_t i = 0; i < size; ++i)
+            values.append(get_random<int>());
+
+        merge_sort(values);
+        EXPECT_EQ(values.size(), size);
+        for (size_t i = 1; i < values.size(); ++i)
+            EXPECT(values[i - 1] <= values[i]);
+    }
+}
+
+TEST_CASE(is_stable)
+{
+    struct Entry {
+        int key;
+        size_t original_index;
+    };
+
+    Vector<Entry> entries;
+    for (size_t i = 0; i < 5000; ++i)
+        entries.append({ static_cast<int>(get_random_uniform(10)), i });
+
+    merge_sort(entries, [](auto& a, auto& b) { return a.key < b.key; });
+
+    for (size_t i = 1; i < entries.size(); ++i) {
+        EXPECT(entries[i - 1].key <= entries[i].key);
+        if (entries[i - 1].key == entries[i].key)
+            EXPECT(entries[i - 1].original_index < entries[i].original_index);
+    }
+}
+
+TEST_CASE(sorts_without_copy)
+{
+    struct NoCopy {
+        AK_MAKE_NONCOPYABLE(NoCopy);
+        AK_MAKE_DEFAULT_MOVABLE(NoCopy);
+
+    public:
+        NoCopy(int value)
+            : value(value)
+        {
+        }
+
+        int value { 0 };
+    };
+
+    Vector<NoCopy> values;
+    for (int i = 0; i < 100; ++i)
+        values.empend((100 - i) % 32);
+
+    merge_sort(values, [](auto& a, auto& b) { return a.value < b.value; });
+
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1].value <= values[i].value);
+}
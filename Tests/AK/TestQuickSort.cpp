@@ -8,7 +8,9 @@
 
 #include <AK/Noncopyable.h>
 #include <AK/QuickSort.h>
+#include <AK/Random.h>
 #include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
 
 TEST_CASE(sorts_without_copy)
 {
@@ -39,6 +41,15 @@ TEST_CASE(sorts_without_copy)
 
     AK::single_pivot_quick_sort(array.begin(), array.end(), [](auto& a, auto& b) { return a.value < b.value; });
 
+    for (size_t i = 0; i < 63; ++i)
+        EXPECT(array[i].value <= array[i + 1].value);
+
+    // Test the pattern-defeating quick sort.
+    for (size_t i = 0; i < 64; ++i)
+        array[i].value = (64 - i) % 32 + 32;
+
+    AK::sort(array, [](auto& a, auto& b) { return a.value < b.value; });
+
     for (size_t i = 0; i < 63; ++i)
         EXPECT(array[i].value <= array[i + 1].value);
 }
@@ -95,3 +106,135 @@ TEST_CASE(maximum_stack_depth)
 
     delete[] data;
 }
+
+static bool is_sorted(Vector<int> const& values)
+{
+    for (size_t i = 1; i < values.size(); ++i) {
+        if (values[i] < values[i - 1])
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE(sorts_patterns)
+{
+    for (size_t size : { 0, 1, 2, 3, 23, 24, 25, 127, 128, 129, 1000, 10000 }) {
+        Vector<int> ascending;
+        Vector<int> descending;
+        Vector<int> organ_pipe;
+        Vector<int> sawtooth;
+        Vector<int> few_unique;
+        Vector<int> random;
+        for (size_t i = 0; i < size; ++i) {
+            ascending.append(i);
+            descending.append(size - i);
+            organ_pipe.append(i < size / 2 ? i : size - i);
+            sawtooth.append(i % 37);
+            few_unique.append(get_random_uniform(4));
+            random.append(get_random<int>());
+        }
+
+        for (auto& input : { ascending, descending, organ_pipe, sawtooth, few_unique, random }) {
+            auto sorted = input;
+            AK::sort(sorted);
+            EXPECT_EQ(sorted.size(), size);
+            EXPECT(is_sorted(sorted));
+        }
+    }
+}
+
+TEST_CASE(sorts_non_arithmetic_values)
+{
+    struct Value {
+        int key;
+        bool operator<(Value const& other) const { return key < other.key; }
+    };
+
+    Vector<Value> values;
+    for (int i = 0; i < 5000; ++i)
+        values.append({ static_cast<int>(get_random_uniform(1000)) });
+
+    AK::sort(values);
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1].key <= values[i].key);
+}
+
+// This is the "antiqsort" adversary from M. D. McIlroy's "A Killer Adversary for Quicksort". It decides the order of
+// the elements while the sort is running, always in the way that makes the current pivot as bad as possible. Plain
+// quick sort needs a quadratic number of comparisons against it, the heap sort fallback avoids that.
+TEST_CASE(adversarial_input_is_not_quadratic)
+{
+    static constexpr int size = 10000;
+
+    Vector<int> values;
+    Vector<int> order;
+    for (int i = 0; i < size; ++i) {
+        values.append(i);
+        order.append(size);
+    }
+
+    int const gas = size;
+    int solid_count = 0;
+    int candidate = 0;
+    size_t comparisons = 0;
+    AK::sort(values, [&](int a, int b) {
+        ++comparisons;
+        if (order[a] == gas && order[b] == gas)
+            order[a == candidate ? a : b] = solid_count++;
+        if (order[a] == gas)
+            candidate = a;
+        else if (order[b] == gas)
+            candidate = b;
+        return order[a] < order[b];
+    });
+
+    for (int i = 1; i < size; ++i)
+        EXPECT(order[values[i - 1]] <= order[values[i]]);
+
+    // n * log2(n) is about 133'000 here, while a quadratic sort would need tens of millions.
+    EXPECT(comparisons < 10 * 133'000);
+}
+
+TEST_CASE(sorted_input_is_linear)
+{
+    static constexpr int size = 10000;
+
+    Vector<int> values;
+    for (int i = 0; i < size; ++i)
+        values.append(i);
+
+    size_t comparisons = 0;
+    AK::sort(values, [&](int a, int b) {
+        ++comparisons;
+        return a < b;
+    });
+    EXPECT(is_sorted(values));
+    EXPECT(comparisons < 4 * size);
+
+    values.reverse();
+    comparisons = 0;
+    AK::sort(values, [&](int a, int b) {
+        ++comparisons;
+        return a < b;
+    });
+    EXPECT(is_sorted(values));
+    EXPECT(comparisons < 4 * size);
+}
+
+BENCHMARK_CASE(sort_random_integers)
+{
+    Vector<int> values;
+    for (int i = 0; i < 1'000'000; ++i)
+        values.append(get_random<int>());
+    AK::sort(values);
+    EXPECT(is_sorted(values));
+}
+
+BENCHMARK_CASE(dual_pivot_quick_sort_random_integers)
+{
+    Vector<int> values;
+    for (int i = 0; i < 1'000'000; ++i)
+        values.append(get_random<int>());
+    dual_pivot_quick_sort(values, 0, values.size() - 1, [](auto& a, auto& b) { return a < b; });
+    EXPECT(is_sorted(values));
+}
@@ -1397,3 +1397,11 @@ TEST_CASE(elementwise_byte_reverse_u64x4)
         EXPECT_EQ(result[i], expected[i]);
     }
 }
+
+TEST_CASE(maskbits_i8x16)
+{
+    AK::SIMD::i8x16 v { -1, 0, 0, -128, 127, 0, 0, 0, 0, -2, 0, 0, 0, 0, 0, -1 };
+    EXPECT_EQ(AK::SIMD::maskbits(v), 0b1000'0010'0000'1001);
+    EXPECT_EQ(AK::SIMD::maskbits(AK::SIMD::i8x16 {}), 0);
+    EXPECT_EQ(AK::SIMD::maskbits(AK::SIMD::i8x16 {} == 0), 0xffff);
+}
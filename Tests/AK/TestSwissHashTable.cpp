@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteString.h>
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/String.h>
+#include <AK/SwissHashTable.h>
+#include <AK/Vector.h>
+
+TEST_CASE(construct)
+{
+    SwissHashTable<int> table;
+    EXPECT(table.is_empty());
+    EXPECT_EQ(table.size(), 0u);
+    EXPECT_EQ(table.capacity(), 0u);
+    EXPECT(table.begin() == table.end());
+    EXPECT(!table.contains(1));
+}
+
+TEST_CASE(populate)
+{
+    SwissHashTable<ByteString> strings;
+    EXPECT_EQ(strings.set("One"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("Two"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("Three"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("Two"), AK::HashSetResult::ReplacedExistingEntry);
+    EXPECT_EQ(strings.set("Two", AK::HashSetExistingEntryBehavior::Keep), AK::HashSetResult::KeptExistingEntry);
+
+    EXPECT_EQ(strings.size(), 3u);
+    EXPECT(strings.contains("One"sv));
+    EXPECT(strings.contains("Two"sv));
+    EXPECT(strings.contains("Three"sv));
+    EXPECT(!strings.contains("Four"sv));
+}
+
+TEST_CASE(range_loop)
+{
+    SwissHashTable<int> table;
+    for (int i = 0; i < 100; ++i)
+        table.set(i);
+
+    int sum = 0;
+    size_t loop_counter = 0;
+    for (auto value : table) {
+        sum += value;
+        ++loop_counter;
+    }
+    EXPECT_EQ(loop_counter, 100u);
+    EXPECT_EQ(sum, 99 * 100 / 2);
+}
+
+TEST_CASE(many_strings)
+{
+    SwissHashTable<ByteString> strings;
+    for (int i = 0; i < 999; ++i)
+        EXPECT_EQ(strings.set(ByteString::number(i)), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.size(), 999u);
+    for (int i = 0; i < 999; ++i)
+        EXPECT(strings.contains(ByteString::number(i)));
+    for (int i = 0; i < 999; ++i)
+        EXPECT_EQ(strings.remove(ByteString::number(i)), true);
+    EXPECT(strings.is_empty());
+}
+
+TEST_CASE(many_collisions)
+{
+    struct StringCollisionTraits : public DefaultTraits<ByteString> {
+        static unsigned hash(ByteString const&) { return 0; }
+    };
+
+    // Everything ends up with the same control byte in the same group, so this probes past lots of full groups.
+    SwissHashTable<ByteString, StringCollisionTraits> strings;
+    for (int i = 0; i < 999; ++i)
+        EXPECT_EQ(strings.set(ByteString::number(i)), AK::HashSetResult::InsertedNewEntry);
+
+    EXPECT_EQ(strings.set("foo"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.size(), 1000u);
+
+    for (int i = 0; i < 999; ++i)
+        EXPECT_EQ(strings.remove(ByteString::number(i)), true);
+
+    EXPECT(strings.find("foo") != strings.end());
+    EXPECT(strings.find("0") == strings.end());
+}
+
+TEST_CASE(tombstones)
+{
+    struct IntCollisionTraits : public DefaultTraits<int> {
+        static unsigned hash(int) { return 0; }
+    };
+
+    SwissHashTable<int, IntCollisionTraits> table;
+    for (int i = 0; i < 100; ++i)
+        table.set(i);
+
+    // Values further along the probe sequence have to stay reachable after the ones before them are gone.
+    for (int i = 0; i < 50; ++i)
+        EXPECT(table.remove(i));
+    for (int i = 50; i < 100; ++i)
+        EXPECT(table.contains(i));
+
+    // Adding the values back should reuse the slots they left behind.
+    auto capacity = table.capacity();
+    for (int i = 0; i < 50; ++i)
+        EXPECT_EQ(table.set(i), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(table.capacity(), capacity);
+    EXPECT_EQ(table.size(), 100u);
+}
+
+TEST_CASE(capacity_leak)
+{
+    SwissHashTable<int> table;
+    for (size_t i = 0; i < 10000; ++i) {
+        table.set(i);
+        table.remove(i);
+    }
+    EXPECT(table.capacity() < 100u);
+}
+
+TEST_CASE(churn_does_not_keep_growing)
+{
+    SwissHashTable<int> table;
+    for (int i = 0; i < 100; ++i)
+        table.set(i);
+    auto capacity = table.capacity();
+
+    // Tombstones pile up here. Once there's enough room, they should be cleaned up instead of growing the table further.
+    for (int i = 100; i < 100'000; ++i) {
+        table.set(i);
+        EXPECT(table.remove(i - 100));
+    }
+    EXPECT_EQ(table.size(), 100u);
+    EXPECT(table.capacity() <= capacity * 2);
+    for (int i = 100'000 - 100; i < 100'000; ++i)
+        EXPECT(table.contains(i));
+}
+
+TEST_CASE(ensure_capacity)
+{
+    SwissHashTable<int> table;
+    table.ensure_capacity(1000);
+    auto capacity = table.capacity();
+    EXPECT(capacity >= 1000u);
+
+    for (int i = 0; i < 1000; ++i)
+        table.set(i);
+    EXPECT_EQ(table.capacity(), capacity);
+}
+
+TEST_CASE(non_trivial_type_table)
+{
+    SwissHashTable<NonnullOwnPtr<int>> table;
+
+    table.set(make<int>(3));
+    table.set(make<int>(11));
+
+    for (int i = 0; i < 1'000; ++i)
+        table.set(make<int>(-i));
+    for (int i = 0; i < 10'000; ++i) {
+        table.set(make<int>(i));
+        table.remove(make<int>(i));
+    }
+
+    EXPECT_EQ(table.remove_all_matching([&](auto&) { return true; }), true);
+    EXPECT(table.is_empty());
+    EXPECT_EQ(table.remove_all_matching([&](auto&) { return true; }), false);
+}
+
+TEST_CASE(copy_and_move)
+{
+    SwissHashTable<ByteString> table;
+    for (int i = 0; i < 100; ++i)
+        table.set(ByteString::number(i));
+
+    auto copy = table;
+    EXPECT_EQ(copy.size(), 100u);
+    for (int i = 0; i < 100; ++i)
+        EXPECT(copy.contains(ByteString::number(i)));
+
+    auto moved = move(table);
+    EXPECT(table.is_empty());
+    EXPECT_EQ(moved.size(), 100u);
+    EXPECT(moved.contains("42"sv));
+
+    moved.clear_with_capacity();
+    EXPECT(moved.is_empty());
+    EXPECT(!moved.contains("42"sv));
+    EXPECT_EQ(copy.size(), 100u);
+}
+
+TEST_CASE(iterator_removal)
+{
+    SwissHashTable<int> table;
+    table.set(0);
+    table.set(1);
+
+    auto it = table.begin();
+    table.remove(it);
+    EXPECT_EQ(it, table.end());
+    EXPECT_EQ(table.size(), 1u);
+}
+
+TEST_CASE(swiss_hash_map)
+{
+    SwissHashMap<int, ByteString> map;
+    map.set(1, "One");
+    map.set(2, "Two");
+    map.set(3, "Three");
+
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map.get(2).value(), "Two");
+    EXPECT(!map.get(4).has_value());
+
+    map.ensure(4) = "Four";
+    EXPECT_EQ(map.get(4).value(), "Four");
+
+    EXPECT_EQ(map.take(1), "One");
+    EXPECT(!map.contains(1));
+    EXPECT_EQ(map.size(), 3u);
+
+    map.remove_all_matching([](int key, ByteString const&) { return key % 2 == 0; });
+    EXPECT_EQ(map.size(), 1u);
+    EXPECT_EQ(map.get(3).value(), "Three");
+
+    auto clone = MUST(map.clone());
+    EXPECT_EQ(clone.size(), 1u);
+    EXPECT_EQ(clone.get(3).value(), "Three");
+}
+
+// Benchmarks comparing the lookup performance of HashMap and SwissHashMap.
+
+static constexpr size_t benchmark_key_count = 10'000;
+static constexpr size_t benchmark_rounds = 100;
+
+template<typename Map, typename Key>
+static void run_lookup_benchmark(Vector<Key> const& keys, Vector<Key> const& missing_keys)
+{
+    Map map;
+    for (size_t i = 0; i < keys.size(); ++i)
+        map.set(keys[i], i);
+
+    size_t found = 0;
+    for (size_t round = 0; round < benchmark_rounds; ++round) {
+        for (auto const& key : keys)
+            found += map.contains(key);
+        for (auto const& key : missing_keys)
+            found += map.contains(key);
+    }
+    EXPECT_EQ(found, keys.size() * benchmark_rounds);
+}
+
+static Vector<int> integer_keys(size_t offset)
+{
+    Vector<int> keys;
+    for (size_t i = 0; i < benchmark_key_count; ++i)
+        keys.append(static_cast<int>((i + offset) * 7919));
+    return keys;
+}
+
+static Vector<void const*> pointer_keys(size_t offset)
+{
+    Vector<void const*> keys;
+    for (size_t i = 0; i < benchmark_key_count; ++i)
+        keys.append(reinterpret_cast<void const*>((i + offset) * 16));
+    return keys;
+}
+
+static Vector<FlyString> fly_string_keys(StringView prefix)
+{
+    Vector<FlyString> keys;
+    for (size_t i = 0; i < benchmark_key_count; ++i)
+        keys.append(FlyString { MUST(String::formatted("{}-{}", prefix, i)) });
+    return keys;
+}
+
+BENCHMARK_CASE(hash_map_integer_keys)
+{
+    run_lookup_benchmark<HashMap<int, size_t>>(integer_keys(0), integer_keys(benchmark_key_count));
+}
+
+BENCHMARK_CASE(swiss_hash_map_integer_keys)
+{
+    run_lookup_benchmark<SwissHashMap<int, size_t>>(integer_keys(0), integer_keys(benchmark_key_count));
+}
+
+BENCHMARK_CASE(hash_map_pointer_keys)
+{
+    run_lookup_benchmark<HashMap<void const*, size_t>>(pointer_keys(1), pointer_keys(benchmark_key_count + 1));
+}
+
+BENCHMARK_CASE(swiss_hash_map_pointer_keys)
+{
+    run_lookup_benchmark<SwissHashMap<void const*, size_t>>(pointer_keys(1), pointer_keys(benchmark_key_count + 1));
+}
+
+BENCHMARK_CASE(hash_map_fly_string_keys)
+{
+    run_lookup_benchmark<HashMap<FlyString, size_t>>(fly_string_keys("present"sv), fly_string_keys("missing"sv));
+}
+
+BENCHMARK_CASE(swiss_hash_map_fly_string_keys)
+{
+    run_lookup_benchmark<SwissHashMap<FlyString, size_t>>(fly_string_keys("present"sv), fly_string_keys("missing"sv));
+}
@@ -7,6 +7,7 @@
 #include <LibTest/TestCase.h>
 #include <fcntl.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <sys/statvfs.h>
 #include <unistd.h>
@@ -106,3 +107,54 @@ TEST_CASE(test_ext2_writes_and_reads_to_block_ranges)
     write_then_read_block(doubly_indirect_blocks_capacity);
     write_then_read_block(triply_indirect_blocks_capacity - 1);
 }
+
+TEST_CASE(test_ext2_writes_during_read_ahead_are_not_lost)
+{
+    static constexpr auto TEST_FILE_PATH = "/home/anon/.ext2_read_ahead_test";
+    static constexpr size_t chunk_size = 4 * KiB;
+    static constexpr size_t chunk_count = 1024;
+
+    auto fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT, 0644);
+    VERIFY(fd != -1);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    static u8 chunk[chunk_size];
+    memset(chunk, 'a', chunk_size);
+    for (size_t i = 0; i < chunk_count; ++i)
+        EXPECT_EQ(write(fd, chunk, chunk_size), static_cast<ssize_t>(chunk_size));
+    EXPECT_EQ(fsync(fd), 0);
+
+    // Read the file sequentially on another thread, so that read-ahead keeps reading ahead of us
+    // while we overwrite the file back to front and flush the new data.
+    pthread_t reader;
+    auto rc = pthread_create(
+        &reader, nullptr, [](void*) -> void* {
+            auto reader_fd = open(TEST_FILE_PATH, O_RDONLY);
+            VERIFY(reader_fd != -1);
+            static u8 read_chunk[chunk_size];
+            while (read(reader_fd, read_chunk, chunk_size) > 0)
+                ;
+            close(reader_fd);
+            return nullptr;
+        },
+        nullptr);
+    EXPECT_EQ(rc, 0);
+
+    memset(chunk, 'b', chunk_size);
+    for (size_t i = chunk_count; i > 0; --i) {
+        EXPECT_EQ(pwrite(fd, chunk, chunk_size, (i - 1) * chunk_size), static_cast<ssize_t>(chunk_size));
+        if (i % 16 == 0)
+            EXPECT_EQ(fsync(fd), 0);
+    }
+    EXPECT_EQ(pthread_join(reader, nullptr), 0);
+
+    // Nothing the reader pulled in ahead of time may have replaced what we wrote.
+    static u8 read_chunk[chunk_size];
+    for (size_t i = 0; i < chunk_count; ++i) {
+        EXPECT_EQ(pread(fd, read_chunk, chunk_size, i * chunk_size), static_cast<ssize_t>(chunk_size));
+        EXPECT_EQ(memcmp(read_chunk, chunk, chunk_size), 0);
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <netinet/in.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int bind_udp_socket(sockaddr_in& address)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    VERIFY(fd >= 0);
+
+    address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = 0;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int rc = bind(fd, (sockaddr*)&address, sizeof(address));
+    VERIFY(rc == 0);
+
+    socklen_t address_length = sizeof(address);
+    rc = getsockname(fd, (sockaddr*)&address, &address_length);
+    VERIFY(rc == 0);
+    return fd;
+}
+
+// Returns two mmsghdrs, laid out so that everything but the msg_len of the second one is writable.
+static mmsghdr* map_messages_with_read_only_second_length(u8*& mapping)
+{
+    auto page_size = sysconf(_SC_PAGESIZE);
+    mapping = (u8*)mmap(nullptr, 2 * page_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    VERIFY(mapping != MAP_FAILED);
+
+    auto* messages = (mmsghdr*)(mapping + page_size - sizeof(mmsghdr) - offsetof(mmsghdr, msg_len));
+    memset(messages, 0, 2 * sizeof(mmsghdr));
+    return messages;
+}
+
+static void make_second_page_read_only(u8* mapping)
+{
+    auto page_size = sysconf(_SC_PAGESIZE);
+    int rc = mprotect(mapping + page_size, page_size, PROT_READ);
+    VERIFY(rc == 0);
+}
+
+TEST_CASE(sendmmsg_counts_messages_up_to_unwritable_length)
+{
+    sockaddr_in receiver_address;
+    int receiver_fd = bind_udp_socket(receiver_address);
+    sockaddr_in sender_address;
+    int sender_fd = bind_udp_socket(sender_address);
+
+    u8* mapping = nullptr;
+    auto* messages = map_messages_with_read_only_second_length(mapping);
+    char data[2] = { 'A', 'B' };
+    iovec iovs[2];
+    for (size_t i = 0; i < 2; ++i) {
+        iovs[i] = { &data[i], 1 };
+        messages[i].msg_hdr.msg_name = &receiver_address;
+        messages[i].msg_hdr.msg_namelen = sizeof(receiver_address);
+        messages[i].msg_hdr.msg_iov = &iovs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    make_second_page_read_only(mapping);
+
+    int rc = sendmmsg(sender_fd, messages, 2, 0);
+    EXPECT_EQ(rc, 1);
+    EXPECT_EQ(messages[0].msg_len, 1u);
+
+    char received;
+    ssize_t nread = recv(receiver_fd, &received, 1, MSG_DONTWAIT);
+    EXPECT_EQ(nread, 1);
+    EXPECT_EQ(received, 'A');
+
+    munmap(mapping, 2 * sysconf(_SC_PAGESIZE));
+    close(sender_fd);
+    close(receiver_fd);
+}
+
+TEST_CASE(recvmmsg_counts_messages_up_to_unwritable_length)
+{
+    sockaddr_in receiver_address;
+    int receiver_fd = bind_udp_socket(receiver_address);
+    sockaddr_in sender_address;
+    int sender_fd = bind_udp_socket(sender_address);
+
+    for (char c : { 'A', 'B' }) {
+        ssize_t nsent = sendto(sender_fd, &c, 1, 0, (sockaddr*)&receiver_address, sizeof(receiver_address));
+        VERIFY(nsent == 1);
+    }
+
+    u8* mapping = nullptr;
+    auto* messages = map_messages_with_read_only_second_length(mapping);
+    char data[2] = {};
+    iovec iovs[2];
+    for (size_t i = 0; i < 2; ++i) {
+        iovs[i] = { &data[i], 1 };
+        messages[i].msg_hdr.msg_iov = &iovs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    make_second_page_read_only(mapping);
+
+    int rc = recvmmsg(receiver_fd, messages, 2, MSG_DONTWAIT, nullptr);
+    EXPECT_EQ(rc, 1);
+    EXPECT_EQ(messages[0].msg_len, 1u);
+    EXPECT_EQ(data[0], 'A');
+
+    munmap(mapping, 2 * sysconf(_SC_PAGESIZE));
+    close(sender_fd);
+    close(receiver_fd);
+}
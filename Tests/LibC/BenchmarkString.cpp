@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/StdLibExtras.h>
+#include <LibTest/TestCase.h>
+#include <string.h>
+
+// NOTE: This file is built with -fno-builtin, so the calls below actually end up in LibC.
+
+static constexpr size_t iterations = 100'000;
+static constexpr size_t small_size = 15;
+static constexpr size_t medium_size = 250;
+static constexpr size_t large_size = 64 * KiB;
+
+// One byte of slack, so the buffers can be offset to get them out of alignment.
+static Array<u8, large_size + 1> s_source;
+static Array<u8, large_size + 1> s_destination;
+
+// Fills the buffer with non-zero bytes that are all different from the needle, and null-terminates it.
+static u8* prepare_buffer(size_t size, size_t offset = 0)
+{
+    s_source.fill('a');
+    s_source[offset + size - 1] = 0;
+    return s_source.data() + offset;
+}
+
+template<typename Callback>
+static void run_benchmark(size_t size, Callback callback)
+{
+    // Make the amount of work roughly the same regardless of the size.
+    auto repetitions = max(iterations * small_size / size, static_cast<size_t>(16));
+    for (size_t i = 0; i < repetitions; ++i)
+        callback();
+}
+
+#define STRING_BENCHMARKS(size_name, offset)                                                        \
+    BENCHMARK_CASE(memcpy_##size_name)                                                              \
+    {                                                                                               \
+        auto* source = prepare_buffer(size_name##_size, offset);                                    \
+        run_benchmark(size_name##_size, [&] {                                                       \
+            auto* result = memcpy(s_destination.data(), source, size_name##_size);                  \
+            AK::taint_for_optimizer(result);                                                        \
+        });                                                                                         \
+    }                                                                                               \
+                                                                                                    \
+    BENCHMARK_CASE(memcmp_##size_name)                                                              \
+    {                                                                                               \
+        auto* source = prepare_buffer(size_name##_size, offset);                                    \
+        memcpy(s_destination.data(), source, size_name##_size);                                     \
+        run_benchmark(size_name##_size, [&] {                                                       \
+            auto result = memcmp(s_destination.data(), source, size_name##_size);                   \
+            AK::taint_for_optimizer(result);                                                        \
+        });                                                                                         \
+    }                                                                                               \
+                                                                                                    \
+    BENCHMARK_CASE(memchr_##size_name)                                                              \
+    {                                                                                               \
+        auto* source = prepare_buffer(size_name##_size, offset);                                    \
+        run_benchmark(size_name##_size, [&] {                                                       \
+            auto* result = memchr(source, 'b', size_name##_size);                                   \
+            AK::taint_for_optimizer(result);                                                        \
+        });                                                                                         \
+    }                                                                                               \
+                                                                                                    \
+    BENCHMARK_CASE(strlen_##size_name)                                                              \
+    {                                                                                               \
+        auto* source = prepare_buffer(size_name##_size, offset);                                    \
+        run_benchmark(size_name##_size, [&] {                                                       \
+            auto result = strlen(reinterpret_cast<char const*>(source));                            \
+            AK::taint_for_optimizer(result);                                                        \
+        });                                                                                         \
+    }                                                                                               \
+                                                                                                    \
+    BENCHMARK_CASE(strchr_##size_name)                                                              \
+    {                                                                                               \
+        auto* source = prepare_buffer(size_name##_size, offset);                                    \
+        run_benchmark(size_name##_size, [&] {                                                       \
+            auto* result = strchr(reinterpret_cast<char const*>(source), 'b');                      \
+            AK::taint_for_optimizer(result);                                                        \
+        });                                                                                         \
+    }                                                                                               \
+                                                                                                    \
+    BENCHMARK_CASE(memset_##size_name)                                                              \
+    {                                                                                               \
+        run_benchmark(size_name##_size, [&] {                                                       \
+            auto* result = memset(s_destination.data() + offset, 'b', size_name##_size);            \
+            AK::taint_for_optimizer(result);                                                        \
+        });                                                                                         \
+    }
+
+// Small strings are the common case, and they're rarely aligned.
+STRING_BENCHMARKS(small, 1)
+STRING_BENCHMARKS(medium, 1)
+STRING_BENCHMARKS(large, 0)
@@ -29,3 +29,112 @@ TEST_CASE(strtok_r_delimiters_only)
     // The string to which `saved_str` initially points to shouldn't be modified.
     EXPECT_EQ(strcmp(dummy, "a;"), 0);
 }
+
+// The optimized implementations work on whole vectors, so make sure we get every alignment and tail length right.
+static constexpr size_t max_test_length = 160;
+
+TEST_CASE(strlen_all_alignments_and_lengths)
+{
+    char buffer[max_test_length + 64];
+    for (size_t offset = 0; offset < 64; ++offset) {
+        memset(buffer, 'a', sizeof(buffer));
+        for (size_t length = 0; length < max_test_length; ++length) {
+            buffer[offset + length] = 0;
+            EXPECT_EQ(strlen(buffer + offset), length);
+            buffer[offset + length] = 'a';
+        }
+    }
+}
+
+TEST_CASE(strchr_all_alignments_and_lengths)
+{
+    char buffer[max_test_length + 64];
+    for (size_t offset = 0; offset < 64; ++offset) {
+        memset(buffer, 'a', sizeof(buffer));
+        buffer[offset + max_test_length - 1] = 0;
+        for (size_t position = 0; position < max_test_length - 1; ++position) {
+            buffer[offset + position] = 'b';
+            EXPECT_EQ(strchr(buffer + offset, 'b'), buffer + offset + position);
+            buffer[offset + position] = 'a';
+        }
+        EXPECT_EQ(strchr(buffer + offset, 'b'), nullptr);
+        EXPECT_EQ(strchr(buffer + offset, 0), buffer + offset + max_test_length - 1);
+    }
+
+    // A match past the null terminator doesn't count.
+    char const string[] = "abc\0d";
+    EXPECT_EQ(strchr(string, 'd'), nullptr);
+}
+
+TEST_CASE(memchr_all_alignments_and_lengths)
+{
+    u8 buffer[max_test_length + 64];
+    for (size_t offset = 0; offset < 64; ++offset) {
+        memset(buffer, 'a', sizeof(buffer));
+        for (size_t position = 0; position < max_test_length; ++position) {
+            buffer[offset + position] = 'b';
+            for (size_t size = 0; size < max_test_length; ++size) {
+                auto* expected = position < size ? buffer + offset + position : nullptr;
+                EXPECT_EQ(memchr(buffer + offset, 'b', size), expected);
+            }
+            buffer[offset + position] = 'a';
+        }
+    }
+}
+
+TEST_CASE(memcmp_all_alignments_and_lengths)
+{
+    u8 first[max_test_length + 64];
+    u8 second[max_test_length + 64];
+    memset(first, 'a', sizeof(first));
+    for (size_t offset = 0; offset < 64; offset += 7) {
+        memset(second, 'a', sizeof(second));
+        for (size_t size = 0; size < max_test_length; ++size) {
+            EXPECT_EQ(memcmp(first, second + offset, size), 0);
+            for (size_t position = 0; position < size; ++position) {
+                second[offset + position] = 'b';
+                EXPECT(memcmp(first, second + offset, size) < 0);
+                EXPECT(memcmp(second + offset, first, size) > 0);
+                second[offset + position] = 'a';
+            }
+        }
+    }
+}
+
+TEST_CASE(memcpy_all_alignments_and_lengths)
+{
+    u8 source[max_test_length + 64];
+    u8 destination[max_test_length + 64];
+    for (size_t i = 0; i < sizeof(source); ++i)
+        source[i] = static_cast<u8>(i * 7 + 1);
+
+    for (size_t offset = 0; offset < 64; offset += 5) {
+        for (size_t size = 0; size < max_test_length; ++size) {
+            memset(destination, 0, sizeof(destination));
+            memcpy(destination + offset, source + (size % 16), size);
+            EXPECT_EQ(memcmp(destination + offset, source + (size % 16), size), 0);
+            // Nothing outside of the destination range may be touched.
+            for (size_t i = 0; i < offset; ++i)
+                EXPECT_EQ(destination[i], 0);
+            for (size_t i = offset + size; i < sizeof(destination); ++i)
+                EXPECT_EQ(destination[i], 0);
+        }
+    }
+}
+
+TEST_CASE(memmove_overlapping_forward)
+{
+    // memmove() hands overlapping copies with dest < src to memcpy(), which has to copy front to back then.
+    u8 buffer[4096];
+    u8 expected[4096];
+    for (size_t size : { 17u, 63u, 64u, 65u, 200u, 1500u, 3000u }) {
+        for (size_t distance : { 1u, 15u, 16u, 33u, 64u }) {
+            for (size_t i = 0; i < sizeof(buffer); ++i)
+                buffer[i] = static_cast<u8>(i * 13 + 5);
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = buffer[i + distance];
+            memmove(buffer, buffer + distance, size);
+            EXPECT_EQ(memcmp(buffer, expected, size), 0);
+        }
+    }
+}
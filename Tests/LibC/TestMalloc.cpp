@@ -6,9 +6,12 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Vector.h>
 #include <errno.h>
 #include <mallocdefs.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 TEST_CASE(malloc_limits)
 {
@@ -38,3 +41,54 @@ TEST_CASE(malloc_limits)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+TEST_CASE(malloc_free_on_other_thread)
+{
+    static constexpr size_t allocation_count = 1000;
+    Vector<u8*> allocations;
+    allocations.ensure_capacity(allocation_count);
+
+    pthread_t thread;
+    auto rc = pthread_create(
+        &thread, nullptr, [](void* argument) -> void* {
+            auto& allocations = *static_cast<Vector<u8*>*>(argument);
+            for (size_t i = 0; i < allocation_count; ++i) {
+                auto size = 1 + (i * 37) % 4096;
+                auto* ptr = static_cast<u8*>(malloc(size));
+                memset(ptr, static_cast<u8>(i), size);
+                allocations.unchecked_append(ptr);
+            }
+            return nullptr;
+        },
+        &allocations);
+    EXPECT_EQ(rc, 0);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    // The thread that allocated these is gone by now, and whatever it had cached went back to the shared heap.
+    EXPECT_EQ(allocations.size(), allocation_count);
+    for (size_t i = 0; i < allocation_count; ++i) {
+        auto size = 1 + (i * 37) % 4096;
+        EXPECT_EQ(allocations[i][0], static_cast<u8>(i));
+        EXPECT_EQ(allocations[i][size - 1], static_cast<u8>(i));
+        free(allocations[i]);
+    }
+}
+
+TEST_CASE(malloc_stats)
+{
+    serenity_malloc_stats before;
+    serenity_get_malloc_stats(&before);
+
+    Vector<void*> allocations;
+    for (size_t i = 0; i < 100; ++i)
+        allocations.append(malloc(64));
+
+    serenity_malloc_stats after;
+    serenity_get_malloc_stats(&after);
+    EXPECT(after.malloc_calls >= before.malloc_calls + 100);
+    EXPECT(after.chunked_bytes_in_use >= 100 * 64);
+    EXPECT(after.chunked_blocks > 0);
+
+    for (auto* ptr : allocations)
+        free(ptr);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/System.h>
+#include <LibCore/Timer.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+
+TEST_CASE(notifier_on_regular_file)
+{
+    // Regular files can't be watched with epoll on Linux, but like with poll() they have to count as always ready.
+    Core::EventLoop event_loop;
+
+    auto fd = TRY_OR_FAIL(Core::System::open("/tmp/notifier-test.txt"sv, O_RDWR | O_CREAT | O_TRUNC, 0644));
+    TRY_OR_FAIL(Core::System::write(fd, "Well hello friends!"sv.bytes()));
+    TRY_OR_FAIL(Core::System::lseek(fd, 0, SEEK_SET));
+
+    auto notifier = Core::Notifier::construct(fd, Core::Notifier::Type::Read);
+    notifier->on_activation = [&] {
+        notifier->set_enabled(false);
+        event_loop.quit(0);
+    };
+
+    auto catchall_timer = Core::Timer::create_single_shot(1000, [&] {
+        event_loop.quit(1);
+    });
+    catchall_timer->start();
+
+    EXPECT_EQ(event_loop.exec(), 0);
+
+    TRY_OR_FAIL(Core::System::close(fd));
+    TRY_OR_FAIL(Core::System::unlink("/tmp/notifier-test.txt"sv));
+}
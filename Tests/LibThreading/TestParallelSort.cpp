@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <AK/QuickSort.h>
+#include <AK/Random.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/ParallelSort.h>
+
+static constexpr size_t element_count = 1'000'000;
+
+static Vector<int> random_integers(size_t count)
+{
+    Vector<int> values;
+    values.ensure_capacity(count);
+    for (size_t i = 0; i < count; ++i)
+        values.unchecked_append(get_random<int>());
+    return values;
+}
+
+TEST_CASE(sorts_like_sequential_sort)
+{
+    for (size_t thread_count : { 1, 2, 3, 4, 7 }) {
+        auto values = random_integers(element_count);
+        auto expected = values;
+
+        Threading::parallel_sort(values.span(), [](int a, int b) { return a < b; }, thread_count);
+        AK::sort(expected);
+
+        EXPECT_EQ(values, expected);
+    }
+}
+
+TEST_CASE(small_inputs)
+{
+    for (size_t size : { 0, 1, 2, 100 }) {
+        auto values = random_integers(size);
+        Threading::parallel_sort(values.span());
+        for (size_t i = 1; i < values.size(); ++i)
+            EXPECT(values[i - 1] <= values[i]);
+    }
+}
+
+TEST_CASE(sorts_non_trivial_values)
+{
+    Vector<ByteString> values;
+    for (size_t i = 0; i < 100'000; ++i)
+        values.append(ByteString::number(get_random<u32>()));
+
+    Threading::parallel_sort(values.span(), [](auto& a, auto& b) { return a < b; }, 4);
+
+    EXPECT_EQ(values.size(), 100'000u);
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1] <= values[i]);
+}
+
+BENCHMARK_CASE(sequential_sort)
+{
+    auto values = random_integers(element_count);
+    AK::sort(values);
+}
+
+BENCHMARK_CASE(parallel_sort)
+{
+    auto values = random_integers(element_count);
+    Threading::parallel_sort(values.span());
+}
@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/CPUFeatures.h>
+#include <AK/Types.h>
+#include <immintrin.h>
+#include <string.h>
+
+#include "tcg.h"
+
+// SSE2 is part of the x86-64 baseline, AVX2 versions are picked at load time if the CPU and kernel support them.
+//
+// NOTE: The string scanning functions below read whole aligned vectors, which may extend past the end of the
+//       string or buffer. That's fine, since an aligned load can never cross into another page.
+
+namespace {
+
+using u16_unaligned [[gnu::aligned(1), gnu::may_alias]] = u16;
+using u32_unaligned [[gnu::aligned(1), gnu::may_alias]] = u32;
+using u64_unaligned [[gnu::aligned(1), gnu::may_alias]] = u64;
+
+// Past this size, rep movsb beats anything we can do with vectors if the CPU has ERMS.
+constexpr size_t rep_movsb_threshold = 1024;
+
+// Copies up to 64 bytes with (possibly overlapping) unaligned loads and stores.
+// All loads are done before any store, which makes this safe for overlapping buffers as well.
+ALWAYS_INLINE void copy_small(u8* dest, u8 const* src, size_t n)
+{
+    if (n >= 32) {
+        auto a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+        auto b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 16));
+        auto c = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + n - 32));
+        auto d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + n - 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 16), b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + n - 32), c);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + n - 16), d);
+    } else if (n >= 16) {
+        auto a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+        auto b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + n - 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + n - 16), b);
+    } else if (n >= 8) {
+        u64 a = *reinterpret_cast<u64_unaligned const*>(src);
+        u64 b = *reinterpret_cast<u64_unaligned const*>(src + n - 8);
+        *reinterpret_cast<u64_unaligned*>(dest) = a;
+        *reinterpret_cast<u64_unaligned*>(dest + n - 8) = b;
+    } else if (n >= 4) {
+        u32 a = *reinterpret_cast<u32_unaligned const*>(src);
+        u32 b = *reinterpret_cast<u32_unaligned const*>(src + n - 4);
+        *reinterpret_cast<u32_unaligned*>(dest) = a;
+        *reinterpret_cast<u32_unaligned*>(dest + n - 4) = b;
+    } else if (n >= 2) {
+        u16 a = *reinterpret_cast<u16_unaligned const*>(src);
+        u16 b = *reinterpret_cast<u16_unaligned const*>(src + n - 2);
+        *reinterpret_cast<u16_unaligned*>(dest) = a;
+        *reinterpret_cast<u16_unaligned*>(dest + n - 2) = b;
+    } else if (n == 1) {
+        *dest = *src;
+    }
+}
+
+// memmove() relies on memcpy() copying front to back when dest < src, so the large copies have to as well.
+// The last 64 bytes are loaded up front, before the loop gets a chance to overwrite them.
+ALWAYS_INLINE void copy_large_forward(u8* dest, u8 const* src, size_t n)
+{
+    auto tail_a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + n - 64));
+    auto tail_b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + n - 48));
+    auto tail_c = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + n - 32));
+    auto tail_d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + n - 16));
+
+    for (size_t i = 0; i + 64 < n; i += 64) {
+        auto a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+        auto b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i + 16));
+        auto c = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i + 32));
+        auto d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i + 48));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 16), b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 32), c);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 48), d);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + n - 64), tail_a);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + n - 48), tail_b);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + n - 32), tail_c);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + n - 16), tail_d);
+}
+
+void* memcpy_sse2(void* dest_ptr, void const* src_ptr, size_t n)
+{
+    auto* dest = static_cast<u8*>(dest_ptr);
+    auto const* src = static_cast<u8 const*>(src_ptr);
+    if (n <= 64)
+        copy_small(dest, src, n);
+    else
+        copy_large_forward(dest, src, n);
+    return dest_ptr;
+}
+
+void* memcpy_sse2_erms(void* dest_ptr, void const* src_ptr, size_t n)
+{
+    auto* dest = static_cast<u8*>(dest_ptr);
+    auto const* src = static_cast<u8 const*>(src_ptr);
+    if (n <= 64) {
+        copy_small(dest, src, n);
+    } else if (n < rep_movsb_threshold) {
+        copy_large_forward(dest, src, n);
+    } else {
+        asm volatile(
+            "rep movsb"
+            : "+D"(dest), "+S"(src), "+c"(n)::"memory");
+    }
+    return dest_ptr;
+}
+
+size_t strlen_sse2(char const* str)
+{
+    auto zero = _mm_setzero_si128();
+    auto offset = reinterpret_cast<FlatPtr>(str) % 16;
+    auto const* chunk = reinterpret_cast<__m128i const*>(str - offset);
+
+    u32 mask = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(chunk), zero))) >> offset;
+    if (mask)
+        return count_trailing_zeroes(mask);
+
+    while (true) {
+        ++chunk;
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(chunk), zero));
+        if (mask)
+            return reinterpret_cast<char const*>(chunk) + count_trailing_zeroes(mask) - str;
+    }
+}
+
+[[gnu::target("avx2")]] size_t strlen_avx2(char const* str)
+{
+    auto zero = _mm256_setzero_si256();
+    auto offset = reinterpret_cast<FlatPtr>(str) % 32;
+    auto const* chunk = reinterpret_cast<__m256i const*>(str - offset);
+
+    u32 mask = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(chunk), zero))) >> offset;
+    if (mask)
+        return count_trailing_zeroes(mask);
+
+    while (true) {
+        ++chunk;
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(chunk), zero));
+        if (mask)
+            return reinterpret_cast<char const*>(chunk) + count_trailing_zeroes(mask) - str;
+    }
+}
+
+// Matches either the character or the null terminator, whichever comes first.
+ALWAYS_INLINE u32 character_or_null_mask_sse2(__m128i const* chunk, __m128i needle)
+{
+    auto bytes = _mm_load_si128(chunk);
+    return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, needle), _mm_cmpeq_epi8(bytes, _mm_setzero_si128())));
+}
+
+char* strchr_sse2(char const* str, int c)
+{
+    auto needle = _mm_set1_epi8(static_cast<char>(c));
+    auto offset = reinterpret_cast<FlatPtr>(str) % 16;
+    auto const* chunk = reinterpret_cast<__m128i const*>(str - offset);
+
+    char const* found;
+    if (u32 mask = character_or_null_mask_sse2(chunk, needle) >> offset) {
+        found = str + count_trailing_zeroes(mask);
+    } else {
+        while (!(mask = character_or_null_mask_sse2(++chunk, needle)))
+            ;
+        found = reinterpret_cast<char const*>(chunk) + count_trailing_zeroes(mask);
+    }
+    return *found == static_cast<char>(c) ? const_cast<char*>(found) : nullptr;
+}
+
+[[gnu::target("avx2")]] ALWAYS_INLINE u32 character_or_null_mask_avx2(__m256i const* chunk, __m256i needle)
+{
+    auto bytes = _mm256_load_si256(chunk);
+    return _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, needle), _mm256_cmpeq_epi8(bytes, _mm256_setzero_si256())));
+}
+
+[[gnu::target("avx2")]] char* strchr_avx2(char const* str, int c)
+{
+    auto needle = _mm256_set1_epi8(static_cast<char>(c));
+    auto offset = reinterpret_cast<FlatPtr>(str) % 32;
+    auto const* chunk = reinterpret_cast<__m256i const*>(str - offset);
+
+    char const* found;
+    if (u32 mask = character_or_null_mask_avx2(chunk, needle) >> offset) {
+        found = str + count_trailing_zeroes(mask);
+    } else {
+        while (!(mask = character_or_null_mask_avx2(++chunk, needle)))
+            ;
+        found = reinterpret_cast<char const*>(chunk) + count_trailing_zeroes(mask);
+    }
+    return *found == static_cast<char>(c) ? const_cast<char*>(found) : nullptr;
+}
+
+void* memchr_sse2(void const* ptr, int c, size_t size)
+{
+    if (size == 0)
+        return nullptr;
+
+    auto const* bytes = static_cast<u8 const*>(ptr);
+    auto needle = _mm_set1_epi8(static_cast<char>(c));
+    auto offset = reinterpret_cast<FlatPtr>(bytes) % 16;
+    auto const* chunk = reinterpret_cast<__m128i const*>(bytes - offset);
+
+    // The number of bytes of the buffer that we've looked at so far.
+    size_t scanned = 16 - offset;
+    u32 mask = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(chunk), needle))) >> offset;
+    if (mask) {
+        size_t index = count_trailing_zeroes(mask);
+        return index < size ? const_cast<u8*>(bytes + index) : nullptr;
+    }
+
+    while (scanned < size) {
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(++chunk), needle));
+        if (mask) {
+            size_t index = scanned + count_trailing_zeroes(mask);
+            return index < size ? const_cast<u8*>(bytes + index) : nullptr;
+        }
+        scanned += 16;
+    }
+    return nullptr;
+}
+
+[[gnu::target("avx2")]] void* memchr_avx2(void const* ptr, int c, size_t size)
+{
+    if (size == 0)
+        return nullptr;
+
+    auto const* bytes = static_cast<u8 const*>(ptr);
+    auto needle = _mm256_set1_epi8(static_cast<char>(c));
+    auto offset = reinterpret_cast<FlatPtr>(bytes) % 32;
+    auto const* chunk = reinterpret_cast<__m256i const*>(bytes - offset);
+
+    // The number of bytes of the buffer that we've looked at so far.
+    size_t scanned = 32 - offset;
+    u32 mask = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(chunk), needle))) >> offset;
+    if (mask) {
+        size_t index = count_trailing_zeroes(mask);
+        return index < size ? const_cast<u8*>(bytes + index) : nullptr;
+    }
+
+    while (scanned < size) {
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(++chunk), needle));
+        if (mask) {
+            size_t index = scanned + count_trailing_zeroes(mask);
+            return index < size ? const_cast<u8*>(bytes + index) : nullptr;
+        }
+        scanned += 32;
+    }
+    return nullptr;
+}
+
+// Unlike the functions above, memcmp() can't look past the end of its buffers, as both of them would have to
+// be aligned the same way for that to be safe. Instead, the last vector overlaps with the one before it.
+ALWAYS_INLINE int compare_byte(u8 const* s1, u8 const* s2, size_t index)
+{
+    return s1[index] < s2[index] ? -1 : 1;
+}
+
+ALWAYS_INLINE u32 difference_mask_sse2(u8 const* s1, u8 const* s2)
+{
+    auto a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s1));
+    auto b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(s2));
+    return static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) ^ 0xffff;
+}
+
+int memcmp_sse2(void const* v1, void const* v2, size_t n)
+{
+    auto const* s1 = static_cast<u8 const*>(v1);
+    auto const* s2 = static_cast<u8 const*>(v2);
+
+    if (n < 16) {
+        for (size_t i = 0; i < n; ++i) {
+            if (s1[i] != s2[i])
+                return compare_byte(s1, s2, i);
+        }
+        return 0;
+    }
+
+    for (size_t i = 0; i + 16 < n; i += 16) {
+        if (u32 mask = difference_mask_sse2(s1 + i, s2 + i))
+            return compare_byte(s1, s2, i + count_trailing_zeroes(mask));
+    }
+    if (u32 mask = difference_mask_sse2(s1 + n - 16, s2 + n - 16))
+        return compare_byte(s1, s2, n - 16 + count_trailing_zeroes(mask));
+    return 0;
+}
+
+[[gnu::target("avx2")]] ALWAYS_INLINE u32 difference_mask_avx2(u8 const* s1, u8 const* s2)
+{
+    auto a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s1));
+    auto b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s2));
+    return ~static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+}
+
+[[gnu::target("avx2")]] int memcmp_avx2(void const* v1, void const* v2, size_t n)
+{
+    auto const* s1 = static_cast<u8 const*>(v1);
+    auto const* s2 = static_cast<u8 const*>(v2);
+
+    if (n < 32)
+        return memcmp_sse2(v1, v2, n);
+
+    for (size_t i = 0; i + 32 < n; i += 32) {
+        if (u32 mask = difference_mask_avx2(s1 + i, s2 + i))
+            return compare_byte(s1, s2, i + count_trailing_zeroes(mask));
+    }
+    if (u32 mask = difference_mask_avx2(s1 + n - 32, s2 + n - 32))
+        return compare_byte(s1, s2, n - 32 + count_trailing_zeroes(mask));
+    return 0;
+}
+
+ALWAYS_INLINE bool has_avx2()
+{
+    return has_flag(AK::Detail::detect_cpu_features_uncached(), CPUFeatures::X86_AVX2);
+}
+
+}
+
+extern "C" {
+
+namespace {
+[[gnu::used]] decltype(&memcpy) resolve_memcpy()
+{
+    // Just like with memset, TCG's rep movsb is strictly slower than SSE copies.
+    if (is_running_under_tcg())
+        return memcpy_sse2;
+
+    if (has_flag(AK::Detail::detect_cpu_features_uncached(), CPUFeatures::X86_ERMS))
+        return memcpy_sse2_erms;
+
+    return memcpy_sse2;
+}
+
+[[gnu::used]] decltype(&strlen) resolve_strlen()
+{
+    return has_avx2() ? strlen_avx2 : strlen_sse2;
+}
+
+[[gnu::used]] decltype(&strchr) resolve_strchr()
+{
+    return has_avx2() ? strchr_avx2 : strchr_sse2;
+}
+
+[[gnu::used]] decltype(&memchr) resolve_memchr()
+{
+    return has_avx2() ? memchr_avx2 : memchr_sse2;
+}
+
+[[gnu::used]] decltype(&memcmp) resolve_memcmp()
+{
+    return has_avx2() ? memcmp_avx2 : memcmp_sse2;
+}
+}
+
+#if !defined(AK_COMPILER_CLANG) && !defined(_DYNAMIC_LOADER)
+[[gnu::ifunc("resolve_memcpy")]] void* memcpy(void*, void const*, size_t);
+[[gnu::ifunc("resolve_strlen")]] size_t strlen(char const*);
+[[gnu::ifunc("resolve_strchr")]] char* strchr(char const*, int);
+[[gnu::ifunc("resolve_memchr")]] void* memchr(void const*, int, size_t);
+[[gnu::ifunc("resolve_memcmp")]] int memcmp(void const*, void const*, size_t);
+#else
+// See memset.cpp for why we can't use IFUNCs here.
+void* memcpy(void* dest_ptr, void const* src_ptr, size_t n)
+{
+    static decltype(&memcpy) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_memcpy();
+
+    return s_impl(dest_ptr, src_ptr, n);
+}
+
+size_t strlen(char const* str)
+{
+    static decltype(&strlen) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_strlen();
+
+    return s_impl(str);
+}
+
+char* strchr(char const* str, int c)
+{
+    static decltype(&strchr) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_strchr();
+
+    return s_impl(str, c);
+}
+
+void* memchr(void const* ptr, int c, size_t size)
+{
+    static decltype(&memchr) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_memchr();
+
+    return s_impl(ptr, c, size);
+}
+
+int memcmp(void const* v1, void const* v2, size_t n)
+{
+    static decltype(&memcmp) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_memcmp();
+
+    return s_impl(v1, v2, n);
+}
+#endif
+}
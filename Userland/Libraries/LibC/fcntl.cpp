@@ -121,6 +121,15 @@ int posix_fallocate(int fd, off_t offset, off_t len)
     return -static_cast<int>(syscall(SC_posix_fallocate, fd, offset, len));
 }
 
+ssize_t splice(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t len, unsigned flags)
+{
+    __pthread_maybe_cancel();
+
+    Syscall::SC_splice_params params { fd_in, off_in, fd_out, off_out, len, flags };
+    int rc = syscall(SC_splice, &params);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/utimensat.html
 int utimensat(int dirfd, char const* path, struct timespec const times[2], int flag)
 {
@@ -114,9 +114,15 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_refills;
+    size_t number_of_thread_cache_flushes;
 };
 static MallocStats g_malloc_stats = {};
 
+static size_t s_big_allocation_count { 0 };
+static size_t s_big_allocation_bytes { 0 };
+
 static size_t s_hot_empty_block_count { 0 };
 static ChunkedBlock* s_hot_empty_blocks[number_of_hot_chunked_blocks_to_keep_around] { nullptr };
 static size_t s_cold_empty_block_count { 0 };
@@ -292,81 +298,13 @@ enum class CallerWillInitializeMemory {
 __thread bool s_allocation_enabled = true;
 #endif
 
-static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
+// Takes a chunk from one of the allocator's blocks, setting up another block if none of them has room left.
+// Must be called with s_malloc_mutex held.
+static ErrorOr<void*> allocate_chunk(Allocator& allocator, size_t good_size, size_t align)
 {
-#ifndef NO_TLS
-    VERIFY(s_allocation_enabled);
-#endif
-
-    // Align must be a power of 2.
-    if (popcount(align) != 1)
-        return EINVAL;
-
-    // FIXME: Support larger than 32KiB alignments (if you dare).
-    if (sizeof(BigAllocationBlock) + align >= ChunkedBlock::block_size)
-        return EINVAL;
-
-    if (s_log_malloc)
-        dbgln("LibC: malloc({})", size);
-
-    if (!size) {
-        // Legally we could just return a null pointer here, but this is more
-        // compatible with existing software.
-        size = 1;
-    }
-
-    g_malloc_stats.number_of_malloc_calls++;
-
-    size_t good_size;
-    auto* allocator = allocator_for_size(size, good_size, align);
-
-    PthreadMutexLocker locker(s_malloc_mutex);
-
-    if (!allocator) {
-        size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size + ((align > 16) ? align : 0), ChunkedBlock::block_size);
-        if (real_size < size) {
-            dbgln_if(MALLOC_DEBUG, "LibC: Detected overflow trying to do big allocation of size {} for {}", real_size, size);
-            return ENOMEM;
-        }
-#ifdef RECYCLE_BIG_ALLOCATIONS
-        if (auto* allocator = big_allocator_for_size(real_size)) {
-            if (!allocator->blocks.is_empty()) {
-                g_malloc_stats.number_of_big_allocator_hits++;
-                auto* block = allocator->blocks.take_last();
-                int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
-                bool this_block_was_purged = rc == 1;
-                if (rc < 0) {
-                    perror("madvise");
-                    VERIFY_NOT_REACHED();
-                }
-                if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
-                    perror("mprotect");
-                    VERIFY_NOT_REACHED();
-                }
-                if (this_block_was_purged) {
-                    g_malloc_stats.number_of_big_allocator_purge_hits++;
-                    new (block) BigAllocationBlock(real_size);
-                }
-
-                void* ptr = reinterpret_cast<void*>(round_up_to_power_of_two(reinterpret_cast<uintptr_t>(&block->m_slot[0]), align));
-
-                ue_notify_malloc(ptr, size);
-                return ptr;
-            }
-        }
-#endif
-        auto* block = (BigAllocationBlock*)TRY(os_alloc(real_size, "malloc: BigAllocationBlock"));
-        g_malloc_stats.number_of_big_allocs++;
-        new (block) BigAllocationBlock(real_size);
-
-        void* ptr = reinterpret_cast<void*>(round_up_to_power_of_two(reinterpret_cast<uintptr_t>(&block->m_slot[0]), align));
-        ue_notify_malloc(ptr, size);
-        return ptr;
-    }
-
     ChunkedBlock* block = nullptr;
     void* ptr = nullptr;
-    for (auto& current : allocator->usable_blocks) {
+    for (auto& current : allocator.usable_blocks) {
         if (current.free_chunks()) {
             ptr = try_allocate_chunk_aligned(align, current);
             if (ptr) {
@@ -386,7 +324,7 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
             snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
             set_mmap_name(block, ChunkedBlock::block_size, buffer);
         }
-        allocator->usable_blocks.append(*block);
+        allocator.usable_blocks.append(*block);
     }
 
     if (!block && s_cold_empty_block_count) {
@@ -409,7 +347,7 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
             new (block) ChunkedBlock(good_size);
             ue_notify_chunk_size_changed(block, good_size);
         }
-        allocator->usable_blocks.append(*block);
+        allocator.usable_blocks.append(*block);
     }
 
     if (!block) {
@@ -418,8 +356,8 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
         block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
         new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
     }
 
     if (!ptr) {
@@ -430,69 +368,19 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     if (block->is_full()) {
         g_malloc_stats.number_of_blocks_full++;
         dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
     }
     dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
-
-    if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
-
-    ue_notify_malloc(ptr, size);
     return ptr;
 }
 
-static void free_impl(void* ptr)
+// Puts a chunk back into its block, and lets go of the block if that was the last chunk in use.
+// Must be called with s_malloc_mutex held.
+static void free_chunk(ChunkedBlock* block, void* ptr)
 {
-#ifndef NO_TLS
-    VERIFY(s_allocation_enabled);
-#endif
-
-    ScopedValueRollback rollback(errno);
-
-    if (!ptr)
-        return;
-
-    g_malloc_stats.number_of_free_calls++;
-
-    void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
-    size_t magic = *(size_t*)block_base;
-
-    PthreadMutexLocker locker(s_malloc_mutex);
-
-    if (magic == MAGIC_BIGALLOC_HEADER) {
-        auto* block = (BigAllocationBlock*)block_base;
-#ifdef RECYCLE_BIG_ALLOCATIONS
-        if (auto* allocator = big_allocator_for_size(block->m_size)) {
-            if (allocator->blocks.size() < number_of_big_blocks_to_keep_around_per_size_class) {
-                g_malloc_stats.number_of_big_allocator_keeps++;
-                allocator->blocks.append(block);
-                size_t this_block_size = block->m_size;
-                if (mprotect(block, this_block_size, PROT_NONE) < 0) {
-                    perror("mprotect");
-                    VERIFY_NOT_REACHED();
-                }
-                if (madvise(block, this_block_size, MADV_SET_VOLATILE) != 0) {
-                    perror("madvise");
-                    VERIFY_NOT_REACHED();
-                }
-                return;
-            }
-        }
-#endif
-        g_malloc_stats.number_of_big_allocator_frees++;
-        os_free(block, block->m_size);
-        return;
-    }
-
-    VERIFY(magic == MAGIC_PAGE_HEADER);
-    auto* block = (ChunkedBlock*)block_base;
-
     dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
 
-    if (s_scrub_free)
-        memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
-
     auto* entry = (FreelistEntry*)ptr;
     entry->next = block->m_freelist;
     block->m_freelist = entry;
@@ -535,6 +423,298 @@ static void free_impl(void* ptr)
     }
 }
 
+#ifndef NO_TLS
+// Every thread keeps some free chunks of the smaller size classes to itself, so most calls to malloc()
+// and free() never have to take s_malloc_mutex. Chunks are taken from and given back to the shared heap
+// in batches. A chunk is put into the cache of whichever thread frees it, no matter who allocated it.
+static constexpr size_t largest_thread_cached_size = 4080;
+static constexpr size_t thread_cache_bytes_per_size_class = 16 * KiB;
+static constexpr size_t max_thread_cached_chunks_per_size_class = 64;
+
+static constexpr size_t thread_cache_capacity(size_t size_class)
+{
+    if (size_classes[size_class] > largest_thread_cached_size)
+        return 0;
+    return min(thread_cache_bytes_per_size_class / size_classes[size_class], max_thread_cached_chunks_per_size_class);
+}
+
+struct ThreadCache {
+    struct Bin {
+        FreelistEntry* chunks { nullptr };
+        size_t count { 0 };
+    };
+    Bin bins[num_size_classes];
+
+    // Counted here rather than in g_malloc_stats so threads don't fight over its cache lines,
+    // and added to it whenever we take s_malloc_mutex anyway.
+    size_t malloc_calls { 0 };
+    size_t free_calls { 0 };
+
+    bool has_exited { false };
+};
+
+static bool s_thread_caches_enabled = true;
+static __thread ThreadCache s_thread_cache;
+
+static void flush_thread_cache_statistics(ThreadCache& cache)
+{
+    g_malloc_stats.number_of_malloc_calls += exchange(cache.malloc_calls, 0);
+    g_malloc_stats.number_of_free_calls += exchange(cache.free_calls, 0);
+}
+
+ALWAYS_INLINE static Optional<size_t> thread_cached_size_class_for(size_t size)
+{
+    if (size > largest_thread_cached_size)
+        return {};
+    for (size_t i = 0;; ++i) {
+        if (size <= size_classes[i])
+            return i;
+    }
+}
+
+// Must be called with s_malloc_mutex held.
+static void flush_thread_cache_bin(ThreadCache::Bin& bin, size_t count)
+{
+    for (size_t i = 0; i < count && bin.chunks; ++i) {
+        auto* entry = bin.chunks;
+        bin.chunks = entry->next;
+        --bin.count;
+        free_chunk((ChunkedBlock*)((FlatPtr)entry & ChunkedBlock::block_mask), entry);
+    }
+    g_malloc_stats.number_of_thread_cache_flushes++;
+}
+
+static void* allocate_from_thread_cache(size_t size_class)
+{
+    auto& bin = s_thread_cache.bins[size_class];
+    if (!bin.chunks) {
+        PthreadMutexLocker locker(s_malloc_mutex);
+        flush_thread_cache_statistics(s_thread_cache);
+        g_malloc_stats.number_of_thread_cache_refills++;
+        // Only fill it halfway, so a few frees in a row don't have us flushing right away.
+        for (size_t i = 0; i < thread_cache_capacity(size_class) / 2; ++i) {
+            auto ptr_or_error = allocate_chunk(allocators()[size_class], size_classes[size_class], 16);
+            if (ptr_or_error.is_error())
+                break;
+            auto* entry = (FreelistEntry*)ptr_or_error.value();
+            entry->next = bin.chunks;
+            bin.chunks = entry;
+            ++bin.count;
+        }
+        if (!bin.chunks)
+            return nullptr;
+    }
+
+    auto* entry = bin.chunks;
+    bin.chunks = entry->next;
+    --bin.count;
+    return entry;
+}
+
+static void free_to_thread_cache(size_t size_class, void* ptr)
+{
+    auto& bin = s_thread_cache.bins[size_class];
+    auto capacity = thread_cache_capacity(size_class);
+    if (bin.count == capacity) {
+        PthreadMutexLocker locker(s_malloc_mutex);
+        flush_thread_cache_statistics(s_thread_cache);
+        flush_thread_cache_bin(bin, capacity / 2);
+    }
+
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = bin.chunks;
+    bin.chunks = entry;
+    ++bin.count;
+}
+
+ALWAYS_INLINE static bool can_use_thread_cache()
+{
+    return s_thread_caches_enabled && !s_thread_cache.has_exited;
+}
+#endif
+
+ALWAYS_INLINE static void count_malloc_call()
+{
+#ifndef NO_TLS
+    ++s_thread_cache.malloc_calls;
+#else
+    g_malloc_stats.number_of_malloc_calls++;
+#endif
+}
+
+ALWAYS_INLINE static void count_free_call()
+{
+#ifndef NO_TLS
+    ++s_thread_cache.free_calls;
+#else
+    g_malloc_stats.number_of_free_calls++;
+#endif
+}
+
+static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+#ifndef NO_TLS
+    VERIFY(s_allocation_enabled);
+#endif
+
+    // Align must be a power of 2.
+    if (popcount(align) != 1)
+        return EINVAL;
+
+    // FIXME: Support larger than 32KiB alignments (if you dare).
+    if (sizeof(BigAllocationBlock) + align >= ChunkedBlock::block_size)
+        return EINVAL;
+
+    if (s_log_malloc)
+        dbgln("LibC: malloc({})", size);
+
+    if (!size) {
+        // Legally we could just return a null pointer here, but this is more
+        // compatible with existing software.
+        size = 1;
+    }
+
+    count_malloc_call();
+
+#ifndef NO_TLS
+    // Every chunk is 16-byte aligned, so anything that doesn't need more than that can come from the thread cache.
+    if (align <= 16 && can_use_thread_cache()) {
+        if (auto size_class = thread_cached_size_class_for(size); size_class.has_value()) {
+            if (auto* ptr = allocate_from_thread_cache(*size_class)) {
+                if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+                    memset(ptr, MALLOC_SCRUB_BYTE, size_classes[*size_class]);
+                ue_notify_malloc(ptr, size);
+                return ptr;
+            }
+        }
+    }
+#endif
+
+    size_t good_size;
+    auto* allocator = allocator_for_size(size, good_size, align);
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+
+    if (!allocator) {
+        size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size + ((align > 16) ? align : 0), ChunkedBlock::block_size);
+        if (real_size < size) {
+            dbgln_if(MALLOC_DEBUG, "LibC: Detected overflow trying to do big allocation of size {} for {}", real_size, size);
+            return ENOMEM;
+        }
+#ifdef RECYCLE_BIG_ALLOCATIONS
+        if (auto* allocator = big_allocator_for_size(real_size)) {
+            if (!allocator->blocks.is_empty()) {
+                g_malloc_stats.number_of_big_allocator_hits++;
+                auto* block = allocator->blocks.take_last();
+                int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
+                bool this_block_was_purged = rc == 1;
+                if (rc < 0) {
+                    perror("madvise");
+                    VERIFY_NOT_REACHED();
+                }
+                if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
+                    perror("mprotect");
+                    VERIFY_NOT_REACHED();
+                }
+                if (this_block_was_purged) {
+                    g_malloc_stats.number_of_big_allocator_purge_hits++;
+                    new (block) BigAllocationBlock(real_size);
+                }
+
+                ++s_big_allocation_count;
+                s_big_allocation_bytes += real_size;
+
+                void* ptr = reinterpret_cast<void*>(round_up_to_power_of_two(reinterpret_cast<uintptr_t>(&block->m_slot[0]), align));
+
+                ue_notify_malloc(ptr, size);
+                return ptr;
+            }
+        }
+#endif
+        auto* block = (BigAllocationBlock*)TRY(os_alloc(real_size, "malloc: BigAllocationBlock"));
+        g_malloc_stats.number_of_big_allocs++;
+        new (block) BigAllocationBlock(real_size);
+
+        ++s_big_allocation_count;
+        s_big_allocation_bytes += real_size;
+
+        void* ptr = reinterpret_cast<void*>(round_up_to_power_of_two(reinterpret_cast<uintptr_t>(&block->m_slot[0]), align));
+        ue_notify_malloc(ptr, size);
+        return ptr;
+    }
+
+    auto* ptr = TRY(allocate_chunk(*allocator, good_size, align));
+
+    if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+
+    ue_notify_malloc(ptr, size);
+    return ptr;
+}
+
+static void free_impl(void* ptr)
+{
+#ifndef NO_TLS
+    VERIFY(s_allocation_enabled);
+#endif
+
+    ScopedValueRollback rollback(errno);
+
+    if (!ptr)
+        return;
+
+    count_free_call();
+
+    void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
+    size_t magic = *(size_t*)block_base;
+
+    if (magic == MAGIC_PAGE_HEADER) {
+        auto* block = (ChunkedBlock*)block_base;
+        if (s_scrub_free)
+            memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
+
+#ifndef NO_TLS
+        if (can_use_thread_cache()) {
+            if (auto size_class = thread_cached_size_class_for(block->m_size); size_class.has_value()) {
+                free_to_thread_cache(*size_class, ptr);
+                return;
+            }
+        }
+#endif
+
+        PthreadMutexLocker locker(s_malloc_mutex);
+        free_chunk(block, ptr);
+        return;
+    }
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+
+    VERIFY(magic == MAGIC_BIGALLOC_HEADER);
+    auto* block = (BigAllocationBlock*)block_base;
+    --s_big_allocation_count;
+    s_big_allocation_bytes -= block->m_size;
+#ifdef RECYCLE_BIG_ALLOCATIONS
+    if (auto* allocator = big_allocator_for_size(block->m_size)) {
+        if (allocator->blocks.size() < number_of_big_blocks_to_keep_around_per_size_class) {
+            g_malloc_stats.number_of_big_allocator_keeps++;
+            allocator->blocks.append(block);
+            size_t this_block_size = block->m_size;
+            if (mprotect(block, this_block_size, PROT_NONE) < 0) {
+                perror("mprotect");
+                VERIFY_NOT_REACHED();
+            }
+            if (madvise(block, this_block_size, MADV_SET_VOLATILE) != 0) {
+                perror("madvise");
+                VERIFY_NOT_REACHED();
+            }
+            return;
+        }
+    }
+#endif
+    g_malloc_stats.number_of_big_allocator_frees++;
+    os_free(block, block->m_size);
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html
 void* malloc(size_t size)
 {
@@ -673,6 +853,12 @@ void __malloc_init()
     if (secure_getenv("LIBC_PROFILE_MALLOC"))
         s_profiling = true;
 
+#ifndef NO_TLS
+    // UserspaceEmulator keeps track of every chunk itself, so don't get in its way by holding on to any.
+    if (s_in_userspace_emulator || secure_getenv("LIBC_NO_MALLOC_THREAD_CACHE"))
+        s_thread_caches_enabled = false;
+#endif
+
     for (size_t i = 0; i < num_size_classes; ++i) {
         new (&allocators()[i]) Allocator();
         allocators()[i].size = size_classes[i];
@@ -681,8 +867,61 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void __malloc_thread_exit()
+{
+#ifndef NO_TLS
+    if (!s_thread_caches_enabled || s_thread_cache.has_exited)
+        return;
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+    flush_thread_cache_statistics(s_thread_cache);
+    for (auto& bin : s_thread_cache.bins) {
+        if (bin.count)
+            flush_thread_cache_bin(bin, bin.count);
+    }
+    // Whatever this thread frees from here on goes straight back to the shared heap.
+    s_thread_cache.has_exited = true;
+#endif
+}
+
+void serenity_get_malloc_stats(struct serenity_malloc_stats* stats)
+{
+    PthreadMutexLocker locker(s_malloc_mutex);
+#ifndef NO_TLS
+    flush_thread_cache_statistics(s_thread_cache);
+#endif
+
+    *stats = {};
+    stats->malloc_calls = g_malloc_stats.number_of_malloc_calls;
+    stats->free_calls = g_malloc_stats.number_of_free_calls;
+    stats->thread_cache_refills = g_malloc_stats.number_of_thread_cache_refills;
+    stats->thread_cache_flushes = g_malloc_stats.number_of_thread_cache_flushes;
+
+    auto add_block = [&](ChunkedBlock const& block) {
+        ++stats->chunked_blocks;
+        stats->chunked_bytes_in_use += block.used_chunks() * block.bytes_per_chunk();
+    };
+    for (auto& allocator : allocators()) {
+        for (auto& block : allocator.usable_blocks)
+            add_block(block);
+        for (auto& block : allocator.full_blocks)
+            add_block(block);
+    }
+    stats->empty_chunked_blocks = s_hot_empty_block_count + s_cold_empty_block_count;
+
+    stats->big_allocations = s_big_allocation_count;
+    stats->big_allocation_bytes = s_big_allocation_bytes;
+}
+
 void serenity_dump_malloc_stats()
 {
+#ifndef NO_TLS
+    {
+        PthreadMutexLocker locker(s_malloc_mutex);
+        flush_thread_cache_statistics(s_thread_cache);
+    }
+#endif
+
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
     dbgln();
     dbgln("big alloc hits: {}", g_malloc_stats.number_of_big_allocator_hits);
@@ -704,5 +943,8 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    dbgln("thread cache refills: {}", g_malloc_stats.number_of_thread_cache_refills);
+    dbgln("thread cache flushes: {}", g_malloc_stats.number_of_thread_cache_flushes);
 }
 }
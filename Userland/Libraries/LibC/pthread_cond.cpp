@@ -155,6 +155,14 @@ int pthread_cond_broadcast(pthread_cond_t* cond)
     pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
     VERIFY(mutex);
 
+    // Waiters requeued onto a priority-inheriting mutex would sleep without the kernel knowing
+    // who they are waiting for, so wake them all up and let them queue up on the mutex themselves.
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        int rc = futex_wake(&cond->value, INT_MAX, false);
+        VERIFY(rc >= 0);
+        return 0;
+    }
+
     int rc = futex(&cond->value, FUTEX_REQUEUE | FUTEX_PRIVATE_FLAG, -1, nullptr, &mutex->lock, INT_MAX);
     VERIFY(rc >= 0);
     return 0;
@@ -6,6 +6,7 @@
 
 #include <AK/Atomic.h>
 #include <AK/NeverDestroyed.h>
+#include <AK/Platform.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <bits/pthread_integration.h>
@@ -97,6 +98,62 @@ static constexpr u32 MUTEX_UNLOCKED = 0;
 static constexpr u32 MUTEX_LOCKED_NO_NEED_TO_WAKE = 1;
 static constexpr u32 MUTEX_LOCKED_NEED_TO_WAKE = 2;
 
+// How often to look at a contended mutex before going to sleep. Most critical sections are
+// short enough that the holder lets go well before a trip through the kernel would be over.
+static constexpr size_t MUTEX_SPIN_COUNT = 100;
+
+static ALWAYS_INLINE void relax_while_spinning()
+{
+#if ARCH(X86_64)
+    asm volatile("pause");
+#elif ARCH(AARCH64)
+    asm volatile("yield");
+#endif
+}
+
+// Locks a priority-inheriting mutex. Its lock word is the TID of the owner, which lets the
+// kernel find the owner and lend it our priority while we wait for it.
+static int lock_priority_inheriting_mutex(pthread_mutex_t* mutex, bool try_only)
+{
+    u32 const tid = pthread_self();
+    u32 expected = MUTEX_UNLOCKED;
+    if (AK::atomic_compare_exchange_strong(&mutex->lock, expected, tid, AK::memory_order_acquire)) [[likely]]
+        return 0;
+
+    while (futex(&mutex->lock, (try_only ? FUTEX_TRYLOCK_PI : FUTEX_LOCK_PI) | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0) < 0) {
+        if (errno == EINTR)
+            continue;
+        return errno == EAGAIN ? EBUSY : errno;
+    }
+    return 0;
+}
+
+static void unlock_priority_inheriting_mutex(pthread_mutex_t* mutex)
+{
+    u32 expected = pthread_self();
+    if (AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_UNLOCKED, AK::memory_order_release)) [[likely]]
+        return;
+
+    // There are waiters, the kernel has to pick the next owner.
+    int rc = futex(&mutex->lock, FUTEX_UNLOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0);
+    VERIFY(rc >= 0);
+}
+
+static void did_lock_mutex(pthread_mutex_t* mutex)
+{
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
+        AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
+    mutex->level = 0;
+}
+
+static bool is_locked_by_current_thread(pthread_mutex_t* mutex)
+{
+    if (mutex->type != __PTHREAD_MUTEX_RECURSIVE)
+        return false;
+    pthread_t owner = AK::atomic_load(&mutex->owner, AK::memory_order_relaxed);
+    return owner == pthread_self();
+}
+
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_init.html
 int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attributes)
 {
@@ -104,47 +161,71 @@ int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attrib
     mutex->owner = 0;
     mutex->level = 0;
     mutex->type = attributes ? attributes->type : __PTHREAD_MUTEX_NORMAL;
+    mutex->protocol = attributes ? attributes->protocol : __PTHREAD_PRIO_NONE;
     return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_trylock.html
 int pthread_mutex_trylock(pthread_mutex_t* mutex)
 {
+    if (is_locked_by_current_thread(mutex)) {
+        // We already own the mutex!
+        mutex->level++;
+        return 0;
+    }
+
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        if (int rc = lock_priority_inheriting_mutex(mutex, true); rc != 0)
+            return rc;
+        did_lock_mutex(mutex);
+        return 0;
+    }
+
     u32 expected = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
+    if (!exchanged)
+        return EBUSY;
 
-    if (exchanged) [[likely]] {
-        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
-            AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
-        mutex->level = 0;
-        return 0;
-    } else if (mutex->type == __PTHREAD_MUTEX_RECURSIVE) {
-        pthread_t owner = AK::atomic_load(&mutex->owner, AK::memory_order_relaxed);
-        if (owner == pthread_self()) {
+    did_lock_mutex(mutex);
+    return 0;
+}
+
+// https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_lock.html
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        if (is_locked_by_current_thread(mutex)) {
             // We already own the mutex!
             mutex->level++;
             return 0;
         }
+        if (int rc = lock_priority_inheriting_mutex(mutex, false); rc != 0)
+            return rc;
+        did_lock_mutex(mutex);
+        return 0;
     }
-    return EBUSY;
-}
 
-// https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_lock.html
-int pthread_mutex_lock(pthread_mutex_t* mutex)
-{
     // Fast path: attempt to claim the mutex without waiting.
     u32 value = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
     if (exchanged) [[likely]] {
-        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
-            AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
-        mutex->level = 0;
+        did_lock_mutex(mutex);
         return 0;
-    } else if (mutex->type == __PTHREAD_MUTEX_RECURSIVE) {
-        pthread_t owner = AK::atomic_load(&mutex->owner, AK::memory_order_relaxed);
-        if (owner == pthread_self()) {
-            // We already own the mutex!
-            mutex->level++;
+    } else if (is_locked_by_current_thread(mutex)) {
+        // We already own the mutex!
+        mutex->level++;
+        return 0;
+    }
+
+    // Spin for a bit, unless someone else already went to sleep waiting for it, in which case
+    // the holder has been at it for a while.
+    for (size_t i = 0; i < MUTEX_SPIN_COUNT && value == MUTEX_LOCKED_NO_NEED_TO_WAKE; ++i) {
+        relax_while_spinning();
+        value = AK::atomic_load(&mutex->lock, AK::memory_order_relaxed);
+        if (value != MUTEX_UNLOCKED)
+            continue;
+        if (AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire)) {
+            did_lock_mutex(mutex);
             return 0;
         }
     }
@@ -159,14 +240,20 @@ int pthread_mutex_lock(pthread_mutex_t* mutex)
         value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
     }
 
-    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
-        AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
-    mutex->level = 0;
+    did_lock_mutex(mutex);
     return 0;
 }
 
 int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
 {
+    // Priority-inheriting mutexes keep track of their waiters in the kernel, so there's nothing to be pessimistic about.
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        if (int rc = lock_priority_inheriting_mutex(mutex, false); rc != 0)
+            return rc;
+        did_lock_mutex(mutex);
+        return 0;
+    }
+
     // Same as pthread_mutex_lock(), but always set MUTEX_LOCKED_NEED_TO_WAKE,
     // and also don't bother checking for already owning the mutex recursively,
     // because we know we don't. Used in the condition variable implementation.
@@ -176,9 +263,7 @@ int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
         value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
     }
 
-    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
-        AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
-    mutex->level = 0;
+    did_lock_mutex(mutex);
     return 0;
 }
 
@@ -193,6 +278,11 @@ int pthread_mutex_unlock(pthread_mutex_t* mutex)
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
         AK::atomic_store(&mutex->owner, 0, AK::memory_order_relaxed);
 
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        unlock_priority_inheriting_mutex(mutex);
+        return 0;
+    }
+
     u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_UNLOCKED, AK::memory_order_release);
     if (value == MUTEX_LOCKED_NEED_TO_WAKE) [[unlikely]] {
         int rc = futex_wake(&mutex->lock, 1, false);
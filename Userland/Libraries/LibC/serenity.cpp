@@ -174,4 +174,22 @@ int serenity_open(char const* path, size_t path_length, int options, ...)
 
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
+
+int io_ring_setup(uint32_t entries, struct IORingParameters* parameters)
+{
+    int rc = syscall(SC_io_ring_setup, entries, parameters);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int io_ring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags)
+{
+    int rc = syscall(SC_io_ring_enter, fd, to_submit, min_complete, flags);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int watch_memory_pressure(unsigned flags)
+{
+    int rc = syscall(SC_watch_memory_pressure, flags);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
 }
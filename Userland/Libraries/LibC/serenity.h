@@ -72,4 +72,10 @@ int emuctl(uintptr_t command, uintptr_t arg0, uintptr_t arg1);
 
 int serenity_open(char const* path, size_t path_length, int options, ...);
 
+struct IORingParameters;
+int io_ring_setup(uint32_t entries, struct IORingParameters* parameters);
+int io_ring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags);
+
+int watch_memory_pressure(unsigned flags);
+
 __END_DECLS
@@ -29,6 +29,24 @@ __attribute__((malloc)) __attribute__((alloc_size(1, 2))) void* calloc(size_t nm
 size_t malloc_size(void const*);
 size_t malloc_good_size(size_t);
 void serenity_dump_malloc_stats(void);
+
+struct serenity_malloc_stats {
+    size_t malloc_calls;
+    size_t free_calls;
+    // How often threads had to go to the shared heap for more chunks, or to give some back.
+    size_t thread_cache_refills;
+    size_t thread_cache_flushes;
+    // Blocks that small allocations are carved out of, and how much of them is handed out.
+    // Chunks held in the caches of threads count as handed out.
+    size_t chunked_blocks;
+    size_t chunked_bytes_in_use;
+    // Blocks that are kept around for reuse after everything in them was freed.
+    size_t empty_chunked_blocks;
+    size_t big_allocations;
+    size_t big_allocation_bytes;
+};
+void serenity_get_malloc_stats(struct serenity_malloc_stats*);
+
 void free(void*);
 __attribute__((alloc_size(2))) void* realloc(void* ptr, size_t);
 char* getenv(char const* name);
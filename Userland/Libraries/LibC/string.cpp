@@ -50,6 +50,8 @@ size_t strcspn(char const* s, char const* reject)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strlen.html
+// For x86-64, optimized implementations are found in ./arch/x86_64/string.cpp
+#if !ARCH(X86_64)
 size_t strlen(char const* str)
 {
     size_t len = 0;
@@ -57,6 +59,7 @@ size_t strlen(char const* str)
         ++len;
     return len;
 }
+#endif
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strnlen.html
 size_t strnlen(char const* str, size_t maxlen)
@@ -115,6 +118,8 @@ int strncmp(char const* s1, char const* s2, size_t n)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memcmp.html
+// For x86-64, optimized implementations are found in ./arch/x86_64/string.cpp
+#if !ARCH(X86_64)
 int memcmp(void const* v1, void const* v2, size_t n)
 {
     auto* s1 = (uint8_t const*)v1;
@@ -125,6 +130,7 @@ int memcmp(void const* v1, void const* v2, size_t n)
     }
     return 0;
 }
+#endif
 
 // Not in POSIX, originated in BSD
 // https://man.openbsd.org/timingsafe_memcmp.3
@@ -134,22 +140,17 @@ int timingsafe_memcmp(void const* b1, void const* b2, size_t len)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memcpy.html
+// For x86-64, optimized implementations are found in ./arch/x86_64/string.cpp
+#if !ARCH(X86_64)
 void* memcpy(void* dest_ptr, void const* src_ptr, size_t n)
 {
-#if ARCH(X86_64)
-    void* original_dest = dest_ptr;
-    asm volatile(
-        "rep movsb"
-        : "+D"(dest_ptr), "+S"(src_ptr), "+c"(n)::"memory");
-    return original_dest;
-#else
     u8* pd = (u8*)dest_ptr;
     u8 const* ps = (u8 const*)src_ptr;
     for (; n--;)
         *pd++ = *ps++;
     return dest_ptr;
-#endif
 }
+#endif
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memccpy.html
 void* memccpy(void* dest_ptr, void const* src_ptr, int c, size_t n)
@@ -246,6 +247,8 @@ size_t strlcpy(char* dest, char const* src, size_t n)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strchr.html
+// For x86-64, optimized implementations are found in ./arch/x86_64/string.cpp
+#if !ARCH(X86_64)
 char* strchr(char const* str, int c)
 {
     char ch = c;
@@ -256,6 +259,7 @@ char* strchr(char const* str, int c)
             return nullptr;
     }
 }
+#endif
 
 // https://pubs.opengroup.org/onlinepubs/9699959399/functions/index.html
 char* index(char const* str, int c)
@@ -274,6 +278,8 @@ char* strchrnul(char const* str, int c)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memchr.html
+// For x86-64, optimized implementations are found in ./arch/x86_64/string.cpp
+#if !ARCH(X86_64)
 void* memchr(void const* ptr, int c, size_t size)
 {
     char ch = c;
@@ -284,6 +290,7 @@ void* memchr(void const* ptr, int c, size_t size)
     }
     return nullptr;
 }
+#endif
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strrchr.html
 char* strrchr(char const* str, int ch)
@@ -24,6 +24,14 @@ ssize_t readv(int fd, const struct iovec* iov, int iov_count)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+ssize_t preadv(int fd, struct iovec const* iov, int iov_count, off_t offset)
+{
+    __pthread_maybe_cancel();
+
+    int rc = syscall(SC_preadv, fd, iov, iov_count, offset);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 ssize_t pwritev(int fd, struct iovec const* iov, int iov_count, off_t offset)
 {
     __pthread_maybe_cancel();
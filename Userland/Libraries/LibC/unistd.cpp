@@ -108,6 +108,8 @@ pid_t fork()
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/vfork.html
 pid_t vfork()
 {
+    // NOTE: There is no way to share an address space between processes, so this is a plain fork()
+    //       and the child gets its own copy-on-write copy of the parent's memory.
     return fork();
 }
 
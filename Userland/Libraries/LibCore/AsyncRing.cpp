@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibCore/AsyncRing.h>
+#include <LibCore/System.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Core {
+
+ErrorOr<NonnullOwnPtr<AsyncRing>> AsyncRing::create(u32 entries)
+{
+    IORingParameters parameters {};
+    auto fd = TRY(System::io_ring_setup(entries, parameters));
+    auto mapping_or_error = System::mmap(nullptr, parameters.mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "AsyncRing"sv);
+    if (mapping_or_error.is_error()) {
+        (void)System::close(fd);
+        return mapping_or_error.release_error();
+    }
+    return adopt_nonnull_own_or_enomem(new (nothrow) AsyncRing(fd, parameters, static_cast<u8*>(mapping_or_error.value())));
+}
+
+AsyncRing::AsyncRing(int fd, IORingParameters const& parameters, u8* mapping)
+    : m_fd(fd)
+    , m_parameters(parameters)
+    , m_mapping(mapping)
+    , m_control(reinterpret_cast<IORingControl*>(mapping))
+    , m_submissions(reinterpret_cast<IORingSubmission*>(mapping + parameters.submission_queue_offset))
+    , m_completions(reinterpret_cast<IORingCompletion const*>(mapping + parameters.completion_queue_offset))
+    , m_submission_tail(m_control->submission_tail)
+{
+}
+
+AsyncRing::~AsyncRing()
+{
+    (void)System::munmap(m_mapping, m_parameters.mapping_size);
+    (void)System::close(m_fd);
+}
+
+ErrorOr<void> AsyncRing::queue(IORingSubmission const& submission)
+{
+    auto head = AK::atomic_load(&m_control->submission_head, AK::memory_order_acquire);
+    if (m_submission_tail - head >= m_parameters.submission_entries)
+        return Error::from_errno(EBUSY);
+    m_submissions[m_submission_tail & (m_parameters.submission_entries - 1)] = submission;
+    ++m_submission_tail;
+    ++m_unsubmitted_count;
+    return {};
+}
+
+ErrorOr<void> AsyncRing::queue_read(int fd, Bytes buffer, Optional<u64> offset, u64 user_data)
+{
+    return queue({
+        .operation = IORingOperation::Read,
+        .fd = fd,
+        .offset = offset.value_or(IORING_CURRENT_OFFSET),
+        .address = reinterpret_cast<FlatPtr>(buffer.data()),
+        .length = static_cast<u32>(buffer.size()),
+        .user_data = user_data,
+    });
+}
+
+ErrorOr<void> AsyncRing::queue_write(int fd, ReadonlyBytes buffer, Optional<u64> offset, u64 user_data)
+{
+    return queue({
+        .operation = IORingOperation::Write,
+        .fd = fd,
+        .offset = offset.value_or(IORING_CURRENT_OFFSET),
+        .address = reinterpret_cast<FlatPtr>(buffer.data()),
+        .length = static_cast<u32>(buffer.size()),
+        .user_data = user_data,
+    });
+}
+
+ErrorOr<void> AsyncRing::queue_accept(int fd, int flags, u64 user_data)
+{
+    return queue({
+        .operation = IORingOperation::Accept,
+        .fd = fd,
+        .operation_flags = static_cast<u32>(flags),
+        .user_data = user_data,
+    });
+}
+
+ErrorOr<void> AsyncRing::queue_recv(int fd, Bytes buffer, int flags, u64 user_data)
+{
+    return queue({
+        .operation = IORingOperation::Recv,
+        .fd = fd,
+        .address = reinterpret_cast<FlatPtr>(buffer.data()),
+        .length = static_cast<u32>(buffer.size()),
+        .operation_flags = static_cast<u32>(flags),
+        .user_data = user_data,
+    });
+}
+
+ErrorOr<void> AsyncRing::queue_send(int fd, ReadonlyBytes buffer, int flags, u64 user_data)
+{
+    return queue({
+        .operation = IORingOperation::Send,
+        .fd = fd,
+        .address = reinterpret_cast<FlatPtr>(buffer.data()),
+        .length = static_cast<u32>(buffer.size()),
+        .operation_flags = static_cast<u32>(flags),
+        .user_data = user_data,
+    });
+}
+
+ErrorOr<void> AsyncRing::queue_fsync(int fd, u64 user_data)
+{
+    return queue({
+        .operation = IORingOperation::Fsync,
+        .fd = fd,
+        .user_data = user_data,
+    });
+}
+
+ErrorOr<void> AsyncRing::queue_open(StringView path, int options, mode_t mode, u64 user_data, int dirfd)
+{
+    return queue({
+        .operation = IORingOperation::Open,
+        .fd = dirfd,
+        .address = reinterpret_cast<FlatPtr>(path.characters_without_null_termination()),
+        .length = static_cast<u32>(path.length()),
+        .operation_flags = static_cast<u32>(options),
+        .mode = mode,
+        .user_data = user_data,
+    });
+}
+
+ErrorOr<void> AsyncRing::queue_nop(u64 user_data)
+{
+    return queue({
+        .operation = IORingOperation::Nop,
+        .user_data = user_data,
+    });
+}
+
+ErrorOr<u32> AsyncRing::submit()
+{
+    if (m_unsubmitted_count == 0)
+        return 0;
+    AK::atomic_store(&m_control->submission_tail, m_submission_tail, AK::memory_order_release);
+    auto submitted = TRY(System::io_ring_enter(m_fd, m_unsubmitted_count, 0, 0));
+    m_unsubmitted_count -= submitted;
+    return submitted;
+}
+
+ErrorOr<void> AsyncRing::wait_for_completions(u32 count)
+{
+    AK::atomic_store(&m_control->submission_tail, m_submission_tail, AK::memory_order_release);
+    auto submitted = TRY(System::io_ring_enter(m_fd, m_unsubmitted_count, count, IORING_ENTER_GETEVENTS));
+    m_unsubmitted_count -= submitted;
+    return {};
+}
+
+Optional<IORingCompletion> AsyncRing::take_completion()
+{
+    auto head = m_control->completion_head;
+    if (head == AK::atomic_load(&m_control->completion_tail, AK::memory_order_acquire))
+        return {};
+    auto completion = m_completions[head & (m_parameters.completion_entries - 1)];
+    AK::atomic_store(&m_control->completion_head, head + 1, AK::memory_order_release);
+    return completion;
+}
+
+}
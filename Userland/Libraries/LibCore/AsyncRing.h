@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/StringView.h>
+#include <Kernel/API/IORing.h>
+#include <fcntl.h>
+
+namespace Core {
+
+// A submission/completion ring for asynchronous I/O, see io_ring_setup(2).
+//
+// Operations are queued up locally, handed to the kernel in batches by submit(), and finish in any order.
+// Each completion carries the user_data of the operation it belongs to. Buffers must stay alive and
+// untouched until the operation's completion has been seen, except for paths given to queue_open(),
+// which are only needed until the next submit().
+class AsyncRing {
+    AK_MAKE_NONCOPYABLE(AsyncRing);
+    AK_MAKE_NONMOVABLE(AsyncRing);
+
+public:
+    static ErrorOr<NonnullOwnPtr<AsyncRing>> create(u32 entries = 64);
+    ~AsyncRing();
+
+    int fd() const { return m_fd; }
+
+    // These fail with EBUSY when the submission queue is full; submit() to make room.
+    ErrorOr<void> queue_read(int fd, Bytes, Optional<u64> offset, u64 user_data);
+    ErrorOr<void> queue_write(int fd, ReadonlyBytes, Optional<u64> offset, u64 user_data);
+    ErrorOr<void> queue_accept(int fd, int flags, u64 user_data);
+    ErrorOr<void> queue_recv(int fd, Bytes, int flags, u64 user_data);
+    ErrorOr<void> queue_send(int fd, ReadonlyBytes, int flags, u64 user_data);
+    ErrorOr<void> queue_fsync(int fd, u64 user_data);
+    ErrorOr<void> queue_open(StringView path, int options, mode_t mode, u64 user_data, int dirfd = AT_FDCWD);
+    ErrorOr<void> queue_nop(u64 user_data);
+
+    u32 unsubmitted_count() const { return m_unsubmitted_count; }
+
+    // Hands everything queued so far to the kernel. Returns how many operations were submitted.
+    ErrorOr<u32> submit();
+
+    // Submits everything queued so far and waits until at least `count` completions are available.
+    ErrorOr<void> wait_for_completions(u32 count);
+
+    // Takes the oldest available completion, if any.
+    Optional<IORingCompletion> take_completion();
+
+private:
+    AsyncRing(int fd, IORingParameters const&, u8* mapping);
+
+    ErrorOr<void> queue(IORingSubmission const&);
+
+    int m_fd { -1 };
+    IORingParameters m_parameters;
+    u8* m_mapping { nullptr };
+    IORingControl* m_control { nullptr };
+    IORingSubmission* m_submissions { nullptr };
+    IORingCompletion const* m_completions { nullptr };
+
+    u32 m_submission_tail { 0 };
+    u32 m_unsubmitted_count { 0 };
+};
+
+}
@@ -20,6 +20,12 @@
 #include <sys/select.h>
 #include <unistd.h>
 
+// Where we have a persistent readiness queue, we keep notifiers registered with the kernel instead of
+// handing it the whole list of watched fds on every iteration, so idle notifiers cost nothing per wakeup.
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    define EVENT_LOOP_USES_EPOLL
+#endif
+
 namespace Core {
 
 namespace {
@@ -33,6 +39,17 @@ static pthread_rwlock_t* s_thread_data_lock = nullptr;
 thread_local pthread_t s_thread_id;
 thread_local OwnPtr<ThreadData> s_this_thread_data;
 
+#ifdef EVENT_LOOP_USES_EPOLL
+u32 notification_type_to_epoll_events(NotificationType type)
+{
+    u32 events = 0;
+    if (has_flag(type, NotificationType::Read))
+        events |= EPOLLIN;
+    if (has_flag(type, NotificationType::Write))
+        events |= EPOLLOUT;
+    return events;
+}
+#else
 short notification_type_to_poll_events(NotificationType type)
 {
     short events = 0;
@@ -42,6 +59,7 @@ short notification_type_to_poll_events(NotificationType type)
         events |= POLLOUT;
     return events;
 }
+#endif
 
 bool has_flag(int value, int flag)
 {
@@ -280,18 +298,73 @@ struct ThreadData {
 
         wake_pipe_fds = result.release_value();
 
+#ifdef EVENT_LOOP_USES_EPOLL
+        if (epoll_fd != -1)
+            close(epoll_fd);
+
+        auto epoll_fd_or_error = Core::System::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_or_error.is_error()) {
+            warnln("\033[31;1mFailed to create event loop queue:\033[0m {}", epoll_fd_or_error.error());
+            VERIFY_NOT_REACHED();
+        }
+        epoll_fd = epoll_fd_or_error.release_value();
+
+        // The wake pipe informs us of POSIX signals as well as manual calls to wake()
+        VERIFY(notifiers_by_fd.is_empty());
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = wake_pipe_fds[0];
+        MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_pipe_fds[0], &event));
+#else
         // The wake pipe informs us of POSIX signals as well as manual calls to wake()
         VERIFY(poll_fds.size() == 0);
         poll_fds.append({ .fd = wake_pipe_fds[0], .events = POLLIN, .revents = 0 });
         notifier_by_index.append(nullptr);
+#endif
     }
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    // Tells the kernel which events we want for fd, which is the union of what its notifiers want.
+    void update_epoll_registration(int fd, int op)
+    {
+        if (always_ready_fds.contains(fd)) {
+            // The queue refused this fd when it was added, so there's no registration to update.
+            if (op == EPOLL_CTL_DEL)
+                always_ready_fds.remove(fd);
+            return;
+        }
+
+        epoll_event event {};
+        event.data.fd = fd;
+        if (auto notifiers = notifiers_by_fd.get(fd); notifiers.has_value()) {
+            for (auto* notifier : notifiers.value())
+                event.events |= notification_type_to_epoll_events(notifier->type());
+        }
+        auto result = Core::System::epoll_ctl(epoll_fd, op, fd, &event);
+        if (result.is_error() && op == EPOLL_CTL_ADD && result.error().code() == EPERM) {
+            // Regular files (e.g. stdin redirected from one) can't be watched, but poll() reports them as always ready,
+            // so we do the same.
+            always_ready_fds.set(fd);
+            return;
+        }
+        // The fd may have been closed before its notifier was unregistered, which already dropped it from the queue.
+        if (result.is_error() && op != EPOLL_CTL_DEL)
+            dbgln("EventLoopImplementationUnix: Failed to watch fd {}: {}", fd, result.error());
+    }
+#endif
+
     // Each thread has its own timers, notifiers and a wake pipe.
     TimeoutSet timeouts;
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    int epoll_fd { -1 };
+    HashMap<int, Vector<Notifier*, 1>> notifiers_by_fd;
+    HashTable<int> always_ready_fds;
+#else
     Vector<pollfd> poll_fds;
     HashMap<Notifier*, size_t> notifier_by_ptr;
     Vector<Notifier*> notifier_by_index;
+#endif
 
     // The wake pipe is used to notify another event loop that someone has called wake(), or a signal has been received.
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
@@ -381,9 +454,22 @@ retry:
         }
     }
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    // Notifiers on fds that are always ready have to fire right away.
+    if (!thread_data.always_ready_fds.is_empty()) {
+        timeout = 0;
+        should_wait_forever = false;
+    }
+#endif
+
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
+#ifdef EVENT_LOOP_USES_EPOLL
+    Array<epoll_event, 64> ready_events;
+    ErrorOr<int> error_or_marked_fd_count = System::epoll_wait(thread_data.epoll_fd, ready_events, should_wait_forever ? -1 : timeout);
+#else
     ErrorOr<int> error_or_marked_fd_count = System::poll(thread_data.poll_fds, should_wait_forever ? -1 : timeout);
+#endif
     auto time_after_poll = MonotonicTime::now_coarse();
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (error_or_marked_fd_count.is_error()) {
@@ -395,7 +481,13 @@ try_select_again:
 
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (has_flag(thread_data.poll_fds[0].revents, POLLIN)) {
+#ifdef EVENT_LOOP_USES_EPOLL
+    auto ready_events_span = ready_events.span().trim(error_or_marked_fd_count.value());
+    bool wake_pipe_is_readable = any_of(ready_events_span, [&](auto& event) { return event.data.fd == thread_data.wake_pipe_fds[0]; });
+#else
+    bool wake_pipe_is_readable = has_flag(thread_data.poll_fds[0].revents, POLLIN);
+#endif
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -424,6 +516,44 @@ try_select_again:
             goto retry;
     }
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    // Handle file system notifiers by making them normal events.
+    // Look notifiers up again here, as signal handlers above may have unregistered some of them.
+    for (auto& event : ready_events_span) {
+        if (event.data.fd == thread_data.wake_pipe_fds[0])
+            continue;
+        auto notifiers = thread_data.notifiers_by_fd.get(event.data.fd);
+        if (!notifiers.has_value())
+            continue;
+
+        NotificationType ready_type = NotificationType::None;
+        if (has_flag(event.events, EPOLLIN))
+            ready_type |= NotificationType::Read;
+        if (has_flag(event.events, EPOLLOUT))
+            ready_type |= NotificationType::Write;
+        if (has_flag(event.events, EPOLLHUP))
+            ready_type |= NotificationType::HangUp;
+        if (has_flag(event.events, EPOLLERR))
+            ready_type |= NotificationType::Error;
+
+        for (auto* notifier : notifiers.value()) {
+            auto type = ready_type & notifier->type();
+            if (type != NotificationType::None)
+                ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd(), type));
+        }
+    }
+
+    for (auto fd : thread_data.always_ready_fds) {
+        auto notifiers = thread_data.notifiers_by_fd.get(fd);
+        if (!notifiers.has_value())
+            continue;
+        for (auto* notifier : notifiers.value()) {
+            auto type = (NotificationType::Read | NotificationType::Write) & notifier->type();
+            if (type != NotificationType::None)
+                ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd(), type));
+        }
+    }
+#else
     if (error_or_marked_fd_count.value() != 0) {
         // Handle file system notifiers by making them normal events.
         for (size_t i = 1; i < thread_data.poll_fds.size(); ++i) {
@@ -444,6 +574,7 @@ try_select_again:
                 ThreadEventQueue::current().post_event(notifier, make<NotifierActivationEvent>(notifier.fd(), type));
         }
     }
+#endif
 
     // Handle expired timers.
     thread_data.timeouts.fire_expired(time_after_poll);
@@ -520,9 +651,15 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
 {
     auto& thread_data = ThreadData::the();
     thread_data.timeouts.clear();
+#ifdef EVENT_LOOP_USES_EPOLL
+    // The queue is shared with our parent, so initialize_wake_pipe() replaces it with a fresh one.
+    thread_data.notifiers_by_fd.clear();
+    thread_data.always_ready_fds.clear();
+#else
     thread_data.poll_fds.clear();
     thread_data.notifier_by_ptr.clear();
     thread_data.notifier_by_index.clear();
+#endif
     thread_data.initialize_wake_pipe();
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
@@ -678,6 +815,12 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
     auto& thread_data = ThreadData::the();
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    auto& notifiers = thread_data.notifiers_by_fd.ensure(notifier.fd());
+    bool is_new_fd = notifiers.is_empty();
+    notifiers.append(&notifier);
+    thread_data.update_epoll_registration(notifier.fd(), is_new_fd ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+#else
     thread_data.notifier_by_ptr.set(&notifier, thread_data.poll_fds.size());
     thread_data.notifier_by_index.append(&notifier);
     thread_data.poll_fds.append({
@@ -685,6 +828,7 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
         .events = notification_type_to_poll_events(notifier.type()),
         .revents = 0,
     });
+#endif
 
     notifier.set_owner_thread(s_thread_id);
 }
@@ -696,6 +840,18 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
         return;
 
     auto& thread_data = *thread_data_ptr;
+#ifdef EVENT_LOOP_USES_EPOLL
+    auto it = thread_data.notifiers_by_fd.find(notifier.fd());
+    VERIFY(it != thread_data.notifiers_by_fd.end());
+
+    it->value.remove_first_matching([&](auto* other) { return other == &notifier; });
+    if (it->value.is_empty()) {
+        thread_data.notifiers_by_fd.remove(it);
+        thread_data.update_epoll_registration(notifier.fd(), EPOLL_CTL_DEL);
+    } else {
+        thread_data.update_epoll_registration(notifier.fd(), EPOLL_CTL_MOD);
+    }
+#else
     auto it = thread_data.notifier_by_ptr.find(&notifier);
     VERIFY(it != thread_data.notifier_by_ptr.end());
 
@@ -709,6 +865,7 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
     }
     thread_data.poll_fds.take_last();
     thread_data.notifier_by_index.take_last();
+#endif
 }
 
 void EventLoopManagerUnix::did_post_event()
@@ -27,6 +27,7 @@ class File;
 class LocalServer;
 class LocalSocket;
 class MappedFile;
+class MemoryPressureNotifier;
 class MimeData;
 class NetworkJob;
 class NetworkResponse;
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/MemoryPressureNotifier.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/System.h>
+
+namespace Core {
+
+ErrorOr<NonnullRefPtr<MemoryPressureNotifier>> MemoryPressureNotifier::create()
+{
+    auto flags = MemoryPressureListenerFlags::Nonblock | MemoryPressureListenerFlags::CloseOnExec;
+    auto fd = TRY(System::watch_memory_pressure(static_cast<unsigned>(flags)));
+    auto notifier = Notifier::construct(fd, Notifier::Type::Read);
+    return adopt_nonnull_ref_or_enomem(new (nothrow) MemoryPressureNotifier(move(notifier)));
+}
+
+MemoryPressureNotifier::MemoryPressureNotifier(NonnullRefPtr<Notifier> notifier)
+    : m_notifier(move(notifier))
+{
+    m_notifier->on_activation = [this] { read_event(); };
+}
+
+MemoryPressureNotifier::~MemoryPressureNotifier()
+{
+    auto fd = m_notifier->fd();
+    m_notifier->on_activation = nullptr;
+    m_notifier->close();
+    (void)System::close(fd);
+}
+
+void MemoryPressureNotifier::read_event()
+{
+    MemoryPressureEvent event;
+    auto result = System::read(m_notifier->fd(), { &event, sizeof(event) });
+    if (result.is_error()) {
+        // Someone else got to it first, or the level changed back before we got here.
+        if (result.error().code() != EAGAIN)
+            dbgln("MemoryPressureNotifier: Failed to read event: {}", result.error());
+        return;
+    }
+    if (result.value() != sizeof(event) || event.level == m_level)
+        return;
+
+    m_level = event.level;
+    if (on_pressure_level_change)
+        on_pressure_level_change(m_level);
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <Kernel/API/MemoryPressure.h>
+#include <LibCore/Forward.h>
+
+namespace Core {
+
+// Lets the event loop know when the system is running low on memory, see watch_memory_pressure(2).
+//
+// Services that keep caches around should drop what's cheap to rebuild once the level goes up to Low,
+// and everything they can do without at Critical.
+class MemoryPressureNotifier : public RefCounted<MemoryPressureNotifier> {
+    AK_MAKE_NONCOPYABLE(MemoryPressureNotifier);
+
+public:
+    static ErrorOr<NonnullRefPtr<MemoryPressureNotifier>> create();
+    ~MemoryPressureNotifier();
+
+    MemoryPressureLevel level() const { return m_level; }
+
+    Function<void(MemoryPressureLevel)> on_pressure_level_change;
+
+private:
+    explicit MemoryPressureNotifier(NonnullRefPtr<Notifier>);
+
+    void read_event();
+
+    NonnullRefPtr<Notifier> m_notifier;
+    MemoryPressureLevel m_level { MemoryPressureLevel::Normal };
+};
+
+}
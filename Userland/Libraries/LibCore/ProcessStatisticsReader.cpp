@@ -5,9 +5,7 @@
  */
 
 #include <AK/ByteBuffer.h>
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonValue.h>
+#include <AK/JsonDocument.h>
 #include <LibCore/File.h>
 #include <LibCore/ProcessStatisticsReader.h>
 #include <pwd.h>
@@ -23,9 +21,9 @@ ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all(SeekableStream&
     AllProcessesStatistics all_processes_statistics;
 
     auto file_contents = TRY(proc_all_file.read_until_eof());
-    auto json_obj = TRY(JsonValue::from_string(file_contents)).as_object();
-    json_obj.get_array("processes"sv)->for_each([&](auto& value) {
-        JsonObject const& process_object = value.as_object();
+    auto document = TRY(JsonDocument::parse(file_contents));
+    auto json_obj = document.root();
+    json_obj.get_array("processes"sv)->for_each([&](auto& process_object) {
         Core::ProcessStatistics process;
 
         // kernel data first
@@ -51,10 +49,9 @@ ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all(SeekableStream&
         process.amount_purgeable_volatile = process_object.get_u32("amount_purgeable_volatile"sv).value_or(0);
         process.amount_purgeable_nonvolatile = process_object.get_u32("amount_purgeable_nonvolatile"sv).value_or(0);
 
-        auto& thread_array = process_object.get_array("threads"sv).value();
+        auto thread_array = process_object.get_array("threads"sv).value();
         process.threads.ensure_capacity(thread_array.size());
-        thread_array.for_each([&](auto& value) {
-            auto& thread_object = value.as_object();
+        thread_array.for_each([&](auto& thread_object) {
             Core::ThreadStatistics thread;
             thread.tid = thread_object.get_u32("tid"sv).value_or(0);
             thread.times_scheduled = thread_object.get_u32("times_scheduled"sv).value_or(0);
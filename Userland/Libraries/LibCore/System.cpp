@@ -35,6 +35,7 @@
 #    include <serenity.h>
 #    include <sys/prctl.h>
 #    include <sys/ptrace.h>
+#    include <sys/sendfile.h>
 #    include <sys/sysmacros.h>
 #endif
 
@@ -1551,6 +1552,24 @@ ErrorOr<ssize_t> recvfrom(int sockfd, void* buffer, size_t buffer_length, int fl
     return received;
 }
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<int> sendmmsg(int sockfd, Span<struct mmsghdr> messages, int flags)
+{
+    auto sent = ::sendmmsg(sockfd, messages.data(), messages.size(), flags);
+    if (sent < 0)
+        return Error::from_syscall("sendmmsg"sv, -errno);
+    return sent;
+}
+
+ErrorOr<int> recvmmsg(int sockfd, Span<struct mmsghdr> messages, int flags, struct timespec* timeout)
+{
+    auto received = ::recvmmsg(sockfd, messages.data(), messages.size(), flags, timeout);
+    if (received < 0)
+        return Error::from_syscall("recvmmsg"sv, -errno);
+    return received;
+}
+#endif
+
 ErrorOr<AddressInfoVector> getaddrinfo(char const* nodename, char const* servname, struct addrinfo const& hints)
 {
     struct addrinfo* results = nullptr;
@@ -1769,6 +1788,31 @@ ErrorOr<int> poll(Span<struct pollfd> poll_fds, int timeout)
     return { rc };
 }
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<int> epoll_create1(int flags)
+{
+    int rc = ::epoll_create1(flags);
+    if (rc < 0)
+        return Error::from_syscall("epoll_create1"sv, -errno);
+    return rc;
+}
+
+ErrorOr<void> epoll_ctl(int epfd, int op, int fd, struct epoll_event* event)
+{
+    if (::epoll_ctl(epfd, op, fd, event) < 0)
+        return Error::from_syscall("epoll_ctl"sv, -errno);
+    return {};
+}
+
+ErrorOr<int> epoll_wait(int epfd, Span<struct epoll_event> events, int timeout)
+{
+    auto const rc = ::epoll_wait(epfd, events.data(), static_cast<int>(events.size()), timeout);
+    if (rc < 0)
+        return Error::from_syscall("epoll_wait"sv, -errno);
+    return { rc };
+}
+#endif
+
 #ifdef AK_OS_SERENITY
 ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length)
 {
@@ -1777,6 +1821,46 @@ ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length)
         return Error::from_syscall("posix_fallocate"sv, -rc);
     return {};
 }
+
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    ssize_t rc = ::sendfile(out_fd, in_fd, offset, count);
+    if (rc < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return rc;
+}
+
+ErrorOr<size_t> splice(int fd_in, off_t* offset_in, int fd_out, off_t* offset_out, size_t length, unsigned flags)
+{
+    ssize_t rc = ::splice(fd_in, offset_in, fd_out, offset_out, length, flags);
+    if (rc < 0)
+        return Error::from_syscall("splice"sv, -errno);
+    return rc;
+}
+
+ErrorOr<int> io_ring_setup(u32 entries, IORingParameters& parameters)
+{
+    int rc = ::io_ring_setup(entries, &parameters);
+    if (rc < 0)
+        return Error::from_syscall("io_ring_setup"sv, -errno);
+    return rc;
+}
+
+ErrorOr<u32> io_ring_enter(int fd, u32 to_submit, u32 min_complete, u32 flags)
+{
+    int rc = ::io_ring_enter(fd, to_submit, min_complete, flags);
+    if (rc < 0)
+        return Error::from_syscall("io_ring_enter"sv, -errno);
+    return static_cast<u32>(rc);
+}
+
+ErrorOr<int> watch_memory_pressure(unsigned flags)
+{
+    int rc = ::watch_memory_pressure(flags);
+    if (rc < 0)
+        return Error::from_syscall("watch_memory_pressure"sv, -errno);
+    return rc;
+}
 #endif
 
 // This constant is copied from LibFileSystem. We cannot use or even include it directly,
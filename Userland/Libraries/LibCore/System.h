@@ -46,9 +46,14 @@
 #endif
 
 #ifdef AK_OS_SERENITY
+#    include <Kernel/API/IORing.h>
 #    include <Kernel/API/Unshare.h>
 #endif
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    include <sys/epoll.h>
+#endif
+
 namespace Core::System {
 
 #ifdef AK_OS_SERENITY
@@ -227,6 +232,10 @@ ErrorOr<ssize_t> sendto(int sockfd, void const*, size_t, int flags, struct socka
 ErrorOr<ssize_t> recv(int sockfd, void*, size_t, int flags);
 ErrorOr<ssize_t> recvmsg(int sockfd, struct msghdr*, int flags);
 ErrorOr<ssize_t> recvfrom(int sockfd, void*, size_t, int flags, struct sockaddr*, socklen_t*);
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<int> sendmmsg(int sockfd, Span<struct mmsghdr>, int flags);
+ErrorOr<int> recvmmsg(int sockfd, Span<struct mmsghdr>, int flags, struct timespec* timeout = nullptr);
+#endif
 ErrorOr<void> getsockopt(int sockfd, int level, int option, void* value, socklen_t* value_size);
 ErrorOr<void> setsockopt(int sockfd, int level, int option, void const* value, socklen_t value_size);
 ErrorOr<void> getsockname(int sockfd, struct sockaddr*, socklen_t*);
@@ -243,6 +252,12 @@ ErrorOr<void> access(StringView pathname, int mode, int flags = 0);
 ErrorOr<ByteString> readlink(StringView pathname);
 ErrorOr<int> poll(Span<struct pollfd>, int timeout);
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<int> epoll_create1(int flags);
+ErrorOr<void> epoll_ctl(int epfd, int op, int fd, struct epoll_event* event);
+ErrorOr<int> epoll_wait(int epfd, Span<struct epoll_event>, int timeout);
+#endif
+
 #ifdef AK_OS_SERENITY
 ErrorOr<void> create_block_device(StringView name, mode_t mode, unsigned major, unsigned minor);
 ErrorOr<void> create_char_device(StringView name, mode_t mode, unsigned major, unsigned minor);
@@ -282,6 +297,11 @@ ErrorOr<AddressInfoVector> getaddrinfo(char const* nodename, char const* servnam
 
 #ifdef AK_OS_SERENITY
 ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length);
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+ErrorOr<size_t> splice(int fd_in, off_t* offset_in, int fd_out, off_t* offset_out, size_t length, unsigned flags = 0);
+ErrorOr<int> io_ring_setup(u32 entries, IORingParameters&);
+ErrorOr<u32> io_ring_enter(int fd, u32 to_submit, u32 min_complete, u32 flags);
+ErrorOr<int> watch_memory_pressure(unsigned flags);
 #endif
 
 unsigned hardware_concurrency();
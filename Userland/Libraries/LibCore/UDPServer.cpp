@@ -12,6 +12,7 @@
 #include <LibCore/UDPServer.h>
 #include <errno.h>
 #include <stdio.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #ifndef SOCK_NONBLOCK
@@ -72,6 +73,96 @@ ErrorOr<ByteBuffer> UDPServer::receive(size_t size, sockaddr_in& in)
     return buf;
 }
 
+ErrorOr<Vector<UDPServer::Datagram>> UDPServer::receive_many(size_t max_count, size_t size)
+{
+    Vector<Datagram> datagrams;
+    TRY(datagrams.try_ensure_capacity(max_count));
+
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    auto buffer = TRY(ByteBuffer::create_uninitialized(max_count * size));
+    Vector<sockaddr_in> addresses;
+    Vector<iovec> iovs;
+    Vector<mmsghdr> messages;
+    TRY(addresses.try_resize(max_count));
+    TRY(iovs.try_resize(max_count));
+    TRY(messages.try_resize(max_count));
+    for (size_t i = 0; i < max_count; ++i) {
+        iovs[i] = { buffer.offset_pointer(i * size), size };
+        messages[i] = {};
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        messages[i].msg_hdr.msg_iov = &iovs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    auto count = TRY(Core::System::recvmmsg(m_fd, messages, MSG_WAITFORONE));
+    for (int i = 0; i < count; ++i) {
+        auto length = min(static_cast<size_t>(messages[i].msg_len), size);
+        auto data = TRY(ByteBuffer::copy(buffer.bytes().slice(i * size, length)));
+        datagrams.unchecked_append({ move(data), addresses[i] });
+    }
+#else
+    while (datagrams.size() < max_count) {
+        sockaddr_in address;
+        auto data_or_error = receive(size, address);
+        if (data_or_error.is_error()) {
+            // Whatever went wrong will come up again next time, once we've dealt with what we have.
+            if (!datagrams.is_empty())
+                break;
+            return data_or_error.release_error();
+        }
+        datagrams.unchecked_append({ data_or_error.release_value(), address });
+    }
+#endif
+
+    return datagrams;
+}
+
+ErrorOr<size_t> UDPServer::send_many(ReadonlySpan<Datagram> datagrams)
+{
+    if (m_fd < 0)
+        return Error::from_errno(EBADF);
+
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    Vector<iovec> iovs;
+    Vector<mmsghdr> messages;
+    TRY(iovs.try_resize(datagrams.size()));
+    TRY(messages.try_resize(datagrams.size()));
+    for (size_t i = 0; i < datagrams.size(); ++i) {
+        iovs[i] = { const_cast<u8*>(datagrams[i].data.data()), datagrams[i].data.size() };
+        messages[i] = {};
+        messages[i].msg_hdr.msg_name = const_cast<sockaddr_in*>(&datagrams[i].address);
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        messages[i].msg_hdr.msg_iov = &iovs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t sent = 0;
+    while (sent < messages.size()) {
+        auto result = Core::System::sendmmsg(m_fd, messages.span().slice(sent), 0);
+        if (result.is_error()) {
+            if (sent == 0)
+                return result.release_error();
+            break;
+        }
+        sent += result.value();
+    }
+    return sent;
+#else
+    size_t sent = 0;
+    for (auto const& datagram : datagrams) {
+        auto result = send(datagram.data, datagram.address);
+        if (result.is_error()) {
+            if (sent == 0)
+                return result.release_error();
+            break;
+        }
+        ++sent;
+    }
+    return sent;
+#endif
+}
+
 Optional<IPv4Address> UDPServer::local_address() const
 {
     if (m_fd == -1)
@@ -10,6 +10,7 @@
 #include <AK/ByteBuffer.h>
 #include <AK/Forward.h>
 #include <AK/Function.h>
+#include <AK/Vector.h>
 #include <LibCore/EventReceiver.h>
 #include <LibCore/Forward.h>
 #include <LibCore/SocketAddress.h>
@@ -33,6 +34,18 @@ public:
 
     ErrorOr<size_t> send(ReadonlyBytes, sockaddr_in const& to);
 
+    struct Datagram {
+        ByteBuffer data;
+        sockaddr_in address {};
+    };
+
+    // Receives up to `max_count` datagrams of at most `size` bytes each that have already arrived,
+    // with a single syscall where the system supports it. Fails only if there was nothing to receive.
+    ErrorOr<Vector<Datagram>> receive_many(size_t max_count, size_t size);
+
+    // Sends each datagram to its address. Returns how many were sent before running into an error.
+    ErrorOr<size_t> send_many(ReadonlySpan<Datagram>);
+
     Optional<IPv4Address> local_address() const;
     Optional<u16> local_port() const;
 
@@ -7,7 +7,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BinarySearch.h>
 #include <AK/ByteBuffer.h>
+#include <AK/Checked.h>
 #include <AK/Debug.h>
 #include <AK/HashMap.h>
 #include <AK/HashTable.h>
@@ -15,6 +17,7 @@
 #include <AK/Platform.h>
 #include <AK/Random.h>
 #include <AK/ScopeGuard.h>
+#include <AK/Time.h>
 #include <AK/Vector.h>
 #include <Kernel/API/VirtualMemoryAnnotations.h>
 #include <Kernel/API/prctl_numbers.h>
@@ -24,6 +27,7 @@
 #include <LibELF/DynamicLoader.h>
 #include <LibELF/DynamicObject.h>
 #include <LibELF/Hashes.h>
+#include <LibELF/PrelinkCache.h>
 #include <bits/dlfcn_integration.h>
 #include <bits/pthread_integration.h>
 #include <dlfcn.h>
@@ -33,6 +37,7 @@
 #include <string.h>
 #include <sys/internals.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <syscall.h>
 #include <unistd.h>
@@ -71,11 +76,82 @@ static ByteString s_loader_pledge_promises;
 
 static HashMap<StringView, DynamicObject::SymbolLookupResult> s_magic_functions;
 
-Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(StringView name)
+// What we keep track of while starting up a program with _LOADER_SHOW_STATISTICS=1 set.
+struct StartupStatistics {
+    struct Object {
+        ByteString path;
+        size_t relocation_count { 0 };
+        Duration link_time;
+    };
+
+    MonotonicTime start_time { MonotonicTime::now() };
+    Duration map_time;
+    Vector<Object> objects;
+    size_t symbol_lookups { 0 };
+    size_t prelinked_lookups { 0 };
+    size_t memoized_lookups { 0 };
+    size_t objects_searched { 0 };
+};
+static OwnPtr<StartupStatistics> s_startup_statistics;
+
+// The symbol bindings prelink(8) worked out for the objects we loaded at startup, if it has done so.
+struct PrelinkedBindings {
+    ReadonlyBytes file;
+    ReadonlySpan<PrelinkCache::Object> objects;
+    ReadonlySpan<PrelinkCache::Binding> bindings;
+    Vector<DynamicObject const*> dynamic_objects;
+    HashMap<DynamicObject const*, size_t> object_indices;
+};
+static OwnPtr<PrelinkedBindings> s_prelinked_bindings;
+
+static Optional<DynamicObject::SymbolLookupResult> lookup_prelinked_binding(DynamicObject::Symbol const& symbol)
 {
-    auto symbol = DynamicObject::HashSymbol { name };
+    if (!s_prelinked_bindings)
+        return {};
+    auto object_index = s_prelinked_bindings->object_indices.get(&symbol.object());
+    if (!object_index.has_value())
+        return {};
+
+    auto const& object = s_prelinked_bindings->objects[object_index.value()];
+    auto bindings = s_prelinked_bindings->bindings.slice(object.first_binding, object.binding_count);
+    auto* binding = binary_search(bindings, symbol.index(), nullptr, [](unsigned index, PrelinkCache::Binding const& binding) {
+        return static_cast<int>(index > binding.symbol_index) - static_cast<int>(index < binding.symbol_index);
+    });
+    // Whatever prelink couldn't find in any of the objects, we still have to look for in the usual way.
+    if (!binding || binding->provider_object >= s_prelinked_bindings->dynamic_objects.size())
+        return {};
+
+    auto const& provider = *s_prelinked_bindings->dynamic_objects[binding->provider_object];
+    if (binding->provider_symbol_index >= provider.symbol_count())
+        return {};
+    auto provider_symbol = provider.symbol(binding->provider_symbol_index);
+    if (provider_symbol.is_undefined() || provider_symbol.name() != symbol.name())
+        return {};
+    return DynamicObject::SymbolLookupResult { provider_symbol.value(), provider_symbol.size(), provider_symbol.address(), provider_symbol.bind(), provider_symbol.type(), &provider };
+}
+
+// Objects are never unloaded, and whatever gets loaded later ends up after everything that is already there.
+// So once a symbol has been found somewhere, looking for it again would only turn up the very same definition.
+struct GlobalSymbolKey {
+    u32 gnu_hash;
+    StringView name;
+
+    bool operator==(GlobalSymbolKey const&) const = default;
+};
+
+struct GlobalSymbolKeyTraits : public DefaultTraits<GlobalSymbolKey> {
+    static unsigned hash(GlobalSymbolKey const& key) { return key.gnu_hash; }
+};
 
+static HashMap<GlobalSymbolKey, DynamicObject::SymbolLookupResult, GlobalSymbolKeyTraits> s_global_symbol_cache;
+// PLT entries are bound on whichever thread first calls through them.
+static __pthread_mutex_t s_global_symbol_cache_lock = __PTHREAD_MUTEX_INITIALIZER;
+
+static Optional<DynamicObject::SymbolLookupResult> search_global_objects(DynamicObject::HashSymbol const& symbol)
+{
     for (auto& lib : s_global_objects) {
+        if (s_startup_statistics)
+            ++s_startup_statistics->objects_searched;
         auto res = lib.value->lookup_symbol(symbol);
         if (!res.has_value())
             continue;
@@ -84,11 +160,51 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
         // We don't want to allow local symbols to be pulled in to other modules
     }
 
-    if (auto magic_lookup = s_magic_functions.get(name); magic_lookup.has_value())
+    if (auto magic_lookup = s_magic_functions.get(symbol.name()); magic_lookup.has_value())
         return *magic_lookup;
     return {};
 }
 
+Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(StringView name)
+{
+    return search_global_objects(DynamicObject::HashSymbol { name });
+}
+
+Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(DynamicObject::Symbol const& symbol)
+{
+    if (s_startup_statistics)
+        ++s_startup_statistics->symbol_lookups;
+
+    if (auto result = lookup_prelinked_binding(symbol); result.has_value()) {
+        if (s_startup_statistics)
+            ++s_startup_statistics->prelinked_lookups;
+        return result;
+    }
+
+    // NOTE: The name lives in the string table of the object referencing it, which stays mapped for good.
+    //       Its hash is computed once here and reused for every object we look at.
+    auto hash_symbol = DynamicObject::HashSymbol { symbol.name() };
+    auto key = GlobalSymbolKey { hash_symbol.gnu_hash(), hash_symbol.name() };
+
+    pthread_mutex_lock(&s_global_symbol_cache_lock);
+    auto cached_result = s_global_symbol_cache.get(key);
+    pthread_mutex_unlock(&s_global_symbol_cache_lock);
+    if (cached_result.has_value()) {
+        if (s_startup_statistics)
+            ++s_startup_statistics->memoized_lookups;
+        return cached_result;
+    }
+
+    auto result = search_global_objects(hash_symbol);
+    // Whatever we didn't find might still show up with the next dlopen(), so only remember what we did find.
+    if (result.has_value()) {
+        pthread_mutex_lock(&s_global_symbol_cache_lock);
+        s_global_symbol_cache.set(key, result.value());
+        pthread_mutex_unlock(&s_global_symbol_cache_lock);
+    }
+    return result;
+}
+
 static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(ByteString const& filepath, int fd)
 {
     VERIFY(filepath.starts_with('/'));
@@ -242,6 +358,98 @@ static ErrorOr<DependencyOrdering, DlErrorMessage> map_dependencies(NonnullRefPt
     };
 }
 
+static bool prelinked_object_matches(PrelinkCache::Object const& object, StringView path, DynamicLoader const& loader)
+{
+    auto const& stat = loader.file_stat();
+    return path == loader.filepath()
+        && object.device == static_cast<u64>(stat.st_dev)
+        && object.inode == static_cast<u64>(stat.st_ino)
+        && object.mtime_seconds == stat.st_mtim.tv_sec
+        && object.mtime_nanoseconds == stat.st_mtim.tv_nsec
+        && object.size == static_cast<u64>(stat.st_size);
+}
+
+static ErrorOr<void, DlErrorMessage> validate_prelinked_bindings(PrelinkedBindings& prelinked, Vector<NonnullRefPtr<DynamicLoader>> const& load_order)
+{
+    if (prelinked.file.size() < sizeof(PrelinkCache::Header))
+        return DlErrorMessage { "Truncated header" };
+    auto const& header = *reinterpret_cast<PrelinkCache::Header const*>(prelinked.file.data());
+    if (header.magic != PrelinkCache::magic || header.version != PrelinkCache::version)
+        return DlErrorMessage { "Unsupported format" };
+
+    Checked<size_t> objects_size = header.object_count;
+    objects_size *= sizeof(PrelinkCache::Object);
+    Checked<size_t> bindings_size = header.binding_count;
+    bindings_size *= sizeof(PrelinkCache::Binding);
+    auto expected_size = objects_size + bindings_size;
+    expected_size += sizeof(PrelinkCache::Header);
+    expected_size += header.string_table_size;
+    if (expected_size.has_overflow() || expected_size.value() != prelinked.file.size())
+        return DlErrorMessage { "Size mismatch" };
+
+    auto const* objects = reinterpret_cast<PrelinkCache::Object const*>(prelinked.file.offset(sizeof(PrelinkCache::Header)));
+    auto const* bindings = reinterpret_cast<PrelinkCache::Binding const*>(objects + header.object_count);
+    auto strings = prelinked.file.slice(prelinked.file.size() - header.string_table_size);
+    prelinked.objects = { objects, header.object_count };
+    prelinked.bindings = { bindings, header.binding_count };
+
+    // If anything was loaded from elsewhere or has changed since, the bindings may be wrong.
+    if (prelinked.objects.size() != load_order.size())
+        return DlErrorMessage { "Different set of objects" };
+    for (size_t i = 0; i < load_order.size(); ++i) {
+        auto const& object = prelinked.objects[i];
+        if (static_cast<u64>(object.path_offset) + object.path_length > strings.size())
+            return DlErrorMessage { "Invalid path" };
+        if (static_cast<u64>(object.first_binding) + object.binding_count > prelinked.bindings.size())
+            return DlErrorMessage { "Invalid bindings" };
+        StringView path { strings.slice(object.path_offset, object.path_length) };
+        if (!prelinked_object_matches(object, path, *load_order[i]))
+            return DlErrorMessage { ByteString::formatted("{} has changed", load_order[i]->filepath()) };
+    }
+
+    prelinked.dynamic_objects.ensure_capacity(load_order.size());
+    for (size_t i = 0; i < load_order.size(); ++i) {
+        auto const& dynamic_object = load_order[i]->dynamic_object();
+        prelinked.dynamic_objects.unchecked_append(&dynamic_object);
+        prelinked.object_indices.set(&dynamic_object, i);
+    }
+    return {};
+}
+
+static void load_prelinked_bindings(Vector<NonnullRefPtr<DynamicLoader>> const& load_order)
+{
+    // prelink doesn't know about any extra library paths, so it might have picked other libraries.
+    if (!s_ld_library_path.is_empty())
+        return;
+
+    auto path = PrelinkCache::path_for_executable(s_main_program_path);
+    int fd = open(path.characters(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    ScopeGuard close_fd = [fd] { close(fd); };
+
+    // Whoever can write the cache decides which code we call, so it has to be as trustworthy as the libraries themselves.
+    struct stat stat;
+    if (fstat(fd, &stat) < 0 || !S_ISREG(stat.st_mode) || stat.st_uid != 0 || (stat.st_mode & (S_IWGRP | S_IWOTH)) || stat.st_size == 0)
+        return;
+
+    auto size = static_cast<size_t>(stat.st_size);
+    auto* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+        return;
+
+    auto prelinked = make<PrelinkedBindings>();
+    prelinked->file = { static_cast<u8 const*>(data), size };
+    if (auto result = validate_prelinked_bindings(*prelinked, load_order); result.is_error()) {
+        dbgln_if(DYNAMIC_LOAD_DEBUG, "Not using prelinked bindings from {}: {}", path, result.error().text);
+        munmap(data, size);
+        return;
+    }
+
+    dbgln_if(DYNAMIC_LOAD_DEBUG, "Using {} prelinked bindings from {}", prelinked->bindings.size(), path);
+    s_prelinked_bindings = move(prelinked);
+}
+
 static ErrorOr<FlatPtr> __create_new_tls_region()
 {
     void* static_tls_region = serenity_mmap(nullptr, s_tls_data.static_tls_region_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, 0, 0, s_tls_data.static_tls_region_alignment, "Static TLS Data");
@@ -378,16 +586,29 @@ static ErrorOr<void, DlErrorMessage> link_main_library(int flags, DependencyOrde
     //        load order? POSIX says to do relocations in load order but does the order really
     //        matter here?
     for (auto& loader : objects.load_order) {
+        auto start_time = MonotonicTime::now();
         bool success = loader->link(flags);
         if (!success) {
             return DlErrorMessage { ByteString::formatted("Failed to link library {}", loader->filepath()) };
         }
+        if (s_startup_statistics) {
+            auto const& object = loader->dynamic_object();
+            s_startup_statistics->objects.append({
+                .path = loader->filepath(),
+                .relocation_count = object.relocation_section().relocation_count() + object.plt_relocation_section().relocation_count(),
+                .link_time = MonotonicTime::now() - start_time,
+            });
+        }
     }
 
-    for (auto& loader : objects.load_order) {
+    for (size_t i = 0; i < objects.load_order.size(); ++i) {
+        auto& loader = objects.load_order[i];
+        auto start_time = MonotonicTime::now();
         auto result = loader->load_stage_3(flags);
         VERIFY(!result.is_error());
         auto& object = result.value();
+        if (s_startup_statistics)
+            s_startup_statistics->objects[i].link_time += MonotonicTime::now() - start_time;
 
         if (loader->filepath().ends_with("/libc.so"sv)) {
             initialize_libc(*object);
@@ -619,6 +840,31 @@ static char** __environ_value()
     return s_envp;
 }
 
+static void print_startup_statistics(StartupStatistics const& statistics)
+{
+    auto format_duration = [](Duration duration) {
+        auto microseconds = duration.to_microseconds();
+        return ByteString::formatted("{}.{:03} ms", microseconds / 1000, microseconds % 1000);
+    };
+
+    Duration total_link_time;
+    size_t total_relocation_count = 0;
+    for (auto const& object : statistics.objects) {
+        total_link_time += object.link_time;
+        total_relocation_count += object.relocation_count;
+    }
+
+    warnln("Loader.so: Startup statistics for {}", s_main_program_path);
+    warnln("    Mapping {} objects: {}", statistics.objects.size(), format_duration(statistics.map_time));
+    warnln("    Linking with {} relocations: {}", total_relocation_count, format_duration(total_link_time));
+    for (auto const& object : statistics.objects)
+        warnln("        {} => {} relocations, {}", object.path, object.relocation_count, format_duration(object.link_time));
+    warnln("    Symbol lookups: {} ({} prelinked, {} memoized, {} searched for in {} objects)",
+        statistics.symbol_lookups, statistics.prelinked_lookups, statistics.memoized_lookups,
+        statistics.symbol_lookups - statistics.prelinked_lookups - statistics.memoized_lookups, statistics.objects_searched);
+    warnln("    Total: {}", format_duration(MonotonicTime::now() - statistics.start_time));
+}
+
 static void read_environment_variables()
 {
     for (char** env = s_envp; *env; ++env) {
@@ -627,6 +873,10 @@ static void read_environment_variables()
             s_do_breakpoint_trap_before_entry = true;
         }
 
+        if (env_string == "_LOADER_SHOW_STATISTICS=1"sv) {
+            s_startup_statistics = make<StartupStatistics>();
+        }
+
         constexpr auto library_path_string = "LD_LIBRARY_PATH="sv;
         if (env_string.starts_with(library_path_string)) {
             s_ld_library_path = env_string.substring_view(library_path_string.length());
@@ -722,6 +972,9 @@ Examples of static-pie ELF objects are ELF packers, and the system dynamic loade
 
     auto objects = result2.release_value();
 
+    if (s_startup_statistics)
+        s_startup_statistics->map_time = MonotonicTime::now() - s_startup_statistics->start_time;
+
     dbgln_if(DYNAMIC_LOAD_DEBUG, "loaded all dependencies");
     for ([[maybe_unused]] auto& object : objects.load_order) {
         dbgln_if(DYNAMIC_LOAD_DEBUG, "{} - tls size: {}, tls alignment: {}, tls offset: {}",
@@ -730,6 +983,8 @@ Examples of static-pie ELF objects are ELF packers, and the system dynamic loade
 
     allocate_tls(objects.load_order);
 
+    load_prelinked_bindings(objects.load_order);
+
     auto result = link_main_library(RTLD_GLOBAL | RTLD_LAZY, objects);
     if (result.is_error()) {
         warnln("{}", result.error().text);
@@ -738,6 +993,12 @@ Examples of static-pie ELF objects are ELF packers, and the system dynamic loade
 
     drop_loader_promise("rpath"sv);
 
+    if (s_startup_statistics) {
+        print_startup_statistics(*s_startup_statistics);
+        // From here on, symbols are only looked up lazily, possibly on many threads at once.
+        s_startup_statistics = nullptr;
+    }
+
     auto& main_executable_loader = objects.load_order.first();
     auto entry_point = main_executable_loader->image().entry();
     if (main_executable_loader->is_dynamic())
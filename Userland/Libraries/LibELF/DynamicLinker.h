@@ -17,6 +17,8 @@ using EntryPointFunction = int (*)(int, char**, char**);
 class DynamicLinker {
 public:
     static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol(StringView symbol);
+    // Uses the bindings from the prelink cache for the symbol references of the objects it covers.
+    static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol(DynamicObject::Symbol const& symbol);
     static EntryPointFunction linker_main(ByteString&& main_program_path, int fd, bool is_secure, char** envp);
     static int iterate_over_loaded_shared_objects(int (*callback)(struct dl_phdr_info* info, size_t size, void* data), void* data);
 
@@ -66,14 +66,15 @@ Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> DynamicLoader::try_create(i
         return DlErrorMessage { "DynamicLoader::try_create mmap" };
     }
 
-    auto loader = adopt_ref(*new DynamicLoader(fd, move(filepath), data, size));
+    auto loader = adopt_ref(*new DynamicLoader(fd, move(filepath), stat, data, size));
     if (!loader->is_valid())
         return DlErrorMessage { "ELF image validation failed" };
     return loader;
 }
 
-DynamicLoader::DynamicLoader(int fd, ByteString filepath, void* data, size_t size)
+DynamicLoader::DynamicLoader(int fd, ByteString filepath, struct stat const& stat, void* data, size_t size)
     : m_filepath(move(filepath))
+    , m_file_stat(stat)
     , m_file_size(size)
     , m_image_fd(fd)
     , m_file_data(data)
@@ -826,7 +827,7 @@ void DynamicLoader::call_object_init_functions()
 Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol(const ELF::DynamicObject::Symbol& symbol)
 {
     if (symbol.is_undefined() || symbol.bind() == STB_WEAK)
-        return DynamicLinker::lookup_global_symbol(symbol.name());
+        return DynamicLinker::lookup_global_symbol(symbol);
 
     return DynamicObject::SymbolLookupResult { symbol.value(), symbol.size(), symbol.address(), symbol.bind(), symbol.type(), &symbol.object() };
 }
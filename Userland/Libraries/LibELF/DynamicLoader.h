@@ -16,6 +16,7 @@
 #include <LibELF/Image.h>
 #include <bits/dlfcn_integration.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace ELF {
 
@@ -48,6 +49,7 @@ public:
     ~DynamicLoader();
 
     ByteString const& filepath() const { return m_filepath; }
+    struct stat const& file_stat() const { return m_file_stat; }
 
     bool is_valid() const { return m_valid; }
 
@@ -98,7 +100,7 @@ public:
     void compute_topological_order(Vector<NonnullRefPtr<DynamicLoader>>& topological_order);
 
 private:
-    DynamicLoader(int fd, ByteString filepath, void* file_data, size_t file_size);
+    DynamicLoader(int fd, ByteString filepath, struct stat const&, void* file_data, size_t file_size);
 
     class ProgramHeaderRegion {
     public:
@@ -156,6 +158,7 @@ private:
     void find_tls_size_and_alignment();
 
     ByteString m_filepath;
+    struct stat m_file_stat {};
     size_t m_file_size { 0 };
     int m_image_fd { -1 };
     void* m_file_data { nullptr };
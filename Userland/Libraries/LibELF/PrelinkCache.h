@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+// The on-disk format of the symbol bindings that prelink(8) works out ahead of time for an executable.
+//
+// Libraries are mapped at randomized addresses, so we can't store relocated data. What we can store is
+// which symbol of which object each symbol reference of the executable and its libraries resolves to,
+// which is what the dynamic loader otherwise spends most of its time looking up by name.
+//
+// A cache file is only used if the objects it was made for are exactly the ones the dynamic loader
+// ended up loading, in the same order. Objects are identified by their path, inode and modification time.
+namespace ELF::PrelinkCache {
+
+static constexpr StringView directory = "/var/cache/prelink"sv;
+
+static constexpr u32 magic = 0x4b4e4c50; // "PLNK"
+static constexpr u32 version = 1;
+
+// Followed by `object_count` Objects, `binding_count` Bindings and `string_table_size` bytes of paths.
+struct Header {
+    u32 magic;
+    u32 version;
+    u32 object_count;
+    u32 binding_count;
+    u32 string_table_size;
+    u32 reserved;
+};
+
+// The objects in load order, starting with the executable.
+struct Object {
+    u64 device;
+    u64 inode;
+    i64 mtime_seconds;
+    i64 mtime_nanoseconds;
+    u64 size;
+    u32 path_offset;
+    u32 path_length;
+    // The bindings for symbols referenced by this object, sorted by symbol_index.
+    u32 first_binding;
+    u32 binding_count;
+};
+
+struct Binding {
+    // Index into the .dynsym of the referencing object.
+    u32 symbol_index;
+    // Index into the objects, and into the .dynsym of that object.
+    u32 provider_object;
+    u32 provider_symbol_index;
+};
+
+static_assert(sizeof(Header) == 24);
+static_assert(sizeof(Object) == 56);
+static_assert(sizeof(Binding) == 12);
+
+inline ByteString path_for_executable(StringView executable_path)
+{
+    // Different paths may end up with the same name here, but the executable's path is checked as well.
+    auto name = executable_path.trim("/"sv, TrimMode::Left).replace("/"sv, "_"sv, ReplaceMode::All);
+    return ByteString::formatted("{}/{}", directory, name);
+}
+
+}
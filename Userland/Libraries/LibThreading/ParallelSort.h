@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/QuickSort.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibCore/System.h>
+#include <LibThreading/ThreadPool.h>
+
+namespace Threading {
+
+// Below this many elements per thread, starting up the threads costs more than they save.
+static constexpr size_t PARALLEL_SORT_MINIMUM_CHUNK_SIZE = 16 * KiB;
+
+namespace Detail {
+
+template<typename T, typename LessThan>
+void merge_runs(Span<T> source, Span<T> destination, size_t begin, size_t middle, size_t end, LessThan const& less_than)
+{
+    size_t left = begin;
+    size_t right = middle;
+    size_t out = begin;
+    while (left < middle && right < end) {
+        if (less_than(source[right], source[left]))
+            destination[out++] = move(source[right++]);
+        else
+            destination[out++] = move(source[left++]);
+    }
+    while (left < middle)
+        destination[out++] = move(source[left++]);
+    while (right < end)
+        destination[out++] = move(source[right++]);
+}
+
+}
+
+// Splits the data into one chunk per thread, sorts the chunks with AK::sort() on a thread pool, and then merges them
+// pairwise (again in parallel) until only one run is left. Inputs that are too small to make that worthwhile are just
+// sorted on the calling thread. The comparison is called from several threads at once, so it must not have any
+// unsynchronized state.
+template<typename T, typename LessThan>
+void parallel_sort(Span<T> data, LessThan less_than, Optional<size_t> thread_count = {})
+{
+    size_t chunk_count = min(thread_count.value_or(Core::System::hardware_concurrency()), data.size() / PARALLEL_SORT_MINIMUM_CHUNK_SIZE);
+    if (chunk_count <= 1) {
+        AK::sort(data, move(less_than));
+        return;
+    }
+
+    ThreadPool<Function<void()>> pool { [](Function<void()> work) { work(); }, chunk_count };
+
+    Vector<size_t> run_bounds;
+    for (size_t i = 0; i <= chunk_count; ++i)
+        run_bounds.append(data.size() * i / chunk_count);
+
+    for (size_t i = 0; i < chunk_count; ++i) {
+        pool.submit([chunk = data.slice(run_bounds[i], run_bounds[i + 1] - run_bounds[i]), &less_than]() mutable {
+            AK::sort(chunk, less_than);
+        });
+    }
+    pool.wait_for_all();
+
+    // Every merge moves the elements to the other buffer, so start out in the scratch buffer.
+    // The moved-from elements left behind in `data` are then overwritten by the first round of merges.
+    Vector<T> buffer;
+    buffer.ensure_capacity(data.size());
+    for (auto& element : data)
+        buffer.unchecked_append(move(element));
+
+    Span<T> source = buffer.span();
+    Span<T> destination = data;
+    while (run_bounds.size() > 2) {
+        Vector<size_t> merged_run_bounds;
+        for (size_t i = 0; i + 1 < run_bounds.size(); i += 2) {
+            size_t begin = run_bounds[i];
+            size_t middle = run_bounds[i + 1];
+            size_t end = i + 2 < run_bounds.size() ? run_bounds[i + 2] : middle;
+            pool.submit([=, &less_than] {
+                Detail::merge_runs(source, destination, begin, middle, end, less_than);
+            });
+            merged_run_bounds.append(begin);
+        }
+        merged_run_bounds.append(data.size());
+        pool.wait_for_all();
+
+        run_bounds = move(merged_run_bounds);
+        swap(source, destination);
+    }
+
+    if (source.data() != data.data()) {
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = move(source[i]);
+    }
+}
+
+template<typename T>
+void parallel_sort(Span<T> data)
+{
+    parallel_sort(data, [](auto& a, auto& b) { return a < b; });
+}
+
+}
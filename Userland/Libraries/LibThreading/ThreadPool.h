@@ -25,6 +25,8 @@ struct ThreadPoolLooper {
             entry = pool.m_work_queue.with_locked([&](auto& queue) -> Optional<typename Pool::Work> {
                 if (queue.is_empty())
                     return {};
+                // Count the work as busy before it leaves the queue, otherwise wait_for_all() could see neither.
+                pool.m_busy_count++;
                 return queue.dequeue();
             });
             if (entry.has_value())
@@ -35,13 +37,19 @@ struct ThreadPoolLooper {
             if (!wait)
                 return IterationDecision::Continue;
 
+            // submit() broadcasts with the mutex held, so checking again here means we can't miss its wakeup.
             pool.m_mutex.lock();
-            pool.m_work_available.wait();
+            if (!pool.m_should_exit && pool.m_work_queue.with_locked([](auto& queue) { return queue.is_empty(); }))
+                pool.m_work_available.wait();
             pool.m_mutex.unlock();
         }
 
-        pool.m_busy_count++;
         pool.m_handler(entry.release_value());
+
+        pool.m_mutex.lock();
+        pool.m_busy_count--;
+        pool.m_work_done.broadcast();
+        pool.m_mutex.unlock();
         return IterationDecision::Continue;
     }
 };
@@ -85,8 +93,10 @@ public:
 
     void request_exit()
     {
+        m_mutex.lock();
         m_should_exit.store(true, AK::MemoryOrder::memory_order_release);
         m_work_available.broadcast();
+        m_mutex.unlock();
     }
 
     bool was_exit_requested() const
@@ -99,24 +109,19 @@ public:
         m_work_queue.with_locked([&](auto& queue) {
             queue.enqueue({ move(work) });
         });
+        m_mutex.lock();
         m_work_available.broadcast();
+        m_mutex.unlock();
     }
 
     void wait_for_all()
     {
-        while (true) {
-            if (m_work_queue.with_locked([](auto& queue) { return queue.is_empty(); }))
-                break;
-            m_mutex.lock();
-            m_work_done.wait();
-            m_mutex.unlock();
-        }
-
-        while (m_busy_count.load(AK::MemoryOrder::memory_order_acquire) > 0) {
-            m_mutex.lock();
+        m_mutex.lock();
+        while (!m_work_queue.with_locked([](auto& queue) { return queue.is_empty(); })
+            || m_busy_count.load(AK::MemoryOrder::memory_order_acquire) > 0) {
             m_work_done.wait();
-            m_mutex.unlock();
         }
+        m_mutex.unlock();
     }
 
 private:
@@ -128,8 +133,6 @@ private:
                 Looper<ThreadPool> thread_looper { move(looper_args)... };
                 for (; !m_should_exit;) {
                     auto result = thread_looper.next(*this, true);
-                    m_busy_count--;
-                    m_work_done.signal();
                     if (result == IterationDecision::Break)
                         break;
                 }
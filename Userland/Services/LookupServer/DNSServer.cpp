@@ -13,27 +13,50 @@ namespace LookupServer {
 
 using namespace DNS;
 
+// Picking up all requests that have arrived with one syscall and answering them with another
+// saves us a trip into the kernel per request when lots of them come in at once.
+static constexpr size_t max_requests_per_batch = 32;
+
 DNSServer::DNSServer(Core::EventReceiver* parent)
     : Core::UDPServer(parent)
 {
     bind(IPv4Address(), 53);
     on_ready_to_receive = [this]() {
-        auto result = handle_client();
+        auto result = handle_clients();
         if (result.is_error()) {
-            dbgln("DNSServer: Failed to handle client: {}", result.error());
+            dbgln("DNSServer: Failed to handle clients: {}", result.error());
         }
     };
 }
 
-ErrorOr<void> DNSServer::handle_client()
+ErrorOr<void> DNSServer::handle_clients()
+{
+    auto requests = TRY(receive_many(max_requests_per_batch, 1024));
+
+    Vector<Datagram> responses;
+    TRY(responses.try_ensure_capacity(requests.size()));
+    for (auto& request : requests) {
+        auto response_or_error = handle_request(request.data);
+        if (response_or_error.is_error()) {
+            dbgln("DNSServer: Failed to handle client: {}", response_or_error.error());
+            continue;
+        }
+        auto response = response_or_error.release_value();
+        if (response.has_value())
+            responses.unchecked_append({ response.release_value(), request.address });
+    }
+
+    TRY(send_many(responses));
+    return {};
+}
+
+ErrorOr<Optional<ByteBuffer>> DNSServer::handle_request(ReadonlyBytes buffer)
 {
-    sockaddr_in client_address;
-    auto buffer = TRY(receive(1024, client_address));
     auto request = TRY(Packet::from_raw_packet(buffer));
 
     if (!request.is_query()) {
         dbgln("It's not a request");
-        return {};
+        return OptionalNone {};
     }
 
     LookupServer& lookup_server = LookupServer::the();
@@ -57,10 +80,7 @@ ErrorOr<void> DNSServer::handle_client()
     else
         response.set_code(Packet::Code::NOERROR);
 
-    buffer = TRY(response.to_byte_buffer());
-
-    TRY(send(buffer, client_address));
-    return {};
+    return TRY(response.to_byte_buffer());
 }
 
 }
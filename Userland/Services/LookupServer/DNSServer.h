@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
 #include <LibCore/UDPServer.h>
 
 namespace LookupServer {
@@ -16,7 +18,8 @@ class DNSServer : public Core::UDPServer {
 private:
     explicit DNSServer(Core::EventReceiver* parent = nullptr);
 
-    ErrorOr<void> handle_client();
+    ErrorOr<void> handle_clients();
+    ErrorOr<Optional<ByteBuffer>> handle_request(ReadonlyBytes);
 };
 
 }
@@ -20,6 +20,9 @@
 
 namespace LookupServer {
 
+// mDNS traffic comes in bursts, so we pick up everything that has arrived with one syscall.
+static constexpr size_t max_packets_per_batch = 32;
+
 MulticastDNS::MulticastDNS(Core::EventReceiver* parent)
     : Core::UDPServer(parent)
     , m_hostname("courage.local")
@@ -44,8 +47,8 @@ MulticastDNS::MulticastDNS(Core::EventReceiver* parent)
     bind(IPv4Address(), 5353);
 
     on_ready_to_receive = [this]() {
-        if (auto result = handle_packet(); result.is_error()) {
-            dbgln("Failed to handle packet: {}", result.error());
+        if (auto result = handle_packets(); result.is_error()) {
+            dbgln("Failed to handle packets: {}", result.error());
         }
     };
 
@@ -53,27 +56,34 @@ MulticastDNS::MulticastDNS(Core::EventReceiver* parent)
     // because it races with the network interfaces getting configured.
 }
 
-ErrorOr<void> MulticastDNS::handle_packet()
+ErrorOr<void> MulticastDNS::handle_packets()
 {
-    auto buffer = TRY(receive(1024));
-    auto packet = TRY(Packet::from_raw_packet(buffer));
-    if (packet.is_query())
-        handle_query(packet);
+    auto datagrams = TRY(receive_many(max_packets_per_batch, 1024));
+
+    // Everyone asking about us gets the same answer, so one announcement covers all queries that came in together.
+    bool should_announce = false;
+    for (auto& datagram : datagrams) {
+        auto packet_or_error = Packet::from_raw_packet(datagram.data);
+        if (packet_or_error.is_error()) {
+            dbgln("Failed to handle packet: {}", packet_or_error.error());
+            continue;
+        }
+        auto packet = packet_or_error.release_value();
+        if (packet.is_query() && is_query_for_us(packet))
+            should_announce = true;
+    }
+
+    if (should_announce)
+        announce();
     return {};
 }
 
-void MulticastDNS::handle_query(Packet const& packet)
+bool MulticastDNS::is_query_for_us(Packet const& packet) const
 {
-    bool should_reply = false;
-
     for (auto& question : packet.questions())
         if (question.name() == m_hostname)
-            should_reply = true;
-
-    if (!should_reply)
-        return;
-
-    announce();
+            return true;
+    return false;
 }
 
 void MulticastDNS::announce()
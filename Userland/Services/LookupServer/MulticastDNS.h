@@ -29,8 +29,8 @@ private:
     void announce();
     ErrorOr<size_t> emit_packet(Packet const&, sockaddr_in const* destination = nullptr);
 
-    ErrorOr<void> handle_packet();
-    void handle_query(Packet const&);
+    ErrorOr<void> handle_packets();
+    bool is_query_for_us(Packet const&) const;
 
     Vector<IPv4Address> local_addresses() const;
 
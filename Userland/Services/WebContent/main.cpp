@@ -8,10 +8,12 @@
 #include <LibAudio/Loader.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalServer.h>
+#include <LibCore/MemoryPressureNotifier.h>
 #include <LibCore/StandardPaths.h>
 #include <LibCore/System.h>
 #include <LibFileSystem/FileSystem.h>
 #include <LibIPC/SingleServer.h>
+#include <LibJS/Runtime/VM.h>
 #include <LibMain/Main.h>
 #include <LibWeb/Bindings/MainThreadVM.h>
 #include <LibWeb/Loader/ResourceLoader.h>
@@ -53,6 +55,16 @@ ErrorOr<int> serenity_main(Main::Arguments)
     Web::ResourceLoader::initialize(TRY(WebView::RequestServerAdapter::try_create()));
     TRY(Web::Bindings::initialize_main_thread_vm(Web::HTML::EventLoop::Type::Window));
 
+    auto memory_pressure_notifier = TRY(Core::MemoryPressureNotifier::create());
+    memory_pressure_notifier->on_pressure_level_change = [](auto level) {
+        if (level == MemoryPressureLevel::Normal)
+            return;
+        // Anything in the resource cache can be loaded again.
+        Web::ResourceLoader::the().clear_cache();
+        if (level == MemoryPressureLevel::Critical)
+            Web::Bindings::main_thread_vm().heap().collect_garbage();
+    };
+
     auto client = TRY(IPC::take_over_accepted_client_from_system_server<WebContent::ConnectionFromClient>());
     return event_loop.exec();
 }
@@ -5,11 +5,13 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/ByteString.h>
 #include <AK/CharacterTypes.h>
 #include <AK/NumberFormat.h>
 #include <AK/Optional.h>
 #include <AK/Vector.h>
+#include <LibCore/AsyncRing.h>
 #include <LibCore/ElapsedTimer.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
@@ -164,9 +166,6 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     size_t skip = 0;
     size_t seek = 0;
 
-    uint8_t* buffer = nullptr;
-    ssize_t nread = 0, nwritten = 0;
-
     for (size_t a = 1; a < arguments.strings.size(); a++) {
         auto argument = arguments.strings[a];
 
@@ -207,9 +206,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         }
     }
 
-    if ((buffer = (uint8_t*)malloc(block_size)) == nullptr) {
-        warnln("Unable to allocate {} bytes for the buffer.", block_size);
-        return -1;
+    // Two buffers, so that the next block can be read while the previous one is being written.
+    Array<uint8_t*, 2> buffers {};
+    for (auto& buffer : buffers) {
+        if ((buffer = (uint8_t*)malloc(block_size)) == nullptr) {
+            warnln("Unable to allocate {} bytes for the buffer.", block_size);
+            return -1;
+        }
     }
 
     if (seek > 0) {
@@ -224,51 +227,87 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         exit(status);
     }));
 
-    statistics.timer.start();
+    auto ring = TRY(Core::AsyncRing::create(4));
+    enum Operation : u64 {
+        Read,
+        Write,
+    };
 
-    while (1) {
-        nread = read(input_fd, buffer, block_size);
-        if (nread < 0) {
-            warnln("Cannot read from the input.");
-            break;
-        } else if (nread == 0) {
-            break;
-        } else {
-            if ((size_t)nread != block_size) {
-                statistics.partial_blocks_in++;
-            } else {
-                statistics.total_blocks_in++;
-            }
+    statistics.timer.start();
 
-            if (statistics.partial_blocks_in + statistics.total_blocks_in <= skip) {
-                continue;
-            }
+    size_t current_buffer = 0;
+    size_t blocks_to_write = 0;
+    TRY(ring->queue_read(input_fd, { buffers[current_buffer], block_size }, {}, Operation::Read));
+    u32 operations_in_flight = 1;
+
+    while (operations_in_flight > 0) {
+        TRY(ring->wait_for_completions(operations_in_flight));
+        operations_in_flight = 0;
+
+        Optional<i32> nread;
+        Optional<i32> nwritten;
+        while (auto completion = ring->take_completion()) {
+            if (completion->user_data == Operation::Read)
+                nread = completion->result;
+            else
+                nwritten = completion->result;
+        }
 
-            nwritten = write(output_fd, buffer, nread);
-            if (nwritten < 0) {
+        if (nwritten.has_value()) {
+            if (*nwritten < 0) {
                 warnln("Cannot write to the output.");
                 break;
-            } else if (nwritten == 0) {
+            } else if (*nwritten == 0) {
                 break;
+            }
+
+            if ((size_t)*nwritten < block_size) {
+                statistics.partial_blocks_out++;
             } else {
-                if ((size_t)nwritten < block_size) {
-                    statistics.partial_blocks_out++;
-                } else {
-                    statistics.total_blocks_out++;
-                }
+                statistics.total_blocks_out++;
+            }
 
-                statistics.total_bytes_copied += nwritten;
+            statistics.total_bytes_copied += *nwritten;
 
-                if (count > 0 && (statistics.partial_blocks_out + statistics.total_blocks_out) >= count) {
-                    break;
-                }
+            if (count > 0 && (statistics.partial_blocks_out + statistics.total_blocks_out) >= count) {
+                break;
             }
         }
+
+        if (!nread.has_value())
+            continue;
+        if (*nread < 0) {
+            warnln("Cannot read from the input.");
+            break;
+        } else if (*nread == 0) {
+            break;
+        }
+
+        if ((size_t)*nread != block_size) {
+            statistics.partial_blocks_in++;
+        } else {
+            statistics.total_blocks_in++;
+        }
+
+        bool is_skipped = statistics.partial_blocks_in + statistics.total_blocks_in <= skip;
+        if (!is_skipped) {
+            TRY(ring->queue_write(output_fd, { buffers[current_buffer], (size_t)*nread }, {}, Operation::Write));
+            ++operations_in_flight;
+            ++blocks_to_write;
+            current_buffer ^= 1;
+        }
+
+        // Don't read past what we're going to copy, the input may be a pipe that someone else reads from afterwards.
+        if (count == 0 || blocks_to_write < count) {
+            TRY(ring->queue_read(input_fd, { buffers[current_buffer], block_size }, {}, Operation::Read));
+            ++operations_in_flight;
+        }
     }
 
     closing_statistics();
 
-    free(buffer);
+    for (auto* buffer : buffers)
+        free(buffer);
 
     if (input_fd != 0) {
         close(input_fd);
@@ -4,9 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonValue.h>
+#include <AK/JsonDocument.h>
 #include <AK/StringBuilder.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
@@ -15,7 +13,7 @@
 #include <unistd.h>
 
 static bool use_color = false;
-static void print(StringView name, JsonValue const&, Vector<ByteString>& trail);
+static void print(StringView name, JsonDocument::Value const&, Vector<ByteString>& trail);
 
 static StringView color_name = ""sv;
 static StringView color_index = ""sv;
@@ -59,7 +57,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(Core::System::pledge("stdio"));
 
     auto file_contents = TRY(file->read_until_eof());
-    auto json = TRY(JsonValue::from_string(file_contents));
+    auto document = TRY(JsonDocument::parse(file_contents));
 
     if (use_color) {
         color_name = "\033[33;1m"sv;
@@ -72,11 +70,11 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     }
 
     Vector<ByteString> trail;
-    print("json"sv, json, trail);
+    print("json"sv, document.root(), trail);
     return 0;
 }
 
-static void print(StringView name, JsonValue const& value, Vector<ByteString>& trail)
+static void print(StringView name, JsonDocument::Value const& value, Vector<ByteString>& trail)
 {
     for (size_t i = 0; i < trail.size(); ++i)
         out("{}", trail[i]);
@@ -93,21 +91,22 @@ static void print(StringView name, JsonValue const& value, Vector<ByteString>& t
     if (value.is_array()) {
         outln("{}[]{};", color_brace, color_off);
         trail.append(ByteString::formatted("{}{}{}", color_name, name, color_off));
-        for (size_t i = 0; i < value.as_array().size(); ++i) {
-            auto element_name = ByteString::formatted("{}{}[{}{}{}{}{}]{}", color_off, color_brace, color_off, color_index, i, color_off, color_brace, color_off);
-            print(element_name, value.as_array()[i], trail);
-        }
+        size_t i = 0;
+        value.as_array().for_each([&](auto& element) {
+            auto element_name = ByteString::formatted("{}{}[{}{}{}{}{}]{}", color_off, color_brace, color_off, color_index, i++, color_off, color_brace, color_off);
+            print(element_name, element, trail);
+        });
         trail.take_last();
         return;
     }
     switch (value.type()) {
-    case JsonValue::Type::Null:
+    case JsonDocument::Type::Null:
         out("{}", color_null);
         break;
-    case JsonValue::Type::Bool:
+    case JsonDocument::Type::Bool:
         out("{}", color_bool);
         break;
-    case JsonValue::Type::String:
+    case JsonDocument::Type::String:
         out("{}", color_string);
         break;
     default:
@@ -115,5 +114,5 @@ static void print(StringView name, JsonValue const& value, Vector<ByteString>& t
         break;
     }
 
-    outln("{}{};", value.serialized<StringBuilder>(), color_off);
+    outln("{}{};", value.to_json_value().serialized<StringBuilder>(), color_off);
 }
@@ -7,6 +7,7 @@
 
 #include <AK/Assertions.h>
 #include <AK/JsonArray.h>
+#include <AK/JsonDocument.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonValue.h>
 #include <AK/StringBuilder.h>
@@ -19,8 +20,10 @@
 #include <LibMain/Main.h>
 #include <unistd.h>
 
-static JsonValue query(JsonValue const& value, Vector<StringView>& key_parts, size_t key_index = 0);
-static void print(JsonValue const& value, int spaces_per_indent, int indent = 0, bool use_color = true);
+template<typename Value>
+static JsonValue query(Value const& value, Vector<StringView>& key_parts, size_t key_index = 0);
+template<typename Value>
+static void print(Value const& value, int spaces_per_indent, int indent = 0, bool use_color = true);
 static void print_indent(int indent, int spaces_per_indent)
 {
     for (int i = 0; i < indent * spaces_per_indent; ++i)
@@ -48,19 +51,20 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(Core::System::pledge("stdio"));
 
     auto file_contents = TRY(file->read_until_eof());
-    auto json = TRY(JsonValue::from_string(file_contents));
+    auto document = TRY(JsonDocument::parse(file_contents));
     if (!dotted_key.is_empty()) {
         auto key_parts = dotted_key.split_view('.');
-        json = query(json, key_parts);
+        print(query(document.root(), key_parts), spaces_in_indent, 0, isatty(STDOUT_FILENO));
+    } else {
+        print(document.root(), spaces_in_indent, 0, isatty(STDOUT_FILENO));
     }
-
-    print(json, spaces_in_indent, 0, isatty(STDOUT_FILENO));
     outln();
 
     return 0;
 }
 
-void print(JsonValue const& value, int spaces_per_indent, int indent, bool use_color)
+template<typename Value>
+void print(Value const& value, int spaces_per_indent, int indent, bool use_color)
 {
     if (value.is_object()) {
         size_t printed_members = 0;
@@ -108,15 +112,23 @@ void print(JsonValue const& value, int spaces_per_indent, int indent, bool use_c
         else if (value.is_null())
             out("\033[34;1m");
     }
-    out("{}", value);
+    if constexpr (IsSame<Value, JsonValue>)
+        out("{}", value);
+    else
+        out("{}", value.to_json_value());
     if (use_color)
         out("\033[0m");
 }
 
-JsonValue query(JsonValue const& value, Vector<StringView>& key_parts, size_t key_index)
+template<typename Value>
+JsonValue query(Value const& value, Vector<StringView>& key_parts, size_t key_index)
 {
-    if (key_index == key_parts.size())
-        return value;
+    if (key_index == key_parts.size()) {
+        if constexpr (IsSame<Value, JsonValue>)
+            return value;
+        else
+            return value.to_json_value();
+    }
     auto key = key_parts[key_index++];
 
     if (key == "*"sv) {
@@ -133,13 +145,13 @@ JsonValue query(JsonValue const& value, Vector<StringView>& key_parts, size_t ke
         return JsonValue(JsonArray(matches));
     }
 
-    JsonValue result {};
     if (value.is_object()) {
-        result = value.as_object().get(key).value_or({});
+        if (auto member = value.as_object().get(key); member.has_value())
+            return query(*member, key_parts, key_index);
     } else if (value.is_array()) {
         auto key_as_index = key.to_number<int>();
         if (key_as_index.has_value())
-            result = value.as_array().at(key_as_index.value());
+            return query(value.as_array().at(key_as_index.value()), key_parts, key_index);
     }
-    return query(result, key_parts, key_index);
+    return query(JsonValue {}, key_parts, key_index);
 }
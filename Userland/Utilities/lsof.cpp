@@ -7,9 +7,7 @@
 #include <AK/ByteString.h>
 #include <AK/CharacterTypes.h>
 #include <AK/GenericLexer.h>
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonValue.h>
+#include <AK/JsonDocument.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
@@ -77,20 +75,20 @@ static Vector<OpenFile> get_open_files_by_pid(pid_t pid)
         return {};
     }
 
-    auto json_or_error = JsonValue::from_string(data.value());
-    if (json_or_error.is_error()) {
-        outln("lsof: {}", json_or_error.error());
+    auto document_or_error = JsonDocument::parse(data.value());
+    if (document_or_error.is_error()) {
+        outln("lsof: {}", document_or_error.error());
         return Vector<OpenFile>();
     }
-    auto json = json_or_error.release_value();
+    auto document = document_or_error.release_value();
 
     Vector<OpenFile> files;
-    json.as_array().for_each([pid, &files](JsonValue const& object) {
+    document.root().as_array().for_each([pid, &files](JsonDocument::Value const& object) {
         OpenFile open_file;
         open_file.pid = pid;
-        open_file.fd = object.as_object().get_integer<int>("fd"sv).value();
+        open_file.fd = object.get_integer<int>("fd"sv).value();
 
-        ByteString name = object.as_object().get_byte_string("absolute_path"sv).value_or({});
+        ByteString name = object.get_byte_string("absolute_path"sv).value_or({});
         VERIFY(parse_name(name, open_file));
         open_file.full_name = name;
 
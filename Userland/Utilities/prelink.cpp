@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/LexicalPath.h>
+#include <AK/QuickSort.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/Directory.h>
+#include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/System.h>
+#include <LibELF/DynamicLinker.h>
+#include <LibELF/DynamicLoader.h>
+#include <LibELF/DynamicObject.h>
+#include <LibELF/PrelinkCache.h>
+#include <LibFileSystem/FileSystem.h>
+#include <LibMain/Main.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ELF;
+
+struct LoadedObject {
+    ByteString path;
+    struct stat file_stat;
+    NonnullRefPtr<DynamicLoader> loader;
+    NonnullRefPtr<DynamicObject> object;
+};
+
+static ErrorOr<LoadedObject> map_object(ByteString const& path)
+{
+    int fd = TRY(Core::System::open(path, O_RDONLY));
+    auto result = DynamicLoader::try_create(fd, path);
+    if (result.is_error()) {
+        warnln("{}", result.error().text);
+        return Error::from_errno(ENOEXEC);
+    }
+    auto& loader = result.value();
+    if (!loader->is_valid() || !loader->image().is_dynamic())
+        return Error::from_string_literal("Not a dynamically linked ELF object");
+
+    auto object = loader->map();
+    if (!object)
+        return Error::from_string_literal("Failed to map ELF object");
+    return LoadedObject { path, loader->file_stat(), loader, object.release_nonnull() };
+}
+
+// Mirrors what the dynamic loader does in map_dependencies(), so we end up with the same objects in the same order.
+static ErrorOr<Vector<LoadedObject>> load_order_for(ByteString const& executable_path)
+{
+    Vector<LoadedObject> load_order;
+    HashMap<ByteString, size_t> object_indices;
+
+    TRY(load_order.try_append(TRY(map_object(executable_path))));
+    TRY(object_indices.try_set(executable_path, 0));
+
+    for (size_t i = 0; i < load_order.size(); ++i) {
+        auto name = LexicalPath::basename(load_order[i].path);
+        Vector<ByteString> dependencies;
+        load_order[i].object->for_each_needed_library([&](StringView needed_name) {
+            if (name != needed_name)
+                dependencies.append(needed_name);
+        });
+
+        for (auto const& needed_name : dependencies) {
+            auto dependency_path = DynamicLinker::resolve_library(needed_name, load_order[i].object);
+            if (!dependency_path.has_value()) {
+                warnln("Could not find required shared library: {}", needed_name);
+                return Error::from_errno(ENOENT);
+            }
+            if (object_indices.contains(*dependency_path))
+                continue;
+            TRY(object_indices.try_set(*dependency_path, load_order.size()));
+            TRY(load_order.try_append(TRY(map_object(*dependency_path))));
+        }
+    }
+    return load_order;
+}
+
+// Works out which object provides each symbol that the given object doesn't define itself (or defines weakly),
+// just like DynamicLinker::lookup_global_symbol() would.
+static ErrorOr<Vector<PrelinkCache::Binding>> bindings_for(DynamicObject const& object, Vector<LoadedObject> const& load_order)
+{
+    Vector<u32> symbol_indices;
+    auto collect_symbol = [&](DynamicObject::Relocation const& relocation) {
+        if (relocation.symbol_index() == 0)
+            return;
+        auto symbol = relocation.symbol();
+        if (!symbol.is_undefined() && symbol.bind() != STB_WEAK)
+            return;
+        symbol_indices.append(relocation.symbol_index());
+    };
+    object.relocation_section().for_each_relocation(collect_symbol);
+    object.plt_relocation_section().for_each_relocation(collect_symbol);
+
+    quick_sort(symbol_indices);
+
+    Vector<PrelinkCache::Binding> bindings;
+    Optional<u32> previous_symbol_index;
+    for (auto symbol_index : symbol_indices) {
+        if (symbol_index == previous_symbol_index)
+            continue;
+        previous_symbol_index = symbol_index;
+
+        auto hash_symbol = DynamicObject::HashSymbol { object.symbol(symbol_index).name() };
+        for (size_t provider = 0; provider < load_order.size(); ++provider) {
+            auto provider_symbol = load_order[provider].object->hash_section().lookup_symbol(hash_symbol);
+            if (!provider_symbol.has_value() || provider_symbol->is_undefined())
+                continue;
+            if (provider_symbol->bind() != STB_GLOBAL && provider_symbol->bind() != STB_WEAK)
+                continue;
+            TRY(bindings.try_append({ symbol_index, static_cast<u32>(provider), provider_symbol->index() }));
+            break;
+        }
+    }
+    return bindings;
+}
+
+static ErrorOr<ByteBuffer> generate_cache(Vector<LoadedObject> const& load_order)
+{
+    Vector<PrelinkCache::Object> objects;
+    Vector<PrelinkCache::Binding> bindings;
+    StringBuilder string_table;
+
+    for (auto const& loaded_object : load_order) {
+        auto object_bindings = TRY(bindings_for(loaded_object.object, load_order));
+        auto const& file_stat = loaded_object.file_stat;
+        TRY(objects.try_append({
+            .device = static_cast<u64>(file_stat.st_dev),
+            .inode = static_cast<u64>(file_stat.st_ino),
+            .mtime_seconds = file_stat.st_mtim.tv_sec,
+            .mtime_nanoseconds = file_stat.st_mtim.tv_nsec,
+            .size = static_cast<u64>(file_stat.st_size),
+            .path_offset = static_cast<u32>(string_table.length()),
+            .path_length = static_cast<u32>(loaded_object.path.length()),
+            .first_binding = static_cast<u32>(bindings.size()),
+            .binding_count = static_cast<u32>(object_bindings.size()),
+        }));
+        TRY(bindings.try_extend(move(object_bindings)));
+        TRY(string_table.try_append(loaded_object.path));
+    }
+
+    PrelinkCache::Header header {
+        .magic = PrelinkCache::magic,
+        .version = PrelinkCache::version,
+        .object_count = static_cast<u32>(objects.size()),
+        .binding_count = static_cast<u32>(bindings.size()),
+        .string_table_size = static_cast<u32>(string_table.length()),
+        .reserved = 0,
+    };
+
+    ByteBuffer cache;
+    TRY(cache.try_append(&header, sizeof(header)));
+    TRY(cache.try_append(objects.data(), objects.size() * sizeof(PrelinkCache::Object)));
+    TRY(cache.try_append(bindings.data(), bindings.size() * sizeof(PrelinkCache::Binding)));
+    TRY(cache.try_append(string_table.string_view().bytes()));
+    return cache;
+}
+
+static bool existing_cache_matches(ByteString const& cache_path, ReadonlyBytes cache)
+{
+    auto existing_cache = Core::MappedFile::map(cache_path);
+    if (existing_cache.is_error())
+        return false;
+    return existing_cache.value()->bytes() == cache;
+}
+
+static ErrorOr<void> write_cache(ByteString const& cache_path, ReadonlyBytes cache)
+{
+    TRY(Core::Directory::create(ByteString { PrelinkCache::directory }, Core::Directory::CreateDirectories::Yes));
+
+    // Write to a temporary file first, so a program starting up meanwhile never sees half a cache file.
+    auto temporary_path = ByteString::formatted("{}.{}", cache_path, getpid());
+    auto file = TRY(Core::File::open(temporary_path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate, 0644));
+    TRY(file->write_until_depleted(cache));
+    file->close();
+    TRY(Core::System::rename(temporary_path, cache_path));
+    return {};
+}
+
+static ErrorOr<void> prelink(StringView path, bool dry_run, bool verbose)
+{
+    auto executable_path = TRY(FileSystem::real_path(path));
+    auto load_order = TRY(load_order_for(executable_path));
+    auto cache = TRY(generate_cache(load_order));
+    auto cache_path = PrelinkCache::path_for_executable(executable_path);
+
+    if (verbose) {
+        auto const& header = *reinterpret_cast<PrelinkCache::Header const*>(cache.data());
+        outln("{}: {} objects, {} bindings", executable_path, header.object_count, header.binding_count);
+    }
+
+    if (existing_cache_matches(cache_path, cache)) {
+        if (verbose)
+            outln("{} is up to date", cache_path);
+        return {};
+    }
+    if (dry_run) {
+        outln("Would write {}", cache_path);
+        return {};
+    }
+    TRY(write_cache(cache_path, cache));
+    if (verbose)
+        outln("Wrote {}", cache_path);
+    return {};
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    TRY(Core::System::pledge("stdio rpath wpath cpath map_fixed"));
+
+    Vector<StringView> paths;
+    bool dry_run = false;
+    bool verbose = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Work out the symbol bindings of dynamically linked programs ahead of time.");
+    args_parser.add_option(dry_run, "Only show which cache files would be written", "dry-run", 'n');
+    args_parser.add_option(verbose, "Show what is being done", "verbose", 'v');
+    args_parser.add_positional_argument(paths, "Executables to prelink", "path");
+    args_parser.parse(arguments);
+
+    if (geteuid() != 0 && !dry_run)
+        warnln("Warning: The dynamic loader ignores cache files that are not owned by root");
+
+    bool had_errors = false;
+    for (auto path : paths) {
+        if (auto result = prelink(path, dry_run, verbose); result.is_error()) {
+            warnln("{}: {}", path, result.error());
+            had_errors = true;
+        }
+    }
+    return had_errors ? 1 : 0;
+}
@@ -5,13 +5,20 @@
  */
 
 #include <LibCore/ArgsParser.h>
+#include <LibCore/File.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
 #include <serenity.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 static Optional<pid_t> determine_pid_to_profile(StringView pid_argument, bool all_processes);
+static ErrorOr<void> set_sample_rate(u32 sample_rate);
+static ErrorOr<void> stream_events();
+
+static volatile sig_atomic_t s_interrupted = 0;
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -24,6 +31,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool enable = false;
     bool disable = false;
     bool all_processes = false;
+    bool stream = false;
+    Optional<u32> sample_rate;
     u64 event_mask = PERF_EVENT_MMAP | PERF_EVENT_MUNMAP | PERF_EVENT_PROCESS_CREATE
         | PERF_EVENT_PROCESS_EXEC | PERF_EVENT_PROCESS_EXIT | PERF_EVENT_THREAD_CREATE | PERF_EVENT_THREAD_EXIT
         | PERF_EVENT_SIGNPOST;
@@ -35,6 +44,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(disable, "Disable", nullptr, 'd');
     args_parser.add_option(free, "Free the profiling buffer for the associated process(es).", nullptr, 'f');
     args_parser.add_option(wait, "Enable profiling and wait for user input to disable.", nullptr, 'w');
+    args_parser.add_option(stream, "Enable profiling of all processes and write events to stdout as they come in, until interrupted.", nullptr, 's');
+    args_parser.add_option(sample_rate, "Take this many samples per second (super-user only)", nullptr, 'r', "rate");
     args_parser.add_option(Core::ArgsParser::Option {
         Core::ArgsParser::OptionArgumentMode::Required,
         "Enable tracking specific event type", nullptr, 't', "event_type",
@@ -73,6 +84,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         exit(0);
     }
 
+    if (stream)
+        all_processes = true;
+
     if (pid_argument.is_empty() && command.is_empty() && !all_processes) {
         args_parser.print_usage(stdout, arguments.strings[0]);
         print_types();
@@ -82,6 +96,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     if (!seen_event_type_arg)
         event_mask |= PERF_EVENT_SAMPLE;
 
+    if (sample_rate.has_value())
+        TRY(set_sample_rate(sample_rate.value()));
+
+    if (stream) {
+        TRY(Core::System::profiling_enable(-1, event_mask));
+        auto result = stream_events();
+        TRY(Core::System::profiling_disable(-1));
+        return result;
+    }
+
     if (!pid_argument.is_empty() || all_processes) {
         if (!(enable ^ disable ^ wait ^ free)) {
             warnln("-a and -p <PID> requires -e xor -d xor -w xor -f.");
@@ -123,6 +147,38 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     return 0;
 }
 
+ErrorOr<void> set_sample_rate(u32 sample_rate)
+{
+    auto file = TRY(Core::File::open("/sys/kernel/conf/profile_sample_rate"sv, Core::File::OpenMode::Write));
+    TRY(file->write_until_depleted(ByteString::number(sample_rate).bytes()));
+    return {};
+}
+
+ErrorOr<void> stream_events()
+{
+    TRY(Core::System::signal(SIGINT, [](int) { s_interrupted = 1; }));
+
+    auto file = TRY(Core::File::open("/sys/kernel/perf_stream"sv, Core::File::OpenMode::Read));
+    auto standard_output = TRY(Core::File::standard_output());
+    auto buffer = TRY(ByteBuffer::create_uninitialized(256 * KiB));
+    while (!s_interrupted) {
+        auto events_or_error = file->read_some(buffer);
+        if (events_or_error.is_error()) {
+            if (events_or_error.error().code() == EINTR)
+                break;
+            return events_or_error.release_error();
+        }
+        auto events = events_or_error.release_value();
+        if (events.is_empty()) {
+            // Nothing new yet, give the kernel some time to collect more.
+            usleep(100'000);
+            continue;
+        }
+        TRY(standard_output->write_until_depleted(events));
+    }
+    return {};
+}
+
 static Optional<pid_t> determine_pid_to_profile(StringView pid_argument, bool all_processes)
 {
     if (all_processes) {
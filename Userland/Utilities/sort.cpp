@@ -14,6 +14,7 @@
 #include <LibCore/File.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/ParallelSort.h>
 
 struct Line {
     StringView key;
@@ -57,6 +58,7 @@ struct Options {
     bool numeric { false };
     bool reverse { false };
     bool zero_terminated { false };
+    size_t thread_count { 1 };
     StringView separator {};
     Vector<ByteString> files;
 };
@@ -99,7 +101,7 @@ static ErrorOr<void> load_file(Options const& options, StringView filename, Stri
 
 ErrorOr<int> serenity_main([[maybe_unused]] Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio rpath"));
+    TRY(Core::System::pledge("stdio rpath thread"));
 
     Options options;
 
@@ -110,6 +112,7 @@ ErrorOr<int> serenity_main([[maybe_unused]] Main::Arguments arguments)
     args_parser.add_option(options.separator, "The separator to split fields by", "sep", 't', "char");
     args_parser.add_option(options.reverse, "Sort in reverse order", "reverse", 'r');
     args_parser.add_option(options.zero_terminated, "Use '\\0' as the line delimiter instead of a newline", "zero-terminated", 'z');
+    args_parser.add_option(options.thread_count, "Sort using this many threads", "parallel", 'j', "threads");
     args_parser.add_positional_argument(options.files, "Files to sort", "file", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -125,7 +128,10 @@ ErrorOr<int> serenity_main([[maybe_unused]] Main::Arguments arguments)
         }
     }
 
-    quick_sort(lines);
+    if (options.thread_count > 1)
+        Threading::parallel_sort(lines.span(), [](auto& a, auto& b) { return a < b; }, options.thread_count);
+    else
+        AK::sort(lines);
 
     auto print_lines = [line_delimiter](auto const& lines) {
         for (auto& line : lines)